@@ -1,4 +1,5 @@
 #include "../include/Simulation.hpp"
+#include "../include/Scene.hpp"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
@@ -168,10 +169,42 @@ void demonstratePresets() {
     }
 }
 
-int main() {
+template <int D>
+bool demonstrateScene(SceneLoader& loader) {
+    std::unique_ptr<SimulationT<D>> sim;
+    loader.getSettings().configure(sim);
+    if (!loader.load(*sim)) {
+        std::cerr << "Scène illisible: " << loader.getError() << std::endl;
+        return false;
+    }
+    
+    std::cout << "  Nombre de corps: " << sim->getBodyCount() << " en " << D << "D" << std::endl;
+    double initialEnergy = sim->computeEnergy();
+    for (int i = 0; i < 100; ++i) {
+        sim->step();
+    }
+    double finalEnergy = sim->computeEnergy();
+    std::cout << "  Variation d'énergie après 100 étapes: "
+              << std::abs(finalEnergy - initialEnergy) / std::abs(initialEnergy) * 100 << "%" << std::endl;
+    return true;
+}
+
+int main(int argc, char** argv) {
     std::cout << "🌟 DÉMONSTRATION SIMULATION N-CORPS 🌟" << std::endl;
     std::cout << "=======================================" << std::endl;
     
+    // ./demo_runner fichier.scene : démonstration sur une scène au lieu des préréglages
+    if (argc > 1) {
+        SceneLoader loader;
+        if (!loader.open(argv[1])) {
+            std::cerr << "Scène illisible: " << loader.getError() << std::endl;
+            return 1;
+        }
+        std::cout << "\n=== Scène " << argv[1] << " ===" << std::endl;
+        bool loaded = loader.getSettings().dimension == 3 ? demonstrateScene<3>(loader) : demonstrateScene<2>(loader);
+        return loaded ? 0 : 1;
+    }
+    
     demonstrateOrbit();
     demonstrateChaos();
     demonstratePresets();
@@ -5,12 +5,27 @@
 #include "Simulation.hpp"
 #include "Renderer.hpp"
 #include "ConfigWindow.hpp"
+#include "Trajectory.hpp"
+#include "SpatialIndex.hpp"
+#include "Camera.hpp"
+#include "Coroutine.hpp"
+#include "Scene.hpp"
+#include <atomic>
 #include <memory>
+#include <string>
 
 class Application {
 private:
+    // Une seule des deux simulations existe, selon la dimension choisie
+    int dimension;
     std::unique_ptr<Simulation> simulation;
+    std::unique_ptr<Simulation3D> simulation3D;
     std::unique_ptr<Renderer> renderer;
+    
+    // Relecture : remplace la simulation, la physique n'est jamais appelée
+    std::unique_ptr<TrajectoryReader> trajectory;
+    double playbackPosition;  // Image courante, fractionnaire aux vitesses < 1
+    int playbackDirection;    // +1 en avant, -1 en arrière
     bool running;
     bool paused;
     
@@ -27,14 +42,45 @@ private:
     bool keys[SDL_NUM_SCANCODES];
     int mouseX, mouseY;
     bool mousePressed;
+    int pressX, pressY;     // Position du clic : un relâché sur place sélectionne
+    
+    // Sélection : index des positions affichées, reconstruit au premier clic sur une nouvelle image
+    SpatialIndex pickIndex;
+    std::vector<Vector2D> pickPoints;
+    bool pickIndexCurrent;
+    size_t selectedBody;
+    
+    // Panneau du corps sélectionné, recalculé toutes les quelques images
+    std::vector<std::string> selectionLines;
+    int selectionAge;
+    
+    // Caméra lissée
+    Camera camera;
+    
+    // Points de reprise (F5) : copiés entre deux images, écrits par un thread d'entrées-sorties
+    SceneWriter checkpointWriter;
+    std::atomic<bool> checkpointPending;
+    
+    // Boucle d'images en coroutine sur le thread principal ; io est démarré au premier point de reprise
+    CoroutineExecutor ui;
+    CoroutineExecutor io;
+    
+    AsyncTask<void> frameLoop();
+    AsyncTask<void> writeCheckpoint(SceneSnapshot snapshot);
+    FrameView currentFrame();
+    Vector2D centerOfMass(const FrameView& frame) const;
+    void updatePickIndex(const FrameView& frame);
+    std::vector<std::string> describeSelection();
     
 public:
-    Application(int windowWidth = 1200, int windowHeight = 800);
+    Application(int windowWidth = 1200, int windowHeight = 800, int dimension = 2);
     ~Application() = default;
     
     // Main loop
     bool initialize();
     bool showConfigDialog();
+    bool loadTrajectory(const std::string& path);
+    bool loadScene(const std::string& path);
     void run();
     void cleanup();
     
@@ -54,6 +100,18 @@ public:
     void adjustSpeed(double factor);
     void setSpeedMultiplier(double multiplier);
     
+    // Relecture
+    void seekFrame(double frame);
+    void reversePlayback() { playbackDirection = -playbackDirection; }
+    
+    // Point de reprise de la simulation, sans interrompre l'affichage
+    void saveCheckpoint();
+    
+    // Sélection
+    void selectBody(size_t index);
+    void toggleFollowSelected();
+    void toggleFollowCenterOfMass();
+    
     // Configuration
     void applyConfig(const SimulationConfig& config);
     void setupCustomSimulation(int numBodies, double G);
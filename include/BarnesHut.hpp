@@ -0,0 +1,155 @@
+/**
+ * @file BarnesHut.hpp
+ * @brief Arbre de Barnes–Hut (quadtree en 2D, octree en 3D) pour des forces approchées en O(N log N)
+ * @author P-Pix
+ * @date 2025
+ *
+ * Construction linéaire : les corps sont triés par clé de Morton, chaque
+ * nœud couvre donc une plage contiguë de corps triés et ses enfants sont
+ * rangés côte à côte. Un nœud dont les corps tiennent dans une boîte de
+ * côté s, et dont le centre de masse est à δ du centre de cette boîte, est
+ * remplacé par son développement multipolaire (masse au centre de masse
+ * et quadrupôle, erreur en θ³) vu d'une distance d > s / θ + δ (le terme δ
+ * protège des centres de masse excentrés) ; sinon il est ouvert, et
+ * une feuille est sommée directement avec la loi de force de la simulation.
+ * θ = 0 n'accepte aucune approximation : on retrouve la sommation directe
+ * aux arrondis près.
+ *
+ * L'arbre peut durer d'un pas à l'autre : refit() garde la topologie (qui
+ * est dans quel nœud) et recalcule de bas en haut boîtes, masses et
+ * moments en O(N). Le critère d'ouverture porte sur les boîtes réelles,
+ * la précision ne change donc pas ; seul le coût du parcours croît quand
+ * les corps quittent leur cellule et que les boîtes des feuilles se
+ * chevauchent. getOverlap() mesure ce chevauchement : au-delà d'un seuil,
+ * une reconstruction (tri et découpage) redevient rentable.
+ */
+
+#ifndef BARNES_HUT_HPP
+#define BARNES_HUT_HPP
+
+#include "BodyArrays.hpp"
+#include "ForceLaw.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * @class BarnesHutTreeT
+ * @brief Arbre reconstruit à partir d'une copie SoA des sources
+ */
+template <int D>
+class BarnesHutTreeT {
+public:
+    static const size_t DEFAULT_LEAF_SIZE = 16;
+    static const uint32_t NONE = 0xFFFFFFFFu;
+
+private:
+    typedef uint64_t (BarnesHutTreeT::*Walker)(BodyArrays&, double, double, double, size_t, size_t) const;
+    typedef uint64_t (BarnesHutTreeT::*ExternalWalker)(BodyArrays&, double, double, double, size_t, size_t,
+                                                       double*) const;
+
+    // Corps triés le long de la courbe ; order donne leur ligne d'origine
+    BodyArrays sorted;
+    std::vector<uint32_t> order;
+    std::vector<uint64_t> keys;
+    std::vector<std::pair<uint64_t, uint32_t>> scratch;
+
+    // Nœuds en SoA, racine en 0 ; les enfants d'un nœud sont contigus
+    std::vector<double> centerX, centerY, centerZ;
+    std::vector<double> nodeMass;
+    std::vector<double> nodeSize;           // Plus grand côté de la boîte englobant ses corps
+    std::vector<double> nodeOffset;         // Distance du centre de masse au centre de cette boîte
+    std::vector<double> nodeRadius;         // Plus grand rayon de ses corps (loi bornée)
+    std::vector<double> quadrupole;         // Σ m (3 x xᵀ - |x|² I) autour du centre de masse : xx xy xz yy yz zz
+    std::vector<double> boxLower, boxUpper; // Boîte englobant ses corps, 3 valeurs par nœud (z = 0 en 2D)
+    std::vector<uint32_t> firstChild, childCount;
+    std::vector<uint32_t> bodyBegin, bodyEnd;
+
+    size_t leafSize;
+    int depth;
+    double overlap;
+    double builtOverlap;
+    Walker walker;
+    ExternalWalker externalWalker;
+
+    size_t addNode(size_t begin, size_t end);
+    void buildNode(uint32_t node, size_t begin, size_t end, int level);
+    void summarize(uint32_t node);
+    void measureOverlap();
+    double boxDistance2(uint32_t node, double x, double y, double z) const;
+
+    // Un corps cible (self = son rang trié) ou un point extérieur (self = NONE, External)
+    template <typename Law, bool External>
+    void walkTarget(const Law& law, double theta, double xi, double yi, double zi, double ri, size_t self,
+                    double& axi, double& ayi, double& azi, double& closest, uint64_t& interactions) const;
+
+    template <typename Law>
+    uint64_t walk(BodyArrays& targets, double G, double softening, double theta, size_t begin, size_t end) const;
+
+    template <typename Law>
+    uint64_t walkExternal(BodyArrays& targets, double G, double softening, double theta, size_t begin, size_t end,
+                          double* nearest2) const;
+
+public:
+    explicit BarnesHutTreeT(ForceLaw law = ForceLaw::Clamped);
+
+    /**
+     * @brief Trie les sources de arrays et construit l'arbre ; au plus leafSize corps par feuille
+     */
+    void build(const BodyArrays& arrays, size_t leafSize = DEFAULT_LEAF_SIZE);
+
+    /**
+     * @brief Reprend positions, masses et rayons de arrays sans changer la topologie, en O(N)
+     *
+     * La ligne d'origine de chaque corps trié est conservée : arrays doit
+     * avoir autant de lignes qu'au dernier build(), sinon rien n'est fait
+     * et false est renvoyé. L'arbre reste exact quel que soit le mouvement.
+     */
+    bool refit(const BodyArrays& arrays);
+
+    /**
+     * @brief Accélérations des corps triés [begin, end), écrites à leur ligne d'origine de arrays
+     *
+     * Les plages contiguës de corps triés sont des régions compactes : des
+     * blocs parallèles parcourent des nœuds voisins, qui restent en cache.
+     * Renvoie le nombre d'interactions évaluées (corps ou nœuds).
+     */
+    uint64_t accelerate(BodyArrays& arrays, double G, double softening, double theta, size_t begin, size_t end) const;
+
+    /**
+     * @brief Accélérations des points [begin, end) de targets (traceurs), qui ne sont pas des sources
+     *
+     * nearest2 reçoit, par point, un minorant du carré de la distance à la
+     * source la plus proche : exact pour les feuilles ouvertes, distance à
+     * la boîte pour les nœuds acceptés. Renvoie le nombre d'interactions.
+     */
+    uint64_t accelerateExternal(BodyArrays& targets, double G, double softening, double theta, size_t begin,
+                                size_t end, double* nearest2) const;
+
+    /**
+     * @brief Ligne d'origine de la source la plus proche de (x, y, z), hors la ligne exclude ; NONE si aucune
+     */
+    uint32_t nearest(double x, double y, double z, uint32_t exclude, double& distance2) const;
+
+    size_t size() const { return order.size(); }
+    size_t getNodeCount() const { return nodeMass.size(); }
+    size_t getLeafSize() const { return leafSize; }
+    int getDepth() const { return depth; }
+
+    /**
+     * @brief Σ (côté des feuilles)^D / (côté de la racine)^D : au plus 1 juste après build()
+     */
+    double getOverlap() const { return overlap; }
+    double getBuildOverlap() const { return builtOverlap; }
+
+    /**
+     * @brief Ligne d'origine du k-ième corps trié
+     */
+    uint32_t getRow(size_t k) const { return order[k]; }
+};
+
+typedef BarnesHutTreeT<2> BarnesHutTree;
+typedef BarnesHutTreeT<3> BarnesHutTree3D;
+
+#endif
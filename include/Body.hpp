@@ -3,63 +3,158 @@
 
 #include <cmath>
 
-struct Vector2D {
+/**
+ * @brief Vecteur de dimension D (2 ou 3)
+ *
+ * Spécialisé par dimension pour garder des membres nommés x, y (z) : en 2D
+ * le code généré est celui de l'ancien Vector2D, sans boucle ni tableau.
+ */
+template <int D>
+struct Vector;
+
+template <>
+struct Vector<2> {
+    static const int dimension = 2;
+    
     double x, y;
     
-    Vector2D(double x = 0, double y = 0) : x(x), y(y) {}
+    Vector(double x = 0, double y = 0) : x(x), y(y) {}
+    
+    Vector operator+(const Vector& other) const {
+        return Vector(x + other.x, y + other.y);
+    }
     
-    Vector2D operator+(const Vector2D& other) const {
-        return Vector2D(x + other.x, y + other.y);
+    Vector operator-(const Vector& other) const {
+        return Vector(x - other.x, y - other.y);
     }
     
-    Vector2D operator-(const Vector2D& other) const {
-        return Vector2D(x - other.x, y - other.y);
+    Vector operator*(double scalar) const {
+        return Vector(x * scalar, y * scalar);
     }
     
-    Vector2D operator*(double scalar) const {
-        return Vector2D(x * scalar, y * scalar);
+    double& operator[](int axis) { return axis == 0 ? x : y; }
+    double operator[](int axis) const { return axis == 0 ? x : y; }
+    
+    double dot(const Vector& other) const {
+        return x * other.x + y * other.y;
     }
     
     double magnitude() const {
         return std::sqrt(x * x + y * y);
     }
     
-    Vector2D normalize() const {
+    Vector normalize() const {
+        double mag = magnitude();
+        if (mag == 0) return Vector(0, 0);
+        return Vector(x / mag, y / mag);
+    }
+};
+
+template <>
+struct Vector<3> {
+    static const int dimension = 3;
+    
+    double x, y, z;
+    
+    Vector(double x = 0, double y = 0, double z = 0) : x(x), y(y), z(z) {}
+    
+    Vector operator+(const Vector& other) const {
+        return Vector(x + other.x, y + other.y, z + other.z);
+    }
+    
+    Vector operator-(const Vector& other) const {
+        return Vector(x - other.x, y - other.y, z - other.z);
+    }
+    
+    Vector operator*(double scalar) const {
+        return Vector(x * scalar, y * scalar, z * scalar);
+    }
+    
+    double& operator[](int axis) { return axis == 0 ? x : (axis == 1 ? y : z); }
+    double operator[](int axis) const { return axis == 0 ? x : (axis == 1 ? y : z); }
+    
+    double dot(const Vector& other) const {
+        return x * other.x + y * other.y + z * other.z;
+    }
+    
+    double magnitude() const {
+        return std::sqrt(x * x + y * y + z * z);
+    }
+    
+    Vector normalize() const {
         double mag = magnitude();
-        if (mag == 0) return Vector2D(0, 0);
-        return Vector2D(x / mag, y / mag);
+        if (mag == 0) return Vector(0, 0, 0);
+        return Vector(x / mag, y / mag, z / mag);
     }
 };
 
-class Body {
+typedef Vector<2> Vector2D;
+typedef Vector<3> Vector3D;
+
+/**
+ * @enum ParticleClass
+ * @brief Rôle d'un corps dans le calcul des forces
+ */
+enum class ParticleClass {
+    Massive,    ///< Source : attire les autres corps et subit leur attraction
+    Tracer      ///< Particule test : subit l'attraction des sources, sa masse n'agit sur personne
+};
+
+/**
+ * @brief Corps ponctuel en dimension D ; instancié pour D = 2 et D = 3 dans Body.cpp
+ */
+template <int D>
+class BodyT {
+public:
+    typedef Vector<D> VectorType;
+    
 private:
-    Vector2D position;
-    Vector2D velocity;
-    Vector2D acceleration;
+    VectorType position;
+    VectorType velocity;
+    VectorType acceleration;
     double mass;
     double radius;
+    ParticleClass particleClass;
+    bool frozen;
     
 public:
-    Body(Vector2D pos, Vector2D vel, double m, double r = 5.0);
+    BodyT(VectorType pos, VectorType vel, double m, double r = 5.0,
+          ParticleClass cls = ParticleClass::Massive);
     
     // Getters
-    Vector2D getPosition() const { return position; }
-    Vector2D getVelocity() const { return velocity; }
+    VectorType getPosition() const { return position; }
+    VectorType getVelocity() const { return velocity; }
+    VectorType getAcceleration() const { return acceleration; }
     double getMass() const { return mass; }
     double getRadius() const { return radius; }
+    ParticleClass getParticleClass() const { return particleClass; }
+    bool isTracer() const { return particleClass == ParticleClass::Tracer; }
+    
+    // Masse qui attire les autres corps : nulle pour un traceur
+    double getSourceMass() const { return particleClass == ParticleClass::Tracer ? 0.0 : mass; }
+    
+    // Traceur gelé par la simulation : plus de calcul de force, il dérive en ligne droite
+    bool isFrozen() const { return frozen; }
     
     // Setters
-    void setPosition(const Vector2D& pos) { position = pos; }
-    void setVelocity(const Vector2D& vel) { velocity = vel; }
-    void setAcceleration(const Vector2D& acc) { acceleration = acc; }
+    void setPosition(const VectorType& pos) { position = pos; }
+    void setVelocity(const VectorType& vel) { velocity = vel; }
+    void setAcceleration(const VectorType& acc) { acceleration = acc; }
+    void setParticleClass(ParticleClass cls) { particleClass = cls; }
+    void setFrozen(bool value) { frozen = value; }
     
     // Physics
-    void applyForce(const Vector2D& force);
+    void applyForce(const VectorType& force);
     void update(double deltaTime);
+    void kick(double deltaTime) { velocity = velocity + acceleration * deltaTime; }
+    void drift(double deltaTime) { position = position + velocity * deltaTime; }
     void resetAcceleration();
     
     // Calculate gravitational force to another body
-    Vector2D calculateGravitationalForce(const Body& other, double G = 6.67430e-11) const;
+    VectorType calculateGravitationalForce(const BodyT& other, double G = 6.67430e-11) const;
 };
 
+typedef BodyT<2> Body;
+typedef BodyT<3> Body3D;
+
 #endif
@@ -0,0 +1,46 @@
+/**
+ * @file BodyArrays.hpp
+ * @brief Copie structure-de-tableaux (SoA) des corps pour les noyaux de calcul
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef BODY_ARRAYS_HPP
+#define BODY_ARRAYS_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @struct BodyArrays
+ * @brief Positions, masses, rayons et accélérations rangés par composante
+ *
+ * Remplie à partir des Body au début du calcul des forces : les boucles
+ * internes lisent des tableaux contigus et peuvent être vectorisées.
+ * z et az restent vides en 2D (placés en fin pour ne pas décaler les autres).
+ */
+struct BodyArrays {
+    std::vector<double> x, y;
+    std::vector<double> mass;
+    std::vector<double> radius;
+    std::vector<double> ax, ay;
+    std::vector<double> z, az;
+
+    void resize(size_t count, int dimension = 2) {
+        size_t depth = dimension == 3 ? count : 0;
+        x.resize(count);
+        y.resize(count);
+        z.resize(depth);
+        mass.resize(count);
+        radius.resize(count);
+        ax.resize(count);
+        ay.resize(count);
+        az.resize(depth);
+    }
+
+    bool isThreeDimensional() const { return !z.empty(); }
+
+    size_t size() const { return x.size(); }
+};
+
+#endif
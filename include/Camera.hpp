@@ -0,0 +1,92 @@
+/**
+ * @file Camera.hpp
+ * @brief Contrôleur de caméra 2D : déplacement cumulé, zoom autour du curseur, suivi lissé
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef CAMERA_HPP
+#define CAMERA_HPP
+
+#include "Body.hpp"
+
+/**
+ * @enum CameraMode
+ * @brief Cible suivie par la caméra
+ */
+enum class CameraMode {
+    Free,               ///< Déplacement et zoom à la main
+    CenterOfMass,       ///< Centre de masse du système
+    SelectedBody        ///< Corps sélectionné à la souris
+};
+
+/**
+ * @class Camera
+ * @brief État visé (entrées) et état affiché, rapproché de la cible à chaque image
+ *
+ * Les entrées modifient la cible ; update() en rapproche l'état affiché par
+ * un lissage exponentiel de constante de temps timeConstant, le zoom étant
+ * interpolé en échelle logarithmique. Pendant un zoom au curseur, le décalage
+ * est déduit du zoom interpolé pour que le point sous le curseur reste fixe
+ * tout au long de l'animation. Les positions à l'écran sont comptées depuis
+ * le centre de la fenêtre.
+ */
+class Camera {
+private:
+    Vector2D offset;
+    double zoom;
+    Vector2D targetOffset;
+    double targetZoom;
+    double timeConstant;
+    CameraMode mode;
+
+    // Zoom au curseur en cours : point du monde à garder sous anchorScreen
+    bool anchored;
+    Vector2D anchorWorld;
+    Vector2D anchorScreen;
+
+public:
+    static constexpr double MIN_ZOOM = 1e-3;
+    static constexpr double MAX_ZOOM = 1e3;
+
+    explicit Camera(double timeConstantSeconds = 0.1);
+
+    /**
+     * @brief Place la caméra sans animation et revient au mode libre
+     */
+    void reset(Vector2D center = Vector2D(), double zoomLevel = 1.0);
+
+    /**
+     * @brief Décale la vue de (dx, dy) pixels à l'écran ; quitte le suivi
+     */
+    void pan(double dx, double dy);
+
+    /**
+     * @brief Multiplie le zoom en gardant fixe le point du monde sous screenFromCenter
+     *
+     * En mode suivi, le zoom se fait autour de la cible suivie.
+     */
+    void zoomAt(double factor, Vector2D screenFromCenter);
+
+    /**
+     * @brief Nouvelle position de la cible suivie (ignorée en mode libre)
+     */
+    void track(Vector2D point);
+
+    /**
+     * @brief Rapproche l'état affiché de la cible ; dt <= 0 ou constante nulle : saut immédiat
+     */
+    void update(double dtSeconds);
+
+    void setMode(CameraMode newMode);
+    CameraMode getMode() const { return mode; }
+
+    Vector2D getOffset() const { return offset; }
+    double getZoom() const { return zoom; }
+    Vector2D getTargetOffset() const { return targetOffset; }
+    double getTargetZoom() const { return targetZoom; }
+
+    Vector2D screenToWorld(Vector2D screenFromCenter) const { return offset + screenFromCenter * (1.0 / zoom); }
+};
+
+#endif
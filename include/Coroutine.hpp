@@ -0,0 +1,306 @@
+/**
+ * @file Coroutine.hpp
+ * @brief Tâches coroutines C++20 et exécuteur coopératif pour les entrées-sorties et l'interface
+ * @author P-Pix
+ * @date 2025
+ *
+ * Écriture de trajectoire, points de reprise et images de l'interface sont
+ * des tâches qui attendent (co_await) un disque, une échéance ou un signal :
+ * plutôt qu'un thread chacune, elles se partagent un CoroutineExecutor. Un
+ * exécuteur tourne soit sur le thread qui appelle run() (interface, thread
+ * principal), soit sur son propre thread (start(), entrées-sorties).
+ *
+ * Le calcul physique n'en fait jamais partie : les workers du TaskScheduler
+ * n'exécutent aucune coroutine, et le thread d'entrées-sorties est épinglé
+ * hors de leurs cœurs quand il en reste, avec une priorité réduite sinon.
+ * Une tâche qui attend co_await executor.schedule() reprend sur le thread de
+ * cet exécuteur : c'est ainsi qu'une tâche passe de l'un à l'autre.
+ */
+
+#ifndef COROUTINE_HPP
+#define COROUTINE_HPP
+
+#include <chrono>
+#include <condition_variable>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+template <typename T>
+class AsyncTask;
+
+namespace detail {
+
+/**
+ * @brief Partie commune des promesses : démarrage paresseux, reprise de l'appelant à la fin
+ */
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;
+    std::exception_ptr error;
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        // Transfert symétrique : l'appelant reprend sans empiler de cadre
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> next = handle.promise().continuation;
+            return next ? next : std::noop_coroutine();
+        }
+
+        void await_resume() noexcept {}
+    };
+
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    FinalAwaiter final_suspend() noexcept { return {}; }
+    void unhandled_exception() { error = std::current_exception(); }
+};
+
+template <typename T>
+struct TaskPromise : TaskPromiseBase {
+    std::optional<T> value;
+
+    AsyncTask<T> get_return_object();
+    void return_value(T result) { value = std::move(result); }
+};
+
+template <>
+struct TaskPromise<void> : TaskPromiseBase {
+    AsyncTask<void> get_return_object();
+    void return_void() {}
+};
+
+/**
+ * @brief Coroutine racine d'une tâche détachée : démarre tout de suite et se détruit seule
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() { return DetachedTask(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+} // namespace detail
+
+/**
+ * @class AsyncTask
+ * @brief Coroutine paresseuse : elle ne démarre qu'au co_await, qui rend sa valeur ou relance son exception
+ */
+template <typename T = void>
+class AsyncTask {
+public:
+    typedef detail::TaskPromise<T> promise_type;
+
+private:
+    std::coroutine_handle<promise_type> handle;
+
+public:
+    explicit AsyncTask(std::coroutine_handle<promise_type> coroutine) : handle(coroutine) {}
+    AsyncTask(AsyncTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    AsyncTask& operator=(AsyncTask&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    ~AsyncTask() {
+        if (handle) handle.destroy();
+    }
+
+    AsyncTask(const AsyncTask&) = delete;
+    AsyncTask& operator=(const AsyncTask&) = delete;
+
+    struct Awaiter {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            handle.promise().continuation = caller;
+            return handle;
+        }
+
+        T await_resume() {
+            if (handle.promise().error) std::rethrow_exception(handle.promise().error);
+            if constexpr (!std::is_void<T>::value) return std::move(*handle.promise().value);
+        }
+    };
+
+    Awaiter operator co_await() && noexcept { return Awaiter{handle}; }
+};
+
+namespace detail {
+
+template <typename T>
+AsyncTask<T> TaskPromise<T>::get_return_object() {
+    return AsyncTask<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+inline AsyncTask<void> TaskPromise<void>::get_return_object() {
+    return AsyncTask<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+/**
+ * @class CoroutineExecutor
+ * @brief File de coroutines prêtes et de minuteries, vidée par un seul thread
+ *
+ * post() et spawn() peuvent être appelés de n'importe quel thread ; les
+ * coroutines ne reprennent que sur le thread de l'exécuteur, l'une après
+ * l'autre : une tâche garde la main jusqu'à son prochain co_await.
+ */
+class CoroutineExecutor {
+public:
+    typedef std::chrono::steady_clock Clock;
+
+private:
+    struct Timer {
+        Clock::time_point due;
+        uint64_t order;                     // Ordre d'armement, à échéance égale
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer& other) const {
+            return due != other.due ? due > other.due : order > other.order;
+        }
+    };
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    std::deque<std::coroutine_handle<>> ready;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    uint64_t timerOrder;
+    size_t outstanding;             // Tâches détachées non terminées
+    uint64_t completed;
+    std::exception_ptr error;       // Première exception d'une tâche détachée
+    bool stopping;
+    std::thread thread;
+
+    static detail::DetachedTask launch(CoroutineExecutor& executor, AsyncTask<void> task);
+    void finish(std::exception_ptr failure);
+    void addTimer(Clock::time_point due, std::coroutine_handle<> handle);
+    void loop(bool untilIdle);
+
+public:
+    CoroutineExecutor();
+    ~CoroutineExecutor();
+
+    CoroutineExecutor(const CoroutineExecutor&) = delete;
+    CoroutineExecutor& operator=(const CoroutineExecutor&) = delete;
+
+    /**
+     * @brief Lance le thread propre de l'exécuteur, qui tourne jusqu'à stop()
+     * @param cpus Cœurs où l'épingler (vide = ceux du thread appelant)
+     * @param niceness Priorité réduite (nice) du thread, 0 = inchangée
+     */
+    void start(const std::vector<int>& cpus = std::vector<int>(), int niceness = 0);
+
+    /**
+     * @brief Exécute les tâches sur le thread appelant jusqu'à ce qu'il n'en reste aucune
+     *
+     * Pour un exécuteur sans thread propre (interface sur le thread principal).
+     */
+    void run();
+
+    /**
+     * @brief Attend la fin des tâches détachées ; relance la première exception de l'une d'elles
+     */
+    void drain();
+
+    /**
+     * @brief Arrête le thread propre après les coroutines déjà prêtes (les minuteries sont abandonnées)
+     */
+    void stop();
+
+    /**
+     * @brief Reprend handle sur le thread de l'exécuteur
+     */
+    void post(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Démarre task sur l'exécuteur, sans attendre son résultat
+     */
+    void spawn(AsyncTask<void> task);
+
+    struct ScheduleAwaiter {
+        CoroutineExecutor& executor;
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle) { executor.post(handle); }
+        void await_resume() const noexcept {}
+    };
+
+    struct SleepAwaiter {
+        CoroutineExecutor& executor;
+        Clock::time_point due;
+        bool await_ready() const noexcept { return due <= Clock::now(); }
+        void await_suspend(std::coroutine_handle<> handle) { executor.addTimer(due, handle); }
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief co_await : reprendre sur cet exécuteur (passage d'un thread à l'autre, ou yield)
+     */
+    ScheduleAwaiter schedule() { return ScheduleAwaiter{*this}; }
+
+    /**
+     * @brief co_await : reprendre à l'échéance due, sans bloquer les autres tâches
+     */
+    SleepAwaiter sleepUntil(Clock::time_point due) { return SleepAwaiter{*this, due}; }
+
+    template <typename Rep, typename Period>
+    SleepAwaiter sleepFor(std::chrono::duration<Rep, Period> delay) {
+        return SleepAwaiter{*this, Clock::now() + std::chrono::duration_cast<Clock::duration>(delay)};
+    }
+
+    bool hasThread() const { return thread.joinable(); }
+    size_t getPendingCount();
+    uint64_t getCompletedCount();
+};
+
+/**
+ * @class AsyncSignal
+ * @brief Événement à réarmement automatique pour une seule coroutine en attente
+ *
+ * set() peut être appelé de n'importe quel thread : la coroutine en attente
+ * reprend sur son exécuteur, ou le prochain wait() passe sans s'arrêter.
+ */
+class AsyncSignal {
+private:
+    CoroutineExecutor& executor;
+    std::mutex mutex;
+    bool signaled;
+    std::coroutine_handle<> waiter;
+
+public:
+    explicit AsyncSignal(CoroutineExecutor& owner) : executor(owner), signaled(false) {}
+
+    void set();
+
+    struct Awaiter {
+        AsyncSignal& signal;
+        bool await_ready() const noexcept { return false; }
+        bool await_suspend(std::coroutine_handle<> handle);
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief co_await : attendre le prochain set()
+     */
+    Awaiter wait() { return Awaiter{*this}; }
+};
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file Decomposition.hpp
+ * @brief Décomposition de domaine sur plusieurs processus en mémoire partagée POSIX, sans MPI
+ * @author P-Pix
+ * @date 2025
+ *
+ * start() range les corps le long d'une courbe de Morton, place l'état dans
+ * un segment shm_open (supprimé du système de fichiers aussitôt projeté) et
+ * crée les processus par fork. Chaque rang possède une tranche contiguë de
+ * la courbe, donc une région compacte de l'espace, et s'exécute épinglé sur
+ * un nœud NUMA : ses tableaux de travail sont alloués, et touchés en
+ * premier, sur ce nœud.
+ *
+ * Communication sans verrou ni système externe :
+ *   - une file à un producteur et un consommateur par rang et par sens
+ *     (ordres du coordinateur, comptes rendus des rangs) ;
+ *   - une barrière par pas, les positions étant en double tampon : chaque
+ *     rang lit tout le tampon courant et n'écrit que sa tranche du suivant ;
+ *   - un résumé par rang (tranche, masse, temps de calcul des forces)
+ *     publié après chaque pas, lu par le rééquilibrage.
+ * Les attentes passent par futex (partagé entre processus) : aucun rang ne
+ * tourne à vide quand les processus sont plus nombreux que les cœurs.
+ *
+ * La sommation est directe : chaque rang a besoin de toutes les positions,
+ * la frontière d'un domaine est donc le domaine entier. Le rééquilibrage
+ * suit le temps de calcul mesuré par rang : un nœud plus chargé reçoit
+ * moins de corps, et la courbe est retriée à cette occasion.
+ */
+
+#ifndef DECOMPOSITION_HPP
+#define DECOMPOSITION_HPP
+
+#include "Simulation.hpp"
+#include "ForceLaw.hpp"
+#include "BodyArrays.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+struct SharedState;
+
+/**
+ * @struct DomainSummary
+ * @brief Résumé publié par un rang pour sa tranche de corps
+ */
+struct DomainSummary {
+    uint64_t begin, end;    ///< Tranche [begin, end) dans l'ordre de la courbe
+    int node;               ///< Nœud NUMA du rang
+    double mass;
+    double forceSeconds;    ///< Temps de calcul des forces depuis le dernier rééquilibrage
+};
+
+/**
+ * @class DecomposedSimulationT
+ * @brief Même calcul que SimulationT (sommation directe), réparti sur des processus
+ *
+ * Le processus appelant est le rang 0 : step() distribue le pas aux autres
+ * rangs, calcule sa propre tranche et attend leurs comptes rendus. La
+ * mort d'un rang est détectée (getError()) au lieu de bloquer les autres.
+ * Gravité seule : ni traceurs, ni contact, ni paires régularisées.
+ */
+template <int D>
+class DecomposedSimulationT {
+public:
+    typedef BodyT<D> BodyType;
+    typedef Vector<D> VectorType;
+
+    static const int MAX_PROCESSES = 64;
+    static const uint64_t DEFAULT_REBALANCE_INTERVAL = 16;
+
+private:
+    double gravitationalConstant;
+    double timeStep;
+    ForceLaw forceLaw;
+    double softening;
+    ForceKernels kernels;
+    Integrator integrator;
+    bool pinning;
+    uint64_t rebalanceInterval;
+    double imbalanceTolerance;
+
+    SharedState* state;
+    size_t mappedBytes;
+    int processes;
+    std::vector<pid_t> workers;
+    uint64_t stepCount;
+    uint64_t rebalanceCount;
+    double lastImbalance;
+    bool failed;
+    std::string lastError;
+
+    // Propres à chaque processus après fork
+    int rank;
+    pid_t coordinator;
+    BodyArrays arrays;
+
+    double* column(int buffer, int index) const;
+    double* velocity(int d) const;
+    double* acceleration(int d) const;
+    double* mass() const;
+    double* radius() const;
+    uint64_t* identity() const;
+
+    void workerLoop();
+    bool runSteps(uint64_t steps, uint64_t& forceNanoseconds);
+    void gather(int buffer);
+    void computeOwnForces(int buffer, uint64_t& forceNanoseconds);
+    void publishSummary();
+    bool healthy();
+    void sortAlongCurve(const std::vector<double>& weights);
+    void maybeRebalance();
+
+public:
+    DecomposedSimulationT(double G = 1.0, double dt = 0.01, ForceLaw law = ForceLaw::Clamped, double softeningLength = 0.0);
+    ~DecomposedSimulationT();
+
+    DecomposedSimulationT(const DecomposedSimulationT&) = delete;
+    DecomposedSimulationT& operator=(const DecomposedSimulationT&) = delete;
+
+    /**
+     * @brief Copie les corps de initial en mémoire partagée et lance processCount - 1 processus
+     */
+    bool start(const SimulationT<D>& initial, int processCount);
+
+    /**
+     * @brief Arrête les autres rangs et libère le segment
+     */
+    void stop();
+
+    /**
+     * @brief Remplace les corps de simulation par l'état partagé, dans l'ordre d'origine
+     */
+    bool exportTo(SimulationT<D>& simulation) const;
+
+    void step();
+
+    /**
+     * @brief Redécoupe immédiatement la courbe selon les temps mesurés
+     */
+    void rebalance();
+
+    void setIntegrator(Integrator scheme);
+    Integrator getIntegrator() const { return integrator; }
+
+    /**
+     * @brief Épingle chaque rang sur un nœud NUMA, à tour de rôle (avant start())
+     */
+    void setNumaPinning(bool enabled) { pinning = enabled; }
+
+    /**
+     * @brief Pas entre deux évaluations de l'équilibre ; écart toléré au temps moyen par rang
+     */
+    void setRebalancing(uint64_t interval, double tolerance) { rebalanceInterval = interval; imbalanceTolerance = tolerance; }
+
+    double computeEnergy() const;
+    uint64_t computeStateHash() const;
+
+    /**
+     * @brief Résumés des rangs, publiés à la fin du dernier pas
+     */
+    std::vector<DomainSummary> getDomains() const;
+
+    /**
+     * @brief Temps du rang le plus lent rapporté au temps moyen, à la dernière évaluation
+     */
+    double getImbalance() const { return lastImbalance; }
+    uint64_t getRebalanceCount() const { return rebalanceCount; }
+
+    bool isRunning() const { return state != nullptr && !failed; }
+    int getProcessCount() const { return processes; }
+    size_t getBodyCount() const;
+    uint64_t getStepCount() const { return stepCount; }
+    size_t getSharedBytes() const { return mappedBytes; }
+    double getGravitationalConstant() const { return gravitationalConstant; }
+    double getTimeStep() const { return timeStep; }
+    ForceLaw getForceLaw() const { return forceLaw; }
+    double getSoftening() const { return softening; }
+    const std::string& getError() const { return lastError; }
+
+    static int getDimension() { return D; }
+};
+
+typedef DecomposedSimulationT<2> DecomposedSimulation;
+typedef DecomposedSimulationT<3> DecomposedSimulation3D;
+
+#endif
@@ -0,0 +1,102 @@
+/**
+ * @file Ensemble.hpp
+ * @brief Ensemble de petits systèmes indépendants avancés ensemble, un système par voie SIMD
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef ENSEMBLE_HPP
+#define ENSEMBLE_HPP
+
+#include "Simulation.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+class TaskScheduler;
+
+/**
+ * @class EnsembleT
+ * @brief M systèmes de K corps (K identique pour tous), chacun avec ses propres G et dt
+ *
+ * Les grandeurs sont rangées corps par corps puis système par système
+ * (indice k * stride + s) : pour une paire (i, j) donnée, la boucle interne
+ * parcourt les systèmes, contigus en mémoire et sans dépendance entre eux.
+ * Avec 3 ou 4 corps, c'est la seule boucle assez longue pour être
+ * vectorisée. Les systèmes sont découpés en blocs qui avancent de tous
+ * leurs pas d'un coup : un bloc tient dans le cache L1.
+ *
+ * Intégration et lois de force identiques à SimulationT<D> sans
+ * ordonnanceur (Euler symplectique, noyau symétrique).
+ */
+template <int D>
+class EnsembleT {
+public:
+    typedef Vector<D> VectorType;
+
+    /**
+     * @brief Appelé dès qu'un système a fini ses pas, depuis le thread qui l'a calculé
+     */
+    typedef std::function<void(size_t system)> SystemCallback;
+
+private:
+    size_t bodiesPerSystem;
+    ForceLaw forceLaw;
+    double softening;
+
+    size_t systemCount;
+    size_t stride;   // Voies allouées par corps (>= systemCount)
+
+    std::vector<double> position[D];
+    std::vector<double> velocity[D];
+    std::vector<double> acceleration[D];
+    std::vector<double> mass;
+    std::vector<double> radius;
+
+    // Par système
+    std::vector<double> gravitationalConstant;
+    std::vector<double> timeStep;
+    uint64_t stepCount;
+
+    TaskScheduler* scheduler;
+
+    void reserveLanes(size_t lanes);
+
+    template <typename Law>
+    void stepLanes(size_t begin, size_t end, int steps);
+
+public:
+    EnsembleT(size_t bodiesPerSystem, ForceLaw law = ForceLaw::Clamped, double softeningLength = 0.0);
+
+    /**
+     * @brief Copie l'état, G et dt d'une simulation déjà préparée (préréglage, addBody...)
+     * @return false si le nombre de corps ou la loi de force diffère de ceux de l'ensemble
+     */
+    bool addSystem(const SimulationT<D>& simulation);
+
+    /**
+     * @brief Avance tous les systèmes de steps pas
+     * @param onSystemDone Résultats au fil de l'eau : appelé une fois par système, éventuellement en parallèle
+     */
+    void run(int steps, const SystemCallback& onSystemDone = SystemCallback());
+
+    // Parallélisme entre blocs de systèmes : nullptr pour le calcul séquentiel
+    void setTaskScheduler(TaskScheduler* taskScheduler) { scheduler = taskScheduler; }
+
+    // Lecture de l'état d'un système
+    VectorType getPosition(size_t system, size_t body) const;
+    VectorType getVelocity(size_t system, size_t body) const;
+    double getMass(size_t system, size_t body) const { return mass[body * stride + system]; }
+    double getGravitationalConstant(size_t system) const { return gravitationalConstant[system]; }
+    double getTimeStep(size_t system) const { return timeStep[system]; }
+
+    size_t getSystemCount() const { return systemCount; }
+    size_t getBodiesPerSystem() const { return bodiesPerSystem; }
+    uint64_t getStepCount() const { return stepCount; }
+};
+
+typedef EnsembleT<2> Ensemble;
+typedef EnsembleT<3> Ensemble3D;
+
+#endif
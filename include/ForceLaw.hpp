@@ -0,0 +1,607 @@
+/**
+ * @file ForceLaw.hpp
+ * @brief Lois de force (adoucissement) en paramètre de template des noyaux de calcul
+ * @author P-Pix
+ * @date 2025
+ *
+ * Chaque loi renvoie le facteur f(r²) tel que l'accélération de i due à j
+ * vaille G * m_j * f * (x_j - x_i), et potential(r²) tel que l'énergie
+ * potentielle de la paire vaille -G * m_i * m_j * potential. Les noyaux sont instanciés une fois par
+ * loi : aucune branche sur la loi dans la boucle interne, qui reste
+ * entièrement inlinée et vectorisable.
+ */
+
+#ifndef FORCE_LAW_HPP
+#define FORCE_LAW_HPP
+
+#include "BodyArrays.hpp"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+/**
+ * @enum ForceLaw
+ * @brief Variante de loi de force choisie à la construction de Simulation
+ */
+enum class ForceLaw {
+    Clamped,    ///< Newton avec distance bornée par la somme des rayons (comportement historique)
+    Newtonian,  ///< Newton pur en 1/r², sans adoucissement
+    Plummer,    ///< Adoucissement de Plummer : 1/(r² + ε²)^(3/2)
+    Spline      ///< Noyau spline cubique (Monaghan), Newtonien au-delà de h = 2.8 ε
+};
+
+/**
+ * @struct ClampedForce
+ * @brief Distance minimale égale à la somme des rayons, comme Body::calculateGravitationalForce
+ */
+struct ClampedForce {
+    explicit ClampedForce(double) {}
+
+    double operator()(double r2, double radiusSum) const {
+        double r = std::sqrt(r2);
+        double clamped = r < radiusSum ? radiusSum : r;
+        return r2 > 0.0 ? 1.0 / (clamped * clamped * r) : 0.0;
+    }
+
+    double potential(double r2, double radiusSum) const {
+        double r = std::sqrt(r2);
+        return 1.0 / (r < radiusSum ? radiusSum : r);
+    }
+};
+
+/**
+ * @struct NewtonianForce
+ * @brief 1/r³ sans protection : deux corps confondus donnent une force infinie
+ */
+struct NewtonianForce {
+    explicit NewtonianForce(double) {}
+
+    double operator()(double r2, double) const {
+        return 1.0 / (r2 * std::sqrt(r2));
+    }
+
+    double potential(double r2, double) const {
+        return 1.0 / std::sqrt(r2);
+    }
+};
+
+/**
+ * @struct PlummerForce
+ */
+struct PlummerForce {
+    double softening2;
+
+    explicit PlummerForce(double softening) : softening2(softening * softening) {}
+
+    double operator()(double r2, double) const {
+        double s = r2 + softening2;
+        return 1.0 / (s * std::sqrt(s));
+    }
+
+    double potential(double r2, double) const {
+        return 1.0 / std::sqrt(r2 + softening2);
+    }
+};
+
+/**
+ * @struct SplineForce
+ * @brief Noyau spline cubique à support compact (forme de GADGET-2)
+ */
+struct SplineForce {
+    double hInverse;
+    double hInverse3;
+
+    explicit SplineForce(double softening)
+        : hInverse(1.0 / (2.8 * softening)), hInverse3(hInverse * hInverse * hInverse) {}
+
+    double operator()(double r2, double) const {
+        double r = std::sqrt(r2);
+        double u = r * hInverse;
+        double u2 = u * u;
+        // Les trois branches sont évaluées puis sélectionnées : pas de saut dans la boucle
+        double inner = hInverse3 * (10.666666666667 + u2 * (32.0 * u - 38.4));
+        double outer = hInverse3 * (21.333333333333 - 48.0 * u + 38.4 * u2
+                                    - 10.666666666667 * u2 * u - 0.066666666667 / (u2 * u));
+        double newton = 1.0 / (r2 * r);
+        return u < 0.5 ? inner : (u < 1.0 ? outer : newton);
+    }
+
+    double potential(double r2, double) const {
+        double r = std::sqrt(r2);
+        double u = r * hInverse;
+        double u2 = u * u;
+        if (u < 0.5) {
+            return -hInverse * (-2.8 + u2 * (5.333333333333 + u2 * (6.4 * u - 9.6)));
+        }
+        if (u < 1.0) {
+            return -hInverse * (-3.2 + 0.066666666667 / u
+                                + u2 * (10.666666666667 + u * (-16.0 + u * (9.6 - 2.133333333333 * u))));
+        }
+        return 1.0 / r;
+    }
+};
+
+// --- Noyaux ------------------------------------------------------------------
+//
+// La dimension D est aussi un paramètre de template : en 2D, toutes les
+// branches « if (D == 3) » disparaissent à la compilation et la boucle
+// interne est exactement celle d'avant ; en 3D, la composante z est
+// vectorisée avec les deux autres.
+
+/**
+ * @brief Accumule sur j dans [jBegin, jEnd) l'accélération du corps i
+ */
+template <typename Law>
+inline void accumulateRange(const BodyArrays& arrays, const Law& law, size_t i, size_t jBegin, size_t jEnd,
+                            double& axi, double& ayi) {
+    const double* x = arrays.x.data();
+    const double* y = arrays.y.data();
+    const double* mass = arrays.mass.data();
+    const double* radius = arrays.radius.data();
+    double xi = x[i], yi = y[i], ri = radius[i];
+
+#pragma omp simd reduction(+:axi, ayi)
+    for (size_t j = jBegin; j < jEnd; ++j) {
+        double dx = x[j] - xi;
+        double dy = y[j] - yi;
+        double f = mass[j] * law(dx * dx + dy * dy, ri + radius[j]);
+        axi += f * dx;
+        ayi += f * dy;
+    }
+}
+
+/**
+ * @brief Variante 3D : un accumulateur de plus, la signature 2D reste celle d'origine
+ */
+template <typename Law>
+inline void accumulateRange3D(const BodyArrays& arrays, const Law& law, size_t i, size_t jBegin, size_t jEnd,
+                              double& axi, double& ayi, double& azi) {
+    const double* x = arrays.x.data();
+    const double* y = arrays.y.data();
+    const double* z = arrays.z.data();
+    const double* mass = arrays.mass.data();
+    const double* radius = arrays.radius.data();
+    double xi = x[i], yi = y[i], zi = z[i], ri = radius[i];
+
+#pragma omp simd reduction(+:axi, ayi, azi)
+    for (size_t j = jBegin; j < jEnd; ++j) {
+        double dx = x[j] - xi;
+        double dy = y[j] - yi;
+        double dz = z[j] - zi;
+        double f = mass[j] * law(dx * dx + dy * dy + dz * dz, ri + radius[j]);
+        axi += f * dx;
+        ayi += f * dy;
+        azi += f * dz;
+    }
+}
+
+/**
+ * @brief Toutes les paires i < j, forces égales et opposées (N(N-1)/2 interactions)
+ */
+template <int D, typename Law>
+void pairwiseKernel(BodyArrays& arrays, double G, double softening) {
+    Law law(softening);
+    size_t n = arrays.size();
+    const double* x = arrays.x.data();
+    const double* y = arrays.y.data();
+    const double* z = arrays.z.data();
+    const double* mass = arrays.mass.data();
+    const double* radius = arrays.radius.data();
+    double* ax = arrays.ax.data();
+    double* ay = arrays.ay.data();
+    double* az = arrays.az.data();
+
+    for (size_t i = 0; i < n; ++i) {
+        double xi = x[i], yi = y[i], zi = D == 3 ? z[i] : 0.0, mi = mass[i], ri = radius[i];
+        double axi = 0.0, ayi = 0.0, azi = 0.0;
+
+#pragma omp simd reduction(+:axi, ayi, azi)
+        for (size_t j = i + 1; j < n; ++j) {
+            double dx = x[j] - xi;
+            double dy = y[j] - yi;
+            double dz = D == 3 ? z[j] - zi : 0.0;
+            double r2 = dx * dx + dy * dy;
+            if (D == 3) r2 += dz * dz;
+            double f = G * law(r2, ri + radius[j]);
+            axi += f * mass[j] * dx;
+            ayi += f * mass[j] * dy;
+            ax[j] -= f * mi * dx;
+            ay[j] -= f * mi * dy;
+            if (D == 3) {
+                azi += f * mass[j] * dz;
+                az[j] -= f * mi * dz;
+            }
+        }
+
+        ax[i] += axi;
+        ay[i] += ayi;
+        if (D == 3) az[i] += azi;
+    }
+}
+
+/**
+ * @brief Lignes complètes pour les corps [begin, end) : sans écriture partagée, parallélisable
+ */
+template <int D, typename Law>
+void rowKernel(BodyArrays& arrays, double G, double softening, size_t begin, size_t end) {
+    Law law(softening);
+    size_t n = arrays.size();
+
+    for (size_t i = begin; i < end; ++i) {
+        double axi = 0.0, ayi = 0.0;
+        if (D == 3) {
+            double azi = 0.0;
+            accumulateRange3D(arrays, law, i, 0, i, axi, ayi, azi);
+            accumulateRange3D(arrays, law, i, i + 1, n, axi, ayi, azi);
+            arrays.az[i] = G * azi;
+        } else {
+            accumulateRange(arrays, law, i, 0, i, axi, ayi);
+            accumulateRange(arrays, law, i, i + 1, n, axi, ayi);
+        }
+        arrays.ax[i] = G * axi;
+        arrays.ay[i] = G * ayi;
+    }
+}
+
+/**
+ * @brief Lignes [begin, end) parcourues par tuiles de tile sources
+ *
+ * Une tuile de sources reste en cache pendant qu'elle défile sur tout le
+ * bloc de cibles, au lieu d'être relue depuis la mémoire pour chaque ligne.
+ * Mêmes interactions que rowKernel, sommées tuile par tuile.
+ */
+template <int D, typename Law>
+void blockedRowKernel(BodyArrays& arrays, double G, double softening, size_t begin, size_t end, size_t tile) {
+    Law law(softening);
+    size_t n = arrays.size();
+    if (tile == 0) tile = n > 0 ? n : 1;
+
+    for (size_t i = begin; i < end; ++i) {
+        arrays.ax[i] = 0.0;
+        arrays.ay[i] = 0.0;
+        if (D == 3) arrays.az[i] = 0.0;
+    }
+
+    for (size_t jBegin = 0; jBegin < n; jBegin += tile) {
+        size_t jEnd = std::min(jBegin + tile, n);
+        for (size_t i = begin; i < end; ++i) {
+            size_t skip = i >= jBegin && i < jEnd ? i : jEnd;
+            double axi = 0.0, ayi = 0.0;
+            if (D == 3) {
+                double azi = 0.0;
+                accumulateRange3D(arrays, law, i, jBegin, skip, axi, ayi, azi);
+                if (skip < jEnd) accumulateRange3D(arrays, law, i, skip + 1, jEnd, axi, ayi, azi);
+                arrays.az[i] += G * azi;
+            } else {
+                accumulateRange(arrays, law, i, jBegin, skip, axi, ayi);
+                if (skip < jEnd) accumulateRange(arrays, law, i, skip + 1, jEnd, axi, ayi);
+            }
+            arrays.ax[i] += G * axi;
+            arrays.ay[i] += G * ayi;
+        }
+    }
+}
+
+/**
+ * @brief Lignes complètes en ordre fixe : j croissant, sommation compensée (Kahan), sans SIMD
+ *
+ * Chaque accélération ne dépend que de son corps : le résultat est le même
+ * bit à bit quel que soit le découpage entre threads. Le compilateur ne
+ * réordonne pas ces sommes sans -ffast-math. GCC contracte en revanche
+ * a*b+c en FMA, même en -std=c++20, dès que la cible en dispose (NATIVE=1) :
+ * le Makefile compile tout avec -ffp-contract=off (et sans vectorisation
+ * SLP, qui en forme malgré tout sous GCC 12), loi de force et
+ * intégrateurs compris, pour que les mêmes bits sortent sur toute machine.
+ */
+template <int D, typename Law>
+void reproducibleRowKernel(BodyArrays& arrays, double G, double softening, size_t begin, size_t end) {
+    Law law(softening);
+    size_t n = arrays.size();
+    const double* x = arrays.x.data();
+    const double* y = arrays.y.data();
+    const double* z = arrays.z.data();
+    const double* mass = arrays.mass.data();
+    const double* radius = arrays.radius.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        double sum[3] = {0.0, 0.0, 0.0};
+        double compensation[3] = {0.0, 0.0, 0.0};
+
+        for (size_t j = 0; j < n; ++j) {
+            if (j == i) continue;
+            double delta[3];
+            delta[0] = x[j] - x[i];
+            delta[1] = y[j] - y[i];
+            delta[2] = D == 3 ? z[j] - z[i] : 0.0;
+            double r2 = delta[0] * delta[0] + delta[1] * delta[1];
+            if (D == 3) r2 += delta[2] * delta[2];
+            double f = mass[j] * law(r2, radius[i] + radius[j]);
+
+            for (int d = 0; d < D; ++d) {
+                double term = f * delta[d] - compensation[d];
+                double total = sum[d] + term;
+                compensation[d] = (total - sum[d]) - term;
+                sum[d] = total;
+            }
+        }
+
+        arrays.ax[i] = G * sum[0];
+        arrays.ay[i] = G * sum[1];
+        if (D == 3) arrays.az[i] = G * sum[2];
+    }
+}
+
+/**
+ * @brief Traceurs [begin, end) en ordre fixe : sources j croissant, sommation compensée, sans SIMD
+ *
+ * Pendant de reproducibleRowKernel pour le mode reproductible : mêmes bits
+ * qu'une ligne de ce noyau pour un corps de masse nulle placé après les
+ * sources, quelle que soit la largeur des vecteurs de la machine.
+ */
+template <int D, typename Law>
+void reproducibleTracerKernel(const BodyArrays& sources, BodyArrays& tracers, double G, double softening,
+                              size_t begin, size_t end, double* nearest2) {
+    Law law(softening);
+    size_t n = sources.size();
+    const double* x = sources.x.data();
+    const double* y = sources.y.data();
+    const double* z = sources.z.data();
+    const double* mass = sources.mass.data();
+    const double* radius = sources.radius.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        double position[3] = {tracers.x[i], tracers.y[i], D == 3 ? tracers.z[i] : 0.0};
+        double sum[3] = {0.0, 0.0, 0.0};
+        double compensation[3] = {0.0, 0.0, 0.0};
+        double closest = HUGE_VAL;
+
+        for (size_t j = 0; j < n; ++j) {
+            double delta[3];
+            delta[0] = x[j] - position[0];
+            delta[1] = y[j] - position[1];
+            delta[2] = D == 3 ? z[j] - position[2] : 0.0;
+            double r2 = delta[0] * delta[0] + delta[1] * delta[1];
+            if (D == 3) r2 += delta[2] * delta[2];
+            double f = mass[j] * law(r2, tracers.radius[i] + radius[j]);
+            closest = r2 < closest ? r2 : closest;
+
+            for (int d = 0; d < D; ++d) {
+                double term = f * delta[d] - compensation[d];
+                double total = sum[d] + term;
+                compensation[d] = (total - sum[d]) - term;
+                sum[d] = total;
+            }
+        }
+
+        tracers.ax[i] = G * sum[0];
+        tracers.ay[i] = G * sum[1];
+        if (D == 3) tracers.az[i] = G * sum[2];
+        nearest2[i] = closest;
+    }
+}
+
+/**
+ * @brief Accélérations des traceurs [begin, end) dues aux seules sources
+ *
+ * Les traceurs ne sont pas des sources : S × T interactions au lieu de
+ * N(N-1)/2. Chaque ligne ne dépend que de son traceur (même résultat quel
+ * que soit le découpage). nearest2 reçoit, par traceur, le carré de la
+ * distance à la source la plus proche.
+ */
+template <int D, typename Law>
+void tracerKernel(const BodyArrays& sources, BodyArrays& tracers, double G, double softening,
+                  size_t begin, size_t end, double* nearest2) {
+    Law law(softening);
+    size_t n = sources.size();
+    const double* x = sources.x.data();
+    const double* y = sources.y.data();
+    const double* z = sources.z.data();
+    const double* mass = sources.mass.data();
+    const double* radius = sources.radius.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        double xi = tracers.x[i], yi = tracers.y[i], zi = D == 3 ? tracers.z[i] : 0.0, ri = tracers.radius[i];
+        double axi = 0.0, ayi = 0.0, azi = 0.0;
+        double closest = HUGE_VAL;
+
+#pragma omp simd reduction(+:axi, ayi, azi) reduction(min:closest)
+        for (size_t j = 0; j < n; ++j) {
+            double dx = x[j] - xi;
+            double dy = y[j] - yi;
+            double dz = D == 3 ? z[j] - zi : 0.0;
+            double r2 = dx * dx + dy * dy;
+            if (D == 3) r2 += dz * dz;
+            double f = mass[j] * law(r2, ri + radius[j]);
+            axi += f * dx;
+            ayi += f * dy;
+            if (D == 3) azi += f * dz;
+            closest = r2 < closest ? r2 : closest;
+        }
+
+        tracers.ax[i] = G * axi;
+        tracers.ay[i] = G * ayi;
+        if (D == 3) tracers.az[i] = G * azi;
+        nearest2[i] = closest;
+    }
+}
+
+/**
+ * @brief Ajoute aux cibles [begin, end) l'accélération due à toutes les sources d'une autre tuile
+ *
+ * Contrairement à tracerKernel, le résultat s'accumule dans targets.ax/ay/az :
+ * les tuiles de sources défilent l'une après l'autre sur le même bloc de
+ * cibles. Les deux ensembles doivent être disjoints (pas de terme i = j).
+ */
+template <int D, typename Law>
+void tileKernel(const BodyArrays& sources, BodyArrays& targets, double G, double softening,
+                size_t begin, size_t end) {
+    Law law(softening);
+    size_t n = sources.size();
+    const double* x = sources.x.data();
+    const double* y = sources.y.data();
+    const double* z = sources.z.data();
+    const double* mass = sources.mass.data();
+    const double* radius = sources.radius.data();
+
+    for (size_t i = begin; i < end; ++i) {
+        double xi = targets.x[i], yi = targets.y[i], zi = D == 3 ? targets.z[i] : 0.0, ri = targets.radius[i];
+        double axi = 0.0, ayi = 0.0, azi = 0.0;
+
+#pragma omp simd reduction(+:axi, ayi, azi)
+        for (size_t j = 0; j < n; ++j) {
+            double dx = x[j] - xi;
+            double dy = y[j] - yi;
+            double dz = D == 3 ? z[j] - zi : 0.0;
+            double r2 = dx * dx + dy * dy;
+            if (D == 3) r2 += dz * dz;
+            double f = mass[j] * law(r2, ri + radius[j]);
+            axi += f * dx;
+            ayi += f * dy;
+            if (D == 3) azi += f * dz;
+        }
+
+        targets.ax[i] += G * axi;
+        targets.ay[i] += G * ayi;
+        if (D == 3) targets.az[i] += G * azi;
+    }
+}
+
+/**
+ * @brief Toutes les paires entre deux ensembles disjoints, forces égales et opposées des deux côtés
+ *
+ * Version séquentielle de tileKernel : chaque interaction entre le bloc et
+ * la tuile n'est calculée qu'une fois, comme dans pairwiseKernel.
+ */
+template <int D, typename Law>
+void tilePairsKernel(BodyArrays& targets, BodyArrays& sources, double G, double softening) {
+    Law law(softening);
+    size_t n = sources.size();
+    const double* x = sources.x.data();
+    const double* y = sources.y.data();
+    const double* z = sources.z.data();
+    const double* mass = sources.mass.data();
+    const double* radius = sources.radius.data();
+    double* ax = sources.ax.data();
+    double* ay = sources.ay.data();
+    double* az = sources.az.data();
+
+    for (size_t i = 0; i < targets.size(); ++i) {
+        double xi = targets.x[i], yi = targets.y[i], zi = D == 3 ? targets.z[i] : 0.0;
+        double mi = targets.mass[i], ri = targets.radius[i];
+        double axi = 0.0, ayi = 0.0, azi = 0.0;
+
+#pragma omp simd reduction(+:axi, ayi, azi)
+        for (size_t j = 0; j < n; ++j) {
+            double dx = x[j] - xi;
+            double dy = y[j] - yi;
+            double dz = D == 3 ? z[j] - zi : 0.0;
+            double r2 = dx * dx + dy * dy;
+            if (D == 3) r2 += dz * dz;
+            double f = G * law(r2, ri + radius[j]);
+            axi += f * mass[j] * dx;
+            ayi += f * mass[j] * dy;
+            ax[j] -= f * mi * dx;
+            ay[j] -= f * mi * dy;
+            if (D == 3) {
+                azi += f * mass[j] * dz;
+                az[j] -= f * mi * dz;
+            }
+        }
+
+        targets.ax[i] += axi;
+        targets.ay[i] += ayi;
+        if (D == 3) targets.az[i] += azi;
+    }
+}
+
+/**
+ * @struct ForceKernels
+ * @brief Noyaux instanciés pour une loi et une dimension, sélectionnés une seule fois
+ */
+struct ForceKernels {
+    typedef void (*Pairwise)(BodyArrays&, double, double);
+    typedef void (*Rows)(BodyArrays&, double, double, size_t, size_t);
+    typedef void (*Tracers)(const BodyArrays&, BodyArrays&, double, double, size_t, size_t, double*);
+    typedef void (*Tiles)(const BodyArrays&, BodyArrays&, double, double, size_t, size_t);
+    typedef void (*TilePairs)(BodyArrays&, BodyArrays&, double, double);
+    typedef void (*BlockedRows)(BodyArrays&, double, double, size_t, size_t, size_t);
+
+    Pairwise pairwise;
+    Rows rows;
+    Rows reproducibleRows;
+    Tracers tracers;
+    Tracers reproducibleTracers;
+    Tiles tiles;
+    TilePairs tilePairs;
+    BlockedRows blockedRows;
+};
+
+template <int D>
+inline ForceKernels selectForceKernels(ForceLaw law) {
+    ForceKernels kernels;
+    switch (law) {
+        case ForceLaw::Newtonian:
+            kernels.pairwise = &pairwiseKernel<D, NewtonianForce>;
+            kernels.rows = &rowKernel<D, NewtonianForce>;
+            kernels.reproducibleRows = &reproducibleRowKernel<D, NewtonianForce>;
+            kernels.tracers = &tracerKernel<D, NewtonianForce>;
+            kernels.reproducibleTracers = &reproducibleTracerKernel<D, NewtonianForce>;
+            kernels.tiles = &tileKernel<D, NewtonianForce>;
+            kernels.tilePairs = &tilePairsKernel<D, NewtonianForce>;
+            kernels.blockedRows = &blockedRowKernel<D, NewtonianForce>;
+            break;
+        case ForceLaw::Plummer:
+            kernels.pairwise = &pairwiseKernel<D, PlummerForce>;
+            kernels.rows = &rowKernel<D, PlummerForce>;
+            kernels.reproducibleRows = &reproducibleRowKernel<D, PlummerForce>;
+            kernels.tracers = &tracerKernel<D, PlummerForce>;
+            kernels.reproducibleTracers = &reproducibleTracerKernel<D, PlummerForce>;
+            kernels.tiles = &tileKernel<D, PlummerForce>;
+            kernels.tilePairs = &tilePairsKernel<D, PlummerForce>;
+            kernels.blockedRows = &blockedRowKernel<D, PlummerForce>;
+            break;
+        case ForceLaw::Spline:
+            kernels.pairwise = &pairwiseKernel<D, SplineForce>;
+            kernels.rows = &rowKernel<D, SplineForce>;
+            kernels.reproducibleRows = &reproducibleRowKernel<D, SplineForce>;
+            kernels.tracers = &tracerKernel<D, SplineForce>;
+            kernels.reproducibleTracers = &reproducibleTracerKernel<D, SplineForce>;
+            kernels.tiles = &tileKernel<D, SplineForce>;
+            kernels.tilePairs = &tilePairsKernel<D, SplineForce>;
+            kernels.blockedRows = &blockedRowKernel<D, SplineForce>;
+            break;
+        case ForceLaw::Clamped:
+        default:
+            kernels.pairwise = &pairwiseKernel<D, ClampedForce>;
+            kernels.rows = &rowKernel<D, ClampedForce>;
+            kernels.reproducibleRows = &reproducibleRowKernel<D, ClampedForce>;
+            kernels.tracers = &tracerKernel<D, ClampedForce>;
+            kernels.reproducibleTracers = &reproducibleTracerKernel<D, ClampedForce>;
+            kernels.tiles = &tileKernel<D, ClampedForce>;
+            kernels.tilePairs = &tilePairsKernel<D, ClampedForce>;
+            kernels.blockedRows = &blockedRowKernel<D, ClampedForce>;
+            break;
+    }
+    return kernels;
+}
+
+inline const char* forceLawName(ForceLaw law) {
+    switch (law) {
+        case ForceLaw::Newtonian: return "newton";
+        case ForceLaw::Plummer: return "plummer";
+        case ForceLaw::Spline: return "spline";
+        case ForceLaw::Clamped:
+        default: return "clamped";
+    }
+}
+
+inline bool parseForceLaw(const std::string& name, ForceLaw& law) {
+    if (name == "clamped") law = ForceLaw::Clamped;
+    else if (name == "newton") law = ForceLaw::Newtonian;
+    else if (name == "plummer") law = ForceLaw::Plummer;
+    else if (name == "spline") law = ForceLaw::Spline;
+    else return false;
+    return true;
+}
+
+#endif
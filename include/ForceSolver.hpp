@@ -0,0 +1,161 @@
+/**
+ * @file ForceSolver.hpp
+ * @brief Registre des solveurs de forces et cache de calibration par machine
+ * @author P-Pix
+ * @date 2025
+ *
+ * Trois familles de solveurs derrière step() : la boucle sur les paires
+ * d'origine, la somme directe par tuiles et l'arbre de Barnes–Hut. Le plus
+ * rapide dépend de N, de la répartition des corps, de la machine et de la
+ * précision demandée : la simulation les chronomètre sur ses propres corps
+ * et garde le plus rapide assez précis. Le choix est mémorisé dans un
+ * fichier texte, une ligne par machine et par situation (clé) :
+ *
+ *     <machine> <clé> <solveur> <threads> <tuile> <θ> <feuille> <secondes>
+ *
+ * La dernière ligne correspondante l'emporte ; les lignes commençant par #
+ * sont ignorées.
+ */
+
+#ifndef FORCE_SOLVER_HPP
+#define FORCE_SOLVER_HPP
+
+#include "BodyArrays.hpp"
+#include "ForceLaw.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * @enum SolverKind
+ * @brief Famille de solveur de forces
+ */
+enum class SolverKind {
+    Pairwise,   ///< Boucle d'origine : paires symétriques en séquentiel, lignes complètes en parallèle
+    Blocked,    ///< Somme directe par tuiles de sources, gardées en cache sur un bloc de cibles
+    Tree        ///< Barnes–Hut, approché en O(N log N)
+};
+
+/**
+ * @struct SolverConfig
+ * @brief Solveur et paramètres ; la valeur par défaut reproduit exactement le calcul d'origine
+ */
+struct SolverConfig {
+    SolverKind kind;
+    unsigned threads;       ///< 1 = thread appelant seul, 0 = tout le TaskScheduler
+    size_t tileSize;        ///< Sources par tuile (Blocked)
+    double openingAngle;    ///< θ : cellule acceptée si côté < θ × distance (Tree)
+    size_t leafSize;        ///< Corps par feuille au plus (Tree)
+
+    SolverConfig() : kind(SolverKind::Pairwise), threads(0), tileSize(1024), openingAngle(0.5), leafSize(16) {}
+
+    /**
+     * @brief Forme lisible, par exemple « tree theta=0.5 leaf=16 threads=4 »
+     */
+    std::string describe() const;
+};
+
+/**
+ * @struct SolverTiming
+ * @brief Mesure d'un candidat pendant une calibration
+ */
+struct SolverTiming {
+    SolverConfig config;
+    double seconds;     ///< Durée d'un calcul complet des forces
+    double error;       ///< Erreur relative RMS des accélérations (voir accelerationError)
+    bool accepted;      ///< Erreur dans la précision demandée
+    bool completed;     ///< false : arrêté au-delà du meilleur temps, ou écarté sans essai
+};
+
+/**
+ * @brief Candidats chronométrés, le calcul d'origine en premier (il sert de référence)
+ *
+ * Le TaskScheduler ne se restreint pas à une partie de ses workers : les
+ * nombres de threads essayés sont 1 et le pool entier.
+ */
+std::vector<SolverConfig> solverCandidates(unsigned poolThreads);
+
+/**
+ * @brief Erreur relative RMS : sqrt(Σ |a - a_ref|² / Σ |a_ref|²) sur toutes les lignes
+ */
+double accelerationError(const BodyArrays& approximate, const BodyArrays& exact);
+
+/**
+ * @brief Groupement des corps dans [0, 1] : part des cellules occupées d'une grille de N cellules
+ *
+ * Une répartition uniforme occupe environ 63 % des cellules ; des galaxies
+ * serrées dans un grand domaine vide en occupent quelques pour cent.
+ */
+double measureClustering(const BodyArrays& arrays);
+
+/**
+ * @brief Clé de la situation : dimension, loi, N et groupement par classes, threads, précision
+ *
+ * N est classé par demi-octave et le groupement par demi-bit de -log2 :
+ * la clé ne change qu'avec la situation, pas à chaque pas.
+ */
+std::string solverKey(int dimension, ForceLaw law, size_t count, double clustering, unsigned poolThreads,
+                      double accuracy);
+
+/**
+ * @class SolverCache
+ * @brief Fichier des solveurs retenus, propre à la machine
+ */
+class SolverCache {
+private:
+    std::string path;
+    std::string machine;
+
+public:
+    explicit SolverCache(const std::string& path);
+
+    /**
+     * @brief $XDG_CACHE_HOME/n-corps-solvers.txt, ou ~/.cache/n-corps-solvers.txt
+     */
+    static std::string defaultPath();
+
+    /**
+     * @brief Nom d'hôte et nombre de cœurs : un même fichier peut être partagé entre machines
+     */
+    static std::string machineName();
+
+    /**
+     * @brief Dernier solveur enregistré pour cette machine et cette clé
+     */
+    bool lookup(const std::string& key, SolverConfig& config) const;
+
+    /**
+     * @brief Ajoute une ligne en fin de fichier ; false si le fichier n'est pas accessible
+     */
+    bool store(const std::string& key, const SolverConfig& config, double seconds) const;
+
+    const std::string& getPath() const { return path; }
+    const std::string& getMachine() const { return machine; }
+};
+
+inline const char* solverKindName(SolverKind kind) {
+    switch (kind) {
+        case SolverKind::Blocked: return "blocked";
+        case SolverKind::Tree: return "tree";
+        case SolverKind::Pairwise:
+        default: return "pairwise";
+    }
+}
+
+inline bool parseSolverKind(const std::string& name, SolverKind& kind) {
+    if (name == "pairwise") kind = SolverKind::Pairwise;
+    else if (name == "blocked") kind = SolverKind::Blocked;
+    else if (name == "tree") kind = SolverKind::Tree;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Relit la forme de SolverConfig::describe(), par exemple « tree theta=0.5 leaf=16 threads=pool »
+ *
+ * Les paramètres absents gardent leur valeur par défaut ; « direct » vaut
+ * pairwise (anciens fichiers de scène).
+ */
+bool parseSolverConfig(const std::string& text, SolverConfig& config);
+
+#endif
@@ -0,0 +1,72 @@
+/**
+ * @file Morton.hpp
+ * @brief Clés de Morton (courbe en Z) : bits des coordonnées entrelacés
+ * @author P-Pix
+ * @date 2025
+ *
+ * Deux corps proches sur la courbe sont proches dans l'espace : trier par
+ * clé range les corps par régions compactes (décomposition de domaine) et
+ * met les corps d'une même cellule d'arbre côte à côte. 32 bits par axe en
+ * 2D, 21 en 3D : la clé tient dans 64 bits.
+ */
+
+#ifndef MORTON_HPP
+#define MORTON_HPP
+
+#include <cstdint>
+
+/**
+ * @brief Cellules par axe de la grille de quantification
+ */
+inline uint64_t mortonCells(int dimension) {
+    return dimension == 3 ? (1ULL << 21) : (1ULL << 32);
+}
+
+/**
+ * @brief Bits de v écartés d'un rang (2D) : bit k en position 2k
+ */
+inline uint64_t spreadBits2(uint64_t v) {
+    v &= 0xffffffffULL;
+    v = (v | (v << 16)) & 0x0000ffff0000ffffULL;
+    v = (v | (v << 8)) & 0x00ff00ff00ff00ffULL;
+    v = (v | (v << 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    v = (v | (v << 2)) & 0x3333333333333333ULL;
+    v = (v | (v << 1)) & 0x5555555555555555ULL;
+    return v;
+}
+
+/**
+ * @brief Bits de v écartés de deux rangs (3D) : bit k en position 3k
+ */
+inline uint64_t spreadBits3(uint64_t v) {
+    v &= 0x1fffffULL;
+    v = (v | (v << 32)) & 0x1f00000000ffffULL;
+    v = (v | (v << 16)) & 0x1f0000ff0000ffULL;
+    v = (v | (v << 8)) & 0x100f00f00f00f00fULL;
+    v = (v | (v << 4)) & 0x10c30c30c30c30c3ULL;
+    v = (v | (v << 2)) & 0x1249249249249249ULL;
+    return v;
+}
+
+/**
+ * @brief Coordonnée ramenée sur [0, cells - 1] ; NaN en 0
+ */
+inline uint64_t mortonQuantize(double value, double lower, double scale, uint64_t cells) {
+    double q = (value - lower) * scale;
+    if (!(q >= 0.0)) return 0;
+    return q >= static_cast<double>(cells - 1) ? cells - 1 : static_cast<uint64_t>(q);
+}
+
+/**
+ * @brief Clé d'un point déjà quantifié, axe 0 sur le bit de poids faible de chaque groupe
+ */
+template <int D>
+inline uint64_t mortonKey(const uint64_t (&cell)[D]) {
+    uint64_t key = 0;
+    for (int d = 0; d < D; ++d) {
+        key |= (D == 3 ? spreadBits3(cell[d]) : spreadBits2(cell[d])) << d;
+    }
+    return key;
+}
+
+#endif
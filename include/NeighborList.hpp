@@ -0,0 +1,85 @@
+/**
+ * @file NeighborList.hpp
+ * @brief Liste de voisins de Verlet (rayon de coupure + peau) construite sur une grille de cellules
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef NEIGHBOR_LIST_HPP
+#define NEIGHBOR_LIST_HPP
+
+#include "BodyArrays.hpp"
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class NeighborList
+ * @brief Paires (i < j) à moins de cutoff + skin, reconstruites seulement quand c'est nécessaire
+ *
+ * Tant qu'aucun corps ne s'est déplacé de plus de skin/2 depuis la dernière
+ * construction, aucune paire à moins de cutoff ne peut manquer dans la liste :
+ * elle est réutilisée telle quelle. La construction range les corps dans une
+ * grille de cellules de côté cutoff + skin (tri par comptage), puis ne
+ * compare chaque corps qu'aux 9 cellules voisines (27 en 3D, quand
+ * BodyArrays::z est rempli) : O(N) à densité bornée.
+ */
+class NeighborList {
+private:
+    double cutoff;
+    double skin;
+
+    // Positions au moment de la dernière construction
+    std::vector<double> referenceX, referenceY, referenceZ;
+
+    // Demi-liste au format CSR : voisins de i dans neighbors[offsets[i], offsets[i+1])
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> neighbors;
+
+    // Grille de cellules (réutilisée entre constructions)
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellBodies;
+    std::vector<uint32_t> bodyCell;
+
+    uint64_t updateCount;
+    uint64_t rebuildCount;
+    uint64_t listLengthSum;
+    uint64_t bodyCountSum;
+
+    bool needsRebuild(const BodyArrays& arrays) const;
+
+public:
+    NeighborList(double cutoffRadius = 0.0, double skinThickness = 0.0);
+
+    void setCutoff(double cutoffRadius) { cutoff = cutoffRadius; }
+    void setSkin(double skinThickness) { skin = skinThickness; }
+    double getCutoff() const { return cutoff; }
+    double getSkin() const { return skin; }
+
+    /**
+     * @brief Appelé à chaque pas : reconstruit la liste si un corps a bougé de plus de skin/2
+     * @return true si la liste a été reconstruite
+     */
+    bool update(const BodyArrays& arrays);
+
+    /**
+     * @brief Reconstruction inconditionnelle
+     */
+    void build(const BodyArrays& arrays);
+
+    /**
+     * @brief Force la reconstruction au prochain update() (corps ajoutés ou retirés)
+     */
+    void invalidate() { referenceX.clear(); referenceY.clear(); referenceZ.clear(); }
+
+    const std::vector<uint32_t>& getOffsets() const { return offsets; }
+    const std::vector<uint32_t>& getNeighbors() const { return neighbors; }
+    size_t getPairCount() const { return neighbors.size(); }
+
+    // Statistiques
+    uint64_t getUpdateCount() const { return updateCount; }
+    uint64_t getRebuildCount() const { return rebuildCount; }
+    double getRebuildFrequency() const;      ///< Reconstructions par pas
+    double getAverageListLength() const;     ///< Voisins par corps, moyenne sur les reconstructions
+};
+
+#endif
@@ -0,0 +1,179 @@
+/**
+ * @file Numa.hpp
+ * @brief Topologie NUMA lue dans sysfs et épinglage des threads sur un nœud
+ * @author P-Pix
+ * @date 2025
+ *
+ * Linux uniquement, sans libnuma : /sys/devices/system/node/node<k>/cpulist
+ * donne les cœurs de chaque nœud. Seuls les cœurs autorisés au processus
+ * (sched_getaffinity, cgroups) sont retenus. Sans sysfs, ou sur une machine
+ * à un seul socket, la topologie se réduit à un nœud portant tous ces cœurs :
+ * épingler reste alors sans effet.
+ *
+ * Placement des pages : le noyau place une page sur le nœud du thread qui la
+ * touche en premier. Des tableaux remplis par le thread principal finissent
+ * donc tous sur son nœud ; les threads des autres sockets les lisent à
+ * distance à chaque passe de forces.
+ */
+
+#ifndef NUMA_HPP
+#define NUMA_HPP
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class TaskScheduler;
+
+/**
+ * @enum PinningPolicy
+ * @brief Répartition des workers d'un TaskScheduler sur les cœurs
+ */
+enum class PinningPolicy {
+    None,       ///< Threads libres, l'ordonnanceur du noyau décide
+    Compact,    ///< Un cœur par worker, nœud après nœud : un socket rempli avant le suivant
+    Scatter     ///< Un cœur par worker, les nœuds à tour de rôle : bande passante de tous les sockets
+};
+
+/**
+ * @enum MemoryPlacement
+ * @brief Placement des tableaux de calcul sur les nœuds NUMA
+ */
+enum class MemoryPlacement {
+    Default,    ///< Pages sur le nœud du thread qui les remplit (thread principal)
+    FirstTouch, ///< Pages touchées en premier par le worker propriétaire de chaque tranche
+    Interleave  ///< Pages réparties à tour de rôle sur tous les nœuds
+};
+
+/**
+ * @struct NodeBandwidth
+ * @brief Débit de lecture mesuré par les workers d'un nœud, en parallèle
+ */
+struct NodeBandwidth {
+    int node;
+    unsigned workers;   ///< Workers mesurés sur ce nœud
+    double bytes;       ///< Octets lus par ces workers
+    double seconds;     ///< Durée la plus longue parmi eux
+
+    NodeBandwidth() : node(-1), workers(0), bytes(0.0), seconds(0.0) {}
+
+    double getBandwidth() const { return seconds > 0.0 ? bytes / seconds : 0.0; }
+};
+
+/**
+ * @struct NumaNode
+ */
+struct NumaNode {
+    int id;                 ///< Numéro du nœud dans sysfs
+    std::vector<int> cpus;  ///< Cœurs autorisés de ce nœud
+};
+
+/**
+ * @class NumaTopology
+ * @brief Nœuds NUMA ayant au moins un cœur autorisé, par numéro croissant
+ */
+class NumaTopology {
+private:
+    std::vector<NumaNode> nodes;
+
+public:
+    /**
+     * @brief Lit la topologie de la machine
+     */
+    NumaTopology();
+
+    size_t getNodeCount() const { return nodes.size(); }
+    const NumaNode& getNode(size_t index) const { return nodes[index]; }
+
+    /**
+     * @brief Nœud attribué au rang rank, à tour de rôle
+     */
+    const NumaNode& nodeForRank(size_t rank) const { return nodes[rank % nodes.size()]; }
+
+    /**
+     * @brief Nœud portant le cœur cpu, -1 s'il n'en fait pas partie
+     */
+    int nodeOfCpu(int cpu) const;
+
+    /**
+     * @brief Cœur de chaque worker selon la politique (-1 partout pour None)
+     *
+     * Au-delà du nombre de cœurs autorisés, l'attribution recommence au début.
+     */
+    std::vector<int> assignCpus(size_t workers, PinningPolicy policy) const;
+
+    /**
+     * @brief Répartit les pages de [data, data + bytes) sur tous les nœuds, pages déjà touchées comprises
+     */
+    bool interleave(void* data, size_t bytes) const;
+
+    /**
+     * @brief Restreint le thread appelant aux cœurs donnés (hérité par fork et par les threads créés ensuite)
+     */
+    static bool pinCurrentThread(const std::vector<int>& cpus);
+
+    /**
+     * @brief Cœurs autorisés au thread appelant
+     */
+    static std::vector<int> currentThreadCpus();
+
+    /**
+     * @brief Rend au noyau les pages entièrement comprises dans [data, data + bytes)
+     *
+     * Mémoire anonyme privée seulement (tas, mmap) : les pages rendues se
+     * relisent à zéro et sont réallouées, sur le nœud de celui qui les
+     * touche, au premier accès suivant.
+     */
+    static void releasePages(void* data, size_t bytes);
+
+    /**
+     * @brief Débit de lecture par nœud, chaque worker lisant bytesPerWorker octets placés selon placement
+     *
+     * Default : tout est rempli par le thread appelant ; FirstTouch : chaque
+     * worker remplit son tampon ; Interleave : pages réparties sur les nœuds.
+     * Avec Default, les workers des autres nœuds mesurent un accès distant.
+     */
+    std::vector<NodeBandwidth> measureBandwidth(TaskScheduler& scheduler, size_t bytesPerWorker,
+                                                MemoryPlacement placement) const;
+
+    /**
+     * @brief Cœurs d'une liste au format du noyau, par exemple "0-3,8-11"
+     */
+    static std::vector<int> parseCpuList(const std::string& text);
+};
+
+inline const char* pinningPolicyName(PinningPolicy policy) {
+    switch (policy) {
+        case PinningPolicy::Compact: return "compact";
+        case PinningPolicy::Scatter: return "scatter";
+        case PinningPolicy::None:
+        default: return "none";
+    }
+}
+
+inline bool parsePinningPolicy(const std::string& name, PinningPolicy& policy) {
+    if (name == "none") policy = PinningPolicy::None;
+    else if (name == "compact") policy = PinningPolicy::Compact;
+    else if (name == "scatter") policy = PinningPolicy::Scatter;
+    else return false;
+    return true;
+}
+
+inline const char* memoryPlacementName(MemoryPlacement placement) {
+    switch (placement) {
+        case MemoryPlacement::FirstTouch: return "first-touch";
+        case MemoryPlacement::Interleave: return "interleave";
+        case MemoryPlacement::Default:
+        default: return "default";
+    }
+}
+
+inline bool parseMemoryPlacement(const std::string& name, MemoryPlacement& placement) {
+    if (name == "default") placement = MemoryPlacement::Default;
+    else if (name == "first-touch") placement = MemoryPlacement::FirstTouch;
+    else if (name == "interleave") placement = MemoryPlacement::Interleave;
+    else return false;
+    return true;
+}
+
+#endif
@@ -0,0 +1,144 @@
+/**
+ * @file OffscreenRenderer.hpp
+ * @brief Rendu sans fenêtre dans une image flottante, pour les vidéos de grosses simulations
+ * @author P-Pix
+ * @date 2025
+ *
+ * Les corps sont déposés de façon additive dans un tampon RGB flottant
+ * linéaire : là où des milliers de corps se superposent, la luminosité
+ * monte au lieu de saturer. Le tampon est ensuite ramené sur 8 bits par
+ * une courbe 1 - exp(-exposition * v) puis un gamma sRGB. Les traînées
+ * naissent de la rémanence (le tampon est atténué au lieu d'être effacé)
+ * et d'une traînée déposée entre la position précédente et la nouvelle.
+ *
+ * L'image est découpée en tuiles de TILE_SIZE pixels : chaque corps est rangé
+ * dans les tuiles que recouvre son empreinte, puis chaque tuile est traitée
+ * par une tâche, sans verrou ni écriture partagée. Le résultat ne dépend pas
+ * du nombre de threads.
+ */
+
+#ifndef OFFSCREEN_RENDERER_HPP
+#define OFFSCREEN_RENDERER_HPP
+
+#include "Simulation.hpp"
+#include "Trajectory.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+class TaskScheduler;
+
+/**
+ * @class OffscreenRenderer
+ * @brief Tampon d'image logiciel à résolution libre, écrit en PNG, PPM ou flux RGB24 brut
+ */
+class OffscreenRenderer {
+public:
+    static const int TILE_SIZE = 64;
+
+private:
+    int width, height;
+    int tileColumns, tileRows;
+    std::vector<float> accumulation;    // RGB linéaire, width * height * 3
+    std::vector<uint8_t> pixels;        // RGB 8 bits après tone mapping
+
+    // Caméra : même projection que Renderer (zoom en pixels par unité, perspective en 3D)
+    Vector2D cameraCenter;
+    double zoomLevel;
+    double cameraDistance;
+    double exposure;
+    double trailPersistence;
+
+    TaskScheduler* scheduler;
+
+    // Projection de l'image courante ; screenRadius < 0 pour un corps invisible
+    std::vector<float> screenX, screenY, screenRadius;
+    std::vector<float> previousX, previousY;
+    std::vector<float> bodyColor;       // RGB linéaire par corps
+
+    // Corps par tuile (tri par comptage, format CSR)
+    std::vector<uint32_t> tileStart;
+    std::vector<uint32_t> tileItems;
+    std::vector<uint32_t> bodyTiles;    // Rectangle de tuiles : x0, y0, x1, y1 par corps
+
+    std::vector<uint8_t> toneCurve;
+
+    // Copie de l'état d'une simulation vivante
+    std::vector<double> stagedPositions;
+    std::vector<double> stagedMass;
+    std::vector<double> stagedRadius;
+
+    std::string lastError;
+
+    template <typename Function>
+    void forEachRange(size_t count, size_t grain, Function function);
+
+    void project(const FrameView& frame);
+    void binBodies(size_t bodyCount);
+    void renderTile(size_t tile);
+
+public:
+    OffscreenRenderer(int width, int height);
+
+    void setTaskScheduler(TaskScheduler* taskScheduler) { scheduler = taskScheduler; }
+
+    // Camera controls
+    void setCamera(Vector2D center, double zoom) { cameraCenter = center; zoomLevel = zoom; }
+    void setCameraDistance(double distance) { cameraDistance = distance; }
+    Vector2D getCameraCenter() const { return cameraCenter; }
+    double getZoom() const { return zoomLevel; }
+
+    /**
+     * @brief Cadre la boîte englobante (x, y) des corps avec une marge relative
+     */
+    void fitCamera(const FrameView& frame, double margin = 0.1);
+
+    /**
+     * @brief Exposition de la courbe 1 - exp(-exposition * v) (défaut : 1)
+     */
+    void setExposure(double value);
+
+    /**
+     * @brief Part du tampon conservée d'une image à la suivante : 0 sans traînées, proche de 1 pour de longues traînées
+     */
+    void setTrailPersistence(double persistence) { trailPersistence = persistence; }
+
+    void clear();
+
+    /**
+     * @brief Dessine une image (simulation vivante ou trajectoire relue) dans le tampon
+     */
+    void renderFrame(const FrameView& frame);
+
+    template <int D>
+    FrameView stageFrame(const SimulationT<D>& simulation);
+
+    template <int D>
+    void renderSimulation(const SimulationT<D>& simulation) { renderFrame(stageFrame(simulation)); }
+
+    /**
+     * @brief Écrit l'image selon l'extension (.png ou .ppm)
+     */
+    bool writeImage(const std::string& path);
+    bool writePNG(const std::string& path);
+    bool writePPM(const std::string& path);
+
+    /**
+     * @brief Flux RGB24 brut (ffmpeg -f rawvideo -pix_fmt rgb24 -s LxH -i -)
+     */
+    bool writeRaw(std::FILE* stream);
+
+    /**
+     * @brief Remplace le premier %d (ou %0Nd) de pattern par index ; sans motif, ajoute _NNNNNN avant l'extension
+     */
+    static std::string framePath(const std::string& pattern, uint64_t index);
+
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    const std::vector<uint8_t>& getPixels() const { return pixels; }
+    const std::vector<float>& getAccumulation() const { return accumulation; }
+    const std::string& getError() const { return lastError; }
+};
+
+#endif
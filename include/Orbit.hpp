@@ -0,0 +1,93 @@
+/**
+ * @file Orbit.hpp
+ * @brief Éléments orbitaux képlériens d'un corps autour de son attracteur dominant
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef ORBIT_HPP
+#define ORBIT_HPP
+
+#include "Simulation.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+/**
+ * @struct OrbitalElements
+ * @brief Orbite à deux corps osculatrice (corps + attracteur seuls, état courant)
+ */
+struct OrbitalElements {
+    size_t attractor;       ///< Indice de l'attracteur, (size_t)-1 si aucun
+    double distance;
+    double relativeSpeed;
+    double semiMajorAxis;   ///< Négatif pour une trajectoire hyperbolique
+    double eccentricity;
+    double period;          ///< 0 si la trajectoire n'est pas liée
+    double inclination;     ///< Radians par rapport au plan z = 0 (toujours 0 en 2D)
+    bool bound;
+
+    OrbitalElements()
+        : attractor(static_cast<size_t>(-1)), distance(0.0), relativeSpeed(0.0), semiMajorAxis(0.0),
+          eccentricity(0.0), period(0.0), inclination(0.0), bound(false) {}
+};
+
+/**
+ * @brief Attracteur dominant (plus forte accélération G m / r²) et orbite relative du corps index
+ *
+ * Parcours linéaire des corps : à n'appeler qu'à la sélection, pas à chaque image.
+ */
+template <int D>
+OrbitalElements computeOrbitalElements(const SimulationT<D>& simulation, size_t index) {
+    typedef typename SimulationT<D>::VectorType VectorType;
+    const auto& bodies = simulation.getBodies();
+    OrbitalElements elements;
+    if (index >= bodies.size()) return elements;
+
+    VectorType position = bodies[index]->getPosition();
+    double strongest = 0.0;
+    for (size_t j = 0; j < bodies.size(); ++j) {
+        if (j == index) continue;
+        VectorType offset = bodies[j]->getPosition() - position;
+        double r2 = offset.dot(offset);
+        if (r2 <= 0.0) continue;
+        double pull = bodies[j]->getMass() / r2;
+        if (pull > strongest) {
+            strongest = pull;
+            elements.attractor = j;
+        }
+    }
+    if (elements.attractor == static_cast<size_t>(-1)) return elements;
+
+    const auto& attractor = *bodies[elements.attractor];
+    VectorType r = position - attractor.getPosition();
+    VectorType v = bodies[index]->getVelocity() - attractor.getVelocity();
+    double mu = simulation.getGravitationalConstant() * (bodies[index]->getMass() + attractor.getMass());
+    elements.distance = r.magnitude();
+    elements.relativeSpeed = v.magnitude();
+    if (mu <= 0.0 || elements.distance <= 0.0) return elements;
+
+    // Énergie spécifique, vecteur excentricité e = ((v² - mu/r) r - (r.v) v) / mu
+    double speed2 = v.dot(v);
+    double energy = 0.5 * speed2 - mu / elements.distance;
+    VectorType eccentricityVector = (r * (speed2 - mu / elements.distance) - v * r.dot(v)) * (1.0 / mu);
+    elements.eccentricity = eccentricityVector.magnitude();
+    elements.bound = energy < 0.0;
+    elements.semiMajorAxis = energy != 0.0 ? -mu / (2.0 * energy) : 0.0;
+    if (elements.bound) {
+        elements.period = 2.0 * M_PI * std::sqrt(elements.semiMajorAxis * elements.semiMajorAxis
+                                                 * elements.semiMajorAxis / mu);
+    }
+
+    if (D == 3) {
+        // Moment cinétique h = r x v
+        double hx = r[1] * v[2] - r[2] * v[1];
+        double hy = r[2] * v[0] - r[0] * v[2];
+        double hz = r[0] * v[1] - r[1] * v[0];
+        double h = std::sqrt(hx * hx + hy * hy + hz * hz);
+        if (h > 0.0) elements.inclination = std::acos(std::max(-1.0, std::min(1.0, hz / h)));
+    }
+    return elements;
+}
+
+#endif
@@ -0,0 +1,188 @@
+/**
+ * @file OutOfCore.hpp
+ * @brief Simulation hors mémoire : corps dans un fichier projeté (mmap), tuiles lues en flux
+ * @author P-Pix
+ * @date 2025
+ *
+ * Format du fichier (petit-boutiste, relu par open()) :
+ *   - en-tête OutOfCoreHeader, seul sur sa page ;
+ *   - tileCount tuiles de tileBodies corps, espacées de tileStride octets
+ *     (multiple de la page) ; la dernière tuile peut être incomplète.
+ * Chaque tuile range ses corps par colonne : positions (D colonnes), vitesses
+ * (D), accélérations (D), masses, rayons.
+ *
+ * Seuls un bloc de cibles, une tuile de sources et la fenêtre de lecture
+ * anticipée sont résidents : la mémoire du processus reste sous le budget
+ * quel que soit N. Le cache de pages du noyau n'est pas compté ; il est
+ * libéré tuile par tuile (MADV_DONTNEED) et réécrit sur le disque au besoin.
+ */
+
+#ifndef OUT_OF_CORE_HPP
+#define OUT_OF_CORE_HPP
+
+#include "Simulation.hpp"
+#include "ForceLaw.hpp"
+#include "BodyArrays.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class TaskScheduler;
+
+/**
+ * @struct OutOfCoreHeader
+ */
+struct OutOfCoreHeader {
+    char magic[8];                  ///< "NCORPSTL"
+    uint32_t dimension;             ///< 2 ou 3
+    uint32_t accelerationsCurrent;  ///< 1 si les accélérations du fichier suivent les positions (leapfrog)
+    uint64_t bodyCount;
+    uint64_t tileBodies;            ///< Corps par tuile
+    uint64_t tileStride;            ///< Octets entre deux tuiles
+    uint64_t tileOffset;            ///< Position de la première tuile
+    uint64_t stepCount;
+};
+
+/**
+ * @struct OutOfCoreStats
+ * @brief Volumes lus et écrits dans le fichier, temps passé à les déplacer et temps total des pas
+ */
+struct OutOfCoreStats {
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+    double ioSeconds;       ///< Copies depuis et vers le fichier, passes d'intégration comprises
+    double stepSeconds;
+    uint64_t steps;
+
+    OutOfCoreStats() : bytesRead(0), bytesWritten(0), ioSeconds(0.0), stepSeconds(0.0), steps(0) {}
+
+    /**
+     * @brief Débit atteint pendant les transferts, en octets par seconde
+     */
+    double getThroughput() const { return ioSeconds > 0.0 ? (bytesRead + bytesWritten) / ioSeconds : 0.0; }
+};
+
+/**
+ * @class OutOfCoreSimulationT
+ * @brief Sommation directe par blocs sur des corps stockés dans un fichier
+ *
+ * Reprend les paramètres et les méthodes de SimulationT (construction,
+ * step(), intégrateur, computeEnergy(), computeStateHash()) : le même état
+ * initial donne la même trajectoire aux arrondis de sommation près. Les
+ * accélérations sont calculées par blocs de cibles tenant dans le budget ;
+ * pour chaque bloc, les autres tuiles défilent une à une, la suivante
+ * annoncée au noyau (MADV_WILLNEED) pendant le calcul de la courante.
+ * Gravité seule : ni traceurs, ni contact, ni paires régularisées.
+ */
+template <int D>
+class OutOfCoreSimulationT {
+public:
+    typedef BodyT<D> BodyType;
+    typedef Vector<D> VectorType;
+
+    static const size_t DEFAULT_TILE_BODIES = 4096;
+
+private:
+    double gravitationalConstant;
+    double timeStep;
+    ForceLaw forceLaw;
+    double softening;
+    ForceKernels kernels;
+    Integrator integrator;
+    TaskScheduler* scheduler;
+
+    int descriptor;
+    char* data;
+    size_t mappedBytes;
+    OutOfCoreHeader* header;        // Dans la projection : tenu à jour à chaque pas
+    size_t budgetBytes;
+    size_t blockTiles;              // Tuiles de cibles par bloc
+
+    BodyArrays block;
+    BodyArrays tile;
+    OutOfCoreStats stats;
+    std::string lastError;
+
+    bool map(const std::string& path, size_t bytes, bool create);
+    bool planBlocks(size_t budget, size_t tileBodies, size_t tileStride, size_t tileCount);
+    double* column(size_t tileIndex, int index) const;
+    size_t bodiesIn(size_t tileIndex) const;
+    void prefetch(size_t tileIndex) const;
+    void release(size_t tileIndex) const;
+    size_t copySources(size_t first, size_t last, BodyArrays& arrays, bool accelerations) const;
+    void loadTiles(size_t first, size_t last, BodyArrays& arrays, bool accelerations);
+    void storeAccelerations(size_t first, size_t last, const BodyArrays& arrays);
+    void computeForces();
+    template <typename Function>
+    void streamTiles(int readColumns, int writeColumns, Function function);
+
+public:
+    OutOfCoreSimulationT(double G = 1.0, double dt = 0.01, ForceLaw law = ForceLaw::Clamped, double softeningLength = 0.0);
+    ~OutOfCoreSimulationT();
+
+    OutOfCoreSimulationT(const OutOfCoreSimulationT&) = delete;
+    OutOfCoreSimulationT& operator=(const OutOfCoreSimulationT&) = delete;
+
+    /**
+     * @brief Écrit les corps de initial dans un nouveau fichier et le projette
+     * @param budget Octets résidents au plus : blocs de cibles, tuile de sources, lecture anticipée
+     */
+    bool create(const std::string& path, const SimulationT<D>& initial, size_t budget,
+                size_t tileBodies = DEFAULT_TILE_BODIES);
+
+    /**
+     * @brief Reprend un fichier existant là où le dernier pas l'a laissé
+     */
+    bool open(const std::string& path, size_t budget);
+    void close();
+
+    /**
+     * @brief Remplace les corps de simulation par ceux du fichier (accélérations comprises)
+     */
+    bool exportTo(SimulationT<D>& simulation) const;
+
+    void step();
+
+    void setTaskScheduler(TaskScheduler* taskScheduler) { scheduler = taskScheduler; }
+    void setIntegrator(Integrator scheme);
+    Integrator getIntegrator() const { return integrator; }
+
+    /**
+     * @brief Même définition que SimulationT::computeEnergy, paires parcourues par tuiles
+     */
+    double computeEnergy() const;
+
+    /**
+     * @brief Même empreinte que SimulationT::computeStateHash pour le même état
+     */
+    uint64_t computeStateHash() const;
+
+    const OutOfCoreStats& getStats() const { return stats; }
+    void resetStats() { stats = OutOfCoreStats(); }
+
+    /**
+     * @brief Mémoire résidente prévue pour les blocs retenus (au plus le budget)
+     */
+    size_t getResidentBytes() const;
+    size_t getBudget() const { return budgetBytes; }
+    size_t getBlockTiles() const { return blockTiles; }
+    size_t getTileBodies() const { return header ? header->tileBodies : 0; }
+    size_t getTileCount() const;
+    size_t getFileSize() const { return mappedBytes; }
+
+    bool isOpen() const { return header != nullptr; }
+    size_t getBodyCount() const { return header ? header->bodyCount : 0; }
+    uint64_t getStepCount() const { return header ? header->stepCount : 0; }
+    double getGravitationalConstant() const { return gravitationalConstant; }
+    double getTimeStep() const { return timeStep; }
+    ForceLaw getForceLaw() const { return forceLaw; }
+    double getSoftening() const { return softening; }
+    const std::string& getError() const { return lastError; }
+
+    static int getDimension() { return D; }
+};
+
+typedef OutOfCoreSimulationT<2> OutOfCoreSimulation;
+typedef OutOfCoreSimulationT<3> OutOfCoreSimulation3D;
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * @file PerfCounters.hpp
+ * @brief Compteurs matériels (perf_event_open) attribués aux phases de Simulation::step()
+ * @author P-Pix
+ * @date 2025
+ *
+ * Module optionnel, Linux uniquement : ailleurs, ou si le noyau refuse
+ * l'accès (perf_event_paranoid, conteneur, VM), isAvailable() renvoie false
+ * et les mesures restent vides sans interrompre la simulation.
+ */
+
+#ifndef PERF_COUNTERS_HPP
+#define PERF_COUNTERS_HPP
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+class TaskScheduler;
+
+/**
+ * @struct CounterSample
+ * @brief Valeurs des compteurs (cumulées sur tous les threads suivis)
+ */
+struct CounterSample {
+    enum Counter { CYCLES, INSTRUCTIONS, CACHE_MISSES, BRANCH_MISSES, COUNTER_COUNT };
+
+    uint64_t values[COUNTER_COUNT];
+    bool valid[COUNTER_COUNT];      ///< Faux si le compteur n'a pas pu être ouvert
+
+    CounterSample();
+
+    CounterSample operator-(const CounterSample& other) const;
+    CounterSample& operator+=(const CounterSample& other);
+
+    double instructionsPerCycle() const;
+};
+
+/**
+ * @struct PhaseCounters
+ * @brief Compteurs accumulés par phase de Simulation::step()
+ */
+struct PhaseCounters {
+    CounterSample forces;           ///< calculateForces()
+    CounterSample integration;      ///< updateBodies()
+    uint64_t interactions;          ///< Paires évaluées pendant les phases mesurées
+    uint64_t steps;
+
+    PhaseCounters() : interactions(0), steps(0) {}
+};
+
+/**
+ * @class PerfCounters
+ * @brief Un groupe de compteurs perf_event par thread suivi
+ *
+ * Chaque groupe (cycles en meneur, puis instructions, défauts de cache et
+ * mauvaises prédictions) est lu en une seule lecture. Les phases de step()
+ * se terminent par une barrière fork-join, la somme des groupes lue avant et
+ * après une phase lui est donc entièrement attribuable.
+ */
+class PerfCounters {
+private:
+    struct Group {
+        int tid;
+        int fds[CounterSample::COUNTER_COUNT];
+    };
+
+    std::vector<Group> groups;
+    std::string lastError;
+
+    bool openGroup(int tid);
+
+public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * @brief Suit le thread appelant
+     */
+    bool attachCurrentThread();
+
+    /**
+     * @brief Suit le thread appelant et tous les workers de l'ordonnanceur
+     */
+    bool attachScheduler(TaskScheduler& scheduler);
+
+    bool isAvailable() const { return !groups.empty(); }
+    const std::string& getError() const { return lastError; }
+
+    /**
+     * @brief Somme courante des compteurs de tous les groupes
+     */
+    CounterSample read() const;
+
+    /**
+     * @brief Affiche IPC et défauts par interaction pour une phase
+     */
+    static void printPhase(std::ostream& out, const char* phase, const CounterSample& sample, uint64_t interactions);
+
+    /**
+     * @brief Rapport complet : phases de force et d'intégration, pas par seconde
+     */
+    static void printReport(std::ostream& out, const PhaseCounters& counters, double stepsPerSecond);
+};
+
+#endif
@@ -0,0 +1,100 @@
+/**
+ * @file Profiler.hpp
+ * @brief Chronomètres par phase et export au format Chrome trace-event
+ * @author P-Pix
+ * @date 2025
+ *
+ * Les macros PROFILE_SCOPE ne génèrent du code que si NBODY_PROFILING est
+ * défini (make PROFILE=1) ; sinon elles disparaissent complètement.
+ */
+
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+/**
+ * @struct ProfileEvent
+ * @brief Intervalle mesuré, en nanosecondes depuis le démarrage du profileur
+ */
+struct ProfileEvent {
+    const char* name;
+    uint64_t start;
+    uint64_t duration;
+};
+
+/**
+ * @class Profiler
+ * @brief Collecte les intervalles dans un tampon circulaire par thread
+ *
+ * Chaque thread écrit uniquement dans son propre tampon, sans verrou ; seul
+ * l'enregistrement du thread (premier événement) prend un mutex. Les exports
+ * doivent être faits une fois les threads au repos (fin de run).
+ */
+class Profiler {
+public:
+    static const size_t BUFFER_CAPACITY = 1 << 16; ///< Événements conservés par thread
+
+    /**
+     * @brief Horloge monotone en nanosecondes depuis le démarrage du programme
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Enregistre un intervalle pour le thread courant
+     */
+    static void record(const char* name, uint64_t start, uint64_t end);
+
+    /**
+     * @brief Écrit tous les événements au format JSON trace-event (chrome://tracing, Perfetto)
+     * @return false si le fichier n'a pas pu être écrit
+     */
+    static bool writeChromeTrace(const std::string& path);
+
+    /**
+     * @brief Affiche le temps total, le nombre d'appels et la moyenne par phase
+     */
+    static void printSummary(std::ostream& out);
+
+    /**
+     * @brief Vide tous les tampons
+     */
+    static void reset();
+
+    /**
+     * @brief Indique si le profilage est compilé dans ce binaire
+     */
+    static bool isCompiledIn();
+};
+
+/**
+ * @class ProfileScope
+ * @brief Mesure la durée de vie de l'objet (RAII)
+ */
+class ProfileScope {
+private:
+    const char* name;
+    uint64_t start;
+
+public:
+    explicit ProfileScope(const char* scopeName) : name(scopeName), start(Profiler::now()) {}
+    ~ProfileScope() { Profiler::record(name, start, Profiler::now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef NBODY_PROFILING
+#define PROFILE_SCOPE(name) ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+#define PROFILE_SCOPE(name) do {} while (0)
+#endif
+
+#endif
@@ -0,0 +1,88 @@
+/**
+ * @file Regularization.hpp
+ * @brief Mouvement relatif d'une paire serrée en variables de Kustaanheimo-Stiefel
+ * @author P-Pix
+ * @date 2025
+ *
+ * La position relative x (3 composantes, z = 0 en 2D) s'écrit x = L(u) u avec
+ * u dans R⁴, et le temps physique avance de dt = r ds. Le problème de Kepler
+ * devient alors un oscillateur harmonique de pulsation sqrt(-h/2), où h est
+ * l'énergie de la paire par unité de masse réduite :
+ *
+ *   u'' = (h/2) u + (r/2) Lᵀ(u) P
+ *
+ * P = T x est l'accélération extérieure relative, donnée par le tenseur de
+ * marée T des autres corps au centre de masse.
+ * Il n'y a plus de singularité en r = 0 et le pas en s suit naturellement le
+ * péricentre. En 2D, u₃ = u₄ = 0 à tout instant : c'est exactement la
+ * transformation de Levi-Civita.
+ *
+ * T est constant sur un pas global, mais P suit la rotation de la paire.
+ * Chaque sous-pas est un schéma de Strang : demi-impulsion de P, oscillateur
+ * résolu exactement (temps compris), demi-impulsion. Sans perturbation,
+ * l'orbite est donc exacte quel que soit le pas.
+ */
+
+#ifndef REGULARIZATION_HPP
+#define REGULARIZATION_HPP
+
+/**
+ * @class RegularizedPair
+ * @brief État KS (u, u', h) d'une paire liée, avancé en temps physique
+ */
+class RegularizedPair {
+public:
+    // Sous-pas par orbite de Kepler (une demi-période de l'oscillateur)
+    static const int SUBSTEPS_PER_ORBIT = 64;
+
+private:
+    double u[4];
+    double velocity[4];     // u' = du/ds
+    double energy;          // h = (2|u'|² - μ) / r
+    double mu;              // G (m₁ + m₂)
+    long long substeps;
+
+    struct Oscillator {
+        double c, s, ds;            // u(Δ) = c u + s u', u'(Δ) = ds u + c u'
+        double icc, ics, iss;       // Intégrales de c², c s et s² sur [0, Δ]
+    };
+
+    void oscillator(double delta, Oscillator& k) const;
+    double elapsed(double delta) const;
+    void drift(double delta);
+    void kick(double delta, const double tide[3][3]);
+    double solveTime(double time) const;
+
+public:
+    RegularizedPair();
+
+    /**
+     * @brief Initialise à partir de la position et de la vitesse relatives (second - premier)
+     */
+    void initialize(const double x[3], const double v[3], double gravitationalParameter);
+
+    /**
+     * @brief Avance de dt en temps physique sous le tenseur de marée tide (constant sur le pas)
+     */
+    void advance(double dt, const double tide[3][3]);
+
+    void relativeState(double x[3], double v[3]) const;
+
+    /**
+     * @brief Rapport de la marée à l'attraction mutuelle, |T x| r² / μ
+     */
+    double getPerturbation(const double tide[3][3]) const;
+
+    double getSeparation() const { return u[0] * u[0] + u[1] * u[1] + u[2] * u[2] + u[3] * u[3]; }
+    double getEnergy() const { return energy; }
+    double getGravitationalParameter() const { return mu; }
+    long long getSubstepCount() const { return substeps; }
+
+    /**
+     * @brief Péricentre et apocentre de l'orbite osculatrice ; false si la paire n'est pas liée
+     */
+    static bool orbit(const double x[3], const double v[3], double gravitationalParameter,
+                      double& pericenter, double& apocenter);
+};
+
+#endif
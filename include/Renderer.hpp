@@ -2,10 +2,13 @@
 #define RENDERER_HPP
 
 #include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
 #include <vector>
 #include <memory>
+#include <string>
 #include "Body.hpp"
 #include "Simulation.hpp"
+#include "Trajectory.hpp"
 
 struct Color {
     Uint8 r, g, b, a;
@@ -23,12 +26,30 @@ private:
     // Camera
     Vector2D cameraOffset;
     double zoomLevel;
+    double cameraDistance;  // Distance de l'œil au plan z = 0 (projection perspective en 3D)
     
-    // Trails
+    // Trails (z = 0 en 2D)
     bool showTrails;
-    std::vector<std::vector<Vector2D>> trails;
+    std::vector<std::vector<Vector3D>> trails;
     int maxTrailLength;
     
+    // Ordre de dessin (du plus lointain au plus proche en 3D)
+    std::vector<size_t> drawOrder;
+    
+    // Copie de l'état d'une simulation vivante, présentée comme une image enregistrée
+    std::vector<double> stagedPositions;
+    std::vector<double> stagedMass;
+    std::vector<double> stagedRadius;
+    
+    // Corps sélectionné, entouré et dont la traînée ressort
+    size_t highlightedBody;
+    
+    // Police des panneaux de texte ; sans elle, les panneaux ne sont pas dessinés
+    TTF_Font* font;
+    bool ttfStarted;
+    
+    void renderDisc(const Vector2D& screenPos, int radius, Color color);
+    
 public:
     Renderer(int width, int height, const char* title);
     ~Renderer();
@@ -40,25 +61,57 @@ public:
     // Rendering
     void clear(Color color = Color(0, 0, 0, 255));
     void present();
-    void renderSimulation(const Simulation& simulation);
+    template <int D>
+    void renderSimulation(const SimulationT<D>& simulation);
+    
+    /**
+     * @brief Copie l'état d'une simulation dans un tampon du Renderer, valable jusqu'au prochain appel
+     */
+    template <int D>
+    FrameView stageFrame(const SimulationT<D>& simulation);
+    
+    /**
+     * @brief Dessine une image (simulation vivante ou trajectoire relue) sans toucher à la physique
+     */
+    void renderFrame(const FrameView& frame);
     void renderBody(const Body& body, Color color = Color(255, 255, 255, 255));
+    void renderBody(const Body3D& body, Color color = Color(255, 255, 255, 255));
     void renderTrails();
     
+    /**
+     * @brief Lignes de texte (UTF-8) sur un fond semi-transparent, coin haut gauche en (x, y)
+     */
+    void renderTextPanel(const std::vector<std::string>& lines, int x, int y);
+    
     // Utility
     void fillCircle(int centerX, int centerY, int radius, Color color);
     void drawCircle(int centerX, int centerY, int radius, Color color);
     
     // Camera controls
     void setCamera(Vector2D offset, double zoom);
+    void setCameraDistance(double distance) { cameraDistance = distance; }
+    Vector2D getCameraOffset() const { return cameraOffset; }
+    double getZoom() const { return zoomLevel; }
     Vector2D worldToScreen(const Vector2D& worldPos) const;
+    Vector2D worldToScreen(const Vector3D& worldPos) const;
     Vector2D screenToWorld(const Vector2D& screenPos) const;
     
+    /**
+     * @brief Grandissement à la profondeur z : zoomLevel dans le plan z = 0, 0 derrière la caméra
+     */
+    double perspectiveScale(double z) const;
+    
     // Trail management
-    void updateTrails(const Simulation& simulation);
+    template <int D>
+    void updateTrails(const SimulationT<D>& simulation);
+    void updateTrails(const FrameView& frame);
     void clearTrails();
     void setShowTrails(bool show) { showTrails = show; }
     void setMaxTrailLength(int length) { maxTrailLength = length; }
     
+    // Sélection : indice du corps mis en évidence, (size_t)-1 pour aucun
+    void setHighlightedBody(size_t index) { highlightedBody = index; }
+    
     // Getters
     int getWidth() const { return windowWidth; }
     int getHeight() const { return windowHeight; }
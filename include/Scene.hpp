@@ -0,0 +1,200 @@
+/**
+ * @file Scene.hpp
+ * @brief Fichier de scène : paramètres de simulation et conditions initiales des corps
+ * @author P-Pix
+ * @date 2025
+ *
+ * En-tête texte, une clé et sa valeur par ligne (# pour un commentaire) :
+ *
+ *   nbody-scene 1
+ *   dimension 2
+ *   G 50
+ *   dt 0.01
+ *   integrator leapfrog
+ *   law plummer
+ *   softening 0.5
+ *   contact 0
+ *   freeze 0              (distance de gel des traceurs, 0 = jamais)
+ *   binaries 0            (rayon des paires régularisées, 0 = aucune)
+ *   solver tree theta=0.5 leaf=16 threads=pool
+ *                         (pairwise, blocked tile=T, tree theta=t leaf=L, comme
+ *                          SolverConfig::describe() ; auto : calibré au premier pas)
+ *   bodies 3              (facultatif : nombre vérifié au chargement)
+ *   data csv              (ou : data binary, data csv corps.csv, data binary corps.bin)
+ *
+ * La table des corps suit la ligne data, ou se trouve dans le fichier nommé
+ * (chemin relatif au fichier de scène) :
+ *   - csv : une ligne par corps, x,y[,z],vx,vy[,vz],masse[,rayon] (rayon 5 par
+ *     défaut) ; une première ligne de noms de colonnes est ignorée ; une masse
+ *     nulle fait du corps un traceur ;
+ *   - binary : doubles petit-boutistes, position, vitesse, masse, rayon par corps.
+ */
+
+#ifndef SCENE_HPP
+#define SCENE_HPP
+
+#include "Coroutine.hpp"
+#include "Simulation.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class TaskScheduler;
+
+/**
+ * @struct SceneSettings
+ * @brief Paramètres lus dans l'en-tête ; valeurs par défaut de SimulationT
+ */
+struct SceneSettings {
+    int dimension;
+    double gravitationalConstant;
+    double timeStep;
+    Integrator integrator;
+    ForceLaw forceLaw;
+    double softening;
+    double contactStiffness;
+    double freezeDistance;
+    double binaryRadius;
+    SolverConfig solver;
+    bool autotune;
+
+    SceneSettings()
+        : dimension(2), gravitationalConstant(1.0), timeStep(0.01), integrator(Integrator::Euler),
+          forceLaw(ForceLaw::Clamped), softening(0.0), contactStiffness(0.0), freezeDistance(0.0),
+          binaryRadius(0.0), autotune(false) {}
+
+    /**
+     * @brief Simulation vide construite avec ces paramètres (D doit valoir dimension)
+     */
+    template <int D>
+    void configure(std::unique_ptr<SimulationT<D>>& simulation) const {
+        simulation.reset(new SimulationT<D>(gravitationalConstant, timeStep, forceLaw, softening));
+        simulation->setIntegrator(integrator);
+        simulation->setContactStiffness(contactStiffness);
+        simulation->setFreezeDistance(freezeDistance);
+        simulation->setBinaryRadius(binaryRadius);
+        simulation->setSolver(solver);
+        simulation->setAutotuning(autotune);
+    }
+};
+
+/**
+ * @class SceneLoader
+ * @brief Lecture en flux d'un fichier de scène projeté en mémoire (mmap)
+ *
+ * open() ne lit que l'en-tête. load() découpe la table en blocs d'environ
+ * CHUNK_BYTES alignés sur les fins de ligne et les analyse en parallèle :
+ * une passe compte les corps de chaque bloc, une seconde construit chaque
+ * corps directement à sa place finale. Aucune table intermédiaire n'est
+ * allouée ; la mémoire de pointe est celle des corps.
+ */
+class SceneLoader {
+public:
+    static const size_t CHUNK_BYTES = 4 << 20;
+
+private:
+    struct Mapping {
+        int descriptor;
+        const char* data;
+        size_t size;
+
+        Mapping() : descriptor(-1), data(nullptr), size(0) {}
+    };
+
+    std::string path;
+    std::string tablePath;
+    Mapping scene;
+    Mapping external;
+    SceneSettings settings;
+    bool binary;
+    size_t declaredBodies;      // (size_t)-1 si non déclaré
+    const char* table;
+    size_t tableSize;
+    size_t tableFirstLine;      // Numéro de la première ligne de la table (messages d'erreur)
+    std::string lastError;
+
+    bool map(const std::string& file, Mapping& mapping);
+    void unmap(Mapping& mapping);
+    bool parseHeader();
+
+    template <int D>
+    bool loadCsv(std::vector<std::unique_ptr<BodyT<D>>>& bodies, TaskScheduler* scheduler);
+    template <int D>
+    bool loadBinary(std::vector<std::unique_ptr<BodyT<D>>>& bodies, TaskScheduler* scheduler);
+
+public:
+    SceneLoader();
+    ~SceneLoader();
+
+    SceneLoader(const SceneLoader&) = delete;
+    SceneLoader& operator=(const SceneLoader&) = delete;
+
+    /**
+     * @brief Projette le fichier et lit l'en-tête (paramètres disponibles via getSettings())
+     */
+    bool open(const std::string& scenePath);
+    void close();
+
+    /**
+     * @brief Remplace les corps de simulation par ceux de la table
+     * @param scheduler Threads d'analyse ; nullptr : pool temporaire au-delà d'un bloc
+     */
+    template <int D>
+    bool load(SimulationT<D>& simulation, TaskScheduler* scheduler = nullptr);
+
+    const SceneSettings& getSettings() const { return settings; }
+    bool isBinary() const { return binary; }
+    const std::string& getError() const { return lastError; }
+};
+
+/**
+ * @struct SceneSnapshot
+ * @brief Copie de l'état d'une simulation, écrite ensuite sans la toucher (point de reprise)
+ */
+struct SceneSnapshot {
+    SceneSettings settings;
+    std::vector<double> values;     ///< Par corps : position, vitesse, masse, rayon (2 × dimension + 2 doubles)
+    size_t bodyCount;
+
+    SceneSnapshot() : bodyCount(0) {}
+
+    /**
+     * @brief Copie les paramètres et les corps : seul ce moment interrompt la simulation
+     */
+    template <int D>
+    static SceneSnapshot capture(const SimulationT<D>& simulation);
+};
+
+/**
+ * @class SceneWriter
+ * @brief Écrit l'état courant d'une simulation au format de scène (table incluse)
+ */
+class SceneWriter {
+private:
+    std::string lastError;
+
+    // durable : données sur disque (fsync) avant le retour, pour un renommage atomique
+    bool writeFile(const std::string& path, const SceneSnapshot& snapshot, bool binary, bool durable);
+
+public:
+    template <int D>
+    bool write(const std::string& path, const SimulationT<D>& simulation, bool binary = false);
+
+    bool write(const std::string& path, const SceneSnapshot& snapshot, bool binary = false);
+
+    /**
+     * @brief Écrit snapshot sur le thread d'executor, dans path.tmp renommé en path une fois complet
+     *
+     * Un point de reprise interrompu ne remplace donc jamais le précédent :
+     * path.tmp est synchronisé (fsync) avant le renommage, et le répertoire
+     * après lui, si bien qu'une coupure de courant laisse l'ancien fichier ou
+     * le nouveau complet. Le SceneWriter doit vivre jusqu'à la fin de la
+     * tâche (getError()).
+     */
+    AsyncTask<bool> writeAsync(CoroutineExecutor& executor, std::string path, SceneSnapshot snapshot,
+                               bool binary = false);
+
+    const std::string& getError() const { return lastError; }
+};
+
+#endif
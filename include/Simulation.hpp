@@ -1,38 +1,482 @@
 #ifndef SIMULATION_HPP
 #define SIMULATION_HPP
 
+#include "BarnesHut.hpp"
 #include "Body.hpp"
+#include "BodyArrays.hpp"
+#include "ForceLaw.hpp"
+#include "ForceSolver.hpp"
+#include "NeighborList.hpp"
+#include "Numa.hpp"
+#include "PerfCounters.hpp"
+#include "Regularization.hpp"
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <vector>
 #include <memory>
+#include <string>
 
-class Simulation {
+class TaskScheduler;
+class TaskGroup;
+struct TelemetryMetrics;
+
+/**
+ * @struct StateHash
+ * @brief Empreinte de l'état relevée après un pas donné
+ */
+struct StateHash {
+    uint64_t step;
+    uint64_t hash;
+};
+
+/**
+ * @enum Integrator
+ * @brief Schéma d'intégration en temps
+ */
+enum class Integrator {
+    Euler,      ///< Euler symplectique (Body::update), comportement historique
+    Leapfrog    ///< Kick-drift-kick, second ordre, réversible
+};
+
+inline const char* integratorName(Integrator integrator) {
+    return integrator == Integrator::Leapfrog ? "leapfrog" : "euler";
+}
+
+inline bool parseIntegrator(const std::string& name, Integrator& integrator) {
+    if (name == "euler") integrator = Integrator::Euler;
+    else if (name == "leapfrog") integrator = Integrator::Leapfrog;
+    else return false;
+    return true;
+}
+
+/**
+ * @brief Simulation en dimension D ; instanciée pour D = 2 (Simulation) et D = 3 (Simulation3D)
+ */
+template <int D>
+class SimulationT {
+public:
+    typedef Vector<D> VectorType;
+    typedef BodyT<D> BodyType;
+    
 private:
-    std::vector<std::unique_ptr<Body>> bodies;
+    std::vector<std::unique_ptr<BodyType>> bodies;
     double gravitationalConstant;
     double timeStep;
     
+    // Loi de force, figée à la construction
+    ForceLaw forceLaw;
+    double softening;
+    ForceKernels kernels;
+    BodyArrays arrays;
+    
+    // Intégration : le leapfrog réutilise les accélérations du pas précédent
+    Integrator integrator;
+    bool accelerationsCurrent;
+    
+    // Totaux tenus à jour à l'ajout et à chaque pas, sans parcours des corps :
+    // Σ m v avance de dt * Σ m a, Σ m x de dt * Σ m v. Σ m a n'est pas nul
+    // hors d'une somme exactement antisymétrique (arbre, contacts, arrondis)
+    double totalMass;
+    VectorType momentum;
+    VectorType massMoment;
+    VectorType netForce;        // Σ m a des sources au dernier calcul des forces
+    
+    // Graine des préréglages aléatoires (sinon std::random_device)
+    bool seeded;
+    uint32_t randomSeed;
+    
+    // Mode reproductible et empreintes périodiques (0 = aucune)
+    bool reproducible;
+    uint64_t stepCount;
+    uint64_t hashInterval;
+    std::vector<StateHash> stateHashes;
+    
+    // Sources massives et traceurs, reclassés à chaque calcul des forces (indices dans bodies)
+    std::vector<uint32_t> sourceIndices;
+    std::vector<uint32_t> activeTracers;
+    BodyArrays tracerArrays;
+    std::vector<double> nearestSource2;
+    
+    // Gel des traceurs loin de toute source (0 = désactivé). freezeSlack borne
+    // le chemin que sources et traceur peuvent encore parcourir avant qu'une
+    // source n'entre dans le rayon ; il est décrémenté du trajet accumulé
+    // depuis le dernier calcul des forces.
+    double freezeDistance;
+    std::vector<double> freezeSlack;
+    double pendingSourceTravel;
+    double pendingTime;
+    size_t frozenCount;
+    
+    // Paires liées serrées : le reste du système ne voit que leur centre de
+    // masse (une ligne de arrays), leur mouvement relatif est régularisé
+    struct Binary {
+        uint32_t first, second;
+        RegularizedPair motion;
+        double tide[3][3];          // Tenseur de marée au centre de masse, au dernier calcul des forces
+        uint32_t row;
+    };
+    std::vector<Binary> binaries;
+    std::vector<int32_t> binaryOf;          // Indice dans binaries par corps, -1 hors paire
+    std::vector<uint32_t> sourceRows;       // Corps de chaque ligne de arrays (premier membre d'une paire)
+    std::vector<uint64_t> binaryRetry;      // Pas avant lequel un corps ne peut reformer de paire
+    double binaryRadius;
+    double binaryPerturbationLimit;
+    NeighborList binaryCandidates;
+    BodyArrays candidateArrays;
+    
+    // Contact mou à courte portée (0 = désactivé), sur liste de Verlet
+    double contactStiffness;
+    double neighborSkin;  // < 0 : fraction de la coupure (CONTACT_SKIN_RATIO)
+    NeighborList neighborList;
+    
+    // Parallélisme (optionnel, non possédé)
+    TaskScheduler* scheduler;
+    
+    // Placement NUMA de arrays, refait quand sa capacité change
+    MemoryPlacement placement;
+    size_t placedCapacity;
+    
+    // Solveur de forces (défaut : boucle d'origine), choisi à la main ou
+    // calibré sur les corps courants ; tunedKey est la situation calibrée
+    SolverConfig solver;
+    BarnesHutTreeT<D> tree;
+    
+    // L'arbre dure d'un calcul à l'autre : réajusté en O(N), reconstruit quand le
+    // chevauchement de ses feuilles ou le coût de son parcours dépasse
+    // treeRebuildRatio fois sa valeur à la dernière construction
+    double treeRebuildRatio;
+    bool treeValid;             // Topologie réutilisable : les corps n'ont pas changé
+    bool treeForcePass;         // Arbre tiré des sources du calcul des forces en cours
+    uint64_t treeBuilds;
+    uint64_t treeRefits;
+    uint64_t treeWalkBaseline;  // Interactions du premier parcours après construction (0 = à mesurer)
+    uint64_t treeWalkLast;
+    double treeWalkAngle;
+    
+    // Requêtes de voisinage : lignes du calcul des forces (premier membre d'une paire) aux positions du pas courant
+    std::vector<uint32_t> treeRows;
+    BodyArrays treeArrays;
+    uint64_t treeQueryStep;
+    bool treeQueryCurrent;
+    
+    bool autotuning;
+    double forceAccuracy;
+    std::string solverCachePath;
+    std::string tunedKey;
+    bool solverStale;
+    uint64_t forcePasses;
+    std::vector<SolverTiming> calibration;
+    size_t calibrationCount;
+    size_t solverCacheHits;
+    
+    // Mode pipeliné : les blocs de forces intègrent leurs corps, et les
+    // diagnostics lisent une copie figée du pas précédent pendant le suivant
+    enum class FusedUpdate { None, Update, Kick };
+    bool pipelined;
+    std::vector<BodyType> snapshot;
+    uint64_t snapshotStep;
+    uint64_t snapshotHash;
+    bool snapshotHashPending;
+    std::unique_ptr<TaskGroup> overlapped;      // Travaux lancés pendant le pas en cours, attendus à sa fin
+    
+    // Instrumentation (optionnelle, non possédée)
+    PerfCounters* perfCounters;
+    PhaseCounters phaseCounters;
+    uint64_t interactionCount;
+    TelemetryMetrics* telemetry;
+    
+    void stepEuler();
+    void publishTelemetry(uint64_t stepStart);
+    void stepLeapfrog();
+    bool computeForces(FusedUpdate fused);
+    void completeUpdate(double dt);
+    void launchDiagnostics(bool hash, bool energy);
+    bool isOverlapping() const;
+    void clearBodies();
+    void bodiesChanged();
+    void classifyBodies();
+    void placeArrays(bool owned);
+    void tuneSolver(size_t n, bool owned);
+    void maintainTree(const BodyArrays& sources, size_t leafSize);
+    void loadSourceRow(BodyArrays& target, size_t row, uint32_t index) const;
+    uint64_t runSolver(const SolverConfig& config, size_t n, bool owned,
+                       const std::function<void(size_t, size_t)>& afterBlock,
+                       std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max());
+    void calculateTracerForces(FusedUpdate fused);
+    void trackSourceTravel(double dt);
+    void computeBinaryTides();
+    void advanceBinaries(double dt);
+    void updateBinaries();
+    void dissolveBinary(size_t index);
+    bool admitsBinary(const BodyType& first, const BodyType& second) const;
+    
+    // Applique function à chaque corps, en parallèle au-delà d'un seuil
+    template <typename Function>
+    void forEachBody(Function function);
+    
+    // Corps pointés (bodies) ou copiés (snapshot)
+    template <typename Container>
+    double energyOf(const Container& container) const;
+    template <typename Container>
+    static uint64_t stateHashOf(const Container& container);
+    
 public:
-    Simulation(double G = 1.0, double dt = 0.01);
-    ~Simulation() = default;
+    SimulationT(double G = 1.0, double dt = 0.01, ForceLaw law = ForceLaw::Clamped, double softeningLength = 0.0);
+    ~SimulationT();
     
     // Body management
-    void addBody(std::unique_ptr<Body> body);
-    void addBody(Vector2D position, Vector2D velocity, double mass, double radius = 5.0);
+    void addBody(std::unique_ptr<BodyType> body);
+    void addBody(VectorType position, VectorType velocity, double mass, double radius = 5.0,
+                 ParticleClass particleClass = ParticleClass::Massive);
+    
+    /**
+     * @brief Change le rôle d'un corps (source ou traceur), totaux recalculés
+     */
+    void setParticleClass(size_t index, ParticleClass particleClass);
+    
+    /**
+     * @brief Les corps de masse inférieure à threshold deviennent des traceurs ; renvoie leur nombre
+     */
+    size_t convertLightBodiesToTracers(double threshold);
+    
+    /**
+     * @brief Remplace tous les corps d'un coup (chargement de scène), totaux recalculés
+     */
+    void replaceBodies(std::vector<std::unique_ptr<BodyType>> newBodies);
     
     // Simulation
     void step();
+    void resetAccelerations();
     void calculateForces();
     void updateBodies();
+    void applyContactForces();
+    
+    // Parallélisme : nullptr pour revenir au calcul séquentiel
+    void setTaskScheduler(TaskScheduler* taskScheduler) { scheduler = taskScheduler; }
+    TaskScheduler* getTaskScheduler() const { return scheduler; }
+    
+    /**
+     * @brief Placement des tableaux de forces sur les nœuds NUMA (défaut : Default)
+     *
+     * FirstTouch, avec un TaskScheduler à plusieurs threads : chaque worker
+     * remplit puis calcule toujours la même tranche de lignes (affinityFor,
+     * sans vol de travail), dont les pages ont été touchées en premier par lui
+     * et sont donc sur son nœud s'il est épinglé. Interleave : pages réparties
+     * sur tous les nœuds. Les trajectoires ne changent pas.
+     */
+    void setMemoryPlacement(MemoryPlacement mode) { placement = mode; placedCapacity = 0; }
+    MemoryPlacement getMemoryPlacement() const { return placement; }
+    
+    /**
+     * @brief Solveur de forces imposé ; désactive la calibration automatique
+     *
+     * La valeur par défaut (Pairwise, tout le pool) est le calcul d'origine,
+     * identique bit à bit. Le mode reproductible garde son propre noyau.
+     */
+    void setSolver(const SolverConfig& config) { solver = config; autotuning = false; }
+    const SolverConfig& getSolver() const { return solver; }
+    
+    /**
+     * @brief Calibration automatique du solveur (défaut : désactivée)
+     *
+     * Au premier calcul des forces, chaque candidat (solverCandidates) fait
+     * un calcul complet sur les corps courants ; le plus rapide dont l'erreur
+     * reste sous la précision demandée est retenu, puis enregistré dans le
+     * cache de la machine. La situation (N, groupement) est revue après tout
+     * changement des corps et tous les 64 calculs : une situation nouvelle
+     * est recalibrée, une situation connue est relue dans le cache.
+     */
+    void setAutotuning(bool enabled) { autotuning = enabled; tunedKey.clear(); }
+    bool isAutotuning() const { return autotuning; }
+    
+    // Erreur relative RMS tolérée sur les accélérations (défaut : 1e-3)
+    void setForceAccuracy(double accuracy) { forceAccuracy = accuracy; tunedKey.clear(); }
+    double getForceAccuracy() const { return forceAccuracy; }
+    
+    // Fichier de cache des calibrations ("" = aucun ; défaut : SolverCache::defaultPath())
+    void setSolverCachePath(const std::string& path) { solverCachePath = path; tunedKey.clear(); }
+    const std::string& getSolverCachePath() const { return solverCachePath; }
+    
+    // Mesures de la dernière calibration, nombre de calibrations et de lectures du cache
+    const std::vector<SolverTiming>& getCalibration() const { return calibration; }
+    size_t getCalibrationCount() const { return calibrationCount; }
+    size_t getSolverCacheHits() const { return solverCacheHits; }
+    
+    /**
+     * @brief Seuil de reconstruction de l'arbre persistant (défaut : 1.05)
+     *
+     * D'un calcul à l'autre, l'arbre garde sa topologie et ne fait que
+     * recalculer boîtes et moments en O(N). Il est trié et redécoupé quand
+     * le chevauchement de ses feuilles (BarnesHutTreeT::getOverlap) ou le
+     * nombre d'interactions du parcours dépasse ratio fois sa valeur juste
+     * après la dernière construction, ou quand les corps changent.
+     * ratio ≤ 1 : reconstruction à chaque calcul.
+     */
+    void setTreeRebuildRatio(double ratio) { treeRebuildRatio = ratio; }
+    double getTreeRebuildRatio() const { return treeRebuildRatio; }
+    uint64_t getTreeBuildCount() const { return treeBuilds; }
+    uint64_t getTreeRefitCount() const { return treeRefits; }
+    
+    /**
+     * @brief Source la plus proche de position, hors le corps exclude ; getBodyCount() s'il n'y en a pas
+     *
+     * Servie par l'arbre persistant, réajusté au plus une fois par pas sur
+     * les positions courantes, avec les lignes du calcul des forces : sans
+     * reconstruction tant que les corps ne changent pas. Une paire régularisée
+     * est cherchée par son centre de masse, puis départagée entre ses deux
+     * membres. Les traceurs, qui ne sont pas dans l'arbre, ne sont candidats
+     * qu'avec includeTracers (parcours linéaire de plus, pour la sélection).
+     */
+    size_t findNearestBody(const VectorType& position, size_t exclude = static_cast<size_t>(-1),
+                           double* distance = nullptr, bool includeTracers = false);
+    
+    /**
+     * @brief Mode pipeliné (défaut : désactivé), utile avec un TaskScheduler à plusieurs threads
+     *
+     * Chaque bloc du calcul des forces intègre ses corps dès que leurs
+     * accélérations sont connues, pendant que les autres blocs sont encore
+     * évalués : ni barrière entre les deux phases ni second passage sur les
+     * corps. Les noyaux ne lisent que la copie SoA faite au début du calcul,
+     * les trajectoires sont donc identiques bit à bit au mode normal (hors
+     * contact mou, qui garde les deux phases). Empreintes et énergie de
+     * télémétrie sont calculées sur une copie de l'état pendant le pas suivant.
+     */
+    void setPipelined(bool enabled);
+    bool isPipelined() const { return pipelined; }
+    
+    /**
+     * @brief Exécute work pendant le prochain pas en mode pipeliné, tout de suite sinon
+     *
+     * work ne doit lire que des copies de l'état (FrameView...) : les corps
+     * changent pendant son exécution. Il est attendu à la fin du pas suivant,
+     * sur le thread qui appelle step().
+     */
+    void overlapNextStep(std::function<void()> work);
+    
+    /**
+     * @brief Attend les travaux et diagnostics en cours ; relance leur première exception
+     */
+    void finishPipeline();
+    
+    // Compteurs matériels échantillonnés autour de calculateForces() et updateBodies()
+    void setPerfCounters(PerfCounters* counters) { perfCounters = counters; }
+    const PhaseCounters& getPhaseCounters() const { return phaseCounters; }
+    void resetPhaseCounters() { phaseCounters = PhaseCounters(); }
+    
+    /**
+     * @brief Publie débit, temps par phase et énergie dans des atomiques lus par un TelemetryServer
+     *
+     * Relève l'énergie tout de suite (référence de la dérive) : à appeler une fois les corps en place.
+     */
+    void setTelemetry(TelemetryMetrics* metrics);
+    
+    /**
+     * @brief Centre de masse en O(1), avancé à chaque pas par la quantité de mouvement totale
+     *
+     * La quantité de mouvement suit elle-même la force totale du dernier
+     * calcul : le centre reste juste avec un solveur approché (arbre).
+     */
+    VectorType getCenterOfMass() const { return totalMass > 0.0 ? massMoment * (1.0 / totalMass) : VectorType(); }
+    VectorType getTotalMomentum() const { return momentum; }
+    double getTotalMass() const { return totalMass; }
+    
+    /**
+     * @brief Recalcule les totaux en O(N) après une modification directe des corps (setVelocity...)
+     */
+    void recomputeCenterOfMass();
+    
+    // Répulsion k * recouvrement entre corps qui se chevauchent ; la liste
+    // de voisins n'est reconstruite que si un corps a bougé de plus de skin/2
+    void setContactStiffness(double k) { contactStiffness = k; }
+    double getContactStiffness() const { return contactStiffness; }
+    /** Peau de la liste de voisins ; négative (défaut), la moitié de la coupure de contact */
+    void setNeighborSkin(double skin) { neighborSkin = skin; neighborList.invalidate(); }
+    const NeighborList& getNeighborList() const { return neighborList; }
+    
+    /**
+     * @brief Gèle les traceurs à plus de distance de toute source (0 = jamais)
+     *
+     * Un traceur gelé n'est plus évalué : accélération nulle, il dérive en
+     * ligne droite. Il est réévalué dès que le trajet cumulé des sources et
+     * le sien pourraient ramener une source à moins de distance.
+     */
+    void setFreezeDistance(double distance) { freezeDistance = distance; freezeSlack.clear(); }
+    double getFreezeDistance() const { return freezeDistance; }
+    
+    // Répartition au dernier calcul des forces
+    size_t getSourceCount() const { return sourceIndices.size(); }
+    size_t getFrozenCount() const { return frozenCount; }
+    
+    /**
+     * @brief Régularise les paires liées dont l'orbite tient dans radius (0 = désactivé)
+     *
+     * Une paire est formée au début d'un pas si son apocentre est inférieur à
+     * radius et que la loi de force y est exactement newtonienne ; elle est
+     * défaite quand la marée des autres corps dépasse la limite de
+     * perturbation (rapport à l'attraction mutuelle, 1e-2 par défaut).
+     */
+    void setBinaryRadius(double radius);
+    double getBinaryRadius() const { return binaryRadius; }
+    void setBinaryPerturbationLimit(double limit) { binaryPerturbationLimit = limit; }
+    size_t getBinaryCount() const { return binaries.size(); }
+    
+    void setIntegrator(Integrator scheme) { integrator = scheme; accelerationsCurrent = false; }
+    Integrator getIntegrator() const { return integrator; }
+    
+    /**
+     * @brief Ordre de sommation des forces fixé (Kahan, j croissant, sans SIMD)
+     *
+     * Les résultats sont identiques bit à bit quel que soit le nombre de threads,
+     * au prix de N(N-1) interactions scalaires au lieu de N(N-1)/2 vectorisées.
+     */
+    void setReproducible(bool enabled) { reproducible = enabled; }
+    bool isReproducible() const { return reproducible; }
+    
+    // Empreinte de l'état tous les interval pas (0 = désactivé) ; en mode
+    // pipeliné, la dernière n'apparaît qu'après le pas suivant ou finishPipeline()
+    void setStateHashInterval(uint64_t interval) { hashInterval = interval; }
+    const std::vector<StateHash>& getStateHashes() const { return stateHashes; }
+    uint64_t getStepCount() const { return stepCount; }
+    
+    // Préréglages aléatoires reproductibles
+    void setRandomSeed(uint32_t seed) { seeded = true; randomSeed = seed; }
+    
+    /**
+     * @brief Énergie cinétique + potentielle des sources (O(S²), pour le suivi de dérive)
+     *
+     * Les traceurs n'exercent aucune force en retour : ils n'entrent ni dans
+     * l'énergie ni dans les totaux (masse, quantité de mouvement).
+     */
+    double computeEnergy() const;
+    
+    /**
+     * @brief Empreinte 64 bits des positions et vitesses, bit à bit
+     */
+    uint64_t computeStateHash() const;
+    
+    // Nombre cumulé de paires évaluées par calculateForces()
+    uint64_t getInteractionCount() const { return interactionCount; }
     
     // Getters
-    const std::vector<std::unique_ptr<Body>>& getBodies() const { return bodies; }
+    double getGravitationalConstant() const { return gravitationalConstant; }
+    double getTimeStep() const { return timeStep; }
+    ForceLaw getForceLaw() const { return forceLaw; }
+    double getSoftening() const { return softening; }
+    const std::vector<std::unique_ptr<BodyType>>& getBodies() const { return bodies; }
     size_t getBodyCount() const { return bodies.size(); }
     
-    // Presets
+    static int getDimension() { return D; }
+    
+    // Presets (en 3D : mêmes scènes, avec une épaisseur hors du plan)
     void setupSolarSystem();
     void setupRandomBodies(int count, double width, double height);
     void setupBinarySystem();
     void setupGalaxyCollision();
+    void setupGalaxyCollision(int starsPerGalaxy);
 };
 
+typedef SimulationT<2> Simulation;
+typedef SimulationT<3> Simulation3D;
+
 #endif
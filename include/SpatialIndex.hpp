@@ -0,0 +1,60 @@
+/**
+ * @file SpatialIndex.hpp
+ * @brief Grille uniforme pour la recherche du corps le plus proche d'un point (sélection à la souris)
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef SPATIAL_INDEX_HPP
+#define SPATIAL_INDEX_HPP
+
+#include "Body.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class SpatialIndex
+ * @brief Points 2D rangés par cellule (tri par comptage, format CSR)
+ *
+ * La construction est en O(N), sans allocation une fois les tableaux à la
+ * bonne taille : elle peut être refaite à chaque image affichée. La taille
+ * des cellules vise deux points par cellule ; nearest() parcourt des anneaux
+ * de cellules autour du point demandé et s'arrête dès qu'aucun anneau plus
+ * lointain ne peut contenir mieux : O(1) en moyenne à densité bornée.
+ */
+class SpatialIndex {
+public:
+    static const size_t NONE = static_cast<size_t>(-1);
+
+private:
+    double originX, originY;
+    double cellSize;
+    int columns, rows;
+
+    std::vector<Vector2D> points;
+    std::vector<uint32_t> cellStart;
+    std::vector<uint32_t> cellItems;
+    std::vector<uint32_t> itemCell;
+
+    int column(double x) const;
+    int row(double y) const;
+
+public:
+    SpatialIndex();
+
+    /**
+     * @brief Reconstruit la grille ; un point non fini (NaN, corps invisible) n'est jamais trouvé
+     */
+    void build(const std::vector<Vector2D>& positions);
+
+    /**
+     * @brief Indice du point le plus proche de query à moins de maxDistance, NONE sinon
+     */
+    size_t nearest(const Vector2D& query, double maxDistance) const;
+
+    size_t size() const { return points.size(); }
+    double getCellSize() const { return cellSize; }
+};
+
+#endif
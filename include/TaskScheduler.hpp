@@ -0,0 +1,265 @@
+/**
+ * @file TaskScheduler.hpp
+ * @brief Ordonnanceur de tâches fork-join à vol de travail (work stealing)
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef TASK_SCHEDULER_HPP
+#define TASK_SCHEDULER_HPP
+
+#include "Numa.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class TaskScheduler;
+class TaskGroup;
+
+/**
+ * @struct Task
+ * @brief Unité de travail soumise à l'ordonnanceur
+ */
+struct Task {
+    std::function<void()> function;   ///< Travail à exécuter
+    TaskGroup* group;                 ///< Groupe à notifier une fois la tâche terminée
+};
+
+/**
+ * @class WorkStealingDeque
+ * @brief File double Chase–Lev : le propriétaire empile/dépile en bas, les voleurs prennent en haut
+ *
+ * Seul le thread propriétaire appelle push() et pop(); steal() peut être
+ * appelé par n'importe quel thread. Le tableau circulaire grandit à la demande,
+ * les anciens tableaux sont conservés jusqu'à la destruction car un voleur
+ * peut encore les lire.
+ */
+class WorkStealingDeque {
+private:
+    struct Array {
+        int64_t capacity;
+        std::unique_ptr<std::atomic<Task*>[]> slots;
+
+        explicit Array(int64_t cap) : capacity(cap), slots(new std::atomic<Task*>[cap]) {}
+        Task* get(int64_t index) const { return slots[index & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t index, Task* task) { slots[index & (capacity - 1)].store(task, std::memory_order_relaxed); }
+    };
+
+    std::atomic<int64_t> top;
+    std::atomic<int64_t> bottom;
+    std::atomic<Array*> array;
+    std::vector<std::unique_ptr<Array>> arrays;
+
+    Array* grow(Array* old, int64_t bottomIndex, int64_t topIndex);
+
+public:
+    explicit WorkStealingDeque(int64_t initialCapacity = 256);
+
+    void push(Task* task);
+    Task* pop();
+    Task* steal();
+    bool empty() const;
+};
+
+/**
+ * @struct WorkerStats
+ * @brief Compteurs de profilage d'un worker
+ */
+struct WorkerStats {
+    uint64_t busyNanoseconds;   ///< Temps passé à exécuter des tâches
+    uint64_t tasksExecuted;     ///< Nombre de tâches exécutées
+    uint64_t steals;            ///< Vols réussis
+    uint64_t stealAttempts;     ///< Tentatives de vol (réussies ou non)
+
+    WorkerStats() : busyNanoseconds(0), tasksExecuted(0), steals(0), stealAttempts(0) {}
+};
+
+/**
+ * @class TaskGroup
+ * @brief Ensemble de tâches fork-join attendues ensemble
+ *
+ * Un groupe créé hors d'un worker fait participer le thread appelant comme
+ * worker 0 pendant toute sa durée de vie : wait() exécute des tâches au lieu
+ * de bloquer.
+ */
+class TaskGroup {
+private:
+    TaskScheduler& scheduler;
+    std::atomic<size_t> pending;
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    bool ownsExternalSlot;
+    TaskScheduler* previousScheduler;
+    unsigned previousWorker;
+
+    friend class TaskScheduler;
+
+public:
+    explicit TaskGroup(TaskScheduler& scheduler);
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Soumet une tâche au groupe
+     */
+    void run(std::function<void()> function);
+
+    /**
+     * @brief Attend la fin de toutes les tâches en aidant à leur exécution
+     *
+     * Relance la première exception levée par une tâche du groupe.
+     */
+    void wait();
+};
+
+/**
+ * @class TaskScheduler
+ * @brief Pool de threads à vol de travail avec une file Chase–Lev par worker
+ *
+ * Les boucles parallèles sont découpées récursivement : un worker inactif vole
+ * la plus grosse moitié restante d'un worker chargé, ce qui équilibre les
+ * charges irrégulières (scènes groupées) mieux qu'un découpage statique.
+ */
+class TaskScheduler {
+private:
+    struct Worker {
+        WorkStealingDeque deque;
+        std::atomic<uint64_t> busyNanoseconds;
+        std::atomic<uint64_t> tasksExecuted;
+        std::atomic<uint64_t> steals;
+        std::atomic<uint64_t> stealAttempts;
+        std::atomic<int> threadId;     // Identifiant noyau (Linux), 0 tant que le thread n'a pas démarré
+        std::atomic<Task*> affine;     // Tâche réservée à ce worker (affinityFor), jamais volée
+        uint32_t randomState;
+        int cpu;                       // Cœur épinglé, -1 sans épinglage
+        int node;                      // Nœud NUMA de ce cœur, -1 sans épinglage
+        char padding[64]; // Évite le faux partage avec l'allocation voisine
+
+        explicit Worker(uint32_t seed)
+            : busyNanoseconds(0), tasksExecuted(0), steals(0), stealAttempts(0), threadId(0), affine(nullptr),
+              randomState(seed), cpu(-1), node(-1) {}
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::vector<std::thread> threads;
+
+    // Le thread externe (non worker) emprunte la place du worker 0
+    std::mutex externalMutex;
+
+    // Mise en sommeil des workers inactifs
+    std::mutex sleepMutex;
+    std::condition_variable sleepCondition;
+    std::atomic<int> sleepers;
+    std::atomic<uint64_t> workEpoch;
+    std::atomic<bool> stopping;
+
+    // Épinglage ; cœurs du thread appelant avant qu'il ne devienne le worker 0
+    PinningPolicy pinning;
+    std::vector<int> callerCpus;
+
+    static thread_local TaskScheduler* currentScheduler;
+    static thread_local unsigned currentWorker;
+
+    void spawn(Task* task);
+    bool executeOne(unsigned self);
+    void execute(Task* task, unsigned self);
+    void workerLoop(unsigned index);
+    void waitFor(TaskGroup& group);
+    void splitRange(TaskGroup& group, size_t begin, size_t end, size_t grain,
+                    const std::function<void(size_t, size_t)>& body);
+
+    friend class TaskGroup;
+
+public:
+    /**
+     * @brief Crée le pool
+     * @param threadCount Nombre total de workers, thread appelant compris (0 = nombre de cœurs)
+     * @param pinning Un cœur par worker ; le thread appelant est épinglé comme worker 0
+     *                jusqu'à la destruction du pool, qui lui rend ses cœurs d'origine
+     */
+    explicit TaskScheduler(unsigned threadCount = 0, PinningPolicy pinning = PinningPolicy::None);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    unsigned getThreadCount() const { return static_cast<unsigned>(workers.size()); }
+    PinningPolicy getPinning() const { return pinning; }
+    int getWorkerCpu(unsigned worker) const { return workers[worker]->cpu; }
+    int getWorkerNode(unsigned worker) const { return workers[worker]->node; }
+
+    /**
+     * @brief Exécute body sur [begin, end) découpé en blocs d'au plus grain éléments, avec vol de travail
+     */
+    void parallelFor(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * @brief Découpage statique en un bloc contigu par worker, sans vol (référence pour les benchmarks)
+     */
+    void staticFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * @brief Même découpage que staticFor, mais le bloc c s'exécute toujours sur le worker c
+     *
+     * Un worker épinglé retrouve ainsi d'un appel à l'autre la même tranche,
+     * dont il a touché les pages en premier : elles sont sur son nœud.
+     * Si la case réservée du worker est déjà prise (appel imbriqué ou depuis
+     * plusieurs threads), le bloc est publié comme une tâche ordinaire et
+     * l'affinité n'est plus garantie pour lui.
+     */
+    void affinityFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body);
+
+    /**
+     * @brief Tri fusion fork-join
+     */
+    template <typename RandomIt, typename Compare>
+    void parallelSort(RandomIt first, RandomIt last, Compare comp, size_t grain = 4096);
+
+    // Profilage
+    std::vector<WorkerStats> getStats() const;
+    void resetStats();
+
+    /**
+     * @brief Identifiants noyau des threads dédiés (workers 1..N-1), pour perf_event_open
+     */
+    std::vector<int> getWorkerThreadIds() const;
+
+    /**
+     * @brief Cœurs autorisés au processus qu'aucun worker épinglé n'occupe
+     *
+     * Pour les threads d'entrées-sorties, qui ne doivent pas préempter le
+     * calcul. Tous les cœurs autorisés si le pool n'est pas épinglé ou les
+     * occupe tous.
+     */
+    std::vector<int> getSpareCpus() const;
+};
+
+template <typename RandomIt, typename Compare>
+void TaskScheduler::parallelSort(RandomIt first, RandomIt last, Compare comp, size_t grain) {
+    size_t count = static_cast<size_t>(last - first);
+    if (count <= grain || workers.size() == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    RandomIt middle = first + count / 2;
+    {
+        TaskGroup group(*this);
+        group.run([this, first, middle, comp, grain]() { parallelSort(first, middle, comp, grain); });
+        parallelSort(middle, last, comp, grain);
+        group.wait();
+    }
+    std::inplace_merge(first, middle, last, comp);
+}
+
+#endif
@@ -0,0 +1,111 @@
+/**
+ * @file Telemetry.hpp
+ * @brief Métriques d'une simulation en cours, servies au format texte Prometheus
+ * @author P-Pix
+ * @date 2025
+ *
+ * La simulation n'écrit que des atomiques (ordre relâché, sans verrou) ; le
+ * serveur les lit depuis son propre thread à chaque requête :
+ *   curl http://127.0.0.1:9100/metrics
+ *   curl --unix-socket /tmp/ncorps.sock http://localhost/metrics
+ */
+
+#ifndef TELEMETRY_HPP
+#define TELEMETRY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+/**
+ * @struct TelemetryMetrics
+ * @brief Compteurs publiés par SimulationT<D>::step() (un seul écrivain)
+ */
+struct TelemetryMetrics {
+    std::atomic<uint64_t> steps;
+    std::atomic<uint64_t> bodies;
+    std::atomic<uint64_t> interactions;
+    std::atomic<uint64_t> stepNanoseconds;     ///< Cumul de step()
+    std::atomic<uint64_t> forceNanoseconds;    ///< Cumul de calculateForces()
+    std::atomic<uint64_t> diagnosticsNanoseconds; ///< Cumul des empreintes et relevés d'énergie de step()
+    std::atomic<double> energy;
+    std::atomic<double> initialEnergy;
+    std::atomic<bool> hasEnergy;
+
+    /// Énergie recalculée tous les energyInterval pas (coût d'un calcul de forces), 0 = jamais
+    uint64_t energyInterval;
+
+    TelemetryMetrics()
+        : steps(0), bodies(0), interactions(0), stepNanoseconds(0), forceNanoseconds(0), diagnosticsNanoseconds(0),
+          energy(0.0), initialEnergy(0.0), hasEnergy(false), energyInterval(100) {}
+
+    /// La première valeur publiée sert de référence à la dérive
+    void recordEnergy(double value) {
+        if (!hasEnergy.load(std::memory_order_relaxed)) {
+            initialEnergy.store(value, std::memory_order_relaxed);
+        }
+        energy.store(value, std::memory_order_relaxed);
+        hasEnergy.store(true, std::memory_order_release);
+    }
+
+    static uint64_t now() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+};
+
+/**
+ * @class TelemetryServer
+ * @brief Mini-serveur HTTP/1.0 sur 127.0.0.1 ou socket Unix, un thread, une requête à la fois
+ *
+ * Répond à GET /metrics (et GET /) ; toute autre requête reçoit 404. Pas de
+ * débit calculé côté serveur : rate(nbody_steps_total[1m]) le donne dans
+ * Prometheus, sans dépendre du rythme des lectures.
+ */
+class TelemetryServer {
+private:
+    const TelemetryMetrics& metrics;
+    int listener;
+    int port;
+    std::string socketPath;
+    std::atomic<bool> running;
+    std::thread thread;
+    std::string lastError;
+
+    bool start(int descriptor);
+    void serve();
+    void answer(int client);
+
+public:
+    explicit TelemetryServer(const TelemetryMetrics& metrics);
+    ~TelemetryServer();
+
+    TelemetryServer(const TelemetryServer&) = delete;
+    TelemetryServer& operator=(const TelemetryServer&) = delete;
+
+    /**
+     * @brief Écoute sur 127.0.0.1 uniquement ; port 0 = port libre choisi par le système (getPort())
+     */
+    bool listenTcp(int portNumber);
+    bool listenUnix(const std::string& path);
+
+    /**
+     * @brief "unix:/chemin" ou numéro de port
+     */
+    bool listen(const std::string& address);
+
+    void stop();
+
+    /**
+     * @brief Page de métriques ; appelée par le thread du serveur
+     */
+    std::string renderMetrics();
+
+    bool isRunning() const { return running.load(); }
+    int getPort() const { return port; }
+    const std::string& getError() const { return lastError; }
+};
+
+#endif
@@ -0,0 +1,251 @@
+/**
+ * @file Trajectory.hpp
+ * @brief Enregistrement de trajectoires sur disque et relecture par projection mémoire (mmap)
+ * @author P-Pix
+ * @date 2025
+ *
+ * Format (petit-boutiste) :
+ *   - en-tête TrajectoryHeader ;
+ *   - masses puis rayons, bodyCount doubles chacun ;
+ *   - frameCount images.
+ * Encodage brut (0) : FrameHeader puis bodyCount * dimension positions. Toutes
+ * les images ont la même taille : l'image i se trouve par un simple calcul
+ * d'adresse, sans index ni lecture préalable du fichier.
+ * Encodage compressé (1) : PackedFrameHeader puis payloadBytes octets produits
+ * par TrajectoryCodec. Le lecteur parcourt les en-têtes à l'ouverture pour
+ * construire l'index des images.
+ * Dans les deux cas, un fichier interrompu (calcul arrêté) reste lisible
+ * jusqu'à sa dernière image complète.
+ */
+
+#ifndef TRAJECTORY_HPP
+#define TRAJECTORY_HPP
+
+#include "Coroutine.hpp"
+#include "Simulation.hpp"
+#include "TrajectoryCodec.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @struct TrajectoryHeader
+ */
+struct TrajectoryHeader {
+    char magic[8];          ///< "NCORPS01"
+    uint32_t dimension;     ///< 2 ou 3
+    uint32_t encoding;      ///< 0 = doubles bruts, 1 = compressé (TrajectoryCodec)
+    uint64_t bodyCount;
+    uint64_t frameCount;    ///< Écrit à la fermeture ; le lecteur se fie à la taille du fichier
+    double timeStep;        ///< Pas de temps de la simulation enregistrée
+};
+
+/**
+ * @struct FrameHeader
+ */
+struct FrameHeader {
+    uint64_t step;          ///< Nombre de pas simulés à cet instant
+    double time;            ///< Temps simulé
+};
+
+/**
+ * @struct PackedFrameHeader
+ */
+struct PackedFrameHeader {
+    uint64_t step;
+    double time;
+    uint32_t payloadBytes;  ///< Taille des données compressées qui suivent
+    uint32_t keyframe;      ///< 1 si l'image se décode seule
+};
+
+/**
+ * @struct FrameView
+ * @brief Positions d'une image, lues sans copie (fichier projeté ou tampon du Renderer)
+ */
+struct FrameView {
+    const double* positions;    ///< bodyCount * dimension valeurs, corps par corps
+    const double* mass;
+    const double* radius;
+    size_t bodyCount;
+    int dimension;
+    uint64_t step;
+    double time;
+
+    FrameView() : positions(nullptr), mass(nullptr), radius(nullptr), bodyCount(0), dimension(2), step(0), time(0.0) {}
+
+    /// Position du corps i, z = 0 en 2D
+    Vector3D position(size_t i) const {
+        const double* p = positions + i * dimension;
+        return Vector3D(p[0], p[1], dimension == 3 ? p[2] : 0.0);
+    }
+};
+
+/**
+ * @class TrajectoryWriter
+ * @brief Ajoute des images à un fichier de trajectoire
+ *
+ * writeFrame() ne fait que copier les positions : une coroutine d'écriture
+ * les code et les écrit sur un exécuteur d'entrées-sorties pendant que la
+ * simulation continue. Deux images au plus sont en attente ; au-delà,
+ * writeFrame() attend que le codeur ait rattrapé son retard.
+ */
+class TrajectoryWriter {
+private:
+    static const size_t QUEUE_DEPTH = 2;
+
+    struct PendingFrame {
+        FrameHeader header;
+        std::vector<double> positions;
+    };
+
+    std::FILE* file;
+    TrajectoryHeader header;
+    double tolerance;
+    int keyframeInterval;
+    std::string lastError;
+    uint64_t submittedFrames;
+
+    // File d'attente entre la simulation et la coroutine d'écriture
+    PendingFrame pending[QUEUE_DEPTH];
+    size_t queueHead;
+    size_t queueCount;
+    bool stopping;
+    bool writing;               // Coroutine d'écriture lancée et pas encore terminée
+    bool failed;
+    std::string workerError;
+    std::mutex queueMutex;
+    std::condition_variable queueChanged;
+
+    // Exécuteur partagé, ou le sien, créé au premier open() sans exécuteur
+    CoroutineExecutor* executor;
+    std::unique_ptr<CoroutineExecutor> ownExecutor;
+    std::unique_ptr<AsyncSignal> frameReady;
+
+    // Propres à la coroutine d'écriture
+    std::unique_ptr<TrajectoryCodec> codec;
+    std::vector<unsigned char> payload;
+    uint64_t writtenFrames;
+    uint64_t writtenBytes;
+
+    bool writeHeader();
+    bool writeBlock(const void* data, size_t bytes);
+    bool writePending(const PendingFrame& frame);
+    AsyncTask<void> writerLoop(CoroutineExecutor& target);
+
+public:
+    TrajectoryWriter();
+    ~TrajectoryWriter();
+
+    TrajectoryWriter(const TrajectoryWriter&) = delete;
+    TrajectoryWriter& operator=(const TrajectoryWriter&) = delete;
+
+    /**
+     * @brief Active la compression pour les prochains open() ; tolerance = 0 pour des doubles bruts
+     * @param tolerance Erreur maximale relative au plus grand côté de la boîte englobante
+     * @param keyframeInterval Une image clé (accès direct) toutes les keyframeInterval images
+     */
+    void setCompression(double tolerance, int keyframeInterval = TrajectoryCodec::DEFAULT_KEYFRAME_INTERVAL);
+
+    /**
+     * @brief Exécuteur (démarré par start()) des prochains open() ; nullptr = un exécuteur propre
+     *
+     * Les écritures partagent alors le thread d'entrées-sorties des autres
+     * tâches (points de reprise, télémétrie) au lieu d'avoir le leur.
+     */
+    void setExecutor(CoroutineExecutor* executor);
+
+    /**
+     * @brief Crée le fichier ; masses et rayons sont pris dans la simulation et supposés constants
+     */
+    template <int D>
+    bool open(const std::string& path, const SimulationT<D>& simulation);
+
+    /**
+     * @brief Ajoute l'état courant de la simulation (même nombre de corps qu'à l'ouverture)
+     */
+    template <int D>
+    bool writeFrame(const SimulationT<D>& simulation);
+
+    /**
+     * @brief Attend l'écriture des images en attente puis ferme le fichier
+     *
+     * Bloquant : à ne pas appeler depuis une coroutine de l'exécuteur d'écriture.
+     */
+    void close();
+
+    bool isOpen() const { return file != nullptr; }
+    uint64_t getFrameCount() const { return submittedFrames; }
+    // Taille du fichier produit, valable après close()
+    uint64_t getFileSize() const { return writtenBytes; }
+    const std::string& getError() const { return lastError; }
+};
+
+/**
+ * @class TrajectoryReader
+ * @brief Relecture par mmap : chercher une image ne coûte qu'un calcul d'adresse
+ *
+ * Le noyau charge les pages à la demande ; prefetch() annonce les images à
+ * venir (madvise WILLNEED) pour que la lecture en avant comme en arrière ne
+ * bloque pas sur le disque.
+ *
+ * Une trajectoire compressée est décodée dans un tampon du lecteur : la vue
+ * rendue par frame() reste valable jusqu'à l'appel suivant. Lire l'image
+ * suivante coûte un décodage ; un saut ou une lecture à l'envers repart de
+ * l'image clé précédente.
+ */
+class TrajectoryReader {
+private:
+    int descriptor;
+    const unsigned char* mapping;
+    size_t mappingSize;
+    TrajectoryHeader header;
+    size_t frameSize;
+    size_t framesOffset;
+    std::string lastError;
+
+    // Encodage compressé : index des images et état du décodeur
+    std::vector<size_t> frameOffsets;
+    std::vector<size_t> keyframeOf;
+    mutable std::unique_ptr<TrajectoryCodec> codec;
+    mutable std::vector<double> decoded;
+    mutable size_t decodedIndex;
+
+    bool indexPackedFrames();
+    PackedFrameHeader packedHeader(size_t index) const;
+    bool decodeUpTo(size_t index) const;
+
+public:
+    TrajectoryReader();
+    ~TrajectoryReader();
+
+    TrajectoryReader(const TrajectoryReader&) = delete;
+    TrajectoryReader& operator=(const TrajectoryReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    /**
+     * @brief Image index (0 <= index < getFrameCount())
+     */
+    FrameView frame(size_t index) const;
+
+    /**
+     * @brief Demande au noyau de lire à l'avance les images [first, first + count)
+     */
+    void prefetch(size_t first, size_t count) const;
+
+    bool isOpen() const { return mapping != nullptr; }
+    size_t getFrameCount() const { return static_cast<size_t>(header.frameCount); }
+    bool isCompressed() const { return header.encoding == 1; }
+    size_t getBodyCount() const { return static_cast<size_t>(header.bodyCount); }
+    int getDimension() const { return static_cast<int>(header.dimension); }
+    double getTimeStep() const { return header.timeStep; }
+    const std::string& getError() const { return lastError; }
+};
+
+#endif
@@ -0,0 +1,81 @@
+/**
+ * @file TrajectoryCodec.hpp
+ * @brief Compression des images de trajectoire : quantification, prédiction, codage entropique
+ * @author P-Pix
+ * @date 2025
+ */
+
+#ifndef TRAJECTORY_CODEC_HPP
+#define TRAJECTORY_CODEC_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @class TrajectoryCodec
+ * @brief Code une suite d'images de positions ; l'encodeur et le décodeur en ont chacun une
+ *
+ * Les positions sont quantifiées sur une grille de pas tolerance * (plus
+ * grand côté de la boîte englobante), fixée à chaque image clé : l'erreur
+ * reste sous un demi-pas et ne s'accumule pas. Entre deux images clés, chaque
+ * coordonnée est prédite par extrapolation linéaire des deux images
+ * précédentes (vitesse constante) ; le résidu entier, presque toujours 0 ou
+ * ±1, est codé par un codeur arithmétique binaire adaptatif (type LZMA).
+ *
+ * Les modèles de probabilité repartent de zéro à chaque image clé : toute
+ * image se décode à partir de la dernière image clé qui la précède.
+ */
+class TrajectoryCodec {
+public:
+    static const int DEFAULT_KEYFRAME_INTERVAL = 32;
+
+private:
+    // Arbre binaire de 7 bits pour la longueur du résidu (0 à 64 bits), par axe
+    static const int LENGTH_TREE_SIZE = 128;
+
+    size_t bodyCount;
+    int dimension;
+    double tolerance;
+    int keyframeInterval;
+
+    // Grille de l'image clé courante
+    double origin[3];
+    double quantum;
+
+    // Coordonnées quantifiées de l'image en cours et des deux précédentes (identiques des deux côtés)
+    std::vector<int64_t> current;
+    std::vector<int64_t> previous;
+    std::vector<int64_t> beforePrevious;
+    int framesSinceKeyframe;   // -1 tant qu'aucune image clé n'a été vue
+
+    std::vector<uint16_t> lengthModels;
+
+    void resetModels();
+    int64_t predict(size_t coordinate) const;
+    void rotateHistory();
+
+public:
+    /**
+     * @param tolerance Erreur maximale relative à la taille du système (demi-pas de la grille)
+     */
+    TrajectoryCodec(size_t bodyCount, int dimension, double tolerance = 1e-4,
+                    int keyframeInterval = DEFAULT_KEYFRAME_INTERVAL);
+
+    /**
+     * @brief Code bodyCount * dimension positions à la suite de payload (vidé au préalable)
+     * @return true si l'image est une image clé
+     */
+    bool encode(const double* positions, std::vector<unsigned char>& payload);
+
+    /**
+     * @brief Décode une image ; une image non clé doit suivre l'image décodée juste avant
+     * @return false si les données sont incohérentes (image clé manquante, taille)
+     */
+    bool decode(const unsigned char* payload, size_t bytes, bool keyframe, double* positions);
+
+    double getQuantum() const { return quantum; }
+    int getKeyframeInterval() const { return keyframeInterval; }
+};
+
+#endif
@@ -1,12 +1,61 @@
 #include "../../include/Application.hpp"
+#include "../../include/Orbit.hpp"
+#include "../../include/Scene.hpp"
+#include "../../include/TaskScheduler.hpp"
 #include <iostream>
 #include <cstring>
 #include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
 
-Application::Application(int windowWidth, int windowHeight) 
-    : running(false), paused(false), lastTime(0), deltaTime(0.0),
+namespace {
+    template <int D>
+    void applyPreset(SimulationT<D>& simulation, int preset) {
+        switch (preset) {
+            case 1:
+                simulation.setupSolarSystem();
+                break;
+            case 2:
+                simulation.setupBinarySystem();
+                break;
+            case 3:
+                simulation.setupRandomBodies(15, 800, 600);
+                break;
+            case 4:
+                simulation.setupGalaxyCollision();
+                break;
+            default:
+                simulation.setupSolarSystem();
+                break;
+        }
+    }
+    
+    // Images annoncées au noyau devant la tête de lecture
+    const size_t PLAYBACK_READAHEAD = 64;
+    
+    // Un relâché à moins de CLICK_SLOP pixels du clic est une sélection, pas un glissé
+    const int CLICK_SLOP = 4;
+    const double PICK_RADIUS_PIXELS = 20.0;
+    
+    // Éléments orbitaux du panneau de sélection recalculés deux fois par seconde
+    const int SELECTION_REFRESH_FRAMES = 30;
+    
+    // ~60 images/s ; l'attente de fin d'image laisse passer les autres tâches de l'interface
+    const std::chrono::milliseconds FRAME_PERIOD(16);
+    
+    const char* const CHECKPOINT_PATH = "n-corps-checkpoint.scene";
+    const int IO_NICENESS = 10;
+}
+
+Application::Application(int windowWidth, int windowHeight, int dimension) 
+    : dimension(dimension), playbackPosition(0.0), playbackDirection(1),
+      running(false), paused(false), lastTime(0), deltaTime(0.0),
       speedMultiplier(1.0), stepsPerFrame(1),
-      mouseX(0), mouseY(0), mousePressed(false) {
+      mouseX(0), mouseY(0), mousePressed(false), pressX(0), pressY(0),
+      pickIndexCurrent(false), selectedBody(SpatialIndex::NONE), selectionAge(0), checkpointPending(false) {
     
     // Les objets seront créés après la configuration
     renderer.reset(new Renderer(windowWidth, windowHeight, "N-Body Problem Simulation"));
@@ -46,8 +95,84 @@ bool Application::showConfigDialog() {
     return true;
 }
 
+bool Application::loadTrajectory(const std::string& path) {
+    std::unique_ptr<TrajectoryReader> reader(new TrajectoryReader());
+    if (!reader->open(path)) {
+        std::cerr << "Relecture impossible: " << reader->getError() << std::endl;
+        return false;
+    }
+    if (reader->getFrameCount() == 0) {
+        std::cerr << "Relecture impossible: " << path << " ne contient aucune image" << std::endl;
+        return false;
+    }
+    
+    trajectory = std::move(reader);
+    dimension = trajectory->getDimension();
+    selectBody(SpatialIndex::NONE);
+    simulation.reset();
+    simulation3D.reset();
+    seekFrame(0.0);
+    running = true;
+    lastTime = SDL_GetTicks();
+    
+    std::cout << "Relecture de " << path << std::endl;
+    std::cout << "  Images: " << trajectory->getFrameCount() << std::endl;
+    std::cout << "  Nombre de corps: " << trajectory->getBodyCount() << std::endl;
+    std::cout << "  Dimension: " << dimension << "D" << std::endl;
+    return true;
+}
+
+bool Application::loadScene(const std::string& path) {
+    SceneLoader loader;
+    if (!loader.open(path)) {
+        std::cerr << "Scène illisible: " << loader.getError() << std::endl;
+        return false;
+    }
+    
+    // La dimension de la scène remplace celle de la ligne de commande
+    const SceneSettings& settings = loader.getSettings();
+    dimension = settings.dimension;
+    selectBody(SpatialIndex::NONE);
+    simulation.reset();
+    simulation3D.reset();
+    bool loaded;
+    if (dimension == 3) {
+        settings.configure(simulation3D);
+        loaded = loader.load(*simulation3D);
+    } else {
+        settings.configure(simulation);
+        loaded = loader.load(*simulation);
+    }
+    if (!loaded) {
+        std::cerr << "Scène illisible: " << loader.getError() << std::endl;
+        return false;
+    }
+    
+    currentConfig.gravitationalConstant = settings.gravitationalConstant;
+    currentConfig.timeStep = settings.timeStep;
+    renderer->clearTrails();
+    camera.reset();
+    running = true;
+    lastTime = SDL_GetTicks();
+    
+    size_t bodyCount = simulation3D ? simulation3D->getBodyCount() : simulation->getBodyCount();
+    std::cout << "Scène " << path << std::endl;
+    std::cout << "  Nombre de corps: " << bodyCount << std::endl;
+    std::cout << "  Constante G: " << settings.gravitationalConstant << std::endl;
+    std::cout << "  Pas de temps: " << settings.timeStep << std::endl;
+    std::cout << "  Dimension: " << dimension << "D" << std::endl;
+    return true;
+}
+
 void Application::run() {
+    // Le thread principal mène l'exécuteur de l'interface jusqu'à la fin de la boucle d'images
+    ui.spawn(frameLoop());
+    ui.drain();
+}
+
+AsyncTask<void> Application::frameLoop() {
     while (running) {
+        CoroutineExecutor::Clock::time_point frameStart = CoroutineExecutor::Clock::now();
         Uint32 currentTime = SDL_GetTicks();
         deltaTime = (currentTime - lastTime) / 1000.0;
         lastTime = currentTime;
@@ -60,12 +185,43 @@ void Application::run() {
         
         render();
         
-        // Limiter le framerate
-        SDL_Delay(16); // ~60 FPS
+        // Limiter le framerate : échéance comptée depuis le début de l'image
+        co_await ui.sleepUntil(frameStart + FRAME_PERIOD);
+    }
+}
+
+void Application::saveCheckpoint() {
+    if (trajectory) return; // Relecture : pas de simulation à sauvegarder
+    if (checkpointPending.exchange(true)) {
+        std::cout << "Point de reprise déjà en cours d'écriture" << std::endl;
+        return;
     }
+    if (!io.hasThread()) {
+        // Comme en mode sans fenêtre : hors des cœurs des workers épinglés s'il en reste
+        TaskScheduler* scheduler = simulation3D ? simulation3D->getTaskScheduler() : simulation->getTaskScheduler();
+        io.start(scheduler ? scheduler->getSpareCpus() : std::vector<int>(), IO_NICENESS);
+    }
+    
+    // Seule la copie se fait sur le thread de l'interface
+    SceneSnapshot snapshot = simulation3D ? SceneSnapshot::capture(*simulation3D) : SceneSnapshot::capture(*simulation);
+    io.spawn(writeCheckpoint(std::move(snapshot)));
+}
+
+AsyncTask<void> Application::writeCheckpoint(SceneSnapshot snapshot) {
+    bool written = co_await checkpointWriter.writeAsync(io, CHECKPOINT_PATH, std::move(snapshot));
+    if (written) {
+        std::cout << "Point de reprise écrit dans " << CHECKPOINT_PATH << std::endl;
+    } else {
+        std::cerr << "Point de reprise non écrit: " << checkpointWriter.getError() << std::endl;
+    }
+    checkpointPending = false;
 }
 
 void Application::cleanup() {
+    // Un point de reprise en cours d'écriture est terminé avant de quitter
+    if (io.hasThread()) {
+        io.drain();
+    }
     renderer->cleanup();
 }
 
@@ -120,6 +276,41 @@ void Application::handleEvents() {
                     case SDLK_0:
                         setSpeedMultiplier(1.0);
                         break;
+                    case SDLK_b:
+                        reversePlayback();
+                        break;
+                    case SDLK_HOME:
+                        seekFrame(0.0);
+                        break;
+                    case SDLK_END:
+                        if (trajectory) seekFrame(static_cast<double>(trajectory->getFrameCount() - 1));
+                        break;
+                    case SDLK_PAGEUP:
+                    case SDLK_PAGEDOWN:
+                        // Saut de 10 % de l'enregistrement
+                        if (trajectory) {
+                            double jump = 0.1 * trajectory->getFrameCount();
+                            seekFrame(playbackPosition + (e.key.keysym.sym == SDLK_PAGEUP ? -jump : jump));
+                        }
+                        break;
+                    case SDLK_f:
+                        toggleFollowSelected();
+                        break;
+                    case SDLK_g:
+                        toggleFollowCenterOfMass();
+                        break;
+                    case SDLK_ESCAPE:
+                        selectBody(SpatialIndex::NONE);
+                        break;
+                    case SDLK_COMMA:
+                        seekFrame(playbackPosition - 1.0);
+                        break;
+                    case SDLK_PERIOD:
+                        seekFrame(playbackPosition + 1.0);
+                        break;
+                    case SDLK_F5:
+                        saveCheckpoint();
+                        break;
                 }
                 break;
                 
@@ -132,36 +323,39 @@ void Application::handleEvents() {
             case SDL_MOUSEBUTTONDOWN:
                 if (e.button.button == SDL_BUTTON_LEFT) {
                     mousePressed = true;
-                    mouseX = e.button.x;
-                    mouseY = e.button.y;
+                    mouseX = pressX = e.button.x;
+                    mouseY = pressY = e.button.y;
                 }
                 break;
                 
             case SDL_MOUSEBUTTONUP:
                 if (e.button.button == SDL_BUTTON_LEFT) {
                     mousePressed = false;
+                    mouseX = e.button.x;
+                    mouseY = e.button.y;
+                    if (std::abs(mouseX - pressX) + std::abs(mouseY - pressY) <= CLICK_SLOP) {
+                        handleMouse();
+                    }
                 }
                 break;
                 
             case SDL_MOUSEMOTION:
                 if (mousePressed) {
-                    // Pan camera
+                    // Pan camera : le monde suit la souris
                     int deltaX = e.motion.x - mouseX;
                     int deltaY = e.motion.y - mouseY;
-                    
-                    Vector2D currentOffset = Vector2D(0, 0); // Simplification
-                    Vector2D newOffset = currentOffset + Vector2D(-deltaX, -deltaY);
-                    renderer->setCamera(newOffset, 1.0);
+                    camera.pan(-deltaX, -deltaY);
                 }
                 mouseX = e.motion.x;
                 mouseY = e.motion.y;
                 break;
                 
             case SDL_MOUSEWHEEL:
-                // Zoom avec Ctrl, vitesse sans Ctrl
+                // Zoom avec Ctrl (autour du curseur), vitesse sans Ctrl
                 if (keys[SDL_SCANCODE_LCTRL] || keys[SDL_SCANCODE_RCTRL]) {
-                    double zoomFactor = (e.wheel.y > 0) ? 1.1 : 0.9;
-                    renderer->setCamera(Vector2D(0, 0), zoomFactor);
+                    double zoomFactor = (e.wheel.y > 0) ? 1.1 : 1.0 / 1.1;
+                    camera.zoomAt(zoomFactor, Vector2D(mouseX - renderer->getWidth() / 2,
+                                                       mouseY - renderer->getHeight() / 2));
                 } else {
                     double speedFactor = (e.wheel.y > 0) ? 1.2 : 0.8;
                     adjustSpeed(speedFactor);
@@ -192,25 +386,126 @@ void Application::handleKeyboard() {
     }
     
     if (cameraMovement.magnitude() > 0) {
-        Vector2D currentOffset = Vector2D(0, 0); // Simplification
-        renderer->setCamera(currentOffset + cameraMovement, 1.0);
+        camera.pan(cameraMovement.x, cameraMovement.y);
     }
 }
 
 void Application::handleMouse() {
-    // Géré dans handleEvents()
+    // Le glissé (déplacement de la caméra) est géré dans handleEvents() ;
+    // un clic sélectionne le corps affiché le plus proche du curseur. Les
+    // événements passent avant le pas : currentFrame() est l'image affichée
+    Vector2D world = renderer->screenToWorld(Vector2D(mouseX, mouseY));
+    double radius = PICK_RADIUS_PIXELS / renderer->getZoom();
+    if (simulation && !trajectory) {
+        // En 2D, positions affichées = positions simulées : l'arbre persistant
+        // de la simulation répond, sans index à construire ; traceurs compris
+        // comme en 3D et en relecture
+        double distance = 0.0;
+        size_t nearest = simulation->findNearestBody(world, static_cast<size_t>(-1), &distance, true);
+        selectBody(nearest < simulation->getBodyCount() && distance <= radius ? nearest : SpatialIndex::NONE);
+        return;
+    }
+    
+    // 3D (perspective) et relecture : index des positions projetées
+    if (!pickIndexCurrent) {
+        updatePickIndex(currentFrame());
+        pickIndexCurrent = true;
+    }
+    selectBody(pickIndex.nearest(world, radius));
 }
 
 void Application::update() {
+    if (trajectory) {
+        // Une image enregistrée par image affichée à x1, fraction d'image en dessous
+        double last = static_cast<double>(trajectory->getFrameCount() - 1);
+        playbackPosition += playbackDirection * speedMultiplier;
+        if (playbackPosition <= 0.0 || playbackPosition >= last) {
+            playbackPosition = std::max(0.0, std::min(playbackPosition, last));
+            paused = true; // Fin de l'enregistrement dans le sens de lecture
+        }
+        
+        size_t current = static_cast<size_t>(playbackPosition);
+        size_t window = PLAYBACK_READAHEAD * static_cast<size_t>(std::ceil(speedMultiplier));
+        trajectory->prefetch(playbackDirection > 0 ? current : (current > window ? current - window : 0), window);
+        return;
+    }
+    
     // Exécuter plusieurs étapes selon la vitesse
     for (int i = 0; i < stepsPerFrame; ++i) {
-        simulation->step();
+        if (simulation3D) {
+            simulation3D->step();
+        } else {
+            simulation->step();
+        }
     }
 }
 
+FrameView Application::currentFrame() {
+    if (trajectory) {
+        return trajectory->frame(static_cast<size_t>(playbackPosition));
+    }
+    return simulation3D ? renderer->stageFrame(*simulation3D) : renderer->stageFrame(*simulation);
+}
+
+Vector2D Application::centerOfMass(const FrameView& frame) const {
+    if (trajectory) {
+        // Pas de vitesses en relecture : somme sur l'image, seulement quand la caméra la suit
+        double totalMass = 0.0;
+        Vector2D massMoment;
+        for (size_t i = 0; i < frame.bodyCount; ++i) {
+            Vector3D position = frame.position(i);
+            totalMass += frame.mass[i];
+            massMoment = massMoment + Vector2D(position.x, position.y) * frame.mass[i];
+        }
+        return totalMass > 0.0 ? massMoment * (1.0 / totalMass) : Vector2D();
+    }
+    if (simulation3D) {
+        Vector3D center = simulation3D->getCenterOfMass();
+        return Vector2D(center.x, center.y);
+    }
+    return simulation->getCenterOfMass();
+}
+
+void Application::updatePickIndex(const FrameView& frame) {
+    // Positions telles qu'affichées, ramenées dans le plan z = 0 : la perspective
+    // est prise en compte et le clic se compare à screenToWorld()
+    pickPoints.resize(frame.bodyCount);
+    for (size_t i = 0; i < frame.bodyCount; ++i) {
+        Vector3D position = frame.position(i);
+        if (renderer->perspectiveScale(position.z) <= 0.0) {
+            pickPoints[i] = Vector2D(NAN, NAN); // Derrière la caméra
+        } else {
+            pickPoints[i] = renderer->screenToWorld(renderer->worldToScreen(position));
+        }
+    }
+    pickIndex.build(pickPoints);
+}
+
 void Application::render() {
     renderer->clear(Color(10, 10, 30, 255)); // Fond bleu foncé
-    renderer->renderSimulation(*simulation);
+    FrameView frame = currentFrame();
+    
+    // Suivi en O(1) : accès direct par indice, ou centre de masse tenu à jour
+    // par la simulation (relecture : sommé sur l'image)
+    if (camera.getMode() == CameraMode::SelectedBody && selectedBody < frame.bodyCount) {
+        Vector3D position = frame.position(selectedBody);
+        camera.track(Vector2D(position.x, position.y));
+    } else if (camera.getMode() == CameraMode::CenterOfMass) {
+        camera.track(centerOfMass(frame));
+    }
+    camera.update(deltaTime);
+    renderer->setCamera(camera.getOffset(), camera.getZoom());
+    
+    renderer->renderFrame(frame);
+    pickIndexCurrent = false;
+    
+    if (selectedBody < frame.bodyCount) {
+        if (++selectionAge >= SELECTION_REFRESH_FRAMES) {
+            selectionLines = describeSelection();
+            selectionAge = 0;
+        }
+        renderer->renderTextPanel(selectionLines, 10, 10);
+    }
     
     // Afficher les instructions (simplifié)
     // TODO: Ajouter du texte avec SDL_ttf
@@ -220,41 +515,36 @@ void Application::render() {
 
 void Application::resetSimulation() {
     renderer->clearTrails();
+    if (trajectory) {
+        seekFrame(0.0);
+        return;
+    }
     // Recharger la configuration actuelle
     switchPreset(1); // Par défaut, système solaire
 }
 
 void Application::switchPreset(int preset) {
+    if (trajectory) return; // Pas de physique en relecture
     renderer->clearTrails();
+    selectBody(SpatialIndex::NONE);
     
-    switch (preset) {
-        case 1:
-            simulation->setupSolarSystem();
-            break;
-        case 2:
-            simulation->setupBinarySystem();
-            break;
-        case 3:
-            simulation->setupRandomBodies(15, 800, 600);
-            break;
-        case 4:
-            simulation->setupGalaxyCollision();
-            break;
-        default:
-            simulation->setupSolarSystem();
-            break;
+    if (simulation3D) {
+        applyPreset(*simulation3D, preset);
+    } else {
+        applyPreset(*simulation, preset);
     }
     
     // Reset camera
-    renderer->setCamera(Vector2D(0, 0), 1.0);
+    camera.reset();
 }
 
 void Application::adjustSpeed(double factor) {
     speedMultiplier *= factor;
     
-    // Limiter la vitesse
+    // Limiter la vitesse ; la relecture ne coûte pas de calcul et va plus loin
+    double maxSpeed = trajectory ? 100.0 : 10.0;
     if (speedMultiplier < 0.1) speedMultiplier = 0.1;
-    if (speedMultiplier > 10.0) speedMultiplier = 10.0;
+    if (speedMultiplier > maxSpeed) speedMultiplier = maxSpeed;
     
     // Calculer le nombre d'étapes par frame
     stepsPerFrame = static_cast<int>(speedMultiplier);
@@ -271,11 +561,112 @@ void Application::setSpeedMultiplier(double multiplier) {
     std::cout << "Vitesse réinitialisée: x" << std::fixed << std::setprecision(1) << speedMultiplier << std::endl;
 }
 
+void Application::seekFrame(double frame) {
+    if (!trajectory) return;
+    
+    double last = static_cast<double>(trajectory->getFrameCount() - 1);
+    playbackPosition = std::max(0.0, std::min(frame, last));
+    
+    // Les traînées d'avant le saut n'ont plus de sens
+    renderer->clearTrails();
+    trajectory->prefetch(static_cast<size_t>(playbackPosition), PLAYBACK_READAHEAD);
+}
+
+void Application::selectBody(size_t index) {
+    selectedBody = index;
+    renderer->setHighlightedBody(index);
+    selectionLines.clear();
+    if (index == SpatialIndex::NONE) {
+        if (camera.getMode() == CameraMode::SelectedBody) camera.setMode(CameraMode::Free);
+        return;
+    }
+    
+    // Affiché dans la fenêtre et recopié sur la sortie standard au moment du clic
+    selectionLines = describeSelection();
+    selectionAge = 0;
+    for (size_t line = 0; line < selectionLines.size(); ++line) {
+        std::cout << (line == 0 ? "" : "  ") << selectionLines[line] << std::endl;
+    }
+}
+
+void Application::toggleFollowSelected() {
+    bool follow = camera.getMode() != CameraMode::SelectedBody && selectedBody != SpatialIndex::NONE;
+    camera.setMode(follow ? CameraMode::SelectedBody : CameraMode::Free);
+    std::cout << (follow ? "Caméra: suivi du corps " : "Caméra: suivi désactivé")
+              << (follow ? std::to_string(selectedBody) : std::string()) << std::endl;
+}
+
+void Application::toggleFollowCenterOfMass() {
+    bool follow = camera.getMode() != CameraMode::CenterOfMass;
+    camera.setMode(follow ? CameraMode::CenterOfMass : CameraMode::Free);
+    std::cout << (follow ? "Caméra: suivi du centre de masse" : "Caméra: suivi désactivé") << std::endl;
+}
+
+std::vector<std::string> Application::describeSelection() {
+    std::vector<std::string> lines;
+    std::ostringstream line;
+    line << std::setprecision(4);
+    auto flush = [&lines, &line]() {
+        lines.push_back(line.str());
+        line.str(std::string());
+    };
+    line << "Corps " << selectedBody << " sélectionné (F : suivre, Échap : désélectionner)";
+    flush();
+    
+    if (trajectory) {
+        // Relecture : pas de vitesses enregistrées
+        FrameView frame = currentFrame();
+        Vector3D position = frame.position(selectedBody);
+        line << "Masse: " << frame.mass[selectedBody] << ", rayon: " << frame.radius[selectedBody];
+        flush();
+        line << "Position: (" << position.x << ", " << position.y << ", " << position.z << "), pas " << frame.step;
+        flush();
+        return lines;
+    }
+    
+    OrbitalElements orbit;
+    double mass, speed;
+    if (simulation3D) {
+        const Body3D& body = *simulation3D->getBodies()[selectedBody];
+        mass = body.getMass();
+        speed = body.getVelocity().magnitude();
+        orbit = computeOrbitalElements(*simulation3D, selectedBody);
+    } else {
+        const Body& body = *simulation->getBodies()[selectedBody];
+        mass = body.getMass();
+        speed = body.getVelocity().magnitude();
+        orbit = computeOrbitalElements(*simulation, selectedBody);
+    }
+    line << "Masse: " << mass << ", vitesse: " << speed;
+    flush();
+    if (orbit.attractor == SpatialIndex::NONE) return lines;
+    
+    line << "Attracteur dominant: corps " << orbit.attractor << ", distance " << orbit.distance
+         << ", vitesse relative " << orbit.relativeSpeed;
+    flush();
+    if (orbit.bound) {
+        line << "Orbite liée: demi-grand axe " << orbit.semiMajorAxis << ", excentricité " << orbit.eccentricity
+             << ", période " << orbit.period;
+    } else {
+        line << "Trajectoire non liée: excentricité " << orbit.eccentricity;
+    }
+    if (dimension == 3) {
+        line << ", inclinaison " << orbit.inclination * 180.0 / M_PI << "°";
+    }
+    flush();
+    return lines;
+}
+
 void Application::applyConfig(const SimulationConfig& config) {
     currentConfig = config;
+    selectBody(SpatialIndex::NONE);
     
     // Créer la simulation avec les paramètres choisis
-    simulation.reset(new Simulation(config.gravitationalConstant, config.timeStep));
+    if (dimension == 3) {
+        simulation3D.reset(new Simulation3D(config.gravitationalConstant, config.timeStep));
+    } else {
+        simulation.reset(new Simulation(config.gravitationalConstant, config.timeStep));
+    }
     
     if (config.usePreset) {
         switchPreset(config.preset);
@@ -287,6 +678,7 @@ void Application::applyConfig(const SimulationConfig& config) {
     std::cout << "  Nombre de corps: " << config.numBodies << std::endl;
     std::cout << "  Constante G: " << config.gravitationalConstant << std::endl;
     std::cout << "  Pas de temps: " << config.timeStep << std::endl;
+    std::cout << "  Dimension: " << dimension << "D" << std::endl;
 }
 
 void Application::setupCustomSimulation(int numBodies, double G) {
@@ -294,11 +686,15 @@ void Application::setupCustomSimulation(int numBodies, double G) {
     renderer->clearTrails();
     
     // Créer une simulation personnalisée avec des corps aléatoires
-    simulation->setupRandomBodies(numBodies, 800, 600);
+    if (simulation3D) {
+        simulation3D->setupRandomBodies(numBodies, 800, 600);
+    } else {
+        simulation->setupRandomBodies(numBodies, 800, 600);
+    }
     
     std::cout << "Simulation personnalisée créée avec " << numBodies << " corps" << std::endl;
     std::cout << "Utilisez +/- ou la molette pour ajuster la vitesse" << std::endl;
     
     // Reset camera
-    renderer->setCamera(Vector2D(0, 0), 1.0);
+    camera.reset();
 }
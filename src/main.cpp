@@ -1,22 +1,49 @@
 #include "../include/Application.hpp"
+#include "../include/Profiler.hpp"
 #include <iostream>
+#include <string>
 
 int main(int argc, char** argv) {
-    (void)argc; // Éviter les warnings de variables non utilisées
-    (void)argv;
+    // --trace fichier.json : export des chronomètres (binaire compilé avec PROFILE=1)
+    // --3d : simulation tridimensionnelle, affichée en perspective
+    // --replay fichier.traj : relecture d'une trajectoire enregistrée (N-Corps-headless --record)
+    // --scene fichier : conditions initiales et paramètres lus dans un fichier de scène
+    std::string tracePath;
+    std::string replayPath;
+    std::string scenePath;
+    int dimension = 2;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--trace" && i + 1 < argc) {
+            tracePath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--replay" && i + 1 < argc) {
+            replayPath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--scene" && i + 1 < argc) {
+            scenePath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--3d") {
+            dimension = 3;
+        }
+    }
     
     std::cout << "=== N-Body Problem Simulation ===" << std::endl;
     std::cout << "Lancement de la fenêtre de configuration..." << std::endl;
     
-    Application app(1200, 800);
+    Application app(1200, 800, dimension);
     
     if (!app.initialize()) {
         std::cerr << "Failed to initialize application!" << std::endl;
         return -1;
     }
     
-    // Afficher la fenêtre de configuration
-    if (!app.showConfigDialog()) {
+    if (!replayPath.empty()) {
+        if (!app.loadTrajectory(replayPath)) {
+            return -1;
+        }
+    } else if (!scenePath.empty()) {
+        if (!app.loadScene(scenePath)) {
+            return -1;
+        }
+    } else if (!app.showConfigDialog()) {
+        // Afficher la fenêtre de configuration
         std::cout << "Configuration annulée ou fermée." << std::endl;
         return 0;
     }
@@ -30,14 +57,31 @@ int main(int argc, char** argv) {
     std::cout << "  +/- - Ajuster vitesse" << std::endl;
     std::cout << "  0 - Vitesse normale" << std::endl;
     std::cout << "  WASD/Arrow Keys - Move camera" << std::endl;
-    std::cout << "  Ctrl + Mouse Wheel - Zoom" << std::endl;
+    std::cout << "  Ctrl + Mouse Wheel - Zoom (autour du curseur)" << std::endl;
     std::cout << "  Mouse Wheel - Vitesse" << std::endl;
     std::cout << "  Mouse Drag - Pan camera" << std::endl;
+    std::cout << "  G - Suivre le centre de masse" << std::endl;
+    std::cout << "  Clic - Sélectionner un corps (F : suivre, Échap : désélectionner)" << std::endl;
+    std::cout << "  F5 - Point de reprise (n-corps-checkpoint.scene, relu avec --scene)" << std::endl;
+    if (!replayPath.empty()) {
+        std::cout << "  B - Inverser le sens de lecture" << std::endl;
+        std::cout << "  , / . - Image précédente / suivante" << std::endl;
+        std::cout << "  PageUp/PageDown - Reculer/avancer de 10 %" << std::endl;
+        std::cout << "  Home/End - Début/fin de l'enregistrement" << std::endl;
+    }
     std::cout << "===============================" << std::endl;
     
     app.run();
     app.cleanup();
     
+    if (!tracePath.empty()) {
+        if (!Profiler::isCompiledIn()) {
+            std::cerr << "Profilage non compilé : recompiler avec make PROFILE=1" << std::endl;
+        } else if (Profiler::writeChromeTrace(tracePath)) {
+            std::cout << "Trace écrite dans " << tracePath << std::endl;
+        }
+    }
+    
     return 0;
 }
 
@@ -0,0 +1,469 @@
+#include "../../include/BarnesHut.hpp"
+#include "../../include/Morton.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Pile de parcours : au plus (2^D - 1) frères en attente par niveau
+    const size_t WALK_STACK = 256;
+
+    int levelsFor(int dimension) {
+        return dimension == 3 ? 21 : 32;
+    }
+}
+
+template <int D>
+BarnesHutTreeT<D>::BarnesHutTreeT(ForceLaw law)
+    : leafSize(DEFAULT_LEAF_SIZE), depth(0), overlap(0.0), builtOverlap(0.0) {
+    switch (law) {
+        case ForceLaw::Newtonian:
+            walker = &BarnesHutTreeT::walk<NewtonianForce>;
+            externalWalker = &BarnesHutTreeT::walkExternal<NewtonianForce>;
+            break;
+        case ForceLaw::Plummer:
+            walker = &BarnesHutTreeT::walk<PlummerForce>;
+            externalWalker = &BarnesHutTreeT::walkExternal<PlummerForce>;
+            break;
+        case ForceLaw::Spline:
+            walker = &BarnesHutTreeT::walk<SplineForce>;
+            externalWalker = &BarnesHutTreeT::walkExternal<SplineForce>;
+            break;
+        case ForceLaw::Clamped:
+        default:
+            walker = &BarnesHutTreeT::walk<ClampedForce>;
+            externalWalker = &BarnesHutTreeT::walkExternal<ClampedForce>;
+            break;
+    }
+}
+
+template <int D>
+void BarnesHutTreeT<D>::build(const BodyArrays& arrays, size_t leaf) {
+    leafSize = leaf > 0 ? leaf : 1;
+    size_t n = arrays.size();
+
+    centerX.clear();
+    centerY.clear();
+    centerZ.clear();
+    nodeMass.clear();
+    nodeSize.clear();
+    nodeOffset.clear();
+    nodeRadius.clear();
+    quadrupole.clear();
+    boxLower.clear();
+    boxUpper.clear();
+    firstChild.clear();
+    childCount.clear();
+    bodyBegin.clear();
+    bodyEnd.clear();
+    depth = 0;
+
+    sorted.resize(n, D);
+    order.resize(n);
+    keys.resize(n);
+    overlap = 0.0;
+    builtOverlap = 0.0;
+    if (n == 0) return;
+
+    // Cube englobant : les cellules d'un même niveau ont le même côté sur tous les axes
+    const double* axis[3] = {arrays.x.data(), arrays.y.data(), D == 3 ? arrays.z.data() : nullptr};
+    double lower[D];
+    double side = 0.0;
+    for (int d = 0; d < D; ++d) {
+        double low = HUGE_VAL, high = -HUGE_VAL;
+        for (size_t i = 0; i < n; ++i) {
+            low = std::min(low, axis[d][i]);
+            high = std::max(high, axis[d][i]);
+        }
+        lower[d] = low;
+        side = std::max(side, high - low);
+    }
+    if (!(side > 0.0) || !std::isfinite(side)) side = 1.0;
+
+    uint64_t cells = mortonCells(D);
+    double scale = static_cast<double>(cells) / side;
+    scratch.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t cell[D];
+        for (int d = 0; d < D; ++d) cell[d] = mortonQuantize(axis[d][i], lower[d], scale, cells);
+        scratch[i] = std::make_pair(mortonKey<D>(cell), static_cast<uint32_t>(i));
+    }
+    std::sort(scratch.begin(), scratch.end());
+
+    for (size_t k = 0; k < n; ++k) {
+        size_t i = scratch[k].second;
+        keys[k] = scratch[k].first;
+        order[k] = static_cast<uint32_t>(i);
+        sorted.x[k] = arrays.x[i];
+        sorted.y[k] = arrays.y[i];
+        if (D == 3) sorted.z[k] = arrays.z[i];
+        sorted.mass[k] = arrays.mass[i];
+        sorted.radius[k] = arrays.radius[i];
+    }
+
+    addNode(0, n);
+    buildNode(0, 0, n, 0);
+    measureOverlap();
+    builtOverlap = overlap;
+}
+
+template <int D>
+bool BarnesHutTreeT<D>::refit(const BodyArrays& arrays) {
+    size_t n = order.size();
+    if (n == 0 || arrays.size() != n) return false;
+
+    for (size_t k = 0; k < n; ++k) {
+        size_t i = order[k];
+        sorted.x[k] = arrays.x[i];
+        sorted.y[k] = arrays.y[i];
+        if (D == 3) sorted.z[k] = arrays.z[i];
+        sorted.mass[k] = arrays.mass[i];
+        sorted.radius[k] = arrays.radius[i];
+    }
+
+    // Les enfants sont toujours rangés après leur parent : l'ordre inverse remonte l'arbre
+    for (size_t node = nodeMass.size(); node-- > 0;) {
+        summarize(static_cast<uint32_t>(node));
+    }
+    measureOverlap();
+    return true;
+}
+
+template <int D>
+void BarnesHutTreeT<D>::measureOverlap() {
+    double root = nodeSize[0];
+    if (!(root > 0.0)) {
+        overlap = 1.0;
+        return;
+    }
+    double sum = 0.0;
+    for (size_t node = 0; node < nodeMass.size(); ++node) {
+        if (childCount[node] > 0) continue;
+        double ratio = nodeSize[node] / root;
+        sum += D == 3 ? ratio * ratio * ratio : ratio * ratio;
+    }
+    overlap = sum;
+}
+
+template <int D>
+size_t BarnesHutTreeT<D>::addNode(size_t begin, size_t end) {
+    centerX.push_back(0.0);
+    centerY.push_back(0.0);
+    centerZ.push_back(0.0);
+    nodeMass.push_back(0.0);
+    nodeSize.push_back(0.0);
+    nodeOffset.push_back(0.0);
+    nodeRadius.push_back(0.0);
+    quadrupole.resize(quadrupole.size() + 6, 0.0);
+    boxLower.resize(boxLower.size() + 3, 0.0);
+    boxUpper.resize(boxUpper.size() + 3, 0.0);
+    firstChild.push_back(0);
+    childCount.push_back(0);
+    bodyBegin.push_back(static_cast<uint32_t>(begin));
+    bodyEnd.push_back(static_cast<uint32_t>(end));
+    return nodeMass.size() - 1;
+}
+
+template <int D>
+void BarnesHutTreeT<D>::buildNode(uint32_t node, size_t begin, size_t end, int level) {
+    depth = std::max(depth, level + 1);
+    int levels = levelsFor(D);
+
+    if (end - begin > leafSize && level < levels) {
+        // Les clés sont triées : chaque enfant est une sous-plage contiguë
+        int shift = (levels - 1 - level) * D;
+        uint64_t mask = (1ULL << D) - 1;
+        size_t bounds[(1 << D) + 1];
+        bounds[0] = begin;
+        for (uint64_t digit = 0; digit < (1ULL << D); ++digit) {
+            bounds[digit + 1] = static_cast<size_t>(
+                std::upper_bound(keys.begin() + bounds[digit], keys.begin() + end, digit,
+                                 [shift, mask](uint64_t value, uint64_t key) { return value < ((key >> shift) & mask); })
+                - keys.begin());
+        }
+
+        // Frères alloués d'un bloc avant de descendre : ils restent contigus
+        uint32_t first = static_cast<uint32_t>(nodeMass.size());
+        uint32_t count = 0;
+        for (int digit = 0; digit < (1 << D); ++digit) {
+            if (bounds[digit + 1] == bounds[digit]) continue;
+            addNode(bounds[digit], bounds[digit + 1]);
+            ++count;
+        }
+        firstChild[node] = first;
+        childCount[node] = count;
+
+        for (uint32_t c = first; c < first + count; ++c) {
+            buildNode(c, bodyBegin[c], bodyEnd[c], level + 1);
+        }
+    }
+    summarize(node);
+}
+
+template <int D>
+void BarnesHutTreeT<D>::summarize(uint32_t node) {
+    double lower[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL};
+    double upper[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+    double mass = 0.0, mx = 0.0, my = 0.0, mz = 0.0, radius = 0.0;
+    size_t begin = bodyBegin[node], end = bodyEnd[node];
+
+    if (childCount[node] > 0) {
+        for (uint32_t c = firstChild[node]; c < firstChild[node] + childCount[node]; ++c) {
+            for (int d = 0; d < D; ++d) {
+                lower[d] = std::min(lower[d], boxLower[3 * c + d]);
+                upper[d] = std::max(upper[d], boxUpper[3 * c + d]);
+            }
+            mass += nodeMass[c];
+            mx += nodeMass[c] * centerX[c];
+            my += nodeMass[c] * centerY[c];
+            mz += nodeMass[c] * centerZ[c];
+            radius = std::max(radius, nodeRadius[c]);
+        }
+    } else {
+        // Feuille
+        const double* axis[3] = {sorted.x.data(), sorted.y.data(), D == 3 ? sorted.z.data() : nullptr};
+        for (size_t k = begin; k < end; ++k) {
+            for (int d = 0; d < D; ++d) {
+                lower[d] = std::min(lower[d], axis[d][k]);
+                upper[d] = std::max(upper[d], axis[d][k]);
+            }
+            mass += sorted.mass[k];
+            mx += sorted.mass[k] * sorted.x[k];
+            my += sorted.mass[k] * sorted.y[k];
+            if (D == 3) mz += sorted.mass[k] * sorted.z[k];
+            radius = std::max(radius, sorted.radius[k]);
+        }
+    }
+    if (D == 2) {
+        lower[2] = 0.0;
+        upper[2] = 0.0;
+    }
+
+    // Sans masse, le centre de la boîte tient lieu de centre de masse
+    double middle[3], center[3];
+    for (int d = 0; d < 3; ++d) middle[d] = 0.5 * (lower[d] + upper[d]);
+    center[0] = mass > 0.0 ? mx / mass : middle[0];
+    center[1] = mass > 0.0 ? my / mass : middle[1];
+    center[2] = mass > 0.0 ? mz / mass : middle[2];
+
+    double size = 0.0, offset2 = 0.0;
+    for (int d = 0; d < 3; ++d) {
+        size = std::max(size, upper[d] - lower[d]);
+        offset2 += (center[d] - middle[d]) * (center[d] - middle[d]);
+        boxLower[3 * node + d] = lower[d];
+        boxUpper[3 * node + d] = upper[d];
+    }
+    centerX[node] = center[0];
+    centerY[node] = center[1];
+    centerZ[node] = center[2];
+    nodeMass[node] = mass;
+    nodeSize[node] = size;
+    nodeOffset[node] = std::sqrt(offset2);
+    nodeRadius[node] = radius;
+
+    // Quadrupôle : corps d'une feuille, ou enfants ramenés au centre de masse (théorème de transport)
+    double* q = &quadrupole[6 * node];
+    for (int component = 0; component < 6; ++component) q[component] = 0.0;
+    auto addPoint = [q, &center](double m, double x, double y, double z) {
+        double dx = x - center[0], dy = y - center[1], dz = z - center[2];
+        double r2 = dx * dx + dy * dy + dz * dz;
+        q[0] += m * (3.0 * dx * dx - r2);
+        q[1] += m * 3.0 * dx * dy;
+        q[2] += m * 3.0 * dx * dz;
+        q[3] += m * (3.0 * dy * dy - r2);
+        q[4] += m * 3.0 * dy * dz;
+        q[5] += m * (3.0 * dz * dz - r2);
+    };
+    if (childCount[node] > 0) {
+        for (uint32_t c = firstChild[node]; c < firstChild[node] + childCount[node]; ++c) {
+            for (int component = 0; component < 6; ++component) q[component] += quadrupole[6 * c + component];
+            addPoint(nodeMass[c], centerX[c], centerY[c], centerZ[c]);
+        }
+    } else {
+        for (size_t k = begin; k < end; ++k) {
+            addPoint(sorted.mass[k], sorted.x[k], sorted.y[k], D == 3 ? sorted.z[k] : 0.0);
+        }
+    }
+}
+
+template <int D>
+double BarnesHutTreeT<D>::boxDistance2(uint32_t node, double x, double y, double z) const {
+    const double point[3] = {x, y, z};
+    double distance2 = 0.0;
+    for (int d = 0; d < D; ++d) {
+        double below = boxLower[3 * node + d] - point[d];
+        double above = point[d] - boxUpper[3 * node + d];
+        double gap = std::max(0.0, std::max(below, above));
+        distance2 += gap * gap;
+    }
+    return distance2;
+}
+
+template <int D>
+template <typename Law, bool External>
+void BarnesHutTreeT<D>::walkTarget(const Law& law, double theta, double xi, double yi, double zi, double ri,
+                                   size_t self, double& axi, double& ayi, double& azi, double& closest,
+                                   uint64_t& interactions) const {
+    double theta2 = theta * theta;
+    uint32_t stack[WALK_STACK];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        uint32_t node = stack[--top];
+        bool contains = !External && self >= bodyBegin[node] && self < bodyEnd[node];
+
+        // Une cellule contenant la cible est toujours ouverte
+        if (!contains) {
+            double dx = centerX[node] - xi;
+            double dy = centerY[node] - yi;
+            double dz = D == 3 ? centerZ[node] - zi : 0.0;
+            double r2 = dx * dx + dy * dy + dz * dz;
+            // d > s / θ + δ, sans division : (s + θ δ)² < θ² d². Aucun corps du nœud
+            // ne doit toucher la cible (d > s + δ + rayons), sinon la loi bornée
+            // n'est plus en 1/r² et le développement ne vaut plus
+            double reach = nodeSize[node] + theta * nodeOffset[node];
+            double contact = nodeSize[node] + nodeOffset[node] + ri + nodeRadius[node];
+            if (reach * reach < theta2 * r2 && contact * contact < r2) {
+                // Monopôle avec la loi de la simulation, quadrupôle newtonien : à
+                // cette distance, les lois adoucies ou bornées sont déjà en 1/r²
+                const double* q = &quadrupole[6 * node];
+                double qx = q[0] * dx + q[1] * dy + q[2] * dz;
+                double qy = q[1] * dx + q[3] * dy + q[4] * dz;
+                double qz = q[2] * dx + q[4] * dy + q[5] * dz;
+                double inverse2 = 1.0 / r2;
+                double inverse5 = inverse2 * inverse2 / std::sqrt(r2);
+                double radial = 2.5 * (dx * qx + dy * qy + dz * qz) * inverse2;
+                double f = nodeMass[node] * law(r2, ri + nodeRadius[node]);
+                axi += f * dx + inverse5 * (radial * dx - qx);
+                ayi += f * dy + inverse5 * (radial * dy - qy);
+                if (D == 3) azi += f * dz + inverse5 * (radial * dz - qz);
+                if (External) closest = std::min(closest, boxDistance2(node, xi, yi, zi));
+                ++interactions;
+                continue;
+            }
+        }
+
+        if (childCount[node] > 0) {
+            for (uint32_t c = 0; c < childCount[node]; ++c) stack[top++] = firstChild[node] + c;
+            continue;
+        }
+
+        size_t b = bodyBegin[node], e = bodyEnd[node];
+        if (External) {
+            for (size_t j = b; j < e; ++j) {
+                double dx = sorted.x[j] - xi;
+                double dy = sorted.y[j] - yi;
+                double dz = D == 3 ? sorted.z[j] - zi : 0.0;
+                double r2 = dx * dx + dy * dy + dz * dz;
+                double f = sorted.mass[j] * law(r2, ri + sorted.radius[j]);
+                axi += f * dx;
+                ayi += f * dy;
+                if (D == 3) azi += f * dz;
+                closest = std::min(closest, r2);
+            }
+            interactions += e - b;
+        } else {
+            size_t skip = contains ? self : e;
+            if (D == 3) {
+                accumulateRange3D(sorted, law, self, b, skip, axi, ayi, azi);
+                if (contains) accumulateRange3D(sorted, law, self, self + 1, e, axi, ayi, azi);
+            } else {
+                accumulateRange(sorted, law, self, b, skip, axi, ayi);
+                if (contains) accumulateRange(sorted, law, self, self + 1, e, axi, ayi);
+            }
+            interactions += e - b - (contains ? 1 : 0);
+        }
+    }
+}
+
+template <int D>
+template <typename Law>
+uint64_t BarnesHutTreeT<D>::walk(BodyArrays& targets, double G, double softening, double theta,
+                                 size_t begin, size_t end) const {
+    Law law(softening);
+    uint64_t interactions = 0;
+    for (size_t k = begin; k < end; ++k) {
+        double axi = 0.0, ayi = 0.0, azi = 0.0, closest = 0.0;
+        walkTarget<Law, false>(law, theta, sorted.x[k], sorted.y[k], D == 3 ? sorted.z[k] : 0.0, sorted.radius[k],
+                               k, axi, ayi, azi, closest, interactions);
+        size_t row = order[k];
+        targets.ax[row] = G * axi;
+        targets.ay[row] = G * ayi;
+        if (D == 3) targets.az[row] = G * azi;
+    }
+    return interactions;
+}
+
+template <int D>
+template <typename Law>
+uint64_t BarnesHutTreeT<D>::walkExternal(BodyArrays& targets, double G, double softening, double theta,
+                                         size_t begin, size_t end, double* nearest2) const {
+    Law law(softening);
+    uint64_t interactions = 0;
+    for (size_t i = begin; i < end; ++i) {
+        double axi = 0.0, ayi = 0.0, azi = 0.0, closest = HUGE_VAL;
+        walkTarget<Law, true>(law, theta, targets.x[i], targets.y[i], D == 3 ? targets.z[i] : 0.0, targets.radius[i],
+                              NONE, axi, ayi, azi, closest, interactions);
+        targets.ax[i] = G * axi;
+        targets.ay[i] = G * ayi;
+        if (D == 3) targets.az[i] = G * azi;
+        nearest2[i] = closest;
+    }
+    return interactions;
+}
+
+template <int D>
+uint64_t BarnesHutTreeT<D>::accelerate(BodyArrays& arrays, double G, double softening, double theta,
+                                       size_t begin, size_t end) const {
+    if (nodeMass.empty()) return 0;
+    return (this->*walker)(arrays, G, softening, theta, begin, end);
+}
+
+template <int D>
+uint64_t BarnesHutTreeT<D>::accelerateExternal(BodyArrays& targets, double G, double softening, double theta,
+                                               size_t begin, size_t end, double* nearest2) const {
+    if (nodeMass.empty()) {
+        for (size_t i = begin; i < end; ++i) {
+            targets.ax[i] = 0.0;
+            targets.ay[i] = 0.0;
+            if (D == 3) targets.az[i] = 0.0;
+            nearest2[i] = HUGE_VAL;
+        }
+        return 0;
+    }
+    return (this->*externalWalker)(targets, G, softening, theta, begin, end, nearest2);
+}
+
+template <int D>
+uint32_t BarnesHutTreeT<D>::nearest(double x, double y, double z, uint32_t exclude, double& distance2) const {
+    distance2 = HUGE_VAL;
+    if (nodeMass.empty()) return NONE;
+
+    // Séparation et évaluation : une boîte plus loin que le meilleur candidat est écartée
+    uint32_t best = NONE;
+    uint32_t stack[WALK_STACK];
+    size_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        uint32_t node = stack[--top];
+        if (boxDistance2(node, x, y, z) >= distance2) continue;
+        if (childCount[node] > 0) {
+            for (uint32_t c = 0; c < childCount[node]; ++c) stack[top++] = firstChild[node] + c;
+            continue;
+        }
+        for (size_t k = bodyBegin[node]; k < bodyEnd[node]; ++k) {
+            if (order[k] == exclude) continue;
+            double dx = sorted.x[k] - x;
+            double dy = sorted.y[k] - y;
+            double dz = D == 3 ? sorted.z[k] - z : 0.0;
+            double r2 = dx * dx + dy * dy + dz * dz;
+            if (r2 < distance2) {
+                distance2 = r2;
+                best = order[k];
+            }
+        }
+    }
+    return best;
+}
+
+template class BarnesHutTreeT<2>;
+template class BarnesHutTreeT<3>;
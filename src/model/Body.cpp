@@ -1,25 +1,30 @@
 #include "../../include/Body.hpp"
 
-Body::Body(Vector2D pos, Vector2D vel, double m, double r) 
-    : position(pos), velocity(vel), acceleration(0, 0), mass(m), radius(r) {}
+template <int D>
+BodyT<D>::BodyT(VectorType pos, VectorType vel, double m, double r, ParticleClass cls)
+    : position(pos), velocity(vel), acceleration(), mass(m), radius(r), particleClass(cls), frozen(false) {}
 
-void Body::applyForce(const Vector2D& force) {
+template <int D>
+void BodyT<D>::applyForce(const VectorType& force) {
     // F = ma, donc a = F/m
     acceleration = acceleration + force * (1.0 / mass);
 }
 
-void Body::update(double deltaTime) {
+template <int D>
+void BodyT<D>::update(double deltaTime) {
     // Intégration de Verlet pour une meilleure stabilité
     velocity = velocity + acceleration * deltaTime;
     position = position + velocity * deltaTime;
 }
 
-void Body::resetAcceleration() {
-    acceleration = Vector2D(0, 0);
+template <int D>
+void BodyT<D>::resetAcceleration() {
+    acceleration = VectorType();
 }
 
-Vector2D Body::calculateGravitationalForce(const Body& other, double G) const {
-    Vector2D direction = other.position - position;
+template <int D>
+typename BodyT<D>::VectorType BodyT<D>::calculateGravitationalForce(const BodyT& other, double G) const {
+    VectorType direction = other.position - position;
     double distance = direction.magnitude();
     
     // Éviter la singularité quand les corps sont trop proches
@@ -31,7 +36,10 @@ Vector2D Body::calculateGravitationalForce(const Body& other, double G) const {
     double forceMagnitude = G * mass * other.mass / (distance * distance);
     
     // Direction normalisée
-    Vector2D forceDirection = direction.normalize();
+    VectorType forceDirection = direction.normalize();
     
     return forceDirection * forceMagnitude;
 }
+
+template class BodyT<2>;
+template class BodyT<3>;
@@ -0,0 +1,67 @@
+#include "../../include/Camera.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Écart relatif en dessous duquel l'état affiché rejoint la cible
+    const double SNAP_TOLERANCE = 1e-4;
+}
+
+constexpr double Camera::MIN_ZOOM;
+constexpr double Camera::MAX_ZOOM;
+
+Camera::Camera(double timeConstantSeconds)
+    : zoom(1.0), targetZoom(1.0), timeConstant(timeConstantSeconds), mode(CameraMode::Free), anchored(false) {}
+
+void Camera::reset(Vector2D center, double zoomLevel) {
+    offset = targetOffset = center;
+    zoom = targetZoom = std::max(MIN_ZOOM, std::min(MAX_ZOOM, zoomLevel));
+    mode = CameraMode::Free;
+    anchored = false;
+}
+
+void Camera::pan(double dx, double dy) {
+    // La cible d'un zoom au curseur en cours est déjà dans targetOffset
+    anchored = false;
+    targetOffset = targetOffset + Vector2D(dx, dy) * (1.0 / targetZoom);
+    mode = CameraMode::Free;
+}
+
+void Camera::zoomAt(double factor, Vector2D screenFromCenter) {
+    if (!(factor > 0.0)) return;
+    targetZoom = std::max(MIN_ZOOM, std::min(MAX_ZOOM, targetZoom * factor));
+    if (mode != CameraMode::Free) return;
+
+    // Point du monde actuellement sous le curseur, tel qu'affiché
+    anchorWorld = screenToWorld(screenFromCenter);
+    anchorScreen = screenFromCenter;
+    anchored = true;
+    targetOffset = anchorWorld - anchorScreen * (1.0 / targetZoom);
+}
+
+void Camera::track(Vector2D point) {
+    if (mode == CameraMode::Free) return;
+    targetOffset = point;
+}
+
+void Camera::setMode(CameraMode newMode) {
+    mode = newMode;
+    anchored = false;
+}
+
+void Camera::update(double dtSeconds) {
+    double blend = (dtSeconds <= 0.0 || timeConstant <= 0.0) ? 1.0 : 1.0 - std::exp(-dtSeconds / timeConstant);
+
+    zoom = std::exp(std::log(zoom) + (std::log(targetZoom) - std::log(zoom)) * blend);
+    if (std::abs(zoom / targetZoom - 1.0) < SNAP_TOLERANCE) zoom = targetZoom;
+
+    if (anchored) {
+        offset = anchorWorld - anchorScreen * (1.0 / zoom);
+        if (zoom == targetZoom) anchored = false;
+        return;
+    }
+
+    Vector2D remaining = targetOffset - offset;
+    offset = offset + remaining * blend;
+    if ((targetOffset - offset).magnitude() * zoom < SNAP_TOLERANCE) offset = targetOffset;
+}
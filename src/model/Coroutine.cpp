@@ -0,0 +1,174 @@
+#include "../../include/Coroutine.hpp"
+#include "../../include/Numa.hpp"
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// --- CoroutineExecutor -------------------------------------------------------
+
+CoroutineExecutor::CoroutineExecutor() : timerOrder(0), outstanding(0), completed(0), stopping(false) {}
+
+CoroutineExecutor::~CoroutineExecutor() {
+    // Les coroutines encore suspendues ne sont pas détruites : leurs cadres appartiennent à leurs tâches
+    stop();
+}
+
+void CoroutineExecutor::start(const std::vector<int>& cpus, int niceness) {
+    if (thread.joinable()) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+    thread = std::thread([this, cpus, niceness] {
+        if (!cpus.empty()) NumaTopology::pinCurrentThread(cpus);
+#ifdef __linux__
+        // Sous Linux, la priorité d'un thread se règle par son identifiant noyau
+        if (niceness != 0) setpriority(PRIO_PROCESS, static_cast<id_t>(syscall(SYS_gettid)), niceness);
+#else
+        (void)niceness;
+#endif
+        loop(false);
+    });
+}
+
+void CoroutineExecutor::run() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+    loop(true);
+}
+
+void CoroutineExecutor::loop(bool untilIdle) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        Clock::time_point now = Clock::now();
+        while (!timers.empty() && timers.top().due <= now) {
+            ready.push_back(timers.top().handle);
+            timers.pop();
+        }
+
+        if (!ready.empty()) {
+            std::coroutine_handle<> handle = ready.front();
+            ready.pop_front();
+            lock.unlock();
+            handle.resume();
+            lock.lock();
+            continue;
+        }
+
+        if (stopping) break;
+        // Plus rien de prêt ni d'armé, et aucune tâche détachée en attente d'un autre thread
+        if (untilIdle && timers.empty() && outstanding == 0) break;
+
+        if (timers.empty()) changed.wait(lock);
+        else changed.wait_until(lock, timers.top().due);
+    }
+}
+
+void CoroutineExecutor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    if (thread.joinable() && thread.get_id() != std::this_thread::get_id()) thread.join();
+}
+
+void CoroutineExecutor::drain() {
+    // Sans thread propre, c'est l'appelant qui exécute les tâches
+    if (!thread.joinable()) run();
+
+    std::unique_lock<std::mutex> lock(mutex);
+    changed.wait(lock, [this] { return outstanding == 0; });
+    if (error) {
+        std::exception_ptr failure = error;
+        error = nullptr;
+        std::rethrow_exception(failure);
+    }
+}
+
+void CoroutineExecutor::post(std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ready.push_back(handle);
+    }
+    changed.notify_all();
+}
+
+void CoroutineExecutor::addTimer(Clock::time_point due, std::coroutine_handle<> handle) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        timers.push(Timer{due, timerOrder++, handle});
+    }
+    changed.notify_all();
+}
+
+detail::DetachedTask CoroutineExecutor::launch(CoroutineExecutor& executor, AsyncTask<void> task) {
+    std::exception_ptr failure;
+    {
+        // La tâche est détruite avant finish() : drain() peut alors libérer ce qu'elle référence
+        AsyncTask<void> body = std::move(task);
+        try {
+            co_await executor.schedule();
+            co_await std::move(body);
+        } catch (...) {
+            failure = std::current_exception();
+        }
+    }
+    executor.finish(failure);
+}
+
+void CoroutineExecutor::spawn(AsyncTask<void> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++outstanding;
+    }
+    launch(*this, std::move(task));
+}
+
+void CoroutineExecutor::finish(std::exception_ptr failure) {
+    // Réveil sous le verrou : drain() ne peut rendre la main, et l'exécuteur être détruit, qu'après
+    std::lock_guard<std::mutex> lock(mutex);
+    if (failure && !error) error = failure;
+    --outstanding;
+    ++completed;
+    changed.notify_all();
+}
+
+size_t CoroutineExecutor::getPendingCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return outstanding;
+}
+
+uint64_t CoroutineExecutor::getCompletedCount() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return completed;
+}
+
+// --- AsyncSignal -------------------------------------------------------------
+
+void AsyncSignal::set() {
+    std::coroutine_handle<> handle;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!waiter) {
+            signaled = true;
+            return;
+        }
+        handle = waiter;
+        waiter = nullptr;
+    }
+    executor.post(handle);
+}
+
+bool AsyncSignal::Awaiter::await_suspend(std::coroutine_handle<> handle) {
+    std::lock_guard<std::mutex> lock(signal.mutex);
+    if (signal.signaled) {
+        // Déjà signalé : la coroutine continue sans s'arrêter
+        signal.signaled = false;
+        return false;
+    }
+    signal.waiter = handle;
+    return true;
+}
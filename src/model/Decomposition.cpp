@@ -0,0 +1,632 @@
+#include "../../include/Decomposition.hpp"
+#include "../../include/Morton.hpp"
+#include "../../include/Numa.hpp"
+#include "../../include/Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstring>
+#include <fcntl.h>
+#include <functional>
+#include <linux/futex.h>
+#include <new>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace {
+    const uint32_t QUEUE_CAPACITY = 16;
+
+    // Attente bornée : un rang mort est remarqué au plus tard après ce délai
+    const long WAIT_NANOSECONDS = 100000000L;
+
+    const uint32_t COMMAND_RUN = 1;
+    const uint32_t COMMAND_STOP = 2;
+
+    std::atomic<uint32_t> segmentSequence(0);
+
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex sur un atomique de 32 bits");
+
+    // Sans FUTEX_PRIVATE_FLAG : le mot est partagé entre processus
+    void futexWait(std::atomic<uint32_t>& word, uint32_t expected) {
+        struct timespec timeout = {0, WAIT_NANOSECONDS};
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+    }
+
+    void futexWake(std::atomic<uint32_t>& word) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+    }
+
+    uint64_t nanosecondsSince(std::chrono::steady_clock::time_point start) {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+    }
+}
+
+// --- Structures du segment partagé -------------------------------------------
+//
+// Construites une fois par start() dans le segment (mis à zéro par ftruncate),
+// avant fork : tous les processus les voient à la même place.
+
+struct SharedCommand {
+    uint32_t type;
+    uint32_t steps;
+};
+
+struct SharedReport {
+    uint64_t forceNanoseconds;
+};
+
+/**
+ * File sans verrou à un producteur et un consommateur ; le consommateur dort sur tail
+ */
+template <typename T>
+struct SharedQueue {
+    std::atomic<uint32_t> head;
+    std::atomic<uint32_t> tail;
+    T items[QUEUE_CAPACITY];
+
+    bool push(const T& item) {
+        uint32_t position = tail.load(std::memory_order_relaxed);
+        if (position - head.load(std::memory_order_acquire) == QUEUE_CAPACITY) return false;
+        items[position % QUEUE_CAPACITY] = item;
+        tail.store(position + 1, std::memory_order_release);
+        futexWake(tail);
+        return true;
+    }
+
+    bool pop(T& item) {
+        uint32_t position = head.load(std::memory_order_relaxed);
+        if (position == tail.load(std::memory_order_acquire)) return false;
+        item = items[position % QUEUE_CAPACITY];
+        head.store(position + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Attend un élément ; false si healthy() signale un arrêt pendant l'attente
+     */
+    bool waitPop(T& item, const std::function<bool()>& healthy) {
+        for (;;) {
+            if (pop(item)) return true;
+            futexWait(tail, head.load(std::memory_order_relaxed));
+            if (pop(item)) return true;
+            if (!healthy()) return false;
+        }
+    }
+};
+
+/**
+ * Barrière à génération : le dernier arrivé remet le compte à zéro puis libère les autres
+ */
+struct SharedBarrier {
+    std::atomic<uint32_t> arrived;
+    std::atomic<uint32_t> generation;
+
+    bool wait(uint32_t parties, const std::function<bool()>& healthy) {
+        uint32_t current = generation.load(std::memory_order_acquire);
+        if (arrived.fetch_add(1, std::memory_order_acq_rel) + 1 == parties) {
+            arrived.store(0, std::memory_order_relaxed);
+            generation.store(current + 1, std::memory_order_release);
+            futexWake(generation);
+            return true;
+        }
+        while (generation.load(std::memory_order_acquire) == current) {
+            futexWait(generation, current);
+            if (generation.load(std::memory_order_acquire) != current) break;
+            if (!healthy()) return false;
+        }
+        return true;
+    }
+};
+
+struct SharedState {
+    SharedBarrier barrier;
+    std::atomic<uint32_t> abort;
+    uint32_t processes;
+    uint32_t integrator;                // Lu par chaque rang au début d'un ordre
+    uint32_t current;                   // Tampon de positions à jour
+    uint32_t accelerationsCurrent;
+    uint64_t bodyCount;
+    uint64_t arrayOffset;               // Octets avant le premier tableau
+    DomainSummary domains[DecomposedSimulationT<2>::MAX_PROCESSES];
+    SharedQueue<SharedCommand> commands[DecomposedSimulationT<2>::MAX_PROCESSES];
+    SharedQueue<SharedReport> reports[DecomposedSimulationT<2>::MAX_PROCESSES];
+};
+
+// --- DecomposedSimulationT ---------------------------------------------------
+//
+// Tableaux de N doubles à la suite de l'en-tête : positions en double tampon
+// (2 D colonnes), vitesses, accélérations, masses, rayons ; puis les indices
+// d'origine des corps (N entiers).
+
+template <int D>
+DecomposedSimulationT<D>::DecomposedSimulationT(double G, double dt, ForceLaw law, double softeningLength)
+    : gravitationalConstant(G), timeStep(dt), forceLaw(law), softening(softeningLength),
+      kernels(selectForceKernels<D>(law)), integrator(Integrator::Euler), pinning(true),
+      rebalanceInterval(DEFAULT_REBALANCE_INTERVAL), imbalanceTolerance(0.1),
+      state(nullptr), mappedBytes(0), processes(0), stepCount(0), rebalanceCount(0), lastImbalance(1.0),
+      failed(false), rank(0), coordinator(0) {}
+
+template <int D>
+DecomposedSimulationT<D>::~DecomposedSimulationT() {
+    stop();
+}
+
+template <int D>
+double* DecomposedSimulationT<D>::column(int buffer, int index) const {
+    double* base = reinterpret_cast<double*>(reinterpret_cast<char*>(state) + state->arrayOffset);
+    return base + static_cast<size_t>(buffer * D + index) * state->bodyCount;
+}
+
+template <int D>
+double* DecomposedSimulationT<D>::velocity(int d) const { return column(2, d); }
+
+template <int D>
+double* DecomposedSimulationT<D>::acceleration(int d) const { return column(3, d); }
+
+template <int D>
+double* DecomposedSimulationT<D>::mass() const { return column(4, 0); }
+
+template <int D>
+double* DecomposedSimulationT<D>::radius() const { return column(4, 1); }
+
+template <int D>
+uint64_t* DecomposedSimulationT<D>::identity() const { return reinterpret_cast<uint64_t*>(column(4, 2)); }
+
+template <int D>
+bool DecomposedSimulationT<D>::start(const SimulationT<D>& initial, int processCount) {
+    stop();
+    failed = false;
+    lastError.clear();
+    stepCount = 0;
+    rebalanceCount = 0;
+    lastImbalance = 1.0;
+
+    const auto& bodies = initial.getBodies();
+    for (const auto& body : bodies) {
+        if (body->isTracer()) {
+            lastError = "traceurs non pris en charge par la décomposition";
+            return false;
+        }
+    }
+    processCount = std::max(1, std::min(processCount, static_cast<int>(MAX_PROCESSES)));
+    size_t n = bodies.size();
+    size_t header = (sizeof(SharedState) + 63) / 64 * 64;
+    size_t bytes = header + (4 * D + 3) * n * sizeof(double);
+
+    // Segment nommé le temps de la projection seulement : rien ne reste dans /dev/shm
+    std::string name = "/ncorps-" + std::to_string(getpid()) + "-" + std::to_string(segmentSequence++);
+    int descriptor = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (descriptor < 0) {
+        lastError = "shm_open: " + std::string(std::strerror(errno));
+        return false;
+    }
+    void* address = MAP_FAILED;
+    if (ftruncate(descriptor, static_cast<off_t>(bytes)) == 0) {
+        address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    }
+    int error = errno;
+    shm_unlink(name.c_str());
+    ::close(descriptor);
+    if (address == MAP_FAILED) {
+        lastError = "mémoire partagée: " + std::string(std::strerror(error));
+        return false;
+    }
+
+    state = new (address) SharedState();
+    mappedBytes = bytes;
+    processes = processCount;
+    state->processes = processCount;
+    state->integrator = static_cast<uint32_t>(integrator);
+    state->bodyCount = n;
+    state->arrayOffset = header;
+    for (size_t i = 0; i < n; ++i) {
+        VectorType p = bodies[i]->getPosition();
+        VectorType v = bodies[i]->getVelocity();
+        VectorType a = bodies[i]->getAcceleration();
+        for (int d = 0; d < D; ++d) {
+            column(0, d)[i] = p[d];
+            velocity(d)[i] = v[d];
+            acceleration(d)[i] = a[d];
+        }
+        mass()[i] = bodies[i]->getMass();
+        radius()[i] = bodies[i]->getRadius();
+        identity()[i] = i;
+    }
+    sortAlongCurve(std::vector<double>(processCount, 1.0));
+
+    NumaTopology topology;
+    for (int r = 0; r < processCount; ++r) {
+        state->domains[r].node = topology.nodeForRank(r).id;
+    }
+
+    coordinator = getpid();
+    for (int r = 1; r < processCount; ++r) {
+        pid_t pid = fork();
+        if (pid < 0) {
+            lastError = "fork: " + std::string(std::strerror(errno));
+            stop();
+            return false;
+        }
+        if (pid == 0) {
+            // Rang r : tué avec le coordinateur, jamais de retour dans le code appelant
+            prctl(PR_SET_PDEATHSIG, SIGKILL);
+            if (getppid() != coordinator) _exit(1);
+            rank = r;
+            workers.clear();
+            if (pinning) NumaTopology::pinCurrentThread(topology.nodeForRank(r).cpus);
+            workerLoop();
+            _exit(0);
+        }
+        workers.push_back(pid);
+    }
+    rank = 0;
+    if (pinning) NumaTopology::pinCurrentThread(topology.nodeForRank(0).cpus);
+    return true;
+}
+
+template <int D>
+void DecomposedSimulationT<D>::stop() {
+    if (!state) return;
+    for (int r = 1; r < processes; ++r) {
+        SharedCommand command = {COMMAND_STOP, 0};
+        state->commands[r].push(command);
+    }
+    // Un rang bloqué dans la barrière (pas interrompu) sort aussi
+    state->abort.store(1, std::memory_order_release);
+    futexWake(state->barrier.generation);
+    for (pid_t pid : workers) {
+        waitpid(pid, nullptr, 0);
+    }
+    workers.clear();
+    munmap(state, mappedBytes);
+    state = nullptr;
+    mappedBytes = 0;
+    processes = 0;
+    arrays = BodyArrays();
+}
+
+template <int D>
+bool DecomposedSimulationT<D>::healthy() {
+    if (state->abort.load(std::memory_order_acquire)) return false;
+    if (rank != 0) return getppid() == coordinator;
+
+    for (size_t w = 0; w < workers.size(); ++w) {
+        int status;
+        if (waitpid(workers[w], &status, WNOHANG) == workers[w]) {
+            lastError = "rang " + std::to_string(w + 1) + " arrêté"
+                        + (WIFSIGNALED(status) ? " (signal " + std::to_string(WTERMSIG(status)) + ")" : "");
+            workers.erase(workers.begin() + w);
+            state->abort.store(1, std::memory_order_release);
+            futexWake(state->barrier.generation);
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int D>
+void DecomposedSimulationT<D>::workerLoop() {
+    std::function<bool()> check = [this]() { return healthy(); };
+    for (;;) {
+        SharedCommand command;
+        if (!state->commands[rank].waitPop(command, check) || command.type == COMMAND_STOP) return;
+        SharedReport report;
+        report.forceNanoseconds = 0;
+        if (!runSteps(command.steps, report.forceNanoseconds)) return;
+        state->reports[rank].push(report);
+    }
+}
+
+template <int D>
+void DecomposedSimulationT<D>::gather(int buffer) {
+    size_t n = state->bodyCount;
+    size_t bytes = n * sizeof(double);
+    arrays.resize(n, D);
+    std::memcpy(arrays.x.data(), column(buffer, 0), bytes);
+    std::memcpy(arrays.y.data(), column(buffer, 1), bytes);
+    if (D == 3) std::memcpy(arrays.z.data(), column(buffer, 2), bytes);
+    std::memcpy(arrays.mass.data(), mass(), bytes);
+    std::memcpy(arrays.radius.data(), radius(), bytes);
+}
+
+template <int D>
+void DecomposedSimulationT<D>::computeOwnForces(int buffer, uint64_t& forceNanoseconds) {
+    PROFILE_SCOPE("Decomposition::calculateForces");
+    const DomainSummary& domain = state->domains[rank];
+    gather(buffer);
+    auto start = std::chrono::steady_clock::now();
+    if (state->processes == 1) {
+        // Rang seul : boucle symétrique de SimulationT, chaque paire une fois
+        std::fill(arrays.ax.begin(), arrays.ax.end(), 0.0);
+        std::fill(arrays.ay.begin(), arrays.ay.end(), 0.0);
+        std::fill(arrays.az.begin(), arrays.az.end(), 0.0);
+        kernels.pairwise(arrays, gravitationalConstant, softening);
+    } else {
+        kernels.rows(arrays, gravitationalConstant, softening, domain.begin, domain.end);
+    }
+    forceNanoseconds += nanosecondsSince(start);
+
+    size_t count = domain.end - domain.begin;
+    std::memcpy(acceleration(0) + domain.begin, arrays.ax.data() + domain.begin, count * sizeof(double));
+    std::memcpy(acceleration(1) + domain.begin, arrays.ay.data() + domain.begin, count * sizeof(double));
+    if (D == 3) std::memcpy(acceleration(2) + domain.begin, arrays.az.data() + domain.begin, count * sizeof(double));
+}
+
+template <int D>
+bool DecomposedSimulationT<D>::runSteps(uint64_t steps, uint64_t& forceNanoseconds) {
+    std::function<bool()> check = [this]() { return healthy(); };
+    const DomainSummary& domain = state->domains[rank];
+    uint32_t parties = state->processes;
+    int current = static_cast<int>(state->current);
+    bool accelerationsCurrent = state->accelerationsCurrent != 0;
+    bool leapfrog = state->integrator == static_cast<uint32_t>(Integrator::Leapfrog);
+    double fullStep = timeStep;
+    double halfStep = 0.5 * timeStep;
+
+    for (uint64_t s = 0; s < steps; ++s) {
+        int next = 1 - current;
+        if (leapfrog && !accelerationsCurrent) computeOwnForces(current, forceNanoseconds);
+        if (!leapfrog) computeOwnForces(current, forceNanoseconds);
+
+        // Mêmes opérations que Body::update (Euler) et Body::kick puis Body::drift (leapfrog)
+        double kickStep = leapfrog ? halfStep : fullStep;
+        for (int d = 0; d < D; ++d) {
+            const double* x = column(current, d);
+            double* xNext = column(next, d);
+            double* v = velocity(d);
+            const double* a = acceleration(d);
+            for (size_t i = domain.begin; i < domain.end; ++i) {
+                v[i] = v[i] + a[i] * kickStep;
+                xNext[i] = x[i] + v[i] * fullStep;
+            }
+        }
+
+        // Tranche écrite dans l'autre tampon : personne ne relit le courant après la barrière
+        if (!state->barrier.wait(parties, check)) return false;
+        current = next;
+
+        if (leapfrog) {
+            computeOwnForces(current, forceNanoseconds);
+            for (int d = 0; d < D; ++d) {
+                double* v = velocity(d);
+                const double* a = acceleration(d);
+                for (size_t i = domain.begin; i < domain.end; ++i) v[i] = v[i] + a[i] * halfStep;
+            }
+        }
+        accelerationsCurrent = leapfrog;
+    }
+    publishSummary();
+
+    // Les autres rangs ont lu ces champs avant la première barrière de l'ordre
+    if (rank == 0) {
+        state->current = static_cast<uint32_t>(current);
+        state->accelerationsCurrent = accelerationsCurrent ? 1 : 0;
+    }
+    return true;
+}
+
+template <int D>
+void DecomposedSimulationT<D>::publishSummary() {
+    // Somme directe : chaque rang relit toutes les positions, seule la masse de la tranche est résumée
+    DomainSummary& domain = state->domains[rank];
+    double total = 0.0;
+    for (size_t i = domain.begin; i < domain.end; ++i) total += mass()[i];
+    domain.mass = total;
+}
+
+template <int D>
+void DecomposedSimulationT<D>::sortAlongCurve(const std::vector<double>& weights) {
+    size_t n = state->bodyCount;
+    int current = static_cast<int>(state->current);
+
+    // Clés de Morton dans la boîte englobante
+    double lower[D], scale[D];
+    uint64_t cells = mortonCells(D);
+    for (int d = 0; d < D; ++d) {
+        const double* x = column(current, d);
+        double low = HUGE_VAL, high = -HUGE_VAL;
+        for (size_t i = 0; i < n; ++i) {
+            low = std::min(low, x[i]);
+            high = std::max(high, x[i]);
+        }
+        lower[d] = low;
+        scale[d] = high > low ? (cells - 1) / (high - low) : 0.0;
+    }
+    std::vector<uint64_t> keys(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t cell[D];
+        for (int d = 0; d < D; ++d) {
+            cell[d] = mortonQuantize(column(current, d)[i], lower[d], scale[d], cells);
+        }
+        keys[i] = mortonKey<D>(cell);
+    }
+    std::vector<size_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(), [&keys](size_t a, size_t b) { return keys[a] < keys[b]; });
+
+    // Une colonne à la fois : un seul tableau temporaire
+    std::vector<double> scratch(n);
+    auto permute = [&order, &scratch, n](double* values) {
+        for (size_t i = 0; i < n; ++i) scratch[i] = values[order[i]];
+        std::copy(scratch.begin(), scratch.end(), values);
+    };
+    for (int d = 0; d < D; ++d) {
+        permute(column(current, d));
+        permute(velocity(d));
+        permute(acceleration(d));
+    }
+    permute(mass());
+    permute(radius());
+    std::vector<uint64_t> ids(identity(), identity() + n);
+    for (size_t i = 0; i < n; ++i) identity()[i] = ids[order[i]];
+
+    // Tranches proportionnelles aux vitesses des rangs
+    double total = 0.0;
+    for (int r = 0; r < processes; ++r) total += weights[r];
+    double cumulative = 0.0;
+    uint64_t begin = 0;
+    for (int r = 0; r < processes; ++r) {
+        cumulative += weights[r];
+        uint64_t end = r + 1 == processes ? n : static_cast<uint64_t>(std::llround(n * cumulative / total));
+        state->domains[r].begin = begin;
+        state->domains[r].end = std::max(begin, std::min<uint64_t>(end, n));
+        state->domains[r].forceSeconds = 0.0;
+        begin = state->domains[r].end;
+    }
+}
+
+template <int D>
+void DecomposedSimulationT<D>::step() {
+    if (!state || failed) return;
+    PROFILE_SCOPE("Decomposition::step");
+    std::function<bool()> check = [this]() { return healthy(); };
+    for (int r = 1; r < processes; ++r) {
+        SharedCommand command = {COMMAND_RUN, 1};
+        state->commands[r].push(command);
+    }
+
+    uint64_t forceNanoseconds = 0;
+    bool completed = runSteps(1, forceNanoseconds);
+    state->domains[0].forceSeconds += forceNanoseconds * 1e-9;
+    for (int r = 1; completed && r < processes; ++r) {
+        SharedReport report;
+        completed = state->reports[r].waitPop(report, check);
+        if (completed) state->domains[r].forceSeconds += report.forceNanoseconds * 1e-9;
+    }
+    if (!completed) {
+        failed = true;
+        if (lastError.empty()) lastError = "décomposition interrompue";
+        return;
+    }
+
+    stepCount++;
+    if (rebalanceInterval > 0 && stepCount % rebalanceInterval == 0) maybeRebalance();
+}
+
+template <int D>
+void DecomposedSimulationT<D>::maybeRebalance() {
+    double slowest = 0.0, total = 0.0;
+    for (int r = 0; r < processes; ++r) {
+        slowest = std::max(slowest, state->domains[r].forceSeconds);
+        total += state->domains[r].forceSeconds;
+    }
+    lastImbalance = total > 0.0 ? slowest * processes / total : 1.0;
+    if (lastImbalance > 1.0 + imbalanceTolerance) {
+        rebalance();
+    } else {
+        for (int r = 0; r < processes; ++r) state->domains[r].forceSeconds = 0.0;
+    }
+}
+
+template <int D>
+void DecomposedSimulationT<D>::rebalance() {
+    if (!state || failed) return;
+    // Vitesse de chaque rang en corps par seconde ; sans mesure, parts égales
+    std::vector<double> weights(processes, 1.0);
+    bool measured = true;
+    for (int r = 0; r < processes; ++r) {
+        const DomainSummary& domain = state->domains[r];
+        measured = measured && domain.forceSeconds > 0.0 && domain.end > domain.begin;
+    }
+    if (measured) {
+        for (int r = 0; r < processes; ++r) {
+            const DomainSummary& domain = state->domains[r];
+            weights[r] = (domain.end - domain.begin) / domain.forceSeconds;
+        }
+    }
+    sortAlongCurve(weights);
+    // Accélérations permutées avec les corps : le leapfrog les reprend telles quelles
+    rebalanceCount++;
+}
+
+template <int D>
+void DecomposedSimulationT<D>::setIntegrator(Integrator scheme) {
+    integrator = scheme;
+    if (state) {
+        state->integrator = static_cast<uint32_t>(scheme);
+        state->accelerationsCurrent = 0;
+    }
+}
+
+template <int D>
+size_t DecomposedSimulationT<D>::getBodyCount() const {
+    return state ? state->bodyCount : 0;
+}
+
+template <int D>
+std::vector<DomainSummary> DecomposedSimulationT<D>::getDomains() const {
+    if (!state) return std::vector<DomainSummary>();
+    return std::vector<DomainSummary>(state->domains, state->domains + processes);
+}
+
+template <int D>
+bool DecomposedSimulationT<D>::exportTo(SimulationT<D>& simulation) const {
+    if (!state) return false;
+    size_t n = state->bodyCount;
+    int current = static_cast<int>(state->current);
+    std::vector<std::unique_ptr<BodyType>> bodies(n);
+    for (size_t i = 0; i < n; ++i) {
+        VectorType p, v, a;
+        for (int d = 0; d < D; ++d) {
+            p[d] = column(current, d)[i];
+            v[d] = velocity(d)[i];
+            a[d] = acceleration(d)[i];
+        }
+        std::unique_ptr<BodyType> body(new BodyType(p, v, mass()[i], radius()[i]));
+        body->setAcceleration(a);
+        bodies[identity()[i]] = std::move(body);
+    }
+    simulation.replaceBodies(std::move(bodies));
+    return true;
+}
+
+template <int D>
+double DecomposedSimulationT<D>::computeEnergy() const {
+    // Corps remis dans l'ordre d'origine : exactement la valeur de SimulationT
+    SimulationT<D> copy(gravitationalConstant, timeStep, forceLaw, softening);
+    if (!exportTo(copy)) return 0.0;
+    return copy.computeEnergy();
+}
+
+template <int D>
+uint64_t DecomposedSimulationT<D>::computeStateHash() const {
+    if (!state) return 0;
+    size_t n = state->bodyCount;
+    int current = static_cast<int>(state->current);
+    std::vector<size_t> position(n);
+    for (size_t i = 0; i < n; ++i) position[identity()[i]] = i;
+
+    // FNV-1a puis splitmix64 dans l'ordre d'origine : voir SimulationT::stateHashOf
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ bits) * 1099511628211ULL;
+    };
+    for (size_t k = 0; k < n; ++k) {
+        size_t i = position[k];
+        for (int d = 0; d < D; ++d) {
+            mix(column(current, d)[i]);
+            mix(velocity(d)[i]);
+        }
+    }
+
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+template class DecomposedSimulationT<2>;
+template class DecomposedSimulationT<3>;
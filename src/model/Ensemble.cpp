@@ -0,0 +1,193 @@
+#include "../../include/Ensemble.hpp"
+#include "../../include/TaskScheduler.hpp"
+#include "../../include/Profiler.hpp"
+#include <algorithm>
+
+namespace {
+    // Systèmes par bloc : 4 corps * 256 voies * 9 tableaux de doubles ≈ 72 Ko
+    const size_t LANE_BLOCK = 256;
+}
+
+template <int D>
+EnsembleT<D>::EnsembleT(size_t bodies, ForceLaw law, double softeningLength)
+    : bodiesPerSystem(bodies), forceLaw(law), softening(softeningLength),
+      systemCount(0), stride(0), stepCount(0), scheduler(nullptr) {}
+
+template <int D>
+void EnsembleT<D>::reserveLanes(size_t lanes) {
+    if (lanes <= stride) return;
+    
+    size_t newStride = std::max(lanes, stride * 2);
+    size_t count = bodiesPerSystem * newStride;
+    
+    // Nouveau pas entre corps : recopie ligne par ligne
+    auto repack = [&](std::vector<double>& values) {
+        std::vector<double> packed(count, 0.0);
+        for (size_t k = 0; k < bodiesPerSystem && stride > 0; ++k) {
+            std::copy(values.begin() + k * stride, values.begin() + k * stride + systemCount,
+                      packed.begin() + k * newStride);
+        }
+        values.swap(packed);
+    };
+    
+    for (int d = 0; d < D; ++d) {
+        repack(position[d]);
+        repack(velocity[d]);
+        repack(acceleration[d]);
+    }
+    repack(mass);
+    repack(radius);
+    stride = newStride;
+}
+
+template <int D>
+bool EnsembleT<D>::addSystem(const SimulationT<D>& simulation) {
+    if (simulation.getBodyCount() != bodiesPerSystem || simulation.getForceLaw() != forceLaw ||
+        simulation.getSoftening() != softening) {
+        return false;
+    }
+    
+    reserveLanes(systemCount + 1);
+    size_t s = systemCount;
+    const auto& bodies = simulation.getBodies();
+    for (size_t k = 0; k < bodiesPerSystem; ++k) {
+        VectorType p = bodies[k]->getPosition();
+        VectorType v = bodies[k]->getVelocity();
+        for (int d = 0; d < D; ++d) {
+            position[d][k * stride + s] = p[d];
+            velocity[d][k * stride + s] = v[d];
+        }
+        mass[k * stride + s] = bodies[k]->getMass();
+        radius[k * stride + s] = bodies[k]->getRadius();
+    }
+    gravitationalConstant.push_back(simulation.getGravitationalConstant());
+    timeStep.push_back(simulation.getTimeStep());
+    systemCount++;
+    return true;
+}
+
+template <int D>
+template <typename Law>
+void EnsembleT<D>::stepLanes(size_t begin, size_t end, int steps) {
+    Law law(softening);
+    const size_t K = bodiesPerSystem;
+    const double* G = gravitationalConstant.data();
+    const double* dt = timeStep.data();
+    
+    for (int step = 0; step < steps; ++step) {
+        for (int d = 0; d < D; ++d) {
+            for (size_t k = 0; k < K; ++k) {
+                std::fill(acceleration[d].begin() + k * stride + begin, acceleration[d].begin() + k * stride + end, 0.0);
+            }
+        }
+        
+        // Forces égales et opposées, une paire (i, j) à la fois pour tous les systèmes du bloc
+        for (size_t i = 0; i < K; ++i) {
+            for (size_t j = i + 1; j < K; ++j) {
+                const double* xi = position[0].data() + i * stride;
+                const double* xj = position[0].data() + j * stride;
+                const double* yi = position[1].data() + i * stride;
+                const double* yj = position[1].data() + j * stride;
+                const double* zi = position[D - 1].data() + i * stride;
+                const double* zj = position[D - 1].data() + j * stride;
+                const double* mi = mass.data() + i * stride;
+                const double* mj = mass.data() + j * stride;
+                const double* ri = radius.data() + i * stride;
+                const double* rj = radius.data() + j * stride;
+                double* axi = acceleration[0].data() + i * stride;
+                double* axj = acceleration[0].data() + j * stride;
+                double* ayi = acceleration[1].data() + i * stride;
+                double* ayj = acceleration[1].data() + j * stride;
+                double* azi = acceleration[D - 1].data() + i * stride;
+                double* azj = acceleration[D - 1].data() + j * stride;
+                
+#pragma omp simd
+                for (size_t s = begin; s < end; ++s) {
+                    double dx = xj[s] - xi[s];
+                    double dy = yj[s] - yi[s];
+                    double dz = D == 3 ? zj[s] - zi[s] : 0.0;
+                    double r2 = dx * dx + dy * dy;
+                    if (D == 3) r2 += dz * dz;
+                    double f = G[s] * law(r2, ri[s] + rj[s]);
+                    axi[s] += f * mj[s] * dx;
+                    ayi[s] += f * mj[s] * dy;
+                    axj[s] -= f * mi[s] * dx;
+                    ayj[s] -= f * mi[s] * dy;
+                    if (D == 3) {
+                        azi[s] += f * mj[s] * dz;
+                        azj[s] -= f * mi[s] * dz;
+                    }
+                }
+            }
+        }
+        
+        // Euler symplectique, comme Body::update
+        for (int d = 0; d < D; ++d) {
+            for (size_t k = 0; k < K; ++k) {
+                double* p = position[d].data() + k * stride;
+                double* v = velocity[d].data() + k * stride;
+                const double* a = acceleration[d].data() + k * stride;
+                
+#pragma omp simd
+                for (size_t s = begin; s < end; ++s) {
+                    v[s] = v[s] + a[s] * dt[s];
+                    p[s] = p[s] + v[s] * dt[s];
+                }
+            }
+        }
+    }
+}
+
+template <int D>
+void EnsembleT<D>::run(int steps, const SystemCallback& onSystemDone) {
+    PROFILE_SCOPE("Ensemble::run");
+    
+    void (EnsembleT::*kernel)(size_t, size_t, int);
+    switch (forceLaw) {
+        case ForceLaw::Newtonian: kernel = &EnsembleT::stepLanes<NewtonianForce>; break;
+        case ForceLaw::Plummer: kernel = &EnsembleT::stepLanes<PlummerForce>; break;
+        case ForceLaw::Spline: kernel = &EnsembleT::stepLanes<SplineForce>; break;
+        case ForceLaw::Clamped:
+        default: kernel = &EnsembleT::stepLanes<ClampedForce>; break;
+    }
+    
+    auto block = [&](size_t begin, size_t end) {
+        PROFILE_SCOPE("Ensemble::block");
+        (this->*kernel)(begin, end, steps);
+        if (onSystemDone) {
+            for (size_t s = begin; s < end; ++s) {
+                onSystemDone(s);
+            }
+        }
+    };
+    
+    if (scheduler && scheduler->getThreadCount() > 1 && systemCount > LANE_BLOCK) {
+        scheduler->parallelFor(0, systemCount, LANE_BLOCK, block);
+    } else {
+        for (size_t begin = 0; begin < systemCount; begin += LANE_BLOCK) {
+            block(begin, std::min(begin + LANE_BLOCK, systemCount));
+        }
+    }
+    stepCount += steps;
+}
+
+template <int D>
+typename EnsembleT<D>::VectorType EnsembleT<D>::getPosition(size_t system, size_t body) const {
+    VectorType result;
+    for (int d = 0; d < D; ++d) {
+        result[d] = position[d][body * stride + system];
+    }
+    return result;
+}
+
+template <int D>
+typename EnsembleT<D>::VectorType EnsembleT<D>::getVelocity(size_t system, size_t body) const {
+    VectorType result;
+    for (int d = 0; d < D; ++d) {
+        result[d] = velocity[d][body * stride + system];
+    }
+    return result;
+}
+
+template class EnsembleT<2>;
+template class EnsembleT<3>;
@@ -0,0 +1,225 @@
+#include "../../include/ForceSolver.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+    const size_t TILE_SIZES[] = {256, 2048};
+    const double OPENING_ANGLES[] = {0.3, 0.5, 0.7};
+    const size_t LEAF_SIZES[] = {8, 32};
+}
+
+std::string SolverConfig::describe() const {
+    std::ostringstream text;
+    text << solverKindName(kind);
+    if (kind == SolverKind::Blocked) text << " tile=" << tileSize;
+    if (kind == SolverKind::Tree) text << " theta=" << openingAngle << " leaf=" << leafSize;
+    text << " threads=";
+    if (threads == 0) text << "pool";
+    else text << threads;
+    return text.str();
+}
+
+bool parseSolverConfig(const std::string& text, SolverConfig& config) {
+    std::istringstream words(text);
+    std::string word;
+    SolverConfig parsed;
+    if (!(words >> word)) return false;
+    if (word != "direct" && !parseSolverKind(word, parsed.kind)) return false;
+
+    // Nombres lus par from_chars : indépendants de la locale, comme les scènes
+    while (words >> word) {
+        size_t equal = word.find('=');
+        if (equal == std::string::npos) return false;
+        std::string key = word.substr(0, equal);
+        const char* first = word.c_str() + equal + 1;
+        const char* last = word.c_str() + word.size();
+        std::from_chars_result result;
+        if (key == "theta") {
+            result = std::from_chars(first, last, parsed.openingAngle);
+            if (result.ec == std::errc() && parsed.openingAngle < 0.0) return false;
+        } else if (key == "tile") {
+            result = std::from_chars(first, last, parsed.tileSize);
+            if (result.ec == std::errc() && parsed.tileSize == 0) return false;
+        } else if (key == "leaf") {
+            result = std::from_chars(first, last, parsed.leafSize);
+            if (result.ec == std::errc() && parsed.leafSize == 0) return false;
+        } else if (key == "threads") {
+            if (std::string(first, last) == "pool") {
+                parsed.threads = 0;
+                continue;
+            }
+            result = std::from_chars(first, last, parsed.threads);
+        } else {
+            return false;
+        }
+        if (result.ec != std::errc() || result.ptr != last) return false;
+    }
+    config = parsed;
+    return true;
+}
+
+std::vector<SolverConfig> solverCandidates(unsigned poolThreads) {
+    std::vector<unsigned> threadCounts(1, 0);
+    if (poolThreads > 1) threadCounts.push_back(1);
+
+    std::vector<SolverConfig> candidates;
+    for (unsigned threads : threadCounts) {
+        SolverConfig config;
+        config.threads = threads;
+        candidates.push_back(config);
+    }
+    for (unsigned threads : threadCounts) {
+        for (size_t tile : TILE_SIZES) {
+            SolverConfig config;
+            config.kind = SolverKind::Blocked;
+            config.threads = threads;
+            config.tileSize = tile;
+            candidates.push_back(config);
+        }
+    }
+    for (unsigned threads : threadCounts) {
+        for (double theta : OPENING_ANGLES) {
+            for (size_t leaf : LEAF_SIZES) {
+                SolverConfig config;
+                config.kind = SolverKind::Tree;
+                config.threads = threads;
+                config.openingAngle = theta;
+                config.leafSize = leaf;
+                candidates.push_back(config);
+            }
+        }
+    }
+    return candidates;
+}
+
+double accelerationError(const BodyArrays& approximate, const BodyArrays& exact) {
+    bool threeDimensional = exact.isThreeDimensional();
+    double difference = 0.0, norm = 0.0;
+    for (size_t i = 0; i < exact.size(); ++i) {
+        double dx = approximate.ax[i] - exact.ax[i];
+        double dy = approximate.ay[i] - exact.ay[i];
+        double dz = threeDimensional ? approximate.az[i] - exact.az[i] : 0.0;
+        double az = threeDimensional ? exact.az[i] : 0.0;
+        difference += dx * dx + dy * dy + dz * dz;
+        norm += exact.ax[i] * exact.ax[i] + exact.ay[i] * exact.ay[i] + az * az;
+    }
+    if (!(norm > 0.0)) return difference > 0.0 ? HUGE_VAL : 0.0;
+    return std::sqrt(difference / norm);
+}
+
+double measureClustering(const BodyArrays& arrays) {
+    size_t n = arrays.size();
+    if (n < 2) return 1.0;
+    int dimension = arrays.isThreeDimensional() ? 3 : 2;
+
+    // Environ N cellules, autant par axe, sur la boîte englobante
+    size_t perAxis = std::max<size_t>(1, static_cast<size_t>(std::pow(static_cast<double>(n), 1.0 / dimension)));
+    const double* axis[3] = {arrays.x.data(), arrays.y.data(), dimension == 3 ? arrays.z.data() : nullptr};
+    double lower[3] = {0.0, 0.0, 0.0}, scale[3] = {0.0, 0.0, 0.0};
+    for (int d = 0; d < dimension; ++d) {
+        double low = HUGE_VAL, high = -HUGE_VAL;
+        for (size_t i = 0; i < n; ++i) {
+            low = std::min(low, axis[d][i]);
+            high = std::max(high, axis[d][i]);
+        }
+        lower[d] = low;
+        scale[d] = high > low ? perAxis / (high - low) : 0.0;
+    }
+
+    size_t cells = 1;
+    for (int d = 0; d < dimension; ++d) cells *= perAxis;
+    std::vector<char> occupied(cells, 0);
+    size_t count = 0;
+    for (size_t i = 0; i < n; ++i) {
+        size_t cell = 0;
+        for (int d = 0; d < dimension; ++d) {
+            double q = (axis[d][i] - lower[d]) * scale[d];
+            size_t c = q >= 0.0 ? std::min(perAxis - 1, static_cast<size_t>(q)) : 0;
+            cell = cell * perAxis + c;
+        }
+        if (!occupied[cell]) {
+            occupied[cell] = 1;
+            ++count;
+        }
+    }
+    return static_cast<double>(count) / static_cast<double>(std::min(n, cells));
+}
+
+std::string solverKey(int dimension, ForceLaw law, size_t count, double clustering, unsigned poolThreads,
+                      double accuracy) {
+    int sizeClass = count > 0 ? static_cast<int>(std::floor(2.0 * std::log2(static_cast<double>(count)))) : 0;
+    int clusterClass = clustering > 0.0 ? static_cast<int>(std::floor(-2.0 * std::log2(std::min(clustering, 1.0)))) : 99;
+    std::ostringstream key;
+    key << "d" << dimension << "-" << forceLawName(law) << "-n" << sizeClass << "-c" << clusterClass
+        << "-t" << poolThreads << "-a" << accuracy;
+    return key.str();
+}
+
+SolverCache::SolverCache(const std::string& path) : path(path), machine(machineName()) {}
+
+std::string SolverCache::defaultPath() {
+    const char* cache = std::getenv("XDG_CACHE_HOME");
+    if (cache && cache[0] != '\0') return std::string(cache) + "/n-corps-solvers.txt";
+    const char* home = std::getenv("HOME");
+    if (home && home[0] != '\0') return std::string(home) + "/.cache/n-corps-solvers.txt";
+    return "n-corps-solvers.txt";
+}
+
+std::string SolverCache::machineName() {
+    char host[256] = {0};
+    if (gethostname(host, sizeof(host) - 1) != 0 || host[0] == '\0') {
+        std::snprintf(host, sizeof(host), "localhost");
+    }
+    std::string name(host);
+    std::replace(name.begin(), name.end(), ' ', '_');
+    std::ostringstream text;
+    text << name << "/" << std::thread::hardware_concurrency();
+    return text.str();
+}
+
+bool SolverCache::lookup(const std::string& key, SolverConfig& config) const {
+    if (path.empty()) return false;
+    std::ifstream file(path.c_str());
+    if (!file) return false;
+
+    bool found = false;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string lineMachine, lineKey, kindName;
+        SolverConfig entry;
+        double seconds = 0.0;
+        if (!(fields >> lineMachine >> lineKey >> kindName >> entry.threads >> entry.tileSize
+                     >> entry.openingAngle >> entry.leafSize >> seconds)) {
+            continue;
+        }
+        if (lineMachine != machine || lineKey != key || !parseSolverKind(kindName, entry.kind)) continue;
+        config = entry;
+        found = true;
+    }
+    return found;
+}
+
+bool SolverCache::store(const std::string& key, const SolverConfig& config, double seconds) const {
+    if (path.empty()) return false;
+    // Le dossier parent (~/.cache) n'existe pas toujours ; un seul niveau est créé
+    size_t slash = path.rfind('/');
+    if (slash != std::string::npos && slash > 0) {
+        mkdir(path.substr(0, slash).c_str(), 0755);
+    }
+
+    std::ofstream file(path.c_str(), std::ios::app);
+    if (!file) return false;
+    file << machine << " " << key << " " << solverKindName(config.kind) << " " << config.threads << " "
+         << config.tileSize << " " << config.openingAngle << " " << config.leafSize << " " << seconds << "\n";
+    return static_cast<bool>(file);
+}
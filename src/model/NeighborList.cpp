@@ -0,0 +1,157 @@
+#include "../../include/NeighborList.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Au-delà, la cellule est agrandie : la grille reste en O(N) mémoire
+    // même si quelques corps éjectés étirent la boîte englobante
+    const size_t MAX_CELLS_PER_BODY = 4;
+}
+
+NeighborList::NeighborList(double cutoffRadius, double skinThickness)
+    : cutoff(cutoffRadius), skin(skinThickness),
+      updateCount(0), rebuildCount(0), listLengthSum(0), bodyCountSum(0) {}
+
+bool NeighborList::needsRebuild(const BodyArrays& arrays) const {
+    size_t n = arrays.size();
+    if (referenceX.size() != n) {
+        return true;
+    }
+
+    double limit2 = 0.25 * skin * skin;
+    const double* x = arrays.x.data();
+    const double* y = arrays.y.data();
+    const double* z = arrays.z.data();
+    const double* x0 = referenceX.data();
+    const double* y0 = referenceY.data();
+    const double* z0 = referenceZ.data();
+    bool threeDimensional = arrays.isThreeDimensional();
+
+    double maxDisplacement2 = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        double dx = x[i] - x0[i];
+        double dy = y[i] - y0[i];
+        double dz = threeDimensional ? z[i] - z0[i] : 0.0;
+        maxDisplacement2 = std::max(maxDisplacement2, dx * dx + dy * dy + dz * dz);
+    }
+    return maxDisplacement2 > limit2;
+}
+
+bool NeighborList::update(const BodyArrays& arrays) {
+    ++updateCount;
+    if (!needsRebuild(arrays)) {
+        return false;
+    }
+    build(arrays);
+    return true;
+}
+
+void NeighborList::build(const BodyArrays& arrays) {
+    size_t n = arrays.size();
+    const double* x = arrays.x.data();
+    const double* y = arrays.y.data();
+    const double* z = arrays.z.data();
+    bool threeDimensional = arrays.isThreeDimensional();
+
+    referenceX.assign(arrays.x.begin(), arrays.x.end());
+    referenceY.assign(arrays.y.begin(), arrays.y.end());
+    referenceZ.assign(arrays.z.begin(), arrays.z.end());
+    offsets.assign(n + 1, 0);
+    neighbors.clear();
+    ++rebuildCount;
+
+    if (n == 0) {
+        return;
+    }
+
+    double range = cutoff + skin;
+    double range2 = range * range;
+
+    // Boîte englobante (une seule couche de cellules en 2D)
+    double minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+    double minZ = threeDimensional ? z[0] : 0.0, maxZ = minZ;
+    for (size_t i = 1; i < n; ++i) {
+        minX = std::min(minX, x[i]);
+        maxX = std::max(maxX, x[i]);
+        minY = std::min(minY, y[i]);
+        maxY = std::max(maxY, y[i]);
+        if (threeDimensional) {
+            minZ = std::min(minZ, z[i]);
+            maxZ = std::max(maxZ, z[i]);
+        }
+    }
+
+    double cellSize = range > 0.0 ? range : 1.0;
+    size_t columns, rows, layers;
+    for (;;) {
+        columns = static_cast<size_t>((maxX - minX) / cellSize) + 1;
+        rows = static_cast<size_t>((maxY - minY) / cellSize) + 1;
+        layers = static_cast<size_t>((maxZ - minZ) / cellSize) + 1;
+        if (columns * rows * layers <= MAX_CELLS_PER_BODY * n + 16) break;
+        cellSize *= 2.0;
+    }
+    double inverseCell = 1.0 / cellSize;
+
+    // Tri par comptage des corps dans les cellules
+    size_t layerSize = columns * rows;
+    size_t cellCount = layerSize * layers;
+    cellStart.assign(cellCount + 1, 0);
+    bodyCell.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        size_t cx = static_cast<size_t>((x[i] - minX) * inverseCell);
+        size_t cy = static_cast<size_t>((y[i] - minY) * inverseCell);
+        size_t cz = threeDimensional ? static_cast<size_t>((z[i] - minZ) * inverseCell) : 0;
+        cx = std::min(cx, columns - 1);
+        cy = std::min(cy, rows - 1);
+        cz = std::min(cz, layers - 1);
+        bodyCell[i] = static_cast<uint32_t>(cz * layerSize + cy * columns + cx);
+        cellStart[bodyCell[i] + 1]++;
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    cellBodies.resize(n);
+    {
+        std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+        for (size_t i = 0; i < n; ++i) {
+            cellBodies[fill[bodyCell[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+
+    // Demi-liste : chaque paire n'est gardée qu'une fois (j > i)
+    for (size_t i = 0; i < n; ++i) {
+        size_t cz = bodyCell[i] / layerSize;
+        size_t cy = bodyCell[i] % layerSize / columns;
+        size_t cx = bodyCell[i] % columns;
+
+        for (size_t nz = (cz > 0 ? cz - 1 : 0); nz <= std::min(cz + 1, layers - 1); ++nz) {
+            for (size_t ny = (cy > 0 ? cy - 1 : 0); ny <= std::min(cy + 1, rows - 1); ++ny) {
+                for (size_t nx = (cx > 0 ? cx - 1 : 0); nx <= std::min(cx + 1, columns - 1); ++nx) {
+                    size_t cell = nz * layerSize + ny * columns + nx;
+                    for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                        uint32_t j = cellBodies[k];
+                        if (j <= i) continue;
+                        double dx = x[j] - x[i];
+                        double dy = y[j] - y[i];
+                        double dz = threeDimensional ? z[j] - z[i] : 0.0;
+                        if (dx * dx + dy * dy + dz * dz < range2) {
+                            neighbors.push_back(j);
+                        }
+                    }
+                }
+            }
+        }
+        offsets[i + 1] = static_cast<uint32_t>(neighbors.size());
+    }
+
+    listLengthSum += 2 * neighbors.size();
+    bodyCountSum += n;
+}
+
+double NeighborList::getRebuildFrequency() const {
+    return updateCount > 0 ? static_cast<double>(rebuildCount) / updateCount : 0.0;
+}
+
+double NeighborList::getAverageListLength() const {
+    return bodyCountSum > 0 ? static_cast<double>(listLengthSum) / bodyCountSum : 0.0;
+}
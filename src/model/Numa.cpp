@@ -0,0 +1,217 @@
+#include "../../include/Numa.hpp"
+#include "../../include/TaskScheduler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <linux/mempolicy.h>
+#include <map>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    const int MAX_NODES = 1024;
+
+    // Lectures répétées : le tampon de chaque worker doit dépasser largement les caches
+    const int BANDWIDTH_PASSES = 4;
+
+    // Plus grand intervalle de pages entières contenu dans [data, data + bytes)
+    bool innerPages(void* data, size_t bytes, uintptr_t& begin, size_t& length) {
+        uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+        uintptr_t start = reinterpret_cast<uintptr_t>(data);
+        begin = (start + page - 1) / page * page;
+        uintptr_t end = (start + bytes) / page * page;
+        if (end <= begin) return false;
+        length = end - begin;
+        return true;
+    }
+
+    std::vector<int> allowedCpus() {
+        std::vector<int> cpus;
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+            for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+                if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+            }
+        }
+        return cpus;
+    }
+}
+
+NumaTopology::NumaTopology() {
+    std::vector<int> allowed = allowedCpus();
+    for (int id = 0; id < MAX_NODES; ++id) {
+        char path[64];
+        std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", id);
+        std::ifstream file(path);
+        if (!file) continue;
+        std::string text;
+        std::getline(file, text);
+
+        NumaNode node;
+        node.id = id;
+        for (int cpu : parseCpuList(text)) {
+            if (std::binary_search(allowed.begin(), allowed.end(), cpu)) node.cpus.push_back(cpu);
+        }
+        if (!node.cpus.empty()) nodes.push_back(node);
+    }
+
+    // Pas de sysfs (ou aucun cœur autorisé trouvé) : un seul nœud
+    if (nodes.empty()) {
+        NumaNode node;
+        node.id = 0;
+        node.cpus = allowed;
+        nodes.push_back(node);
+    }
+}
+
+int NumaTopology::nodeOfCpu(int cpu) const {
+    for (const NumaNode& node : nodes) {
+        if (std::find(node.cpus.begin(), node.cpus.end(), cpu) != node.cpus.end()) return node.id;
+    }
+    return -1;
+}
+
+std::vector<int> NumaTopology::assignCpus(size_t workers, PinningPolicy policy) const {
+    std::vector<int> order;
+    if (policy == PinningPolicy::Compact) {
+        for (const NumaNode& node : nodes) {
+            order.insert(order.end(), node.cpus.begin(), node.cpus.end());
+        }
+    } else if (policy == PinningPolicy::Scatter) {
+        // k-ième cœur de chaque nœud, puis le suivant
+        size_t widest = 0;
+        for (const NumaNode& node : nodes) widest = std::max(widest, node.cpus.size());
+        for (size_t k = 0; k < widest; ++k) {
+            for (const NumaNode& node : nodes) {
+                if (k < node.cpus.size()) order.push_back(node.cpus[k]);
+            }
+        }
+    }
+
+    std::vector<int> cpus(workers, -1);
+    for (size_t i = 0; i < workers && !order.empty(); ++i) {
+        cpus[i] = order[i % order.size()];
+    }
+    return cpus;
+}
+
+bool NumaTopology::interleave(void* data, size_t bytes) const {
+    uintptr_t begin;
+    size_t length;
+    if (!innerPages(data, bytes, begin, length)) return false;
+
+    const size_t bitsPerWord = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(MAX_NODES / bitsPerWord, 0);
+    for (const NumaNode& node : nodes) {
+        mask[node.id / bitsPerWord] |= 1UL << (node.id % bitsPerWord);
+    }
+    // MPOL_MF_MOVE : les pages déjà présentes sont migrées, pas seulement les suivantes
+    return syscall(SYS_mbind, begin, length, MPOL_INTERLEAVE, mask.data(), MAX_NODES + 1, MPOL_MF_MOVE) == 0;
+}
+
+bool NumaTopology::pinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) return false;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+}
+
+std::vector<int> NumaTopology::currentThreadCpus() {
+    return allowedCpus();
+}
+
+void NumaTopology::releasePages(void* data, size_t bytes) {
+    uintptr_t begin;
+    size_t length;
+    if (innerPages(data, bytes, begin, length)) {
+        madvise(reinterpret_cast<void*>(begin), length, MADV_DONTNEED);
+    }
+}
+
+std::vector<NodeBandwidth> NumaTopology::measureBandwidth(TaskScheduler& scheduler, size_t bytesPerWorker,
+                                                          MemoryPlacement placement) const {
+    size_t workers = scheduler.getThreadCount();
+    size_t count = std::max<size_t>(bytesPerWorker / sizeof(double), 4);
+    size_t total = count * workers;
+
+    // Projection neuve : aucune page n'existe avant le remplissage
+    void* address = mmap(nullptr, total * sizeof(double), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (address == MAP_FAILED) return std::vector<NodeBandwidth>();
+    double* data = static_cast<double*>(address);
+
+    if (placement == MemoryPlacement::Interleave) interleave(data, total * sizeof(double));
+    auto fill = [data](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) data[i] = static_cast<double>(i & 1023);
+    };
+    if (placement == MemoryPlacement::FirstTouch) {
+        scheduler.affinityFor(0, total, fill);
+    } else {
+        fill(0, total);
+    }
+
+    // Bloc w de affinityFor = tampon du worker w (total est un multiple de workers)
+    std::vector<double> seconds(workers, 0.0);
+    std::vector<int> nodeOf(workers, -1);
+    std::vector<double> sums(workers, 0.0);
+    scheduler.affinityFor(0, total, [this, data, count, &seconds, &nodeOf, &sums](size_t begin, size_t end) {
+        size_t worker = begin / count;
+        nodeOf[worker] = nodeOfCpu(sched_getcpu());
+        auto start = std::chrono::steady_clock::now();
+        // Quatre sommes indépendantes : le débit mémoire limite, pas la latence de l'addition
+        double s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+        for (int pass = 0; pass < BANDWIDTH_PASSES; ++pass) {
+            for (size_t i = begin; i + 4 <= end; i += 4) {
+                s0 += data[i];
+                s1 += data[i + 1];
+                s2 += data[i + 2];
+                s3 += data[i + 3];
+            }
+        }
+        seconds[worker] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        sums[worker] = s0 + s1 + s2 + s3;
+    });
+    munmap(address, total * sizeof(double));
+
+    // Les workers d'un nœud lisent en même temps : débit cumulé sur la durée la plus longue
+    std::map<int, NodeBandwidth> byNode;
+    for (size_t w = 0; w < workers; ++w) {
+        NodeBandwidth& entry = byNode[nodeOf[w]];
+        entry.node = nodeOf[w];
+        entry.workers++;
+        entry.bytes += static_cast<double>(count / 4 * 4) * sizeof(double) * BANDWIDTH_PASSES;
+        entry.seconds = std::max(entry.seconds, seconds[w]);
+    }
+    std::vector<NodeBandwidth> result;
+    for (const auto& entry : byNode) result.push_back(entry.second);
+    return result;
+}
+
+std::vector<int> NumaTopology::parseCpuList(const std::string& text) {
+    std::vector<int> cpus;
+    const char* cursor = text.c_str();
+    while (*cursor) {
+        char* end;
+        long first = std::strtol(cursor, &end, 10);
+        if (end == cursor) break;
+        long last = first;
+        cursor = end;
+        if (*cursor == '-') {
+            last = std::strtol(cursor + 1, &end, 10);
+            if (end == cursor + 1) break;
+            cursor = end;
+        }
+        for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(static_cast<int>(cpu));
+        if (*cursor != ',') break;
+        ++cursor;
+    }
+    return cpus;
+}
@@ -0,0 +1,494 @@
+#include "../../include/OffscreenRenderer.hpp"
+#include "../../include/TaskScheduler.hpp"
+#include "../../include/Profiler.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    // Au-delà, le corps a sauté (début, téléportation) : pas de traînée
+    const double MAX_STREAK_PIXELS = 256.0;
+    const float STREAK_WEIGHT = 0.35f;
+
+    // Un corps plus petit qu'un pixel dépose son aire, sans descendre sous ce seuil
+    const float MIN_POINT_WEIGHT = 0.25f;
+
+    const size_t PROJECT_GRAIN = 16384;
+    const size_t TONE_CURVE_SIZE = 1 << 16;
+
+    // Palette de Renderer selon la masse, convertie une fois en RGB linéaire
+    struct Palette {
+        float colors[4][3];
+
+        Palette() {
+            const int srgb[4][3] = {
+                {255, 255, 0},      // Étoiles
+                {255, 165, 0},      // Planètes géantes
+                {0, 255, 0},        // Grosses planètes
+                {100, 150, 255}     // Petites planètes
+            };
+            for (int c = 0; c < 4; ++c) {
+                for (int k = 0; k < 3; ++k) {
+                    colors[c][k] = static_cast<float>(std::pow(srgb[c][k] / 255.0, 2.2));
+                }
+            }
+        }
+    };
+
+    const float* massColor(double mass) {
+        static const Palette palette;
+        int index = mass > 100 ? 0 : mass > 50 ? 1 : mass > 10 ? 2 : 3;
+        return palette.colors[index];
+    }
+
+    // Rectangle de pixels [x0, x1) x [y0, y1) d'une tuile
+    struct TileRect {
+        int x0, y0, x1, y1;
+    };
+
+    inline void deposit(float* accumulation, int width, const TileRect& rect, int x, int y,
+                        const float* color, float weight) {
+        if (x < rect.x0 || x >= rect.x1 || y < rect.y0 || y >= rect.y1) return;
+        float* pixel = accumulation + (static_cast<size_t>(y) * width + x) * 3;
+        pixel[0] += color[0] * weight;
+        pixel[1] += color[1] * weight;
+        pixel[2] += color[2] * weight;
+    }
+
+    // Dépôt bilinéaire : l'énergie est répartie sur les quatre centres de pixel voisins
+    void depositPoint(float* accumulation, int width, const TileRect& rect, float x, float y,
+                      const float* color, float weight) {
+        float fx = x - 0.5f;
+        float fy = y - 0.5f;
+        int ix = static_cast<int>(std::floor(fx));
+        int iy = static_cast<int>(std::floor(fy));
+        float tx = fx - ix;
+        float ty = fy - iy;
+        deposit(accumulation, width, rect, ix, iy, color, weight * (1.0f - tx) * (1.0f - ty));
+        deposit(accumulation, width, rect, ix + 1, iy, color, weight * tx * (1.0f - ty));
+        deposit(accumulation, width, rect, ix, iy + 1, color, weight * (1.0f - tx) * ty);
+        deposit(accumulation, width, rect, ix + 1, iy + 1, color, weight * tx * ty);
+    }
+
+    // Disque antialiasé : couverture linéaire sur un pixel de bord
+    void depositDisc(float* accumulation, int width, const TileRect& rect, float x, float y, float radius,
+                     const float* color) {
+        int xMin = std::max(rect.x0, static_cast<int>(std::floor(x - radius - 0.5f)));
+        int xMax = std::min(rect.x1 - 1, static_cast<int>(std::ceil(x + radius + 0.5f)));
+        int yMin = std::max(rect.y0, static_cast<int>(std::floor(y - radius - 0.5f)));
+        int yMax = std::min(rect.y1 - 1, static_cast<int>(std::ceil(y + radius + 0.5f)));
+        for (int py = yMin; py <= yMax; ++py) {
+            float dy = py + 0.5f - y;
+            for (int px = xMin; px <= xMax; ++px) {
+                float dx = px + 0.5f - x;
+                float coverage = radius + 0.5f - std::sqrt(dx * dx + dy * dy);
+                if (coverage <= 0.0f) continue;
+                deposit(accumulation, width, rect, px, py, color, std::min(coverage, 1.0f));
+            }
+        }
+    }
+
+    // CRC-32 des blocs PNG
+    struct CrcTable {
+        uint32_t entries[256];
+
+        CrcTable() {
+            for (uint32_t n = 0; n < 256; ++n) {
+                uint32_t c = n;
+                for (int k = 0; k < 8; ++k) {
+                    c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+                }
+                entries[n] = c;
+            }
+        }
+    };
+
+    uint32_t crc32(uint32_t crc, const uint8_t* data, size_t size) {
+        static const CrcTable table;
+        crc = ~crc;
+        for (size_t i = 0; i < size; ++i) {
+            crc = table.entries[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        }
+        return ~crc;
+    }
+
+    void putBig32(std::vector<uint8_t>& out, uint32_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 24));
+        out.push_back(static_cast<uint8_t>(value >> 16));
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool writeChunk(std::FILE* file, const char* type, const std::vector<uint8_t>& data) {
+        std::vector<uint8_t> header;
+        putBig32(header, static_cast<uint32_t>(data.size()));
+        header.insert(header.end(), type, type + 4);
+        uint32_t crc = crc32(0, header.data() + 4, 4);
+        crc = crc32(crc, data.data(), data.size());
+        std::vector<uint8_t> trailer;
+        putBig32(trailer, crc);
+        return std::fwrite(header.data(), 1, header.size(), file) == header.size()
+            && std::fwrite(data.data(), 1, data.size(), file) == data.size()
+            && std::fwrite(trailer.data(), 1, trailer.size(), file) == trailer.size();
+    }
+}
+
+OffscreenRenderer::OffscreenRenderer(int imageWidth, int imageHeight)
+    : width(std::max(1, imageWidth)), height(std::max(1, imageHeight)),
+      cameraCenter(0, 0), zoomLevel(1.0), cameraDistance(1000.0), exposure(1.0), trailPersistence(0.0),
+      scheduler(nullptr) {
+    tileColumns = (width + TILE_SIZE - 1) / TILE_SIZE;
+    tileRows = (height + TILE_SIZE - 1) / TILE_SIZE;
+    accumulation.assign(static_cast<size_t>(width) * height * 3, 0.0f);
+    pixels.assign(static_cast<size_t>(width) * height * 3, 0);
+
+    // Fonction de transfert sRGB, indexée par la valeur déjà compressée dans [0, 1]
+    toneCurve.resize(TONE_CURVE_SIZE + 1);
+    for (size_t k = 0; k <= TONE_CURVE_SIZE; ++k) {
+        double v = static_cast<double>(k) / TONE_CURVE_SIZE;
+        double encoded = v <= 0.0031308 ? 12.92 * v : 1.055 * std::pow(v, 1.0 / 2.4) - 0.055;
+        toneCurve[k] = static_cast<uint8_t>(std::min(255.0, encoded * 255.0 + 0.5));
+    }
+}
+
+template <typename Function>
+void OffscreenRenderer::forEachRange(size_t count, size_t grain, Function function) {
+    if (scheduler && scheduler->getThreadCount() > 1 && count > grain) {
+        scheduler->parallelFor(0, count, grain, [&function](size_t begin, size_t end) { function(begin, end); });
+    } else {
+        function(0, count);
+    }
+}
+
+void OffscreenRenderer::setExposure(double value) {
+    exposure = value > 0.0 ? value : 1.0;
+}
+
+void OffscreenRenderer::clear() {
+    std::fill(accumulation.begin(), accumulation.end(), 0.0f);
+    std::fill(pixels.begin(), pixels.end(), 0);
+    previousX.clear();
+    previousY.clear();
+}
+
+void OffscreenRenderer::fitCamera(const FrameView& frame, double margin) {
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    for (size_t i = 0; i < frame.bodyCount; ++i) {
+        Vector3D p = frame.position(i);
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) continue;
+        minX = std::min(minX, p.x - frame.radius[i]);
+        maxX = std::max(maxX, p.x + frame.radius[i]);
+        minY = std::min(minY, p.y - frame.radius[i]);
+        maxY = std::max(maxY, p.y + frame.radius[i]);
+    }
+    if (minX > maxX) {
+        setCamera(Vector2D(0, 0), 1.0);
+        return;
+    }
+    double spanX = std::max(maxX - minX, 1e-9) * (1.0 + 2.0 * margin);
+    double spanY = std::max(maxY - minY, 1e-9) * (1.0 + 2.0 * margin);
+    setCamera(Vector2D(0.5 * (minX + maxX), 0.5 * (minY + maxY)), std::min(width / spanX, height / spanY));
+}
+
+void OffscreenRenderer::project(const FrameView& frame) {
+    size_t count = frame.bodyCount;
+    screenX.resize(count);
+    screenY.resize(count);
+    screenRadius.resize(count);
+    bodyColor.resize(count * 3);
+    if (previousX.size() != count) {
+        // Nouvelle scène : aucune traînée à la première image
+        previousX.assign(count, std::numeric_limits<float>::quiet_NaN());
+        previousY.assign(count, std::numeric_limits<float>::quiet_NaN());
+    }
+
+    bool streaks = trailPersistence > 0.0;
+    double halfWidth = width / 2;
+    double halfHeight = height / 2;
+    forEachRange(count, PROJECT_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            Vector3D position = frame.position(i);
+            double depth = cameraDistance - position.z;
+            double scale = frame.dimension == 3 ? (depth > 1e-6 * cameraDistance ? zoomLevel * cameraDistance / depth : 0.0)
+                                                : zoomLevel;
+            double x = (position.x - cameraCenter.x) * scale + halfWidth;
+            double y = (position.y - cameraCenter.y) * scale + halfHeight;
+            bool visible = scale > 0.0 && std::isfinite(x) && std::isfinite(y);
+            screenX[i] = static_cast<float>(x);
+            screenY[i] = static_cast<float>(y);
+            screenRadius[i] = visible ? static_cast<float>(frame.radius[i] * scale) : -1.0f;
+            std::memcpy(&bodyColor[i * 3], massColor(frame.mass[i]), 3 * sizeof(float));
+
+            double dx = x - previousX[i];
+            double dy = y - previousY[i];
+            if (!visible || !streaks || !(dx * dx + dy * dy <= MAX_STREAK_PIXELS * MAX_STREAK_PIXELS)) {
+                previousX[i] = std::numeric_limits<float>::quiet_NaN();
+            }
+        }
+    });
+}
+
+void OffscreenRenderer::binBodies(size_t bodyCount) {
+    // Rectangle de tuiles recouvert par le corps et sa traînée
+    size_t tileCount = static_cast<size_t>(tileColumns) * tileRows;
+    bodyTiles.resize(bodyCount * 4);
+    tileStart.assign(tileCount + 1, 0);
+    for (size_t i = 0; i < bodyCount; ++i) {
+        uint32_t* rect = &bodyTiles[i * 4];
+        rect[0] = 1;
+        rect[2] = 0; // Vide tant que x0 > x1
+        float radius = screenRadius[i];
+        if (radius < 0.0f) continue;
+
+        float reach = std::max(radius, 1.0f) + 1.0f;
+        float minX = screenX[i], maxX = screenX[i], minY = screenY[i], maxY = screenY[i];
+        if (!std::isnan(previousX[i])) {
+            minX = std::min(minX, previousX[i]);
+            maxX = std::max(maxX, previousX[i]);
+            minY = std::min(minY, previousY[i]);
+            maxY = std::max(maxY, previousY[i]);
+        }
+        minX -= reach;
+        minY -= reach;
+        maxX += reach;
+        maxY += reach;
+        if (maxX < 0.0f || maxY < 0.0f || minX >= width || minY >= height) continue;
+
+        rect[0] = static_cast<uint32_t>(std::max(0.0f, minX) / TILE_SIZE);
+        rect[1] = static_cast<uint32_t>(std::max(0.0f, minY) / TILE_SIZE);
+        rect[2] = static_cast<uint32_t>(std::min(static_cast<float>(width - 1), maxX) / TILE_SIZE);
+        rect[3] = static_cast<uint32_t>(std::min(static_cast<float>(height - 1), maxY) / TILE_SIZE);
+        for (uint32_t ty = rect[1]; ty <= rect[3]; ++ty) {
+            for (uint32_t tx = rect[0]; tx <= rect[2]; ++tx) {
+                tileStart[ty * tileColumns + tx + 1]++;
+            }
+        }
+    }
+
+    for (size_t t = 0; t < tileCount; ++t) {
+        tileStart[t + 1] += tileStart[t];
+    }
+    tileItems.resize(tileStart[tileCount]);
+    std::vector<uint32_t> fill(tileStart.begin(), tileStart.end() - 1);
+    for (size_t i = 0; i < bodyCount; ++i) {
+        const uint32_t* rect = &bodyTiles[i * 4];
+        if (rect[0] > rect[2]) continue;
+        for (uint32_t ty = rect[1]; ty <= rect[3]; ++ty) {
+            for (uint32_t tx = rect[0]; tx <= rect[2]; ++tx) {
+                tileItems[fill[ty * tileColumns + tx]++] = static_cast<uint32_t>(i);
+            }
+        }
+    }
+}
+
+void OffscreenRenderer::renderTile(size_t tile) {
+    TileRect rect;
+    rect.x0 = static_cast<int>(tile % tileColumns) * TILE_SIZE;
+    rect.y0 = static_cast<int>(tile / tileColumns) * TILE_SIZE;
+    rect.x1 = std::min(width, rect.x0 + TILE_SIZE);
+    rect.y1 = std::min(height, rect.y0 + TILE_SIZE);
+    float* buffer = accumulation.data();
+
+    // Rémanence : l'image précédente s'estompe au lieu d'être effacée
+    float keep = static_cast<float>(std::max(0.0, std::min(trailPersistence, 1.0)));
+    for (int y = rect.y0; y < rect.y1; ++y) {
+        float* row = buffer + (static_cast<size_t>(y) * width + rect.x0) * 3;
+        for (int k = 0; k < (rect.x1 - rect.x0) * 3; ++k) {
+            row[k] *= keep;
+        }
+    }
+
+    // Corps dans l'ordre des indices : résultat identique quel que soit le découpage
+    for (uint32_t k = tileStart[tile]; k < tileStart[tile + 1]; ++k) {
+        uint32_t i = tileItems[k];
+        const float* color = &bodyColor[i * 3];
+        float x = screenX[i];
+        float y = screenY[i];
+        float radius = screenRadius[i];
+
+        if (!std::isnan(previousX[i])) {
+            float dx = x - previousX[i];
+            float dy = y - previousY[i];
+            int samples = std::max(1, static_cast<int>(std::ceil(std::sqrt(dx * dx + dy * dy))));
+            for (int s = 0; s < samples; ++s) {
+                float t = static_cast<float>(s) / samples;
+                depositPoint(buffer, width, rect, previousX[i] + dx * t, previousY[i] + dy * t, color, STREAK_WEIGHT);
+            }
+        }
+
+        if (radius < 1.0f) {
+            float weight = std::max(MIN_POINT_WEIGHT, static_cast<float>(M_PI) * radius * radius);
+            depositPoint(buffer, width, rect, x, y, color, weight);
+        } else {
+            depositDisc(buffer, width, rect, x, y, radius, color);
+        }
+    }
+
+    // Tone mapping 1 - exp(-exposition * v), puis sRGB
+    for (int y = rect.y0; y < rect.y1; ++y) {
+        size_t offset = (static_cast<size_t>(y) * width + rect.x0) * 3;
+        for (int k = 0; k < (rect.x1 - rect.x0) * 3; ++k) {
+            double mapped = 1.0 - std::exp(-exposure * buffer[offset + k]);
+            pixels[offset + k] = toneCurve[static_cast<size_t>(mapped * TONE_CURVE_SIZE)];
+        }
+    }
+}
+
+void OffscreenRenderer::renderFrame(const FrameView& frame) {
+    PROFILE_SCOPE("OffscreenRenderer::renderFrame");
+    project(frame);
+    binBodies(frame.bodyCount);
+
+    size_t tileCount = static_cast<size_t>(tileColumns) * tileRows;
+    forEachRange(tileCount, 1, [this](size_t begin, size_t end) {
+        for (size_t tile = begin; tile < end; ++tile) {
+            renderTile(tile);
+        }
+    });
+
+    // Départ des traînées de l'image suivante
+    for (size_t i = 0; i < frame.bodyCount; ++i) {
+        previousX[i] = screenRadius[i] >= 0.0f ? screenX[i] : std::numeric_limits<float>::quiet_NaN();
+        previousY[i] = screenY[i];
+    }
+}
+
+template <int D>
+FrameView OffscreenRenderer::stageFrame(const SimulationT<D>& simulation) {
+    const auto& bodies = simulation.getBodies();
+    stagedPositions.resize(bodies.size() * D);
+    stagedMass.resize(bodies.size());
+    stagedRadius.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Vector<D> position = bodies[i]->getPosition();
+        for (int axis = 0; axis < D; ++axis) {
+            stagedPositions[i * D + axis] = position[axis];
+        }
+        stagedMass[i] = bodies[i]->getMass();
+        stagedRadius[i] = bodies[i]->getRadius();
+    }
+
+    FrameView frame;
+    frame.positions = stagedPositions.data();
+    frame.mass = stagedMass.data();
+    frame.radius = stagedRadius.data();
+    frame.bodyCount = bodies.size();
+    frame.dimension = D;
+    frame.step = simulation.getStepCount();
+    frame.time = frame.step * simulation.getTimeStep();
+    return frame;
+}
+
+template FrameView OffscreenRenderer::stageFrame<2>(const Simulation& simulation);
+template FrameView OffscreenRenderer::stageFrame<3>(const Simulation3D& simulation);
+
+bool OffscreenRenderer::writeImage(const std::string& path) {
+    std::string extension = path.size() >= 4 ? path.substr(path.size() - 4) : std::string();
+    std::transform(extension.begin(), extension.end(), extension.begin(), ::tolower);
+    if (extension == ".png") return writePNG(path);
+    if (extension == ".ppm") return writePPM(path);
+    lastError = path + ": extension inconnue (.png ou .ppm)";
+    return false;
+}
+
+bool OffscreenRenderer::writePPM(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+    bool ok = std::fprintf(file, "P6\n%d %d\n255\n", width, height) > 0 && writeRaw(file);
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) lastError = path + ": écriture incomplète";
+    return ok;
+}
+
+bool OffscreenRenderer::writePNG(const std::string& path) {
+    // Lignes précédées du filtre 0, flux zlib en blocs "stored" (non compressés) :
+    // pas de dépendance, l'encodeur vidéo se charge de la compression
+    size_t rowBytes = static_cast<size_t>(width) * 3;
+    size_t rawSize = (rowBytes + 1) * height;
+    const size_t maxBlock = 65535;
+
+    std::vector<uint8_t> raw(rawSize);
+    for (int y = 0; y < height; ++y) {
+        raw[y * (rowBytes + 1)] = 0;
+        std::memcpy(&raw[y * (rowBytes + 1) + 1], &pixels[y * rowBytes], rowBytes);
+    }
+
+    std::vector<uint8_t> idat;
+    idat.reserve(rawSize + rawSize / maxBlock * 5 + 16);
+    idat.push_back(0x78);
+    idat.push_back(0x01);
+    uint32_t adlerA = 1, adlerB = 0;
+    for (size_t offset = 0; offset < rawSize; offset += maxBlock) {
+        size_t length = std::min(maxBlock, rawSize - offset);
+        idat.push_back(offset + length >= rawSize ? 1 : 0);
+        idat.push_back(static_cast<uint8_t>(length));
+        idat.push_back(static_cast<uint8_t>(length >> 8));
+        idat.push_back(static_cast<uint8_t>(~length));
+        idat.push_back(static_cast<uint8_t>(~length >> 8));
+        idat.insert(idat.end(), raw.begin() + offset, raw.begin() + offset + length);
+        for (size_t i = offset; i < offset + length; ++i) {
+            adlerA = (adlerA + raw[i]) % 65521;
+            adlerB = (adlerB + adlerA) % 65521;
+        }
+    }
+    putBig32(idat, (adlerB << 16) | adlerA);
+
+    std::vector<uint8_t> ihdr;
+    putBig32(ihdr, static_cast<uint32_t>(width));
+    putBig32(ihdr, static_cast<uint32_t>(height));
+    const uint8_t format[5] = {8, 2, 0, 0, 0}; // 8 bits, RGB, deflate, filtre standard, non entrelacé
+    ihdr.insert(ihdr.end(), format, format + 5);
+
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+    const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    bool ok = std::fwrite(signature, 1, 8, file) == 8
+           && writeChunk(file, "IHDR", ihdr)
+           && writeChunk(file, "IDAT", idat)
+           && writeChunk(file, "IEND", std::vector<uint8_t>());
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) lastError = path + ": écriture incomplète";
+    return ok;
+}
+
+bool OffscreenRenderer::writeRaw(std::FILE* stream) {
+    if (std::fwrite(pixels.data(), 1, pixels.size(), stream) != pixels.size()) {
+        lastError = std::string("flux vidéo: ") + std::strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+std::string OffscreenRenderer::framePath(const std::string& pattern, uint64_t index) {
+    std::string number = std::to_string(index);
+    size_t percent = pattern.find('%');
+    while (percent != std::string::npos) {
+        size_t cursor = percent + 1;
+        bool zeroPad = cursor < pattern.size() && pattern[cursor] == '0';
+        size_t digitsStart = cursor;
+        while (cursor < pattern.size() && std::isdigit(static_cast<unsigned char>(pattern[cursor]))) ++cursor;
+        if (cursor < pattern.size() && pattern[cursor] == 'd') {
+            size_t padding = cursor > digitsStart ? std::strtoul(pattern.substr(digitsStart, cursor - digitsStart).c_str(), nullptr, 10) : 0;
+            std::string field = number;
+            if (field.size() < padding) field.insert(0, padding - field.size(), zeroPad ? '0' : ' ');
+            return pattern.substr(0, percent) + field + pattern.substr(cursor + 1);
+        }
+        percent = pattern.find('%', percent + 1);
+    }
+
+    // Sans motif : numéro sur six chiffres avant l'extension
+    std::string field = number.size() < 6 ? std::string(6 - number.size(), '0') + number : number;
+    size_t dot = pattern.find_last_of('.');
+    size_t slash = pattern.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return pattern + "_" + field;
+    return pattern.substr(0, dot) + "_" + field + pattern.substr(dot);
+}
@@ -0,0 +1,562 @@
+#include "../../include/OutOfCore.hpp"
+#include "../../include/TaskScheduler.hpp"
+#include "../../include/Profiler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char OUT_OF_CORE_MAGIC[8] = {'N', 'C', 'O', 'R', 'P', 'S', 'T', 'L'};
+
+    const size_t PARALLEL_FORCE_THRESHOLD = 64;
+    const size_t FORCE_GRAIN = 8;
+
+    // Colonnes d'une tuile, chacune de tileBodies doubles
+    template <int D>
+    struct Columns {
+        static const int POSITION = 0;
+        static const int VELOCITY = D;
+        static const int ACCELERATION = 2 * D;
+        static const int MASS = 3 * D;
+        static const int RADIUS = 3 * D + 1;
+        static const int COUNT = 3 * D + 2;
+    };
+
+    size_t pageSize() {
+        return static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+
+    size_t roundUp(size_t bytes, size_t alignment) {
+        return (bytes + alignment - 1) / alignment * alignment;
+    }
+
+    double secondsSince(std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // Bloc de cibles et tuile de sources (BodyArrays complets), plus la tuile courante et la suivante projetées
+    template <int D>
+    size_t residentBytes(size_t blockTiles, size_t tileBodies, size_t tileStride) {
+        return (blockTiles + 1) * tileBodies * (2 * D + 2) * sizeof(double) + 2 * tileStride;
+    }
+
+    // Somme des m_i m_j potential(r²) : paires i < j si same, toutes les paires sinon
+    template <int D, typename Law>
+    double pairPotential(const BodyArrays& a, const BodyArrays& b, double softening, bool same) {
+        Law law(softening);
+        double sum = 0.0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            for (size_t j = same ? i + 1 : 0; j < b.size(); ++j) {
+                double dx = b.x[j] - a.x[i];
+                double dy = b.y[j] - a.y[i];
+                double r2 = dx * dx + dy * dy;
+                if (D == 3) {
+                    double dz = b.z[j] - a.z[i];
+                    r2 += dz * dz;
+                }
+                sum += a.mass[i] * b.mass[j] * law.potential(r2, a.radius[i] + b.radius[j]);
+            }
+        }
+        return sum;
+    }
+
+    template <int D>
+    double pairPotential(ForceLaw law, const BodyArrays& a, const BodyArrays& b, double softening, bool same) {
+        switch (law) {
+            case ForceLaw::Newtonian: return pairPotential<D, NewtonianForce>(a, b, softening, same);
+            case ForceLaw::Plummer: return pairPotential<D, PlummerForce>(a, b, softening, same);
+            case ForceLaw::Spline: return pairPotential<D, SplineForce>(a, b, softening, same);
+            case ForceLaw::Clamped:
+            default: return pairPotential<D, ClampedForce>(a, b, softening, same);
+        }
+    }
+}
+
+template <int D>
+OutOfCoreSimulationT<D>::OutOfCoreSimulationT(double G, double dt, ForceLaw law, double softeningLength)
+    : gravitationalConstant(G), timeStep(dt), forceLaw(law), softening(softeningLength),
+      kernels(selectForceKernels<D>(law)), integrator(Integrator::Euler), scheduler(nullptr),
+      descriptor(-1), data(nullptr), mappedBytes(0), header(nullptr), budgetBytes(0), blockTiles(0) {}
+
+template <int D>
+OutOfCoreSimulationT<D>::~OutOfCoreSimulationT() {
+    close();
+}
+
+template <int D>
+bool OutOfCoreSimulationT<D>::map(const std::string& path, size_t bytes, bool create) {
+    descriptor = ::open(path.c_str(), create ? O_RDWR | O_CREAT | O_TRUNC : O_RDWR, 0644);
+    if (descriptor < 0) {
+        lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+    if (create) {
+        if (ftruncate(descriptor, static_cast<off_t>(bytes)) != 0) {
+            lastError = path + ": " + std::strerror(errno);
+            close();
+            return false;
+        }
+    } else {
+        struct stat info;
+        if (fstat(descriptor, &info) != 0) {
+            lastError = path + ": " + std::strerror(errno);
+            close();
+            return false;
+        }
+        bytes = static_cast<size_t>(info.st_size);
+        if (bytes < sizeof(OutOfCoreHeader)) {
+            lastError = path + ": fichier tronqué";
+            close();
+            return false;
+        }
+    }
+
+    void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    if (address == MAP_FAILED) {
+        lastError = std::string("mmap: ") + std::strerror(errno);
+        close();
+        return false;
+    }
+    // Accès par tuiles avec annonces explicites : pas de lecture anticipée du noyau au-delà
+    madvise(address, bytes, MADV_RANDOM);
+    data = static_cast<char*>(address);
+    mappedBytes = bytes;
+    return true;
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::close() {
+    if (data) {
+        munmap(data, mappedBytes);
+        data = nullptr;
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+    header = nullptr;
+    mappedBytes = 0;
+    blockTiles = 0;
+    block = BodyArrays();
+    tile = BodyArrays();
+}
+
+template <int D>
+bool OutOfCoreSimulationT<D>::planBlocks(size_t budget, size_t tileBodies, size_t tileStride, size_t tileCount) {
+    size_t minimum = residentBytes<D>(1, tileBodies, tileStride);
+    if (budget < minimum) {
+        lastError = "budget de " + std::to_string(budget) + " octets insuffisant : " + std::to_string(minimum)
+                    + " au moins pour des tuiles de " + std::to_string(tileBodies) + " corps";
+        return false;
+    }
+    size_t blockBytes = tileBodies * (2 * D + 2) * sizeof(double);
+    size_t fitting = (budget - 2 * tileStride) / blockBytes - 1;
+    blockTiles = std::max<size_t>(1, std::min(fitting, tileCount));
+    budgetBytes = budget;
+    return true;
+}
+
+template <int D>
+bool OutOfCoreSimulationT<D>::create(const std::string& path, const SimulationT<D>& initial, size_t budget,
+                                     size_t tileBodies) {
+    typedef Columns<D> C;
+    close();
+    const auto& bodies = initial.getBodies();
+    for (const auto& body : bodies) {
+        if (body->isTracer()) {
+            lastError = "traceurs non pris en charge hors mémoire";
+            return false;
+        }
+    }
+    if (tileBodies == 0) {
+        lastError = "tuiles vides";
+        return false;
+    }
+
+    // Budget vérifié avant d'écrire quoi que ce soit
+    size_t page = pageSize();
+    size_t stride = roundUp(tileBodies * C::COUNT * sizeof(double), page);
+    size_t tiles = (bodies.size() + tileBodies - 1) / tileBodies;
+    if (!planBlocks(budget, tileBodies, stride, tiles)) return false;
+    if (!map(path, page + tiles * stride, true)) return false;
+
+    header = reinterpret_cast<OutOfCoreHeader*>(data);
+    std::memcpy(header->magic, OUT_OF_CORE_MAGIC, sizeof(header->magic));
+    header->dimension = D;
+    header->accelerationsCurrent = 0;
+    header->bodyCount = bodies.size();
+    header->tileBodies = tileBodies;
+    header->tileStride = stride;
+    header->tileOffset = page;
+    header->stepCount = 0;
+
+    // Écriture tuile par tuile, chacune rendue au noyau aussitôt remplie
+    for (size_t t = 0; t < tiles; ++t) {
+        size_t count = bodiesIn(t);
+        for (size_t i = 0; i < count; ++i) {
+            const BodyType& body = *bodies[t * tileBodies + i];
+            VectorType p = body.getPosition();
+            VectorType v = body.getVelocity();
+            VectorType a = body.getAcceleration();
+            for (int d = 0; d < D; ++d) {
+                column(t, C::POSITION + d)[i] = p[d];
+                column(t, C::VELOCITY + d)[i] = v[d];
+                column(t, C::ACCELERATION + d)[i] = a[d];
+            }
+            column(t, C::MASS)[i] = body.getMass();
+            column(t, C::RADIUS)[i] = body.getRadius();
+        }
+        release(t);
+    }
+    return true;
+}
+
+template <int D>
+bool OutOfCoreSimulationT<D>::open(const std::string& path, size_t budget) {
+    typedef Columns<D> C;
+    close();
+    if (!map(path, 0, false)) return false;
+
+    const OutOfCoreHeader* stored = reinterpret_cast<const OutOfCoreHeader*>(data);
+    size_t page = pageSize();
+    if (std::memcmp(stored->magic, OUT_OF_CORE_MAGIC, sizeof(stored->magic)) != 0) {
+        lastError = path + ": ce n'est pas un fichier de corps hors mémoire";
+    } else if (stored->dimension != static_cast<uint32_t>(D)) {
+        lastError = path + ": simulation en " + std::to_string(stored->dimension) + "D";
+    } else if (stored->tileBodies == 0 || stored->tileStride < stored->tileBodies * C::COUNT * sizeof(double)
+               || stored->tileStride % page != 0 || stored->tileOffset % page != 0
+               || stored->tileOffset < sizeof(OutOfCoreHeader)) {
+        lastError = path + ": tuiles incohérentes";
+    } else if (mappedBytes < stored->tileOffset
+               + (stored->bodyCount + stored->tileBodies - 1) / stored->tileBodies * stored->tileStride) {
+        lastError = path + ": fichier tronqué";
+    } else if (planBlocks(budget, stored->tileBodies, stored->tileStride,
+                          (stored->bodyCount + stored->tileBodies - 1) / stored->tileBodies)) {
+        header = reinterpret_cast<OutOfCoreHeader*>(data);
+        return true;
+    }
+    close();
+    return false;
+}
+
+template <int D>
+bool OutOfCoreSimulationT<D>::exportTo(SimulationT<D>& simulation) const {
+    typedef Columns<D> C;
+    if (!header) return false;
+    std::vector<std::unique_ptr<BodyType>> bodies;
+    bodies.reserve(header->bodyCount);
+    for (size_t t = 0; t < getTileCount(); ++t) {
+        prefetch(t + 1);
+        for (size_t i = 0; i < bodiesIn(t); ++i) {
+            VectorType p, v, a;
+            for (int d = 0; d < D; ++d) {
+                p[d] = column(t, C::POSITION + d)[i];
+                v[d] = column(t, C::VELOCITY + d)[i];
+                a[d] = column(t, C::ACCELERATION + d)[i];
+            }
+            bodies.emplace_back(new BodyType(p, v, column(t, C::MASS)[i], column(t, C::RADIUS)[i]));
+            bodies.back()->setAcceleration(a);
+        }
+        release(t);
+    }
+    simulation.replaceBodies(std::move(bodies));
+    return true;
+}
+
+template <int D>
+size_t OutOfCoreSimulationT<D>::getTileCount() const {
+    return header ? (header->bodyCount + header->tileBodies - 1) / header->tileBodies : 0;
+}
+
+template <int D>
+size_t OutOfCoreSimulationT<D>::getResidentBytes() const {
+    return header ? residentBytes<D>(blockTiles, header->tileBodies, header->tileStride) : 0;
+}
+
+template <int D>
+double* OutOfCoreSimulationT<D>::column(size_t tileIndex, int index) const {
+    char* tileStart = data + header->tileOffset + tileIndex * header->tileStride;
+    return reinterpret_cast<double*>(tileStart) + static_cast<size_t>(index) * header->tileBodies;
+}
+
+template <int D>
+size_t OutOfCoreSimulationT<D>::bodiesIn(size_t tileIndex) const {
+    size_t first = tileIndex * header->tileBodies;
+    return std::min<size_t>(header->tileBodies, header->bodyCount - first);
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::prefetch(size_t tileIndex) const {
+    if (tileIndex >= getTileCount()) return;
+    madvise(data + header->tileOffset + tileIndex * header->tileStride, header->tileStride, MADV_WILLNEED);
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::release(size_t tileIndex) const {
+    // Projection partagée : les pages modifiées restent dans le cache du fichier, rien n'est perdu
+    madvise(data + header->tileOffset + tileIndex * header->tileStride, header->tileStride, MADV_DONTNEED);
+}
+
+template <int D>
+size_t OutOfCoreSimulationT<D>::copySources(size_t first, size_t last, BodyArrays& arrays, bool accelerations) const {
+    typedef Columns<D> C;
+    size_t count = 0;
+    for (size_t t = first; t < last; ++t) count += bodiesIn(t);
+    arrays.resize(count, D);
+
+    size_t offset = 0;
+    for (size_t t = first; t < last; ++t) {
+        if (t + 1 < last) prefetch(t + 1);
+        size_t n = bodiesIn(t);
+        size_t bytes = n * sizeof(double);
+        std::memcpy(arrays.x.data() + offset, column(t, C::POSITION), bytes);
+        std::memcpy(arrays.y.data() + offset, column(t, C::POSITION + 1), bytes);
+        if (D == 3) std::memcpy(arrays.z.data() + offset, column(t, C::POSITION + 2), bytes);
+        std::memcpy(arrays.mass.data() + offset, column(t, C::MASS), bytes);
+        std::memcpy(arrays.radius.data() + offset, column(t, C::RADIUS), bytes);
+        if (accelerations) {
+            std::memcpy(arrays.ax.data() + offset, column(t, C::ACCELERATION), bytes);
+            std::memcpy(arrays.ay.data() + offset, column(t, C::ACCELERATION + 1), bytes);
+            if (D == 3) std::memcpy(arrays.az.data() + offset, column(t, C::ACCELERATION + 2), bytes);
+        }
+        release(t);
+        offset += n;
+    }
+    return count * ((accelerations ? 2 * D : D) + 2) * sizeof(double);
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::loadTiles(size_t first, size_t last, BodyArrays& arrays, bool accelerations) {
+    auto start = std::chrono::steady_clock::now();
+    stats.bytesRead += copySources(first, last, arrays, accelerations);
+    stats.ioSeconds += secondsSince(start);
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::storeAccelerations(size_t first, size_t last, const BodyArrays& arrays) {
+    typedef Columns<D> C;
+    auto start = std::chrono::steady_clock::now();
+    size_t offset = 0;
+    for (size_t t = first; t < last; ++t) {
+        size_t n = bodiesIn(t);
+        size_t bytes = n * sizeof(double);
+        std::memcpy(column(t, C::ACCELERATION), arrays.ax.data() + offset, bytes);
+        std::memcpy(column(t, C::ACCELERATION + 1), arrays.ay.data() + offset, bytes);
+        if (D == 3) std::memcpy(column(t, C::ACCELERATION + 2), arrays.az.data() + offset, bytes);
+        release(t);
+        offset += n;
+    }
+    stats.bytesWritten += offset * D * sizeof(double);
+    stats.ioSeconds += secondsSince(start);
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::computeForces() {
+    PROFILE_SCOPE("OutOfCore::calculateForces");
+    size_t tiles = getTileCount();
+    if (scheduler && scheduler->getThreadCount() > 1 && header->bodyCount >= PARALLEL_FORCE_THRESHOLD) {
+        // Blocs indépendants : lignes complètes réparties sur les threads, chaque
+        // interaction entre blocs calculée une fois de chaque côté
+        for (size_t first = 0; first < tiles; first += blockTiles) {
+            size_t last = std::min(first + blockTiles, tiles);
+            loadTiles(first, last, block, false);
+            size_t n = block.size();
+            scheduler->parallelFor(0, n, FORCE_GRAIN, [this](size_t begin, size_t end) {
+                kernels.rows(block, gravitationalConstant, softening, begin, end);
+            });
+
+            // Autres tuiles en flux : la suivante est annoncée avant le calcul de la courante
+            for (size_t source = 0; source < tiles; ++source) {
+                if (source >= first && source < last) continue;
+                prefetch(source + 1 == first ? last : source + 1);
+                loadTiles(source, source + 1, tile, false);
+                scheduler->parallelFor(0, n, FORCE_GRAIN, [this](size_t begin, size_t end) {
+                    kernels.tiles(tile, block, gravitationalConstant, softening, begin, end);
+                });
+            }
+            storeAccelerations(first, last, block);
+        }
+        return;
+    }
+
+    // Un seul thread : chaque paire une fois, comme pairwiseKernel. Le bloc ne voit
+    // défiler que les tuiles qui le suivent ; la réaction s'ajoute à leurs
+    // accélérations dans le fichier, reprises quand vient leur tour d'être cibles.
+    for (size_t first = 0; first < tiles; first += blockTiles) {
+        size_t last = std::min(first + blockTiles, tiles);
+        bool accumulated = first > 0;
+        loadTiles(first, last, block, accumulated);
+        if (!accumulated) {
+            std::fill(block.ax.begin(), block.ax.end(), 0.0);
+            std::fill(block.ay.begin(), block.ay.end(), 0.0);
+            std::fill(block.az.begin(), block.az.end(), 0.0);
+        }
+        kernels.pairwise(block, gravitationalConstant, softening);
+
+        for (size_t source = last; source < tiles; ++source) {
+            prefetch(source + 1);
+            loadTiles(source, source + 1, tile, accumulated);
+            if (!accumulated) {
+                std::fill(tile.ax.begin(), tile.ax.end(), 0.0);
+                std::fill(tile.ay.begin(), tile.ay.end(), 0.0);
+                std::fill(tile.az.begin(), tile.az.end(), 0.0);
+            }
+            kernels.tilePairs(block, tile, gravitationalConstant, softening);
+            storeAccelerations(source, source + 1, tile);
+        }
+        storeAccelerations(first, last, block);
+    }
+}
+
+template <int D>
+template <typename Function>
+void OutOfCoreSimulationT<D>::streamTiles(int readColumns, int writeColumns, Function function) {
+    auto start = std::chrono::steady_clock::now();
+    size_t tiles = getTileCount();
+    for (size_t t = 0; t < tiles; ++t) {
+        prefetch(t + 1);
+        function(t, bodiesIn(t));
+        release(t);
+    }
+    stats.bytesRead += header->bodyCount * readColumns * sizeof(double);
+    stats.bytesWritten += header->bodyCount * writeColumns * sizeof(double);
+    stats.ioSeconds += secondsSince(start);
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::step() {
+    typedef Columns<D> C;
+    if (!header) return;
+    PROFILE_SCOPE("OutOfCore::step");
+    auto start = std::chrono::steady_clock::now();
+    double fullStep = timeStep;
+    double halfStep = 0.5 * timeStep;
+
+    // Mêmes opérations, dans le même ordre, que Body::update, Body::kick et Body::drift
+    auto kick = [this](double dt) {
+        return [this, dt](size_t t, size_t count) {
+            for (int d = 0; d < D; ++d) {
+                double* v = column(t, C::VELOCITY + d);
+                const double* a = column(t, C::ACCELERATION + d);
+                for (size_t i = 0; i < count; ++i) v[i] = v[i] + a[i] * dt;
+            }
+        };
+    };
+
+    if (integrator == Integrator::Leapfrog) {
+        if (!header->accelerationsCurrent) computeForces();
+        streamTiles(3 * D, 2 * D, [this, halfStep, fullStep](size_t t, size_t count) {
+            for (int d = 0; d < D; ++d) {
+                double* x = column(t, C::POSITION + d);
+                double* v = column(t, C::VELOCITY + d);
+                const double* a = column(t, C::ACCELERATION + d);
+                for (size_t i = 0; i < count; ++i) {
+                    v[i] = v[i] + a[i] * halfStep;
+                    x[i] = x[i] + v[i] * fullStep;
+                }
+            }
+        });
+        computeForces();
+        streamTiles(2 * D, D, kick(halfStep));
+        header->accelerationsCurrent = 1;
+    } else {
+        computeForces();
+        streamTiles(3 * D, 2 * D, [this, fullStep](size_t t, size_t count) {
+            for (int d = 0; d < D; ++d) {
+                double* x = column(t, C::POSITION + d);
+                double* v = column(t, C::VELOCITY + d);
+                const double* a = column(t, C::ACCELERATION + d);
+                for (size_t i = 0; i < count; ++i) {
+                    v[i] = v[i] + a[i] * fullStep;
+                    x[i] = x[i] + v[i] * fullStep;
+                }
+            }
+        });
+        header->accelerationsCurrent = 0;
+    }
+
+    header->stepCount++;
+    stats.steps++;
+    stats.stepSeconds += secondsSince(start);
+}
+
+template <int D>
+void OutOfCoreSimulationT<D>::setIntegrator(Integrator scheme) {
+    integrator = scheme;
+    if (header) header->accelerationsCurrent = 0;
+}
+
+template <int D>
+double OutOfCoreSimulationT<D>::computeEnergy() const {
+    typedef Columns<D> C;
+    if (!header) return 0.0;
+    size_t tiles = getTileCount();
+
+    double kinetic = 0.0;
+    for (size_t t = 0; t < tiles; ++t) {
+        prefetch(t + 1);
+        const double* mass = column(t, C::MASS);
+        for (size_t i = 0; i < bodiesIn(t); ++i) {
+            double v2 = 0.0;
+            for (int d = 0; d < D; ++d) {
+                double v = column(t, C::VELOCITY + d)[i];
+                v2 += v * v;
+            }
+            kinetic += 0.5 * mass[i] * v2;
+        }
+        release(t);
+    }
+
+    // Chaque paire une fois : dans le bloc, puis avec les tuiles qui le suivent
+    double potential = 0.0;
+    BodyArrays targets, sources;
+    for (size_t first = 0; first < tiles; first += blockTiles) {
+        size_t last = std::min(first + blockTiles, tiles);
+        copySources(first, last, targets, false);
+        potential += pairPotential<D>(forceLaw, targets, targets, softening, true);
+        for (size_t source = last; source < tiles; ++source) {
+            prefetch(source + 1);
+            copySources(source, source + 1, sources, false);
+            potential += pairPotential<D>(forceLaw, targets, sources, softening, false);
+        }
+    }
+    return kinetic - gravitationalConstant * potential;
+}
+
+template <int D>
+uint64_t OutOfCoreSimulationT<D>::computeStateHash() const {
+    typedef Columns<D> C;
+    // FNV-1a puis splitmix64, corps dans l'ordre : voir SimulationT::stateHashOf
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ bits) * 1099511628211ULL;
+    };
+
+    for (size_t t = 0; t < getTileCount(); ++t) {
+        prefetch(t + 1);
+        for (size_t i = 0; i < bodiesIn(t); ++i) {
+            for (int d = 0; d < D; ++d) {
+                mix(column(t, C::POSITION + d)[i]);
+                mix(column(t, C::VELOCITY + d)[i]);
+            }
+        }
+        release(t);
+    }
+
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+template class OutOfCoreSimulationT<2>;
+template class OutOfCoreSimulationT<3>;
@@ -0,0 +1,185 @@
+#include "../../include/PerfCounters.hpp"
+#include "../../include/TaskScheduler.hpp"
+#include <iomanip>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace {
+    const char* const COUNTER_NAMES[CounterSample::COUNTER_COUNT] = {
+        "cycles", "instructions", "cache-misses", "branch-misses"
+    };
+}
+
+// --- CounterSample -----------------------------------------------------------
+
+CounterSample::CounterSample() {
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        values[i] = 0;
+        valid[i] = false;
+    }
+}
+
+CounterSample CounterSample::operator-(const CounterSample& other) const {
+    CounterSample result;
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        result.valid[i] = valid[i] && other.valid[i];
+        result.values[i] = values[i] >= other.values[i] ? values[i] - other.values[i] : 0;
+    }
+    return result;
+}
+
+CounterSample& CounterSample::operator+=(const CounterSample& other) {
+    for (int i = 0; i < COUNTER_COUNT; ++i) {
+        valid[i] = valid[i] || other.valid[i];
+        values[i] += other.values[i];
+    }
+    return *this;
+}
+
+double CounterSample::instructionsPerCycle() const {
+    if (!valid[CYCLES] || !valid[INSTRUCTIONS] || values[CYCLES] == 0) return 0.0;
+    return static_cast<double>(values[INSTRUCTIONS]) / values[CYCLES];
+}
+
+// --- PerfCounters ------------------------------------------------------------
+
+PerfCounters::PerfCounters() {}
+
+PerfCounters::~PerfCounters() {
+#ifdef __linux__
+    for (const Group& group : groups) {
+        for (int fd : group.fds) {
+            if (fd >= 0) close(fd);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::openGroup(int tid) {
+#ifdef __linux__
+    static const uint64_t configs[CounterSample::COUNTER_COUNT] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+        PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    Group group;
+    group.tid = tid;
+    int leader = -1;
+
+    for (int i = 0; i < CounterSample::COUNTER_COUNT; ++i) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = configs[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, tid, -1, leader, PERF_FLAG_FD_CLOEXEC));
+        group.fds[i] = fd;
+
+        if (fd < 0) {
+            if (i == CounterSample::CYCLES) {
+                // Sans meneur, pas de groupe : compteurs indisponibles pour ce thread
+                lastError = std::string("perf_event_open(") + COUNTER_NAMES[i] + "): " + std::strerror(errno);
+                return false;
+            }
+            continue; // Compteur non supporté (VM...), les autres restent utilisables
+        }
+        if (leader < 0) leader = fd;
+    }
+
+    groups.push_back(group);
+    return true;
+#else
+    (void)tid;
+    lastError = "compteurs matériels disponibles uniquement sous Linux";
+    return false;
+#endif
+}
+
+bool PerfCounters::attachCurrentThread() {
+#ifdef __linux__
+    return openGroup(static_cast<int>(syscall(SYS_gettid)));
+#else
+    return openGroup(0);
+#endif
+}
+
+bool PerfCounters::attachScheduler(TaskScheduler& scheduler) {
+    bool ok = attachCurrentThread();
+    std::vector<int> ids = scheduler.getWorkerThreadIds();
+    for (int id : ids) {
+        ok = openGroup(id) && ok;
+    }
+    return ok;
+}
+
+CounterSample PerfCounters::read() const {
+    CounterSample total;
+
+#ifdef __linux__
+    for (const Group& group : groups) {
+        // nr, time_enabled, time_running, puis une valeur par compteur ouvert
+        uint64_t buffer[3 + CounterSample::COUNTER_COUNT];
+        ssize_t bytes = ::read(group.fds[CounterSample::CYCLES], buffer, sizeof(buffer));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) continue;
+
+        uint64_t count = buffer[0];
+        uint64_t enabled = buffer[1];
+        uint64_t running = buffer[2];
+        // Compteurs multiplexés : extrapolation au temps total d'activation
+        double scale = (running > 0 && running < enabled) ? static_cast<double>(enabled) / running : 1.0;
+
+        uint64_t slot = 0;
+        for (int i = 0; i < CounterSample::COUNTER_COUNT && slot < count; ++i) {
+            if (group.fds[i] < 0) continue;
+            total.values[i] += static_cast<uint64_t>(buffer[3 + slot] * scale);
+            total.valid[i] = true;
+            ++slot;
+        }
+    }
+#endif
+
+    return total;
+}
+
+void PerfCounters::printPhase(std::ostream& out, const char* phase, const CounterSample& sample, uint64_t interactions) {
+    out << "  " << std::left << std::setw(16) << phase << std::right << std::fixed;
+
+    if (!sample.valid[CounterSample::CYCLES]) {
+        out << "compteurs indisponibles" << std::endl;
+        return;
+    }
+
+    out << std::setprecision(0) << std::setw(14) << static_cast<double>(sample.values[CounterSample::CYCLES]) << " cycles";
+    if (sample.valid[CounterSample::INSTRUCTIONS]) {
+        out << ", IPC " << std::setprecision(2) << sample.instructionsPerCycle();
+    }
+
+    double perInteraction = interactions > 0 ? 1.0 / interactions : 0.0;
+    if (sample.valid[CounterSample::CACHE_MISSES]) {
+        out << ", défauts cache/interaction " << std::setprecision(4)
+            << sample.values[CounterSample::CACHE_MISSES] * perInteraction;
+    }
+    if (sample.valid[CounterSample::BRANCH_MISSES]) {
+        out << ", mauvaises prédictions/interaction " << std::setprecision(4)
+            << sample.values[CounterSample::BRANCH_MISSES] * perInteraction;
+    }
+    out << std::endl;
+}
+
+void PerfCounters::printReport(std::ostream& out, const PhaseCounters& counters, double stepsPerSecond) {
+    out << "Compteurs matériels (" << counters.steps << " pas, " << std::fixed << std::setprecision(1)
+        << stepsPerSecond << " pas/s, " << counters.interactions << " interactions):" << std::endl;
+    printPhase(out, "calculateForces", counters.forces, counters.interactions);
+    printPhase(out, "updateBodies", counters.integration, counters.interactions);
+}
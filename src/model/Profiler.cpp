@@ -0,0 +1,154 @@
+#include "../../include/Profiler.hpp"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+
+namespace {
+
+struct ThreadBuffer {
+    uint32_t threadId;
+    std::vector<ProfileEvent> events;
+    std::atomic<uint64_t> written;
+
+    explicit ThreadBuffer(uint32_t id) : threadId(id), events(Profiler::BUFFER_CAPACITY), written(0) {}
+};
+
+// Les tampons ne sont jamais libérés : un thread terminé garde ses événements
+std::mutex registryMutex;
+std::vector<std::unique_ptr<ThreadBuffer>>& registry() {
+    static std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    return buffers;
+}
+
+thread_local ThreadBuffer* localBuffer = nullptr;
+
+ThreadBuffer* currentBuffer() {
+    if (localBuffer == nullptr) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        std::vector<std::unique_ptr<ThreadBuffer>>& buffers = registry();
+        buffers.emplace_back(new ThreadBuffer(static_cast<uint32_t>(buffers.size())));
+        localBuffer = buffers.back().get();
+    }
+    return localBuffer;
+}
+
+const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+// Écrit une chaîne JSON en échappant les caractères spéciaux
+void writeJsonString(std::ostream& out, const char* text) {
+    out << '"';
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') out << '\\';
+        out << *c;
+    }
+    out << '"';
+}
+
+// Parcourt les événements encore présents dans un tampon circulaire
+template <typename Visitor>
+void forEachEvent(const ThreadBuffer& buffer, Visitor visit) {
+    uint64_t written = buffer.written.load(std::memory_order_acquire);
+    uint64_t first = written > Profiler::BUFFER_CAPACITY ? written - Profiler::BUFFER_CAPACITY : 0;
+    for (uint64_t i = first; i < written; ++i) {
+        visit(buffer.events[i % Profiler::BUFFER_CAPACITY]);
+    }
+}
+
+} // namespace
+
+uint64_t Profiler::now() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - origin).count());
+}
+
+void Profiler::record(const char* name, uint64_t start, uint64_t end) {
+    ThreadBuffer* buffer = currentBuffer();
+    uint64_t index = buffer->written.load(std::memory_order_relaxed);
+
+    ProfileEvent& event = buffer->events[index % BUFFER_CAPACITY];
+    event.name = name;
+    event.start = start;
+    event.duration = end - start;
+
+    buffer->written.store(index + 1, std::memory_order_release);
+}
+
+bool Profiler::writeChromeTrace(const std::string& path) {
+    std::ofstream file(path.c_str());
+    if (!file) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(registryMutex);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+
+    for (const auto& buffer : registry()) {
+        // Métadonnée : nom lisible du thread dans le visualiseur
+        if (!first) file << ",\n";
+        first = false;
+        file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+             << ",\"args\":{\"name\":\"thread " << buffer->threadId << "\"}}";
+
+        forEachEvent(*buffer, [&file, &buffer](const ProfileEvent& event) {
+            file << ",\n{\"name\":";
+            writeJsonString(file, event.name);
+            file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+                 << std::fixed << std::setprecision(3)
+                 << ",\"ts\":" << event.start / 1000.0
+                 << ",\"dur\":" << event.duration / 1000.0 << "}";
+        });
+    }
+
+    file << "\n]}\n";
+    return static_cast<bool>(file);
+}
+
+void Profiler::printSummary(std::ostream& out) {
+    struct Totals {
+        uint64_t calls;
+        uint64_t nanoseconds;
+        Totals() : calls(0), nanoseconds(0) {}
+    };
+    std::map<std::string, Totals> phases;
+
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (const auto& buffer : registry()) {
+            forEachEvent(*buffer, [&phases](const ProfileEvent& event) {
+                Totals& totals = phases[event.name];
+                totals.calls++;
+                totals.nanoseconds += event.duration;
+            });
+        }
+    }
+
+    out << "Profil par phase:" << std::endl;
+    for (const auto& phase : phases) {
+        out << "  " << std::left << std::setw(34) << phase.first << std::right
+            << std::fixed << std::setprecision(3)
+            << std::setw(10) << phase.second.nanoseconds * 1e-6 << " ms  "
+            << std::setw(8) << phase.second.calls << " appels  "
+            << std::setw(10) << phase.second.nanoseconds * 1e-3 / phase.second.calls << " µs/appel" << std::endl;
+    }
+}
+
+void Profiler::reset() {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    for (auto& buffer : registry()) {
+        buffer->written.store(0, std::memory_order_release);
+    }
+}
+
+bool Profiler::isCompiledIn() {
+#ifdef NBODY_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
@@ -0,0 +1,221 @@
+#include "../../include/Regularization.hpp"
+#include <cmath>
+
+namespace {
+    const int MAX_NEWTON_ITERATIONS = 50;
+
+    // En dessous, y - sin y et sinh y - y passent par leur série (annulation)
+    const double SERIES_THRESHOLD = 0.1;
+
+    double sineDefect(double y) {
+        if (std::abs(y) >= SERIES_THRESHOLD) return y - std::sin(y);
+        double y2 = y * y;
+        return y * y2 * (1.0 / 6.0 - y2 * (1.0 / 120.0 - y2 * (1.0 / 5040.0 - y2 / 362880.0)));
+    }
+
+    double hyperbolicSineDefect(double y) {
+        if (std::abs(y) >= SERIES_THRESHOLD) return std::sinh(y) - y;
+        double y2 = y * y;
+        return y * y2 * (1.0 / 6.0 + y2 * (1.0 / 120.0 + y2 * (1.0 / 5040.0 + y2 / 362880.0)));
+    }
+
+    double squaredNorm(const double w[4]) {
+        return w[0] * w[0] + w[1] * w[1] + w[2] * w[2] + w[3] * w[3];
+    }
+
+    // Lᵀ(u) w pour w = (w₁, w₂, w₃, 0)
+    void transposedMatrix(const double u[4], const double w[3], double out[4]) {
+        out[0] = u[0] * w[0] + u[1] * w[1] + u[2] * w[2];
+        out[1] = -u[1] * w[0] + u[0] * w[1] + u[3] * w[2];
+        out[2] = -u[2] * w[0] - u[3] * w[1] + u[0] * w[2];
+        out[3] = u[3] * w[0] - u[2] * w[1] + u[1] * w[2];
+    }
+
+    // Trois premières composantes de L(u) w (la quatrième est nulle)
+    void matrix(const double u[4], const double w[4], double out[3]) {
+        out[0] = u[0] * w[0] - u[1] * w[1] - u[2] * w[2] + u[3] * w[3];
+        out[1] = u[1] * w[0] + u[0] * w[1] - u[3] * w[2] - u[2] * w[3];
+        out[2] = u[2] * w[0] + u[3] * w[1] + u[0] * w[2] + u[1] * w[3];
+    }
+
+    // Accélération relative T x pour la séparation x = L(u) u
+    void tidalAcceleration(const double u[4], const double tide[3][3], double out[3]) {
+        double x[3];
+        matrix(u, u, x);
+        for (int a = 0; a < 3; ++a) {
+            out[a] = tide[a][0] * x[0] + tide[a][1] * x[1] + tide[a][2] * x[2];
+        }
+    }
+}
+
+RegularizedPair::RegularizedPair() : energy(0.0), mu(0.0), substeps(0) {
+    for (int k = 0; k < 4; ++k) {
+        u[k] = 0.0;
+        velocity[k] = 0.0;
+    }
+}
+
+void RegularizedPair::initialize(const double x[3], const double v[3], double gravitationalParameter) {
+    mu = gravitationalParameter;
+    double r = std::sqrt(x[0] * x[0] + x[1] * x[1] + x[2] * x[2]);
+
+    // Branche choisie selon le signe de x₁ pour éviter la division par un petit u
+    if (x[0] >= 0.0) {
+        u[0] = std::sqrt(0.5 * (r + x[0]));
+        u[3] = 0.0;
+        u[1] = u[0] > 0.0 ? x[1] / (2.0 * u[0]) : 0.0;
+        u[2] = u[0] > 0.0 ? x[2] / (2.0 * u[0]) : 0.0;
+    } else {
+        u[1] = std::sqrt(0.5 * (r - x[0]));
+        u[2] = 0.0;
+        u[0] = x[1] / (2.0 * u[1]);
+        u[3] = x[2] / (2.0 * u[1]);
+    }
+
+    transposedMatrix(u, v, velocity);
+    for (int k = 0; k < 4; ++k) velocity[k] *= 0.5;
+    energy = r > 0.0 ? (2.0 * squaredNorm(velocity) - mu) / r : 0.0;
+}
+
+void RegularizedPair::oscillator(double delta, Oscillator& k) const {
+    double half = 0.5 * energy;
+    if (half < 0.0) {
+        double omega = std::sqrt(-half);
+        double angle = omega * delta;
+        double sine = std::sin(angle);
+        k.c = std::cos(angle);
+        k.s = sine / omega;
+        k.icc = 0.5 * delta + std::sin(2.0 * angle) / (4.0 * omega);
+        k.ics = sine * sine / (2.0 * omega * omega);
+        k.iss = sineDefect(2.0 * angle) / (4.0 * omega * omega * omega);
+    } else if (half > 0.0) {
+        double kappa = std::sqrt(half);
+        double angle = kappa * delta;
+        double sine = std::sinh(angle);
+        k.c = std::cosh(angle);
+        k.s = sine / kappa;
+        k.icc = 0.5 * delta + std::sinh(2.0 * angle) / (4.0 * kappa);
+        k.ics = sine * sine / (2.0 * kappa * kappa);
+        k.iss = hyperbolicSineDefect(2.0 * angle) / (4.0 * kappa * kappa * kappa);
+    } else {
+        k.c = 1.0;
+        k.s = delta;
+        k.icc = delta;
+        k.ics = 0.5 * delta * delta;
+        k.iss = delta * delta * delta / 3.0;
+    }
+    k.ds = half * k.s;
+}
+
+double RegularizedPair::elapsed(double delta) const {
+    // t(Δ) = ∫ |u(s)|² ds, avec u(s) = c u + s u'
+    Oscillator k;
+    oscillator(delta, k);
+    double dot = u[0] * velocity[0] + u[1] * velocity[1] + u[2] * velocity[2] + u[3] * velocity[3];
+    return squaredNorm(u) * k.icc + 2.0 * dot * k.ics + squaredNorm(velocity) * k.iss;
+}
+
+void RegularizedPair::drift(double delta) {
+    Oscillator k;
+    oscillator(delta, k);
+    for (int i = 0; i < 4; ++i) {
+        double position = u[i];
+        u[i] = k.c * position + k.s * velocity[i];
+        velocity[i] = k.ds * position + k.c * velocity[i];
+    }
+}
+
+void RegularizedPair::kick(double delta, const double tide[3][3]) {
+    double r = squaredNorm(u);
+    double perturbation[3], force[4];
+    tidalAcceleration(u, tide, perturbation);
+    transposedMatrix(u, perturbation, force);
+    for (int i = 0; i < 4; ++i) {
+        velocity[i] += delta * 0.5 * r * force[i];
+    }
+    // μ = 2|u'|² - h r est invariant : h suit le travail de la perturbation
+    energy = (2.0 * squaredNorm(velocity) - mu) / r;
+}
+
+double RegularizedPair::solveTime(double time) const {
+    // Newton sur t(Δ) = time, de dérivée r(Δ) > 0
+    double delta = time / squaredNorm(u);
+    for (int iteration = 0; iteration < MAX_NEWTON_ITERATIONS; ++iteration) {
+        Oscillator k;
+        oscillator(delta, k);
+        double r = 0.0;
+        for (int i = 0; i < 4; ++i) {
+            double component = k.c * u[i] + k.s * velocity[i];
+            r += component * component;
+        }
+        double correction = (elapsed(delta) - time) / r;
+        delta -= correction;
+        if (std::abs(correction) <= 1e-15 * std::abs(delta)) break;
+    }
+    return delta;
+}
+
+void RegularizedPair::advance(double dt, const double tide[3][3]) {
+    bool perturbed = false;
+    for (int a = 0; a < 3; ++a) {
+        perturbed = perturbed || tide[a][0] != 0.0 || tide[a][1] != 0.0 || tide[a][2] != 0.0;
+    }
+    double time = 0.0;
+
+    for (;;) {
+        double remaining = dt - time;
+        if (!(remaining > 0.0)) break;
+
+        double nominal = energy < 0.0 ? M_PI / (std::sqrt(-0.5 * energy) * SUBSTEPS_PER_ORBIT)
+                                      : remaining / (SUBSTEPS_PER_ORBIT * squaredNorm(u));
+        bool last = elapsed(nominal) >= remaining;
+        double delta = last ? solveTime(remaining) : nominal;
+
+        if (perturbed) kick(0.5 * delta, tide);
+        time += elapsed(delta);
+        drift(delta);
+        if (perturbed) kick(0.5 * delta, tide);
+        ++substeps;
+        if (last) break;
+    }
+
+    // La dernière impulsion a décalé l'horloge d'un rien : dérive libre jusqu'à dt exactement
+    if (time != dt) drift(solveTime(dt - time));
+}
+
+double RegularizedPair::getPerturbation(const double tide[3][3]) const {
+    double perturbation[3];
+    tidalAcceleration(u, tide, perturbation);
+    double r = squaredNorm(u);
+    double magnitude = std::sqrt(perturbation[0] * perturbation[0] + perturbation[1] * perturbation[1]
+                                 + perturbation[2] * perturbation[2]);
+    return magnitude * r * r / mu;
+}
+
+void RegularizedPair::relativeState(double x[3], double v[3]) const {
+    double r = squaredNorm(u);
+    matrix(u, u, x);
+    matrix(u, velocity, v);
+    for (int i = 0; i < 3; ++i) {
+        v[i] *= 2.0 / r;
+    }
+}
+
+bool RegularizedPair::orbit(const double x[3], const double v[3], double gravitationalParameter,
+                            double& pericenter, double& apocenter) {
+    double r2 = x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+    double v2 = v[0] * v[0] + v[1] * v[1] + v[2] * v[2];
+    double radial = x[0] * v[0] + x[1] * v[1] + x[2] * v[2];
+    if (r2 == 0.0) return false;
+
+    double orbitalEnergy = 0.5 * v2 - gravitationalParameter / std::sqrt(r2);
+    if (orbitalEnergy >= 0.0) return false;
+
+    double semiMajorAxis = -gravitationalParameter / (2.0 * orbitalEnergy);
+    double angularMomentum2 = r2 * v2 - radial * radial;
+    double eccentricity2 = 1.0 + 2.0 * orbitalEnergy * angularMomentum2 / (gravitationalParameter * gravitationalParameter);
+    double eccentricity = eccentricity2 > 0.0 ? std::sqrt(eccentricity2) : 0.0;
+    pericenter = semiMajorAxis * (1.0 - eccentricity);
+    apocenter = semiMajorAxis * (1.0 + eccentricity);
+    return true;
+}
@@ -0,0 +1,633 @@
+#include "../../include/Scene.hpp"
+#include "../../include/TaskScheduler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const size_t NOT_DECLARED = static_cast<size_t>(-1);
+    const double DEFAULT_RADIUS = 5.0;
+    const size_t BINARY_GRAIN = 65536;
+
+    // Puissances de 10 représentées exactement en double
+    const double EXACT_POWERS[] = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    inline bool isBlank(char c) {
+        return c == ' ' || c == '\t' || c == '\r';
+    }
+
+    inline bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    // Une masse nulle désigne un traceur
+    inline ParticleClass classOf(double mass) {
+        return mass == 0.0 ? ParticleClass::Tracer : ParticleClass::Massive;
+    }
+
+    /**
+     * Nombre décimal, indépendant de la locale. Chemin rapide de Clinger :
+     * mantisse <= 2^53 et |exposant| <= 22 donnent un produit ou un quotient
+     * exact, donc correctement arrondi ; les autres cas passent par
+     * std::from_chars, qui ignore LC_NUMERIC contrairement à strtod.
+     */
+    bool parseNumber(const char*& cursor, const char* end, double& value) {
+        const char* p = cursor;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+')) {
+            negative = *p == '-';
+            ++p;
+        }
+        const char* start = p;
+
+        uint64_t mantissa = 0;
+        int significant = 0;
+        int exponent = 0;
+        bool digits = false;
+        for (; p < end && isDigit(*p); ++p) {
+            digits = true;
+            if (significant < 19) {
+                mantissa = mantissa * 10 + (*p - '0');
+                if (mantissa != 0) ++significant;
+            } else {
+                ++exponent;
+            }
+        }
+        if (p < end && *p == '.') {
+            for (++p; p < end && isDigit(*p); ++p) {
+                digits = true;
+                if (significant < 19) {
+                    mantissa = mantissa * 10 + (*p - '0');
+                    if (mantissa != 0) ++significant;
+                    --exponent;
+                }
+            }
+        }
+        if (!digits) return false;
+
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            const char* q = p + 1;
+            bool negativeExponent = false;
+            if (q < end && (*q == '-' || *q == '+')) {
+                negativeExponent = *q == '-';
+                ++q;
+            }
+            if (q < end && isDigit(*q)) {
+                int written = 0;
+                for (; q < end && isDigit(*q); ++q) {
+                    if (written < 100000) written = written * 10 + (*q - '0');
+                }
+                exponent += negativeExponent ? -written : written;
+                p = q;
+            }
+        }
+        cursor = p;
+
+        if (mantissa <= (static_cast<uint64_t>(1) << 53) && exponent >= -22 && exponent <= 22) {
+            double magnitude = static_cast<double>(mantissa);
+            magnitude = exponent < 0 ? magnitude / EXACT_POWERS[-exponent] : magnitude * EXACT_POWERS[exponent];
+            value = negative ? -magnitude : magnitude;
+            return true;
+        }
+        // Hors de portée : infini ou zéro, comme strtod
+        double magnitude = 0.0;
+        std::from_chars_result result = std::from_chars(start, p, magnitude, std::chars_format::general);
+        if (result.ec == std::errc::result_out_of_range) {
+            magnitude = exponent > 0 ? HUGE_VAL : 0.0;
+        } else if (result.ec != std::errc() || result.ptr != p) {
+            return false;
+        }
+        value = negative ? -magnitude : magnitude;
+        return true;
+    }
+
+    /**
+     * Valeurs d'une ligne séparées par virgules, points-virgules ou blancs ;
+     * -1 si un champ n'est pas un nombre ou s'il y a plus de capacity valeurs
+     */
+    int parseRow(const char* p, const char* end, double* values, int capacity) {
+        int count = 0;
+        while (true) {
+            while (p < end && isBlank(*p)) ++p;
+            if (p == end) return count;
+            if (count == capacity || !parseNumber(p, end, values[count])) return -1;
+            ++count;
+            const char* field = p;
+            while (p < end && isBlank(*p)) ++p;
+            if (p < end && (*p == ',' || *p == ';')) {
+                ++p;
+            } else if (p < end && p == field) {
+                return -1; // Caractère collé au nombre
+            }
+        }
+    }
+
+    // Début utile d'une ligne, nullptr pour une ligne vide ou un commentaire
+    const char* content(const char* line, const char* end) {
+        while (line < end && isBlank(*line)) ++line;
+        return (line == end || *line == '#') ? nullptr : line;
+    }
+
+    // Appelle visit(début, fin, numéro local) pour chaque ligne de [begin, end)
+    template <typename Visit>
+    bool forEachLine(const char* begin, const char* end, Visit visit) {
+        size_t number = 0;
+        while (begin < end) {
+            const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            const char* lineEnd = newline ? newline : end;
+            if (!visit(begin, lineEnd, number++)) return false;
+            begin = newline ? newline + 1 : end;
+        }
+        return true;
+    }
+
+    template <typename Function>
+    void forEachRange(TaskScheduler* scheduler, size_t count, size_t grain, Function function) {
+        if (scheduler && scheduler->getThreadCount() > 1 && count > grain) {
+            scheduler->parallelFor(0, count, grain, [&function](size_t begin, size_t end) { function(begin, end); });
+        } else {
+            function(0, count);
+        }
+    }
+
+    std::string directoryOf(const std::string& path) {
+        size_t slash = path.find_last_of('/');
+        return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+    }
+
+    bool parseValue(const std::string& text, double& value) {
+        const char* cursor = text.c_str();
+        return parseNumber(cursor, cursor + text.size(), value) && cursor == text.c_str() + text.size();
+    }
+}
+
+// --- SceneLoader -------------------------------------------------------------
+
+SceneLoader::SceneLoader()
+    : binary(false), declaredBodies(NOT_DECLARED), table(nullptr), tableSize(0), tableFirstLine(0) {}
+
+SceneLoader::~SceneLoader() {
+    close();
+}
+
+bool SceneLoader::map(const std::string& file, Mapping& mapping) {
+    mapping.descriptor = ::open(file.c_str(), O_RDONLY);
+    if (mapping.descriptor < 0) {
+        lastError = file + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (fstat(mapping.descriptor, &info) != 0) {
+        lastError = file + ": " + std::strerror(errno);
+        unmap(mapping);
+        return false;
+    }
+    mapping.size = static_cast<size_t>(info.st_size);
+    if (mapping.size == 0) return true; // Table vide : rien à projeter
+
+    void* address = mmap(nullptr, mapping.size, PROT_READ, MAP_SHARED, mapping.descriptor, 0);
+    if (address == MAP_FAILED) {
+        lastError = std::string("mmap: ") + std::strerror(errno);
+        mapping.size = 0;
+        unmap(mapping);
+        return false;
+    }
+    // Lecture d'un seul passage, du début à la fin
+    madvise(address, mapping.size, MADV_SEQUENTIAL);
+    mapping.data = static_cast<const char*>(address);
+    return true;
+}
+
+void SceneLoader::unmap(Mapping& mapping) {
+    if (mapping.data) {
+        munmap(const_cast<char*>(mapping.data), mapping.size);
+        mapping.data = nullptr;
+    }
+    if (mapping.descriptor >= 0) {
+        ::close(mapping.descriptor);
+        mapping.descriptor = -1;
+    }
+    mapping.size = 0;
+}
+
+bool SceneLoader::open(const std::string& scenePath) {
+    close();
+    path = scenePath;
+    if (!map(path, scene)) return false;
+    if (!scene.data) {
+        lastError = path + ": fichier vide";
+        return false;
+    }
+    if (!parseHeader()) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void SceneLoader::close() {
+    unmap(scene);
+    unmap(external);
+    tablePath.clear();
+    settings = SceneSettings();
+    binary = false;
+    declaredBodies = NOT_DECLARED;
+    table = nullptr;
+    tableSize = 0;
+    tableFirstLine = 0;
+}
+
+bool SceneLoader::parseHeader() {
+    const char* end = scene.data + scene.size;
+    const char* line = scene.data;
+    size_t number = 0;
+    bool versioned = false;
+
+    while (line < end) {
+        const char* newline = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        const char* lineEnd = newline ? newline : end;
+        const char* next = newline ? newline + 1 : end;
+        ++number;
+        std::string where = path + ":" + std::to_string(number) + ": ";
+
+        const char* start = content(line, lineEnd);
+        line = next;
+        if (!start) continue;
+
+        // Clé, puis valeur jusqu'à la fin de ligne (blancs de fin retirés)
+        const char* keyEnd = start;
+        while (keyEnd < lineEnd && !isBlank(*keyEnd)) ++keyEnd;
+        const char* valueStart = keyEnd;
+        while (valueStart < lineEnd && isBlank(*valueStart)) ++valueStart;
+        const char* valueEnd = lineEnd;
+        while (valueEnd > valueStart && isBlank(valueEnd[-1])) --valueEnd;
+        std::string key(start, keyEnd);
+        std::string value(valueStart, valueEnd);
+
+        if (!versioned) {
+            if (key != "nbody-scene" || value != "1") {
+                lastError = where + "pas un fichier de scène (première ligne attendue : nbody-scene 1)";
+                return false;
+            }
+            versioned = true;
+            continue;
+        }
+
+        double parsed = 0.0;
+        if (key == "dimension") {
+            if (value != "2" && value != "3") {
+                lastError = where + "dimension 2 ou 3 attendue";
+                return false;
+            }
+            settings.dimension = value == "3" ? 3 : 2;
+        } else if (key == "G" || key == "dt" || key == "softening" || key == "contact"
+                   || key == "freeze" || key == "binaries") {
+            if (!parseValue(value, parsed) || parsed < 0.0 || (key == "dt" && parsed == 0.0)) {
+                lastError = where + "valeur invalide pour " + key;
+                return false;
+            }
+            if (key == "G") settings.gravitationalConstant = parsed;
+            else if (key == "dt") settings.timeStep = parsed;
+            else if (key == "softening") settings.softening = parsed;
+            else if (key == "freeze") settings.freezeDistance = parsed;
+            else if (key == "binaries") settings.binaryRadius = parsed;
+            else settings.contactStiffness = parsed;
+        } else if (key == "integrator") {
+            if (!parseIntegrator(value, settings.integrator)) {
+                lastError = where + "intégrateur inconnu: " + value;
+                return false;
+            }
+        } else if (key == "law") {
+            if (!parseForceLaw(value, settings.forceLaw)) {
+                lastError = where + "loi de force inconnue: " + value;
+                return false;
+            }
+        } else if (key == "solver") {
+            settings.autotune = value == "auto";
+            if (!settings.autotune && !parseSolverConfig(value, settings.solver)) {
+                lastError = where + "solveur inconnu: " + value;
+                return false;
+            }
+        } else if (key == "bodies") {
+            char* parsed = nullptr;
+            unsigned long long count = std::strtoull(value.c_str(), &parsed, 10);
+            if (value.empty() || *parsed != '\0') {
+                lastError = where + "nombre de corps invalide";
+                return false;
+            }
+            declaredBodies = static_cast<size_t>(count);
+        } else if (key == "data") {
+            std::string format = value.substr(0, value.find_first_of(" \t"));
+            std::string file = format.size() < value.size() ? value.substr(format.size()) : std::string();
+            file.erase(0, file.find_first_not_of(" \t"));
+            if (format != "csv" && format != "binary") {
+                lastError = where + "format de table inconnu (csv ou binary): " + format;
+                return false;
+            }
+            binary = format == "binary";
+            if (file.empty()) {
+                table = next;
+                tableSize = static_cast<size_t>(end - next);
+                tableFirstLine = number + 1;
+                return true;
+            }
+            tablePath = file[0] == '/' ? file : directoryOf(path) + file;
+            if (!map(tablePath, external)) return false;
+            table = external.data;
+            tableSize = external.size;
+            tableFirstLine = 1;
+            return true;
+        } else {
+            lastError = where + "clé inconnue: " + key;
+            return false;
+        }
+    }
+
+    lastError = path + ": " + (versioned ? "ligne data manquante" : "pas un fichier de scène");
+    return false;
+}
+
+template <int D>
+bool SceneLoader::load(SimulationT<D>& simulation, TaskScheduler* scheduler) {
+    if (!scene.data) {
+        lastError = "aucune scène ouverte";
+        return false;
+    }
+    if (settings.dimension != D) {
+        lastError = path + ": scène en " + std::to_string(settings.dimension) + "D, simulation en "
+                  + std::to_string(D) + "D";
+        return false;
+    }
+
+    // Pool temporaire : tous les cœurs pour une grosse table, aucun thread pour une petite
+    std::unique_ptr<TaskScheduler> temporary;
+    if (!scheduler && tableSize > CHUNK_BYTES) {
+        temporary.reset(new TaskScheduler(0));
+        scheduler = temporary.get();
+    }
+
+    std::vector<std::unique_ptr<BodyT<D>>> bodies;
+    if (!(binary ? loadBinary(bodies, scheduler) : loadCsv(bodies, scheduler))) {
+        return false;
+    }
+    if (declaredBodies != NOT_DECLARED && bodies.size() != declaredBodies) {
+        lastError = path + ": " + std::to_string(bodies.size()) + " corps lus, " + std::to_string(declaredBodies)
+                  + " annoncés";
+        return false;
+    }
+    simulation.replaceBodies(std::move(bodies));
+    return true;
+}
+
+template <int D>
+bool SceneLoader::loadCsv(std::vector<std::unique_ptr<BodyT<D>>>& bodies, TaskScheduler* scheduler) {
+    const char* end = table + tableSize;
+    const std::string& source = tablePath.empty() ? path : tablePath;
+
+    // Blocs alignés sur les débuts de ligne
+    std::vector<const char*> chunkStart(1, table);
+    while (static_cast<size_t>(end - chunkStart.back()) > CHUNK_BYTES) {
+        const char* cut = chunkStart.back() + CHUNK_BYTES;
+        const char* newline = static_cast<const char*>(std::memchr(cut, '\n', end - cut));
+        if (!newline || newline + 1 >= end) break;
+        chunkStart.push_back(newline + 1);
+    }
+    size_t chunks = chunkStart.size();
+    chunkStart.push_back(end);
+
+    // Une première ligne commençant par une lettre nomme les colonnes
+    const char* columnNames = nullptr;
+    forEachLine(table, end, [&columnNames](const char* line, const char* lineEnd, size_t) {
+        const char* start = content(line, lineEnd);
+        if (!start) return true;
+        if ((*start >= 'a' && *start <= 'z') || (*start >= 'A' && *start <= 'Z')) columnNames = start;
+        return false;
+    });
+
+    // Passe 1 : lignes et corps par bloc
+    std::vector<size_t> chunkLines(chunks + 1, 0);
+    std::vector<size_t> chunkBodies(chunks + 1, 0);
+    forEachRange(scheduler, chunks, 1, [&](size_t begin, size_t finish) {
+        for (size_t k = begin; k < finish; ++k) {
+            size_t lines = 0, rows = 0;
+            forEachLine(chunkStart[k], chunkStart[k + 1], [&](const char* line, const char* lineEnd, size_t) {
+                ++lines;
+                const char* start = content(line, lineEnd);
+                if (start && start != columnNames) ++rows;
+                return true;
+            });
+            chunkLines[k + 1] = lines;
+            chunkBodies[k + 1] = rows;
+        }
+    });
+    for (size_t k = 0; k < chunks; ++k) {
+        chunkLines[k + 1] += chunkLines[k];
+        chunkBodies[k + 1] += chunkBodies[k];
+    }
+    bodies.resize(chunkBodies[chunks]);
+
+    // Passe 2 : chaque corps construit à sa place finale
+    const int minimum = 2 * D + 1;
+    const int maximum = 2 * D + 2;
+    std::vector<size_t> errorLine(chunks, NOT_DECLARED);
+    std::vector<std::string> errorText(chunks);
+    forEachRange(scheduler, chunks, 1, [&](size_t begin, size_t finish) {
+        for (size_t k = begin; k < finish; ++k) {
+            size_t index = chunkBodies[k];
+            forEachLine(chunkStart[k], chunkStart[k + 1], [&](const char* line, const char* lineEnd, size_t local) {
+                const char* start = content(line, lineEnd);
+                if (!start || start == columnNames) return true;
+
+                double values[2 * D + 2];
+                int count = parseRow(start, lineEnd, values, maximum);
+                const char* problem = nullptr;
+                if (count < minimum) {
+                    problem = D == 3 ? "x,y,z,vx,vy,vz,masse[,rayon] attendus" : "x,y,vx,vy,masse[,rayon] attendus";
+                } else if (values[2 * D] < 0.0 || (count == maximum && values[maximum - 1] < 0.0)) {
+                    problem = "masse ou rayon négatif";
+                }
+                if (problem) {
+                    errorLine[k] = chunkLines[k] + local;
+                    errorText[k] = problem;
+                    return false;
+                }
+
+                Vector<D> position, velocity;
+                for (int axis = 0; axis < D; ++axis) {
+                    position[axis] = values[axis];
+                    velocity[axis] = values[D + axis];
+                }
+                double radius = count == maximum ? values[maximum - 1] : DEFAULT_RADIUS;
+                bodies[index++].reset(new BodyT<D>(position, velocity, values[2 * D], radius, classOf(values[2 * D])));
+                return true;
+            });
+        }
+    });
+
+    for (size_t k = 0; k < chunks; ++k) {
+        if (errorLine[k] != NOT_DECLARED) {
+            lastError = source + ":" + std::to_string(tableFirstLine + errorLine[k]) + ": " + errorText[k];
+            bodies.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int D>
+bool SceneLoader::loadBinary(std::vector<std::unique_ptr<BodyT<D>>>& bodies, TaskScheduler* scheduler) {
+    const size_t record = (2 * D + 2) * sizeof(double);
+    if (tableSize % record != 0) {
+        lastError = (tablePath.empty() ? path : tablePath) + ": table binaire tronquée ("
+                  + std::to_string(tableSize % record) + " octets en trop)";
+        return false;
+    }
+
+    bodies.resize(tableSize / record);
+    const char* data = table;
+    forEachRange(scheduler, bodies.size(), BINARY_GRAIN, [&](size_t begin, size_t finish) {
+        for (size_t i = begin; i < finish; ++i) {
+            double values[2 * D + 2];
+            std::memcpy(values, data + i * record, record);
+            Vector<D> position, velocity;
+            for (int axis = 0; axis < D; ++axis) {
+                position[axis] = values[axis];
+                velocity[axis] = values[D + axis];
+            }
+            bodies[i].reset(new BodyT<D>(position, velocity, values[2 * D], values[2 * D + 1], classOf(values[2 * D])));
+        }
+    });
+    return true;
+}
+
+template bool SceneLoader::load<2>(Simulation& simulation, TaskScheduler* scheduler);
+template bool SceneLoader::load<3>(Simulation3D& simulation, TaskScheduler* scheduler);
+
+// --- SceneSnapshot -----------------------------------------------------------
+
+template <int D>
+SceneSnapshot SceneSnapshot::capture(const SimulationT<D>& simulation) {
+    SceneSnapshot snapshot;
+    snapshot.settings.dimension = D;
+    snapshot.settings.gravitationalConstant = simulation.getGravitationalConstant();
+    snapshot.settings.timeStep = simulation.getTimeStep();
+    snapshot.settings.integrator = simulation.getIntegrator();
+    snapshot.settings.forceLaw = simulation.getForceLaw();
+    snapshot.settings.softening = simulation.getSoftening();
+    snapshot.settings.contactStiffness = simulation.getContactStiffness();
+    snapshot.settings.freezeDistance = simulation.getFreezeDistance();
+    snapshot.settings.binaryRadius = simulation.getBinaryRadius();
+    snapshot.settings.solver = simulation.getSolver();
+    snapshot.settings.autotune = simulation.isAutotuning();
+
+    const auto& bodies = simulation.getBodies();
+    snapshot.bodyCount = bodies.size();
+    snapshot.values.resize(bodies.size() * (2 * D + 2));
+    double* values = snapshot.values.data();
+    for (const auto& body : bodies) {
+        Vector<D> position = body->getPosition();
+        Vector<D> velocity = body->getVelocity();
+        for (int axis = 0; axis < D; ++axis) {
+            values[axis] = position[axis];
+            values[D + axis] = velocity[axis];
+        }
+        values[2 * D] = body->getSourceMass();
+        values[2 * D + 1] = body->getRadius();
+        values += 2 * D + 2;
+    }
+    return snapshot;
+}
+
+template SceneSnapshot SceneSnapshot::capture<2>(const Simulation& simulation);
+template SceneSnapshot SceneSnapshot::capture<3>(const Simulation3D& simulation);
+
+// --- SceneWriter -------------------------------------------------------------
+
+template <int D>
+bool SceneWriter::write(const std::string& path, const SimulationT<D>& simulation, bool binary) {
+    return write(path, SceneSnapshot::capture(simulation), binary);
+}
+
+template bool SceneWriter::write<2>(const std::string& path, const Simulation& simulation, bool binary);
+template bool SceneWriter::write<3>(const std::string& path, const Simulation3D& simulation, bool binary);
+
+bool SceneWriter::write(const std::string& path, const SceneSnapshot& snapshot, bool binary) {
+    return writeFile(path, snapshot, binary, false);
+}
+
+bool SceneWriter::writeFile(const std::string& path, const SceneSnapshot& snapshot, bool binary, bool durable) {
+    std::FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const SceneSettings& settings = snapshot.settings;
+    int dimension = settings.dimension;
+    std::fprintf(file, "# Scène N-Corps\nnbody-scene 1\ndimension %d\n", dimension);
+    std::fprintf(file, "G %.17g\ndt %.17g\n", settings.gravitationalConstant, settings.timeStep);
+    std::fprintf(file, "integrator %s\nlaw %s\n", integratorName(settings.integrator), forceLawName(settings.forceLaw));
+    std::fprintf(file, "softening %.17g\ncontact %.17g\n", settings.softening, settings.contactStiffness);
+    if (settings.freezeDistance > 0.0) std::fprintf(file, "freeze %.17g\n", settings.freezeDistance);
+    if (settings.binaryRadius > 0.0) std::fprintf(file, "binaries %.17g\n", settings.binaryRadius);
+    // Calibré : relu en « auto », le cache de la machine redonne le même choix
+    std::string solver = settings.autotune ? std::string("auto") : settings.solver.describe();
+    std::fprintf(file, "solver %s\nbodies %llu\ndata %s\n", solver.c_str(),
+                 static_cast<unsigned long long>(snapshot.bodyCount), binary ? "binary" : "csv");
+
+    size_t stride = 2 * dimension + 2;
+    if (binary) {
+        std::fwrite(snapshot.values.data(), sizeof(double), snapshot.values.size(), file);
+    } else {
+        std::fputs(dimension == 3 ? "x,y,z,vx,vy,vz,mass,radius\n" : "x,y,vx,vy,mass,radius\n", file);
+        for (size_t i = 0; i < snapshot.bodyCount; ++i) {
+            const double* values = snapshot.values.data() + i * stride;
+            for (size_t k = 0; k + 1 < stride; ++k) std::fprintf(file, "%.17g,", values[k]);
+            std::fprintf(file, "%.17g\n", values[stride - 1]);
+        }
+    }
+
+    bool ok = !std::ferror(file);
+    if (durable && ok) {
+        ok = std::fflush(file) == 0 && fsync(fileno(file)) == 0;
+    }
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) lastError = path + ": écriture incomplète";
+    return ok;
+}
+
+AsyncTask<bool> SceneWriter::writeAsync(CoroutineExecutor& executor, std::string path, SceneSnapshot snapshot,
+                                        bool binary) {
+    co_await executor.schedule();
+    std::string temporary = path + ".tmp";
+    if (!writeFile(temporary, snapshot, binary, true)) {
+        std::remove(temporary.c_str());
+        co_return false;
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        lastError = path + ": " + std::strerror(errno);
+        co_return false;
+    }
+
+    // Entrée du répertoire rendue durable à son tour ; sans effet si le système refuse
+    size_t slash = path.find_last_of('/');
+    std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : path.substr(0, slash));
+    int descriptor = ::open(directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (descriptor >= 0) {
+        fsync(descriptor);
+        ::close(descriptor);
+    }
+    co_return true;
+}
@@ -1,75 +1,1307 @@
 #include "../../include/Simulation.hpp"
+#include "../../include/TaskScheduler.hpp"
+#include "../../include/Profiler.hpp"
+#include "../../include/Telemetry.hpp"
 #include <random>
 #include <cmath>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <limits>
 
-Simulation::Simulation(double G, double dt) 
-    : gravitationalConstant(G), timeStep(dt) {}
+namespace {
+    // En dessous de ces tailles, le coût de distribution dépasse le gain
+    const size_t PARALLEL_FORCE_THRESHOLD = 64;
+    const size_t FORCE_GRAIN = 8;
+    
+    // Blocs de cibles plus gros pour les tuiles (une tuile sert à tout le bloc)
+    // et pour l'arbre (des cibles voisines parcourent les mêmes nœuds)
+    const size_t BLOCKED_GRAIN = 64;
+    const size_t TREE_GRAIN = 64;
+    
+    // Dégradation tolérée de l'arbre réajusté ; sa construction ne coûte que quelques
+    // pour cent d'un parcours, au-delà le réajustement ne paie plus
+    const double DEFAULT_TREE_REBUILD_RATIO = 1.05;
+    
+    // Calculs des forces entre deux révisions de la situation du solveur
+    const uint64_t SOLVER_CHECK_INTERVAL = 64;
+    
+    // Au-delà, les candidats O(N²) sur un seul thread ne sont pas chronométrés (pool disponible)
+    const size_t SERIAL_CALIBRATION_LIMIT = 8192;
+    const size_t UPDATE_GRAIN = 1024;
+    
+    // Traceurs : une tâche porte environ ce nombre d'interactions traceur-source
+    const size_t TRACER_BLOCK_INTERACTIONS = 16384;
+    
+    // Pas d'attente avant qu'une paire défaite par la marée puisse se reformer
+    const uint64_t BINARY_RETRY_STEPS = 16;
+    
+    // Peau par défaut de la liste de contact, en fraction de la coupure : sans
+    // peau, la liste serait reconstruite à chaque pas
+    const double CONTACT_SKIN_RATIO = 0.5;
+    
+    // Composantes d'un vecteur de dimension D, z nul en 2D (variables KS)
+    template <int D>
+    void toArray(const Vector<D>& vector, double out[3]) {
+        out[0] = vector[0];
+        out[1] = vector[1];
+        out[2] = D == 3 ? vector[2] : 0.0;
+    }
+    
+    // Contribution newtonienne m (3 d dᵀ / d⁵ - I / d³) d'une masse en d au tenseur de marée
+    void addTide(double tide[3][3], const double d[3], double mass) {
+        double d2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+        double inverse3 = 1.0 / (d2 * std::sqrt(d2));
+        double inverse5 = 3.0 * inverse3 / d2;
+        for (int a = 0; a < 3; ++a) {
+            for (int b = 0; b < 3; ++b) {
+                tide[a][b] += mass * (inverse5 * d[a] * d[b] - (a == b ? inverse3 : 0.0));
+            }
+        }
+    }
+    
+    // Composante hors du plan : ignorée en 2D, où les préréglages restent inchangés
+    template <int D>
+    Vector<D> makeVector(double x, double y, double z);
+    
+    template <>
+    Vector<2> makeVector<2>(double x, double y, double) { return Vector<2>(x, y); }
+    
+    template <>
+    Vector<3> makeVector<3>(double x, double y, double z) { return Vector<3>(x, y, z); }
+    
+    // Même parcours pour les corps de la simulation et pour leur copie figée
+    template <int D>
+    const BodyT<D>& bodyOf(const std::unique_ptr<BodyT<D>>& body) { return *body; }
+    
+    template <int D>
+    const BodyT<D>& bodyOf(const BodyT<D>& body) { return body; }
+}
+
+template <int D>
+SimulationT<D>::SimulationT(double G, double dt, ForceLaw law, double softeningLength) 
+    : gravitationalConstant(G), timeStep(dt), forceLaw(law), softening(softeningLength),
+      kernels(selectForceKernels<D>(law)), integrator(Integrator::Euler), accelerationsCurrent(false),
+      totalMass(0.0), seeded(false), randomSeed(0), reproducible(false), stepCount(0), hashInterval(0),
+      freezeDistance(0.0), pendingSourceTravel(0.0), pendingTime(0.0), frozenCount(0),
+      binaryRadius(0.0), binaryPerturbationLimit(1e-2), contactStiffness(0.0), neighborSkin(-1.0), scheduler(nullptr),
+      placement(MemoryPlacement::Default), placedCapacity(0),
+      tree(law), treeRebuildRatio(DEFAULT_TREE_REBUILD_RATIO), treeValid(false), treeForcePass(false),
+      treeBuilds(0), treeRefits(0), treeWalkBaseline(0), treeWalkLast(0), treeWalkAngle(0.0), treeQueryStep(0), treeQueryCurrent(false), autotuning(false), forceAccuracy(1e-3), solverCachePath(SolverCache::defaultPath()),
+      solverStale(true), forcePasses(0), calibrationCount(0), solverCacheHits(0), pipelined(false), snapshotStep(0), snapshotHash(0), snapshotHashPending(false),
+      perfCounters(nullptr), interactionCount(0), telemetry(nullptr) {}
 
-void Simulation::addBody(std::unique_ptr<Body> body) {
+template <int D>
+SimulationT<D>::~SimulationT() {
+    // Le groupe attend ses tâches (qui lisent snapshot) avant la destruction des membres
+    overlapped.reset();
+}
+
+template <int D>
+void SimulationT<D>::addBody(std::unique_ptr<BodyType> body) {
+    double mass = body->getSourceMass();
+    totalMass += mass;
+    momentum = momentum + body->getVelocity() * mass;
+    massMoment = massMoment + body->getPosition() * mass;
     bodies.push_back(std::move(body));
+    bodiesChanged();
+}
+
+template <int D>
+void SimulationT<D>::addBody(VectorType position, VectorType velocity, double mass, double radius,
+                             ParticleClass particleClass) {
+    addBody(std::unique_ptr<BodyType>(new BodyType(position, velocity, mass, radius, particleClass)));
+}
+
+template <int D>
+void SimulationT<D>::setParticleClass(size_t index, ParticleClass particleClass) {
+    bodies[index]->setParticleClass(particleClass);
+    bodies[index]->setFrozen(false);
+    recomputeCenterOfMass();
+    bodiesChanged();
+}
+
+template <int D>
+size_t SimulationT<D>::convertLightBodiesToTracers(double threshold) {
+    size_t converted = 0;
+    for (auto& body : bodies) {
+        if (body->getMass() < threshold && !body->isTracer()) {
+            body->setParticleClass(ParticleClass::Tracer);
+            ++converted;
+        }
+    }
+    recomputeCenterOfMass();
+    bodiesChanged();
+    return converted;
+}
+
+template <int D>
+void SimulationT<D>::replaceBodies(std::vector<std::unique_ptr<BodyType>> newBodies) {
+    bodies = std::move(newBodies);
+    recomputeCenterOfMass();
+    bodiesChanged();
+}
+
+template <int D>
+void SimulationT<D>::clearBodies() {
+    bodies.clear();
+    totalMass = 0.0;
+    momentum = VectorType();
+    massMoment = VectorType();
+    bodiesChanged();
+}
+
+template <int D>
+void SimulationT<D>::bodiesChanged() {
+    neighborList.invalidate();
+    accelerationsCurrent = false;
+    // Marges de gel remises à zéro : les traceurs gelés seront réévalués
+    freezeSlack.clear();
+    sourceIndices.clear();
+    // Les membres des paires portent toujours leur état absolu : rien à restituer
+    binaries.clear();
+    binaryOf.clear();
+    binaryRetry.clear();
+    binaryCandidates.invalidate();
+    // N ou le groupement ont pu changer : situation du solveur revue au prochain calcul
+    solverStale = true;
+    treeValid = false;
+    treeQueryCurrent = false;
+}
+
+template <int D>
+void SimulationT<D>::setBinaryRadius(double radius) {
+    binaryRadius = radius;
+    binaryCandidates.setCutoff(radius);
+    binaryCandidates.setSkin(0.5 * radius);
+    binaryCandidates.invalidate();
+}
+
+template <int D>
+void SimulationT<D>::recomputeCenterOfMass() {
+    totalMass = 0.0;
+    momentum = VectorType();
+    massMoment = VectorType();
+    for (const auto& body : bodies) {
+        double mass = body->getSourceMass();
+        totalMass += mass;
+        momentum = momentum + body->getVelocity() * mass;
+        massMoment = massMoment + body->getPosition() * mass;
+    }
+}
+
+template <int D>
+void SimulationT<D>::step() {
+    PROFILE_SCOPE("Simulation::step");
+    uint64_t stepStart = telemetry ? TelemetryMetrics::now() : 0;
+    
+    // Paires formées ou défaites sur un état synchronisé (positions et vitesses au même instant)
+    if (binaryRadius > 0.0 || !binaries.empty()) {
+        updateBinaries();
+    }
+    
+    if (integrator == Integrator::Leapfrog) {
+        stepLeapfrog();
+    } else {
+        stepEuler();
+    }
+    
+    ++stepCount;
+    uint64_t diagnosticsStart = telemetry ? TelemetryMetrics::now() : 0;
+    bool hash = hashInterval > 0 && stepCount % hashInterval == 0;
+    bool energy = telemetry && telemetry->energyInterval > 0 && stepCount % telemetry->energyInterval == 0;
+    if (isOverlapping()) {
+        // Travaux recouverts par ce pas terminés, diagnostics de ce pas recouverts par le suivant
+        finishPipeline();
+        if (hash || energy) {
+            launchDiagnostics(hash, energy);
+        }
+    } else {
+        if (hash) {
+            StateHash record;
+            record.step = stepCount;
+            record.hash = computeStateHash();
+            stateHashes.push_back(record);
+        }
+        if (energy) {
+            telemetry->recordEnergy(computeEnergy());
+        }
+    }
+    
+    if (telemetry) {
+        // Attente des diagnostics recouverts comprise : sinon comptée comme intégration
+        telemetry->diagnosticsNanoseconds.fetch_add(TelemetryMetrics::now() - diagnosticsStart,
+                                                    std::memory_order_relaxed);
+        publishTelemetry(stepStart);
+    }
+}
+
+template <int D>
+bool SimulationT<D>::isOverlapping() const {
+    return pipelined && scheduler && scheduler->getThreadCount() > 1;
+}
+
+template <int D>
+void SimulationT<D>::setPipelined(bool enabled) {
+    if (!enabled) {
+        finishPipeline();
+    }
+    pipelined = enabled;
+}
+
+template <int D>
+void SimulationT<D>::overlapNextStep(std::function<void()> work) {
+    if (!isOverlapping()) {
+        work();
+        return;
+    }
+    if (!overlapped) {
+        overlapped.reset(new TaskGroup(*scheduler));
+    }
+    overlapped->run(std::move(work));
+}
+
+template <int D>
+void SimulationT<D>::finishPipeline() {
+    if (!overlapped) return;
+    
+    // Le groupe est détruit même si une tâche a échoué
+    std::unique_ptr<TaskGroup> group(std::move(overlapped));
+    group->wait();
+    if (snapshotHashPending) {
+        StateHash record;
+        record.step = snapshotStep;
+        record.hash = snapshotHash;
+        stateHashes.push_back(record);
+        snapshotHashPending = false;
+    }
 }
 
-void Simulation::addBody(Vector2D position, Vector2D velocity, double mass, double radius) {
-    bodies.push_back(std::unique_ptr<Body>(new Body(position, velocity, mass, radius)));
+template <int D>
+void SimulationT<D>::launchDiagnostics(bool hash, bool energy) {
+    PROFILE_SCOPE("Simulation::snapshot");
+    
+    // Copie en O(N) sur le chemin critique ; empreinte et énergie (O(S²)) hors de lui
+    snapshot.clear();
+    snapshot.reserve(bodies.size());
+    for (const auto& body : bodies) {
+        snapshot.push_back(*body);
+    }
+    snapshotStep = stepCount;
+    snapshotHashPending = hash;
+    
+    TelemetryMetrics* metrics = energy ? telemetry : nullptr;
+    overlapNextStep([this, hash, metrics]() {
+        PROFILE_SCOPE("Simulation::diagnostics");
+        if (hash) {
+            snapshotHash = stateHashOf(snapshot);
+        }
+        if (metrics) {
+            metrics->recordEnergy(energyOf(snapshot));
+        }
+    });
+}
+
+template <int D>
+void SimulationT<D>::publishTelemetry(uint64_t stepStart) {
+    // Un seul écrivain : stores relâchés, jamais de verrou sur le chemin du pas
+    telemetry->steps.store(stepCount, std::memory_order_relaxed);
+    telemetry->bodies.store(bodies.size(), std::memory_order_relaxed);
+    telemetry->interactions.store(interactionCount, std::memory_order_relaxed);
+    telemetry->stepNanoseconds.fetch_add(TelemetryMetrics::now() - stepStart, std::memory_order_relaxed);
+}
+
+template <int D>
+void SimulationT<D>::setTelemetry(TelemetryMetrics* metrics) {
+    telemetry = metrics;
+    if (telemetry) {
+        telemetry->recordEnergy(computeEnergy());
+        telemetry->steps.store(stepCount, std::memory_order_relaxed);
+        telemetry->bodies.store(bodies.size(), std::memory_order_relaxed);
+    }
+}
+
+template <int D>
+void SimulationT<D>::stepEuler() {
+    FusedUpdate fused = pipelined ? FusedUpdate::Update : FusedUpdate::None;
+    if (!perfCounters) {
+        if (computeForces(fused)) {
+            completeUpdate(timeStep);
+        } else {
+            updateBodies();
+        }
+        return;
+    }
+    
+    // Mode pipeliné : l'intégration fusionnée compte dans la phase des forces
+    uint64_t interactionsBefore = interactionCount;
+    CounterSample beforeForces = perfCounters->read();
+    bool integrated = computeForces(fused);
+    CounterSample afterForces = perfCounters->read();
+    if (integrated) {
+        completeUpdate(timeStep);
+    } else {
+        updateBodies();
+    }
+    CounterSample afterUpdate = perfCounters->read();
+    
+    phaseCounters.forces += afterForces - beforeForces;
+    phaseCounters.integration += afterUpdate - afterForces;
+    phaseCounters.interactions += interactionCount - interactionsBefore;
+    phaseCounters.steps++;
 }
 
-void Simulation::step() {
-    calculateForces();
-    updateBodies();
+template <int D>
+void SimulationT<D>::stepLeapfrog() {
+    // Le premier demi-kick reprend les accélérations calculées à la fin du pas précédent
+    if (!accelerationsCurrent) {
+        calculateForces();
+    }
+    
+    double halfStep = 0.5 * timeStep;
+    double fullStep = timeStep;
+    uint64_t interactionsBefore = interactionCount;
+    CounterSample start = perfCounters ? perfCounters->read() : CounterSample();
+    
+    {
+        PROFILE_SCOPE("Simulation::updateBodies");
+        forEachBody([halfStep, fullStep](BodyType& body) {
+            body.kick(halfStep);
+            body.drift(fullStep);
+        });
+        momentum = momentum + netForce * halfStep;
+        massMoment = massMoment + momentum * fullStep;
+        advanceBinaries(fullStep);
+        trackSourceTravel(fullStep);
+    }
+    CounterSample afterDrift = perfCounters ? perfCounters->read() : CounterSample();
+    
+    // Mode pipeliné : le second demi-kick de chaque bloc suit immédiatement ses forces
+    bool kicked = computeForces(pipelined ? FusedUpdate::Kick : FusedUpdate::None);
+    CounterSample afterForces = perfCounters ? perfCounters->read() : CounterSample();
+    momentum = momentum + netForce * halfStep;
+    
+    if (!kicked) {
+        PROFILE_SCOPE("Simulation::updateBodies");
+        forEachBody([halfStep](BodyType& body) { body.kick(halfStep); });
+    }
+    
+    if (perfCounters) {
+        CounterSample end = perfCounters->read();
+        phaseCounters.forces += afterForces - afterDrift;
+        phaseCounters.integration += afterDrift - start;
+        phaseCounters.integration += end - afterForces;
+        phaseCounters.interactions += interactionCount - interactionsBefore;
+        phaseCounters.steps++;
+    }
 }
 
-void Simulation::calculateForces() {
-    // Reset all accelerations
+template <int D>
+void SimulationT<D>::resetAccelerations() {
+    PROFILE_SCOPE("Simulation::resetAccelerations");
     for (auto& body : bodies) {
         body->resetAcceleration();
     }
+}
+
+template <int D>
+void SimulationT<D>::calculateForces() {
+    computeForces(FusedUpdate::None);
+}
+
+template <int D>
+bool SimulationT<D>::computeForces(FusedUpdate fused) {
+    uint64_t forcesStart = telemetry ? TelemetryMetrics::now() : 0;
+    resetAccelerations();
+    
+    PROFILE_SCOPE("Simulation::calculateForces");
+    
+    classifyBodies();
+    treeForcePass = false;
+    
+    // Une ligne par source, une seule pour les deux membres d'une paire régularisée
+    if (!binaries.empty()) {
+        sourceRows.clear();
+        for (uint32_t index : sourceIndices) {
+            int32_t binary = binaryOf[index];
+            if (binary >= 0 && binaries[binary].second == index) continue;
+            if (binary >= 0) binaries[binary].row = static_cast<uint32_t>(sourceRows.size());
+            sourceRows.push_back(index);
+        }
+    }
+    const std::vector<uint32_t>& rows = binaries.empty() ? sourceIndices : sourceRows;
+    size_t n = rows.size();
+    bool parallel = scheduler && scheduler->getThreadCount() > 1 && n >= PARALLEL_FORCE_THRESHOLD;
+    
+    // Le contact mou s'ajoute après le noyau, sur toutes les lignes : pas de fusion
+    if (contactStiffness > 0.0 && n > 1) {
+        fused = FusedUpdate::None;
+    }
+    double dt = timeStep;
+    
+    // Accélérations des lignes [begin, end) rendues aux corps, puis intégrées en mode fusionné
+    auto writeBack = [this, &rows, fused, dt](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            VectorType acceleration = makeVector<D>(arrays.ax[i], arrays.ay[i], D == 3 ? arrays.az[i] : 0.0);
+            BodyType& body = *bodies[rows[i]];
+            body.setAcceleration(acceleration);
+            if (fused == FusedUpdate::Update) body.update(dt);
+            else if (fused == FusedUpdate::Kick) body.kick(0.5 * dt);
+            // Les deux membres suivent leur centre de masse ; le mouvement relatif est régularisé
+            if (!binaries.empty() && binaryOf[rows[i]] >= 0) {
+                BodyType& partner = *bodies[binaries[binaryOf[rows[i]]].second];
+                partner.setAcceleration(acceleration);
+                if (fused == FusedUpdate::Update) partner.update(dt);
+                else if (fused == FusedUpdate::Kick) partner.kick(0.5 * dt);
+            }
+        }
+    };
+    // Tranches fixes par worker en FirstTouch : remplissage et noyau au même endroit
+    bool owned = parallel && placement == MemoryPlacement::FirstTouch;
+    auto forEachBlock = [this, owned, n](const std::function<void(size_t, size_t)>& block) {
+        if (owned) scheduler->affinityFor(0, n, block);
+        else scheduler->parallelFor(0, n, FORCE_GRAIN, block);
+    };
+    
+    // Copie SoA des sources : les noyaux ne lisent que des tableaux contigus
+    arrays.resize(n, D);
+    if (placement != MemoryPlacement::Default && arrays.x.capacity() != placedCapacity) {
+        placeArrays(owned);
+    }
+    auto fill = [this, &rows](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            loadSourceRow(arrays, i, rows[i]);
+            if (D == 3) arrays.az[i] = 0.0;
+            arrays.ax[i] = 0.0;
+            arrays.ay[i] = 0.0;
+        }
+    };
+    if (owned) scheduler->affinityFor(0, n, fill);
+    else fill(0, n);
+    
+    if (autotuning && !reproducible && n > 1) {
+        tuneSolver(n, owned);
+    }
+    
+    // En parallèle et fusionné, chaque bloc rend ses lignes dès son noyau terminé : les
+    // autres blocs ne lisent que arrays, jamais les corps. L'arbre écrit ses lignes
+    // dans l'ordre de la courbe : elles sont rendues après coup.
+    bool blockWriteBack = parallel && fused != FusedUpdate::None &&
+                          (reproducible || (solver.threads != 1 && solver.kind != SolverKind::Tree));
+    
+    if (reproducible && n > 1) {
+        // Même noyau en séquentiel et en parallèle : ordre de sommation fixé par corps
+        ForceKernels::Rows kernel = kernels.reproducibleRows;
+        if (parallel) {
+            forEachBlock([this, kernel, blockWriteBack, &writeBack](size_t begin, size_t end) {
+                PROFILE_SCOPE("Simulation::forceBlock");
+                kernel(arrays, gravitationalConstant, softening, begin, end);
+                if (blockWriteBack) writeBack(begin, end);
+            });
+        } else {
+            kernel(arrays, gravitationalConstant, softening, 0, n);
+        }
+        interactionCount += static_cast<uint64_t>(n) * (n - 1);
+    } else if (n > 1) {
+        std::function<void(size_t, size_t)> afterBlock;
+        if (blockWriteBack) afterBlock = writeBack;
+        interactionCount += runSolver(solver, n, owned, afterBlock);
+    }
+    
+    if (contactStiffness > 0.0 && n > 1) {
+        applyContactForces();
+    }
+    
+    // Une ligne par source ou par paire (masse totale) ; les traceurs n'ont pas de masse source
+    netForce = VectorType();
+    for (size_t i = 0; i < n; ++i) {
+        netForce = netForce + makeVector<D>(arrays.ax[i], arrays.ay[i], D == 3 ? arrays.az[i] : 0.0) * arrays.mass[i];
+    }
+    
+    if (!blockWriteBack) {
+        writeBack(0, n);
+    }
+    
+    if (!binaries.empty()) {
+        computeBinaryTides();
+    }
+    
+    if (!activeTracers.empty()) {
+        calculateTracerForces(fused);
+    }
+    accelerationsCurrent = true;
+    
+    if (telemetry) {
+        telemetry->forceNanoseconds.fetch_add(TelemetryMetrics::now() - forcesStart, std::memory_order_relaxed);
+    }
+    return fused != FusedUpdate::None;
+}
+
+template <int D>
+uint64_t SimulationT<D>::runSolver(const SolverConfig& config, size_t n, bool owned,
+                                   const std::function<void(size_t, size_t)>& afterBlock,
+                                   std::chrono::steady_clock::time_point deadline) {
+    bool parallel = config.threads != 1 && scheduler && scheduler->getThreadCount() > 1 &&
+                    n >= PARALLEL_FORCE_THRESHOLD;
+    
+    // Calibration : passé l'échéance, les blocs restants sont sautés (forces incomplètes)
+    bool bounded = deadline != std::chrono::steady_clock::time_point::max();
+    auto expired = [bounded, deadline]() { return bounded && std::chrono::steady_clock::now() > deadline; };
+    
+    if (config.kind == SolverKind::Tree) {
+        // Réajustement en O(N) ou construction séquentielle en O(N log N), parcours par plages de la courbe
+        maintainTree(arrays, config.leafSize);
+        treeForcePass = true;
+        treeQueryCurrent = false;
+        uint64_t walked = 0;
+        if (!parallel) {
+            size_t grain = bounded ? TREE_GRAIN : n;
+            for (size_t begin = 0; begin < n && !expired(); begin += grain) {
+                walked += tree.accelerate(arrays, gravitationalConstant, softening, config.openingAngle, begin,
+                                          std::min(n, begin + grain));
+            }
+        } else {
+            std::atomic<uint64_t> interactions(0);
+            scheduler->parallelFor(0, n, TREE_GRAIN, [this, &config, &interactions, &expired](size_t begin, size_t end) {
+                if (expired()) return;
+                PROFILE_SCOPE("Simulation::forceBlock");
+                uint64_t count = tree.accelerate(arrays, gravitationalConstant, softening, config.openingAngle, begin, end);
+                interactions.fetch_add(count, std::memory_order_relaxed);
+            });
+            walked = interactions.load();
+        }
+        if (bounded) return walked;
+        // Coût de référence : premier parcours après construction, au même θ
+        if (treeWalkBaseline == 0 || treeWalkAngle != config.openingAngle) {
+            treeWalkBaseline = walked;
+            treeWalkAngle = config.openingAngle;
+        }
+        treeWalkLast = walked;
+        return walked;
+    }
+    
+    if (!parallel) {
+        if (config.kind == SolverKind::Blocked) {
+            size_t grain = bounded ? BLOCKED_GRAIN : n;
+            for (size_t begin = 0; begin < n && !expired(); begin += grain) {
+                kernels.blockedRows(arrays, gravitationalConstant, softening, begin, std::min(n, begin + grain),
+                                    config.tileSize);
+            }
+            return static_cast<uint64_t>(n) * (n - 1);
+        }
+        // Forces égales et opposées sur toutes les paires ; le noyau accumule,
+        // et une calibration le relance sur des accélérations déjà écrites
+        std::fill(arrays.ax.begin(), arrays.ax.end(), 0.0);
+        std::fill(arrays.ay.begin(), arrays.ay.end(), 0.0);
+        std::fill(arrays.az.begin(), arrays.az.end(), 0.0);
+        kernels.pairwise(arrays, gravitationalConstant, softening);
+        return static_cast<uint64_t>(n) * (n - 1) / 2;
+    }
+    
+    // Chaque tâche accumule la ligne complète de ses corps : pas d'écriture
+    // partagée, au prix de deux fois plus d'interactions que la boucle symétrique
+    auto block = [this, &config, &afterBlock, &expired](size_t begin, size_t end) {
+        if (expired()) return;
+        PROFILE_SCOPE("Simulation::forceBlock");
+        if (config.kind == SolverKind::Blocked) {
+            kernels.blockedRows(arrays, gravitationalConstant, softening, begin, end, config.tileSize);
+        } else {
+            kernels.rows(arrays, gravitationalConstant, softening, begin, end);
+        }
+        if (afterBlock) afterBlock(begin, end);
+    };
+    if (owned) scheduler->affinityFor(0, n, block);
+    else scheduler->parallelFor(0, n, config.kind == SolverKind::Blocked ? BLOCKED_GRAIN : FORCE_GRAIN, block);
+    return static_cast<uint64_t>(n) * (n - 1);
+}
+
+template <int D>
+void SimulationT<D>::maintainTree(const BodyArrays& sources, size_t leafSize) {
+    // Le chevauchement se lit après le refit ; le coût du parcours, sur le calcul précédent
+    double limit = treeRebuildRatio;
+    if (treeValid && limit > 1.0 && tree.getLeafSize() == leafSize && treeWalkLast <= limit * treeWalkBaseline
+        && tree.refit(sources) && tree.getOverlap() <= limit * tree.getBuildOverlap()) {
+        ++treeRefits;
+        return;
+    }
+    tree.build(sources, leafSize);
+    treeValid = true;
+    treeWalkBaseline = 0;
+    treeWalkLast = 0;
+    ++treeBuilds;
+}
+
+template <int D>
+void SimulationT<D>::loadSourceRow(BodyArrays& target, size_t row, uint32_t index) const {
+    // Une paire régularisée n'occupe qu'une ligne : masse totale au centre de masse
+    const BodyType& body = *bodies[index];
+    VectorType position = body.getPosition();
+    double mass = body.getMass();
+    double radius = body.getRadius();
+    if (!binaries.empty() && binaryOf[index] >= 0) {
+        const BodyType& partner = *bodies[binaries[binaryOf[index]].second];
+        double total = mass + partner.getMass();
+        position = (position * mass + partner.getPosition() * partner.getMass()) * (1.0 / total);
+        mass = total;
+        radius = std::max(radius, partner.getRadius());
+    }
+    target.x[row] = position.x;
+    target.y[row] = position.y;
+    if (D == 3) target.z[row] = position[2];
+    target.mass[row] = mass;
+    target.radius[row] = radius;
+}
+
+template <int D>
+size_t SimulationT<D>::findNearestBody(const VectorType& position, size_t exclude, double* distance,
+                                       bool includeTracers) {
+    if (!treeQueryCurrent || treeQueryStep != stepCount) {
+        // Lignes construites comme au calcul des forces (une par paire) : même
+        // nombre de lignes, l'arbre est réajusté et non reconstruit
+        treeRows.clear();
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            if (bodies[i]->isTracer()) continue;
+            if (!binaries.empty() && binaryOf[i] >= 0 && binaries[binaryOf[i]].second == i) continue;
+            treeRows.push_back(static_cast<uint32_t>(i));
+        }
+        treeArrays.resize(treeRows.size(), D);
+        for (size_t k = 0; k < treeRows.size(); ++k) {
+            loadSourceRow(treeArrays, k, treeRows[k]);
+        }
+        size_t leaf = solver.kind == SolverKind::Tree ? solver.leafSize : BarnesHutTreeT<D>::DEFAULT_LEAF_SIZE;
+        maintainTree(treeArrays, leaf);
+        treeQueryStep = stepCount;
+        treeQueryCurrent = true;
+    }
+    
+    // Un membre de paire exclu laisse sa ligne candidate : elle désigne alors l'autre membre
+    uint32_t excludeRow = BarnesHutTreeT<D>::NONE;
+    std::vector<uint32_t>::const_iterator found = std::lower_bound(treeRows.begin(), treeRows.end(), exclude);
+    if (exclude < bodies.size() && found != treeRows.end() && *found == exclude
+        && (binaries.empty() || binaryOf[exclude] < 0)) {
+        excludeRow = static_cast<uint32_t>(found - treeRows.begin());
+    }
+    double distance2 = std::numeric_limits<double>::infinity();
+    uint32_t row = tree.nearest(position[0], position[1], D == 3 ? position[2] : 0.0, excludeRow, distance2);
+    size_t nearest = row == BarnesHutTreeT<D>::NONE ? bodies.size() : treeRows[row];
+    if (nearest == bodies.size()) distance2 = std::numeric_limits<double>::infinity();
+    if (nearest < bodies.size() && !binaries.empty() && binaryOf[nearest] >= 0) {
+        // Ligne d'une paire : le plus proche de ses deux membres, hors exclude
+        const Binary& binary = binaries[binaryOf[nearest]];
+        double best = std::numeric_limits<double>::infinity();
+        for (uint32_t member : {binary.first, binary.second}) {
+            if (member == exclude) continue;
+            VectorType offset = bodies[member]->getPosition() - position;
+            if (offset.dot(offset) < best) {
+                best = offset.dot(offset);
+                nearest = member;
+            }
+        }
+        distance2 = best;
+    }
+    
+    // Traceurs hors de l'arbre (pas des sources) : parcours linéaire, battu seulement s'il fait mieux
+    if (includeTracers) {
+        for (size_t i = 0; i < bodies.size(); ++i) {
+            if (i == exclude || !bodies[i]->isTracer()) continue;
+            VectorType offset = bodies[i]->getPosition() - position;
+            if (offset.dot(offset) < distance2) {
+                distance2 = offset.dot(offset);
+                nearest = i;
+            }
+        }
+    }
+    if (nearest == bodies.size()) return nearest;
+    if (distance) *distance = std::sqrt(distance2);
+    return nearest;
+}
+
+template <int D>
+void SimulationT<D>::tuneSolver(size_t n, bool owned) {
+    bool check = solverStale || tunedKey.empty() || forcePasses % SOLVER_CHECK_INTERVAL == 0;
+    ++forcePasses;
+    if (!check) return;
+    solverStale = false;
+    
+    unsigned pool = scheduler ? scheduler->getThreadCount() : 1;
+    std::string key = solverKey(D, forceLaw, n, measureClustering(arrays), pool, forceAccuracy);
+    if (key == tunedKey) return;
+    tunedKey = key;
+    
+    SolverCache cache(solverCachePath);
+    if (cache.lookup(key, solver)) {
+        ++solverCacheHits;
+        return;
+    }
+    
+    // Un calcul complet par candidat sur les corps courants ; le premier (calcul
+    // d'origine) sert de référence pour l'erreur des suivants. Les autres
+    // s'arrêtent dès qu'ils dépassent le meilleur temps retenu
+    PROFILE_SCOPE("Simulation::tuneSolver");
+    std::vector<SolverConfig> candidates = solverCandidates(pool);
+    BodyArrays reference;
+    calibration.clear();
+    size_t best = 0;
+    for (size_t c = 0; c < candidates.size(); ++c) {
+        SolverTiming timing;
+        timing.config = candidates[c];
+        timing.seconds = 0.0;
+        timing.error = std::numeric_limits<double>::infinity();
+        timing.accepted = false;
+        timing.completed = false;
+        
+        // Somme directe sur un thread quand le pool existe : elle ne peut battre sa jumelle parallèle
+        bool serialQuadratic = c > 0 && pool > 1 && candidates[c].threads == 1 &&
+                               candidates[c].kind != SolverKind::Tree && n >= SERIAL_CALIBRATION_LIMIT;
+        if (!serialQuadratic) {
+            auto start = std::chrono::steady_clock::now();
+            std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+            if (c > 0) {
+                deadline = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                       std::chrono::duration<double>(calibration[best].seconds));
+            }
+            runSolver(candidates[c], n, owned, std::function<void(size_t, size_t)>(), deadline);
+            auto stop = std::chrono::steady_clock::now();
+            timing.seconds = std::chrono::duration<double>(stop - start).count();
+            timing.completed = stop <= deadline;
+        }
+        if (c == 0) reference = arrays;
+        if (timing.completed) {
+            timing.error = c == 0 ? 0.0 : accelerationError(arrays, reference);
+            timing.accepted = timing.error <= forceAccuracy;
+        }
+        calibration.push_back(timing);
+        if (timing.accepted && timing.seconds < calibration[best].seconds) best = c;
+    }
+    solver = candidates[best];
+    ++calibrationCount;
+    cache.store(key, solver, calibration[best].seconds);
+}
+
+template <int D>
+void SimulationT<D>::placeArrays(bool owned) {
+    std::vector<double>* columns[] = {&arrays.x, &arrays.y, &arrays.z, &arrays.mass, &arrays.radius,
+                                      &arrays.ax, &arrays.ay, &arrays.az};
+    NumaTopology topology;
+    for (std::vector<double>* column : columns) {
+        if (column->empty()) continue;
+        void* data = column->data();
+        size_t bytes = column->capacity() * sizeof(double);
+        if (placement == MemoryPlacement::Interleave) {
+            topology.interleave(data, bytes);
+        } else if (owned) {
+            // Pages rendues puis retouchées par le remplissage en tranches : chacune
+            // est réallouée sur le nœud du worker propriétaire de ses lignes
+            NumaTopology::releasePages(data, bytes);
+        }
+    }
+    // Sans threads, FirstTouch attend le premier calcul parallèle
+    if (placement == MemoryPlacement::Interleave || owned) {
+        placedCapacity = arrays.x.capacity();
+    }
+}
+
+template <int D>
+void SimulationT<D>::classifyBodies() {
+    size_t n = bodies.size();
+    bool freezing = freezeDistance > 0.0;
+    sourceIndices.clear();
+    activeTracers.clear();
+    freezeSlack.resize(n, 0.0);
+    frozenCount = 0;
+    
+    for (size_t i = 0; i < n; ++i) {
+        BodyType& body = *bodies[i];
+        if (!body.isTracer()) {
+            sourceIndices.push_back(static_cast<uint32_t>(i));
+            continue;
+        }
+        if (body.isFrozen()) {
+            if (freezing) {
+                // Vitesse constante tant que le traceur est gelé (accélération nulle)
+                freezeSlack[i] -= pendingSourceTravel + body.getVelocity().magnitude() * pendingTime;
+                if (freezeSlack[i] > 0.0) {
+                    ++frozenCount;
+                    continue;
+                }
+            }
+            body.setFrozen(false);
+        }
+        activeTracers.push_back(static_cast<uint32_t>(i));
+    }
+    
+    pendingSourceTravel = 0.0;
+    pendingTime = 0.0;
+}
+
+template <int D>
+void SimulationT<D>::calculateTracerForces(FusedUpdate fused) {
+    PROFILE_SCOPE("Simulation::tracerForces");
+    
+    size_t count = activeTracers.size();
+    tracerArrays.resize(count, D);
+    nearestSource2.resize(count);
+    for (size_t k = 0; k < count; ++k) {
+        const BodyType& body = *bodies[activeTracers[k]];
+        VectorType position = body.getPosition();
+        tracerArrays.x[k] = position.x;
+        tracerArrays.y[k] = position.y;
+        if (D == 3) tracerArrays.z[k] = position[2];
+        tracerArrays.radius[k] = body.getRadius();
+    }
+    
+    // Avec l'arbre du calcul en cours, distance à la source la plus proche minorée
+    // (boîte des nœuds acceptés) : un traceur peut geler un peu plus tard, jamais trop tôt
+    size_t sources = arrays.size();
+    if (treeForcePass && solver.kind == SolverKind::Tree) {
+        double theta = solver.openingAngle;
+        if (scheduler && scheduler->getThreadCount() > 1 && count >= PARALLEL_FORCE_THRESHOLD) {
+            std::atomic<uint64_t> interactions(0);
+            scheduler->parallelFor(0, count, TREE_GRAIN, [this, theta, &interactions](size_t begin, size_t end) {
+                PROFILE_SCOPE("Simulation::tracerBlock");
+                uint64_t walked = tree.accelerateExternal(tracerArrays, gravitationalConstant, softening, theta, begin,
+                                                          end, nearestSource2.data());
+                interactions.fetch_add(walked, std::memory_order_relaxed);
+            });
+            interactionCount += interactions.load();
+        } else {
+            interactionCount += tree.accelerateExternal(tracerArrays, gravitationalConstant, softening, theta, 0, count,
+                                                        nearestSource2.data());
+        }
+    } else if (scheduler && scheduler->getThreadCount() > 1 && count * sources >= TRACER_BLOCK_INTERACTIONS) {
+        // Une ligne par traceur, sans écriture partagée : le résultat ne dépend pas du découpage
+        ForceKernels::Tracers kernel = reproducible ? kernels.reproducibleTracers : kernels.tracers;
+        size_t grain = std::max(FORCE_GRAIN, TRACER_BLOCK_INTERACTIONS / std::max<size_t>(sources, 1));
+        scheduler->parallelFor(0, count, grain, [this, kernel](size_t begin, size_t end) {
+            PROFILE_SCOPE("Simulation::tracerBlock");
+            kernel(arrays, tracerArrays, gravitationalConstant, softening, begin, end, nearestSource2.data());
+        });
+        interactionCount += static_cast<uint64_t>(count) * sources;
+    } else {
+        // Mode reproductible : ordre de sommation fixe, indépendant de la largeur SIMD
+        ForceKernels::Tracers kernel = reproducible ? kernels.reproducibleTracers : kernels.tracers;
+        kernel(arrays, tracerArrays, gravitationalConstant, softening, 0, count, nearestSource2.data());
+        interactionCount += static_cast<uint64_t>(count) * sources;
+    }
+    
+    double freeze2 = freezeDistance * freezeDistance;
+    for (size_t k = 0; k < count; ++k) {
+        BodyType& body = *bodies[activeTracers[k]];
+        if (freezeDistance > 0.0 && nearestSource2[k] > freeze2) {
+            // L'accélération reste nulle (resetAccelerations) jusqu'au dégel
+            body.setFrozen(true);
+            freezeSlack[activeTracers[k]] = std::sqrt(nearestSource2[k]) - freezeDistance;
+            ++frozenCount;
+            continue;
+        }
+        body.setAcceleration(makeVector<D>(tracerArrays.ax[k], tracerArrays.ay[k], D == 3 ? tracerArrays.az[k] : 0.0));
+        if (fused == FusedUpdate::Update) body.update(timeStep);
+        else if (fused == FusedUpdate::Kick) body.kick(0.5 * timeStep);
+    }
+}
+
+template <int D>
+void SimulationT<D>::computeBinaryTides() {
+    PROFILE_SCOPE("Simulation::binaryTides");
+    
+    // Tenseur de marée newtonien des autres lignes au centre de masse :
+    // l'accélération relative des membres vaut T x pour une séparation x
+    size_t n = arrays.size();
+    for (Binary& binary : binaries) {
+        double center[3] = {arrays.x[binary.row], arrays.y[binary.row], D == 3 ? arrays.z[binary.row] : 0.0};
+        double tide[3][3] = {{0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}, {0.0, 0.0, 0.0}};
+        for (size_t j = 0; j < n; ++j) {
+            if (j == binary.row) continue;
+            double d[3] = {arrays.x[j] - center[0], arrays.y[j] - center[1], D == 3 ? arrays.z[j] - center[2] : 0.0};
+            addTide(tide, d, arrays.mass[j]);
+        }
+        for (int a = 0; a < 3; ++a) {
+            for (int b = 0; b < 3; ++b) {
+                binary.tide[a][b] = gravitationalConstant * tide[a][b];
+            }
+        }
+    }
+    interactionCount += static_cast<uint64_t>(binaries.size()) * (n - 1);
+}
+
+template <int D>
+void SimulationT<D>::advanceBinaries(double dt) {
+    if (binaries.empty()) return;
+    PROFILE_SCOPE("Simulation::binaries");
+    
+    // Les membres ont avancé avec leur centre de masse : seul le mouvement relatif est remplacé
+    for (Binary& binary : binaries) {
+        BodyType& first = *bodies[binary.first];
+        BodyType& second = *bodies[binary.second];
+        double m1 = first.getMass(), m2 = second.getMass();
+        double total = m1 + m2;
+        VectorType center = (first.getPosition() * m1 + second.getPosition() * m2) * (1.0 / total);
+        VectorType centerVelocity = (first.getVelocity() * m1 + second.getVelocity() * m2) * (1.0 / total);
+        
+        double x[3], v[3];
+        binary.motion.advance(dt, binary.tide);
+        binary.motion.relativeState(x, v);
+        VectorType separation = makeVector<D>(x[0], x[1], x[2]);
+        VectorType relativeVelocity = makeVector<D>(v[0], v[1], v[2]);
+        
+        first.setPosition(center - separation * (m2 / total));
+        second.setPosition(center + separation * (m1 / total));
+        first.setVelocity(centerVelocity - relativeVelocity * (m2 / total));
+        second.setVelocity(centerVelocity + relativeVelocity * (m1 / total));
+    }
+}
+
+template <int D>
+bool SimulationT<D>::admitsBinary(const BodyType& first, const BodyType& second) const {
+    VectorType separation = second.getPosition() - first.getPosition();
+    if (separation.dot(separation) >= binaryRadius * binaryRadius) return false;
+    
+    double x[3], v[3], pericenter, apocenter;
+    toArray(separation, x);
+    toArray(second.getVelocity() - first.getVelocity(), v);
+    double mu = gravitationalConstant * (first.getMass() + second.getMass());
+    if (!RegularizedPair::orbit(x, v, mu, pericenter, apocenter) || apocenter >= binaryRadius) return false;
+    
+    // L'orbite ne doit parcourir que la zone où la loi est newtonienne (corps disjoints)
+    double minimum = first.getRadius() + second.getRadius();
+    if (forceLaw == ForceLaw::Spline) minimum = std::max(minimum, 2.8 * softening);
+    if (forceLaw == ForceLaw::Plummer && softening > 0.0) return false;
+    return pericenter > minimum;
+}
+
+template <int D>
+void SimulationT<D>::dissolveBinary(size_t index) {
+    binaryOf[binaries[index].first] = -1;
+    binaryOf[binaries[index].second] = -1;
+    if (index + 1 != binaries.size()) {
+        binaries[index] = binaries.back();
+        binaryOf[binaries[index].first] = static_cast<int32_t>(index);
+        binaryOf[binaries[index].second] = static_cast<int32_t>(index);
+    }
+    binaries.pop_back();
+}
+
+template <int D>
+void SimulationT<D>::updateBinaries() {
+    PROFILE_SCOPE("Simulation::updateBinaries");
+    
+    size_t count = bodies.size();
+    binaryOf.resize(count, -1);
+    binaryRetry.resize(count, 0);
+    bool changed = false;
+    
+    // Paires défaites : trop perturbées, ou sorties du rayon (déliées par la marée)
+    for (size_t k = 0; k < binaries.size();) {
+        const Binary& binary = binaries[k];
+        double r = binary.motion.getSeparation();
+        bool perturbed = binary.motion.getPerturbation(binary.tide) > binaryPerturbationLimit;
+        if (binaryRadius <= 0.0 || perturbed || binary.motion.getEnergy() >= 0.0 || r >= binaryRadius) {
+            if (perturbed) {
+                binaryRetry[binary.first] = binaryRetry[binary.second] = stepCount + BINARY_RETRY_STEPS;
+            }
+            dissolveBinary(k);
+            changed = true;
+            continue;
+        }
+        ++k;
+    }
+    
+    // Sources du dernier calcul des forces, ou à établir si les corps viennent de changer
+    if (sourceIndices.empty()) {
+        classifyBodies();
+    }
+    
+    if (binaryRadius > 0.0 && sourceIndices.size() > 1) {
+        // Candidats : sources à moins de binaryRadius, par liste de Verlet sur grille
+        size_t sources = sourceIndices.size();
+        candidateArrays.resize(sources, D);
+        for (size_t i = 0; i < sources; ++i) {
+            VectorType position = bodies[sourceIndices[i]]->getPosition();
+            candidateArrays.x[i] = position.x;
+            candidateArrays.y[i] = position.y;
+            if (D == 3) candidateArrays.z[i] = position[2];
+        }
+        binaryCandidates.update(candidateArrays);
+        
+        const std::vector<uint32_t>& offsets = binaryCandidates.getOffsets();
+        const std::vector<uint32_t>& neighbors = binaryCandidates.getNeighbors();
+        for (size_t i = 0; i < sources; ++i) {
+            uint32_t first = sourceIndices[i];
+            if (binaryOf[first] >= 0 || binaryRetry[first] > stepCount) continue;
+            for (uint32_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                uint32_t second = sourceIndices[neighbors[k]];
+                if (binaryOf[second] >= 0 || binaryRetry[second] > stepCount) continue;
+                if (!admitsBinary(*bodies[first], *bodies[second])) continue;
+                
+                Binary binary;
+                binary.first = first;
+                binary.second = second;
+                binary.row = 0;
+                double x[3], v[3];
+                toArray(bodies[second]->getPosition() - bodies[first]->getPosition(), x);
+                toArray(bodies[second]->getVelocity() - bodies[first]->getVelocity(), v);
+                binary.motion.initialize(x, v, gravitationalConstant * (bodies[first]->getMass() + bodies[second]->getMass()));
+                
+                // Marée mesurée dès la formation : une paire née trop perturbée ferait un pas faux
+                double m1 = bodies[first]->getMass(), m2 = bodies[second]->getMass();
+                VectorType center = (bodies[first]->getPosition() * m1 + bodies[second]->getPosition() * m2) * (1.0 / (m1 + m2));
+                std::memset(binary.tide, 0, sizeof(binary.tide));
+                for (uint32_t other : sourceIndices) {
+                    if (other == first || other == second) continue;
+                    double d[3];
+                    toArray(bodies[other]->getPosition() - center, d);
+                    addTide(binary.tide, d, gravitationalConstant * bodies[other]->getMass());
+                }
+                if (binary.motion.getPerturbation(binary.tide) > binaryPerturbationLimit) {
+                    binaryRetry[first] = binaryRetry[second] = stepCount + BINARY_RETRY_STEPS;
+                    break;
+                }
+                
+                binaryOf[first] = binaryOf[second] = static_cast<int32_t>(binaries.size());
+                binaries.push_back(binary);
+                changed = true;
+                break;
+            }
+        }
+    }
     
-    // Calculate gravitational forces between all pairs of bodies
-    for (size_t i = 0; i < bodies.size(); ++i) {
-        for (size_t j = i + 1; j < bodies.size(); ++j) {
-            Vector2D force = bodies[i]->calculateGravitationalForce(*bodies[j], gravitationalConstant);
+    // Accélérations à recalculer avec (ou sans) les centres de masse
+    if (changed) {
+        accelerationsCurrent = false;
+    }
+}
+
+template <int D>
+void SimulationT<D>::trackSourceTravel(double dt) {
+    if (frozenCount == 0) return;
+    
+    // Borne du déplacement de toute source pendant ce pas : vitesse de dérive maximale
+    double fastest2 = 0.0;
+    for (uint32_t index : sourceIndices) {
+        VectorType velocity = bodies[index]->getVelocity();
+        fastest2 = std::max(fastest2, velocity.dot(velocity));
+    }
+    pendingSourceTravel += std::sqrt(fastest2) * dt;
+    pendingTime += dt;
+}
+
+template <int D>
+void SimulationT<D>::applyContactForces() {
+    PROFILE_SCOPE("Simulation::contactForces");
+    
+    size_t n = arrays.size();
+    double maxRadius = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        maxRadius = std::max(maxRadius, arrays.radius[i]);
+    }
+    double cutoff = 2.0 * maxRadius;
+    double skin = neighborSkin >= 0.0 ? neighborSkin : CONTACT_SKIN_RATIO * cutoff;
+    if (neighborList.getCutoff() != cutoff || neighborList.getSkin() != skin) {
+        neighborList.setCutoff(cutoff);
+        neighborList.setSkin(skin);
+        neighborList.invalidate();
+    }
+    neighborList.update(arrays);
+    
+    const std::vector<uint32_t>& offsets = neighborList.getOffsets();
+    const std::vector<uint32_t>& neighbors = neighborList.getNeighbors();
+    const double* x = arrays.x.data();
+    const double* y = arrays.y.data();
+    const double* z = arrays.z.data();
+    const double* mass = arrays.mass.data();
+    const double* radius = arrays.radius.data();
+    double* ax = arrays.ax.data();
+    double* ay = arrays.ay.data();
+    double* az = arrays.az.data();
+    
+    // Demi-liste : chaque paire reçoit des forces égales et opposées
+    for (size_t i = 0; i < n; ++i) {
+        for (uint32_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+            uint32_t j = neighbors[k];
+            double dx = x[j] - x[i];
+            double dy = y[j] - y[i];
+            double dz = D == 3 ? z[j] - z[i] : 0.0;
+            double d2 = dx * dx + dy * dy;
+            if (D == 3) d2 += dz * dz;
+            double contact = radius[i] + radius[j];
+            if (d2 >= contact * contact || d2 == 0.0) continue;
             
-            // Apply equal and opposite forces
-            bodies[i]->applyForce(force);
-            bodies[j]->applyForce(force * -1.0);
+            double d = std::sqrt(d2);
+            double f = contactStiffness * (contact - d) / d;
+            ax[i] -= f / mass[i] * dx;
+            ay[i] -= f / mass[i] * dy;
+            ax[j] += f / mass[j] * dx;
+            ay[j] += f / mass[j] * dy;
+            if (D == 3) {
+                az[i] -= f / mass[i] * dz;
+                az[j] += f / mass[j] * dz;
+            }
         }
     }
+    interactionCount += neighbors.size();
 }
 
-void Simulation::updateBodies() {
+template <int D>
+void SimulationT<D>::updateBodies() {
+    PROFILE_SCOPE("Simulation::updateBodies");
+    
+    double dt = timeStep;
+    forEachBody([dt](BodyType& body) { body.update(dt); });
+    momentum = momentum + netForce * dt;
+    massMoment = massMoment + momentum * dt;
+    advanceBinaries(dt);
+    trackSourceTravel(dt);
+    accelerationsCurrent = false;
+}
+
+template <int D>
+void SimulationT<D>::completeUpdate(double dt) {
+    PROFILE_SCOPE("Simulation::updateBodies");
+    
+    // Corps intégrés par le calcul des forces, sauf les traceurs gelés (accélération nulle)
+    if (frozenCount > 0) {
+        forEachBody([dt](BodyType& body) {
+            if (body.isFrozen()) body.update(dt);
+        });
+    }
+    momentum = momentum + netForce * dt;
+    massMoment = massMoment + momentum * dt;
+    advanceBinaries(dt);
+    trackSourceTravel(dt);
+    accelerationsCurrent = false;
+}
+
+template <int D>
+template <typename Function>
+void SimulationT<D>::forEachBody(Function function) {
+    if (scheduler && scheduler->getThreadCount() > 1 && bodies.size() >= UPDATE_GRAIN) {
+        scheduler->parallelFor(0, bodies.size(), UPDATE_GRAIN, [this, &function](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                function(*bodies[i]);
+            }
+        });
+        return;
+    }
+    
     for (auto& body : bodies) {
-        body->update(timeStep);
+        function(*body);
     }
 }
 
-void Simulation::setupSolarSystem() {
-    bodies.clear();
+template <int D>
+double SimulationT<D>::computeEnergy() const {
+    return energyOf(bodies);
+}
+
+template <int D>
+template <typename Container>
+double SimulationT<D>::energyOf(const Container& container) const {
+    double kinetic = 0.0;
+    std::vector<const BodyType*> sources;
+    for (const auto& element : container) {
+        const BodyType& body = bodyOf(element);
+        if (body.isTracer()) continue;
+        VectorType v = body.getVelocity();
+        kinetic += 0.5 * body.getMass() * v.dot(v);
+        sources.push_back(&body);
+    }
+    
+    double potential = 0.0;
+    ClampedForce clamped(softening);
+    NewtonianForce newtonian(softening);
+    PlummerForce plummer(softening);
+    SplineForce spline(softening);
+    for (size_t i = 0; i < sources.size(); ++i) {
+        for (size_t j = i + 1; j < sources.size(); ++j) {
+            VectorType d = sources[j]->getPosition() - sources[i]->getPosition();
+            double r2 = d.dot(d);
+            double radiusSum = sources[i]->getRadius() + sources[j]->getRadius();
+            double phi;
+            switch (forceLaw) {
+                case ForceLaw::Newtonian: phi = newtonian.potential(r2, radiusSum); break;
+                case ForceLaw::Plummer: phi = plummer.potential(r2, radiusSum); break;
+                case ForceLaw::Spline: phi = spline.potential(r2, radiusSum); break;
+                case ForceLaw::Clamped:
+                default: phi = clamped.potential(r2, radiusSum); break;
+            }
+            potential -= gravitationalConstant * sources[i]->getMass() * sources[j]->getMass() * phi;
+        }
+    }
+    return kinetic + potential;
+}
+
+template <int D>
+uint64_t SimulationT<D>::computeStateHash() const {
+    return stateHashOf(bodies);
+}
+
+template <int D>
+template <typename Container>
+uint64_t SimulationT<D>::stateHashOf(const Container& container) {
+    // FNV-1a sur les motifs binaires des doubles, mot de 64 bits par mot
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](double value) {
+        uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        hash = (hash ^ bits) * 1099511628211ULL;
+    };
+    
+    for (const auto& element : container) {
+        const BodyType& body = bodyOf(element);
+        VectorType p = body.getPosition();
+        VectorType v = body.getVelocity();
+        for (int d = 0; d < D; ++d) {
+            mix(p[d]);
+            mix(v[d]);
+        }
+    }
+    
+    // Avalanche finale (splitmix64) : un bit changé modifie tout le mot
+    hash ^= hash >> 30;
+    hash *= 0xbf58476d1ce4e5b9ULL;
+    hash ^= hash >> 27;
+    hash *= 0x94d049bb133111ebULL;
+    hash ^= hash >> 31;
+    return hash;
+}
+
+template <int D>
+void SimulationT<D>::setupSolarSystem() {
+    clearBodies();
     
     // Soleil au centre
-    addBody(Vector2D(0, 0), Vector2D(0, 0), 1000.0, 20.0);
+    addBody(VectorType(0, 0), VectorType(0, 0), 1000.0, 20.0);
     
-    // Planètes avec orbites approximatives
-    addBody(Vector2D(100, 0), Vector2D(0, 30), 1.0, 3.0);    // Mercure
-    addBody(Vector2D(150, 0), Vector2D(0, 25), 2.0, 4.0);    // Vénus
-    addBody(Vector2D(200, 0), Vector2D(0, 22), 3.0, 5.0);    // Terre
-    addBody(Vector2D(250, 0), Vector2D(0, 18), 1.5, 4.0);    // Mars
-    addBody(Vector2D(350, 0), Vector2D(0, 12), 50.0, 12.0);  // Jupiter
-    addBody(Vector2D(450, 0), Vector2D(0, 10), 40.0, 10.0);  // Saturne
+    // Planètes avec orbites approximatives (vitesse z en 3D : inclinaison orbitale)
+    addBody(VectorType(100, 0), makeVector<D>(0, 30, 3.7), 1.0, 3.0);    // Mercure
+    addBody(VectorType(150, 0), makeVector<D>(0, 25, 1.5), 2.0, 4.0);    // Vénus
+    addBody(VectorType(200, 0), makeVector<D>(0, 22, 0.0), 3.0, 5.0);    // Terre
+    addBody(VectorType(250, 0), makeVector<D>(0, 18, 0.6), 1.5, 4.0);    // Mars
+    addBody(VectorType(350, 0), makeVector<D>(0, 12, 0.3), 50.0, 12.0);  // Jupiter
+    addBody(VectorType(450, 0), makeVector<D>(0, 10, 0.4), 40.0, 10.0);  // Saturne
 }
 
-void Simulation::setupRandomBodies(int count, double width, double height) {
-    bodies.clear();
+template <int D>
+void SimulationT<D>::setupRandomBodies(int count, double width, double height) {
+    clearBodies();
     
     std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(seeded ? randomSeed : rd());
     std::uniform_real_distribution<> posX(-width/2, width/2);
     std::uniform_real_distribution<> posY(-height/2, height/2);
     std::uniform_real_distribution<> vel(-10, 10);
     std::uniform_real_distribution<> mass(1, 20);
     
+    std::uniform_real_distribution<> posZ(-std::min(width, height)/2, std::min(width, height)/2);
+    
     for (int i = 0; i < count; ++i) {
-        Vector2D position(posX(gen), posY(gen));
-        Vector2D velocity(vel(gen), vel(gen));
+        VectorType position(posX(gen), posY(gen));
+        VectorType velocity(vel(gen), vel(gen));
+        if (D == 3) {
+            position[2] = posZ(gen);
+            velocity[2] = vel(gen);
+        }
         double bodyMass = mass(gen);
         double radius = std::sqrt(bodyMass) + 2;
         
@@ -77,50 +1309,63 @@ void Simulation::setupRandomBodies(int count, double width, double height) {
     }
 }
 
-void Simulation::setupBinarySystem() {
-    bodies.clear();
+template <int D>
+void SimulationT<D>::setupBinarySystem() {
+    clearBodies();
     
     // Système binaire avec deux étoiles
     double separation = 200.0;
     double velocity = 15.0;
     
-    addBody(Vector2D(-separation/2, 0), Vector2D(0, -velocity), 100.0, 15.0);
-    addBody(Vector2D(separation/2, 0), Vector2D(0, velocity), 100.0, 15.0);
+    addBody(VectorType(-separation/2, 0), VectorType(0, -velocity), 100.0, 15.0);
+    addBody(VectorType(separation/2, 0), VectorType(0, velocity), 100.0, 15.0);
     
     // Ajouter quelques planètes autour
-    addBody(Vector2D(0, 300), Vector2D(20, 0), 2.0, 4.0);
-    addBody(Vector2D(0, -300), Vector2D(-20, 0), 2.0, 4.0);
+    addBody(VectorType(0, 300), VectorType(20, 0), 2.0, 4.0);
+    addBody(VectorType(0, -300), VectorType(-20, 0), 2.0, 4.0);
 }
 
-void Simulation::setupGalaxyCollision() {
-    bodies.clear();
+template <int D>
+void SimulationT<D>::setupGalaxyCollision() {
+    setupGalaxyCollision(20);
+}
+
+template <int D>
+void SimulationT<D>::setupGalaxyCollision(int starsPerGalaxy) {
+    clearBodies();
     
     std::random_device rd;
-    std::mt19937 gen(rd());
+    std::mt19937 gen(seeded ? randomSeed : rd());
     std::uniform_real_distribution<> angle(0, 2 * M_PI);
     std::uniform_real_distribution<> radius(20, 150);
+    std::normal_distribution<> thickness(0, 5); // Épaisseur des disques en 3D
     
     // Première galaxie
-    Vector2D center1(-200, 0);
-    addBody(center1, Vector2D(5, 0), 200.0, 20.0); // Centre galactique
+    VectorType center1(-200, 0);
+    addBody(center1, VectorType(5, 0), 200.0, 20.0); // Centre galactique
     
-    for (int i = 0; i < 20; ++i) {
+    for (int i = 0; i < starsPerGalaxy; ++i) {
         double r = radius(gen);
         double a = angle(gen);
-        Vector2D pos = center1 + Vector2D(r * cos(a), r * sin(a));
-        Vector2D vel = Vector2D(-sin(a), cos(a)) * sqrt(200.0 / r) * 0.5 + Vector2D(5, 0);
+        VectorType pos = center1 + VectorType(r * cos(a), r * sin(a));
+        if (D == 3) pos[2] = thickness(gen);
+        VectorType vel = VectorType(-sin(a), cos(a)) * sqrt(200.0 / r) * 0.5 + VectorType(5, 0);
         addBody(pos, vel, 2.0, 3.0);
     }
     
     // Deuxième galaxie
-    Vector2D center2(200, 0);
-    addBody(center2, Vector2D(-5, 0), 200.0, 20.0); // Centre galactique
+    VectorType center2(200, 0);
+    addBody(center2, VectorType(-5, 0), 200.0, 20.0); // Centre galactique
     
-    for (int i = 0; i < 20; ++i) {
+    for (int i = 0; i < starsPerGalaxy; ++i) {
         double r = radius(gen);
         double a = angle(gen);
-        Vector2D pos = center2 + Vector2D(r * cos(a), r * sin(a));
-        Vector2D vel = Vector2D(-sin(a), cos(a)) * sqrt(200.0 / r) * 0.5 + Vector2D(-5, 0);
+        VectorType pos = center2 + VectorType(r * cos(a), r * sin(a));
+        if (D == 3) pos[2] = thickness(gen);
+        VectorType vel = VectorType(-sin(a), cos(a)) * sqrt(200.0 / r) * 0.5 + VectorType(-5, 0);
         addBody(pos, vel, 2.0, 3.0);
     }
 }
+
+template class SimulationT<2>;
+template class SimulationT<3>;
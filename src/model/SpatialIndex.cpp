@@ -0,0 +1,112 @@
+#include "../../include/SpatialIndex.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    const double POINTS_PER_CELL = 2.0;
+    const int MAX_CELLS_PER_AXIS = 4096;
+}
+
+SpatialIndex::SpatialIndex()
+    : originX(0.0), originY(0.0), cellSize(1.0), columns(1), rows(1) {}
+
+int SpatialIndex::column(double x) const {
+    int c = static_cast<int>(std::floor((x - originX) / cellSize));
+    return std::max(0, std::min(columns - 1, c));
+}
+
+int SpatialIndex::row(double y) const {
+    int r = static_cast<int>(std::floor((y - originY) / cellSize));
+    return std::max(0, std::min(rows - 1, r));
+}
+
+void SpatialIndex::build(const std::vector<Vector2D>& positions) {
+    points = positions;
+
+    // Boîte englobante des points valides
+    double minX = HUGE_VAL, minY = HUGE_VAL, maxX = -HUGE_VAL, maxY = -HUGE_VAL;
+    size_t valid = 0;
+    for (const Vector2D& p : points) {
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) continue;
+        minX = std::min(minX, p.x);
+        maxX = std::max(maxX, p.x);
+        minY = std::min(minY, p.y);
+        maxY = std::max(maxY, p.y);
+        ++valid;
+    }
+    if (valid == 0) {
+        minX = minY = maxX = maxY = 0.0;
+    }
+
+    // Côté choisi pour ~POINTS_PER_CELL points par cellule, grille bornée
+    double width = std::max(maxX - minX, 1e-9);
+    double height = std::max(maxY - minY, 1e-9);
+    double cells = std::max(1.0, valid / POINTS_PER_CELL);
+    cellSize = std::sqrt(width * height / cells);
+    cellSize = std::max(cellSize, std::max(width, height) / MAX_CELLS_PER_AXIS);
+    originX = minX;
+    originY = minY;
+    columns = std::max(1, std::min(MAX_CELLS_PER_AXIS, static_cast<int>(width / cellSize) + 1));
+    rows = std::max(1, std::min(MAX_CELLS_PER_AXIS, static_cast<int>(height / cellSize) + 1));
+
+    // Tri par comptage des points valides
+    size_t cellCount = static_cast<size_t>(columns) * rows;
+    cellStart.assign(cellCount + 1, 0);
+    itemCell.resize(points.size());
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Vector2D& p = points[i];
+        if (!std::isfinite(p.x) || !std::isfinite(p.y)) {
+            itemCell[i] = static_cast<uint32_t>(cellCount);
+            continue;
+        }
+        itemCell[i] = static_cast<uint32_t>(row(p.y) * columns + column(p.x));
+        cellStart[itemCell[i] + 1]++;
+    }
+    for (size_t c = 0; c < cellCount; ++c) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    cellItems.resize(cellStart[cellCount]);
+    std::vector<uint32_t> fill(cellStart.begin(), cellStart.end() - 1);
+    for (size_t i = 0; i < points.size(); ++i) {
+        if (itemCell[i] < cellCount) {
+            cellItems[fill[itemCell[i]]++] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+size_t SpatialIndex::nearest(const Vector2D& query, double maxDistance) const {
+    if (cellItems.empty() || !std::isfinite(query.x) || !std::isfinite(query.y)) return NONE;
+
+    int centerColumn = column(query.x);
+    int centerRow = row(query.y);
+    size_t best = NONE;
+    double bestDistance2 = maxDistance * maxDistance;
+
+    // Anneau r : cellules à distance de Tchebychev r de la cellule du point.
+    // Après l'anneau r, tout point restant est à plus de r * cellSize.
+    int maxRing = std::max(columns, rows);
+    for (int ring = 0; ring <= maxRing; ++ring) {
+        for (int r = centerRow - ring; r <= centerRow + ring; ++r) {
+            if (r < 0 || r >= rows) continue;
+            bool edgeRow = (r == centerRow - ring || r == centerRow + ring);
+            int step = edgeRow ? 1 : 2 * ring;
+            for (int c = centerColumn - ring; c <= centerColumn + ring; c += std::max(step, 1)) {
+                if (c < 0 || c >= columns) continue;
+                size_t cell = static_cast<size_t>(r) * columns + c;
+                for (uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) {
+                    const Vector2D& p = points[cellItems[k]];
+                    double dx = p.x - query.x;
+                    double dy = p.y - query.y;
+                    double distance2 = dx * dx + dy * dy;
+                    if (distance2 <= bestDistance2) {
+                        bestDistance2 = distance2;
+                        best = cellItems[k];
+                    }
+                }
+            }
+        }
+        double reach = ring * cellSize;
+        if (reach * reach >= bestDistance2) break;
+    }
+    return best;
+}
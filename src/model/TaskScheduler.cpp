@@ -0,0 +1,437 @@
+#include "../../include/TaskScheduler.hpp"
+#include <chrono>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+thread_local TaskScheduler* TaskScheduler::currentScheduler = nullptr;
+thread_local unsigned TaskScheduler::currentWorker = 0;
+
+// --- WorkStealingDeque -------------------------------------------------------
+
+WorkStealingDeque::WorkStealingDeque(int64_t initialCapacity)
+    : top(0), bottom(0), array(nullptr) {
+    int64_t capacity = 1;
+    while (capacity < initialCapacity) capacity <<= 1;
+    arrays.emplace_back(new Array(capacity));
+    array.store(arrays.back().get(), std::memory_order_relaxed);
+}
+
+WorkStealingDeque::Array* WorkStealingDeque::grow(Array* old, int64_t bottomIndex, int64_t topIndex) {
+    Array* bigger = new Array(old->capacity * 2);
+    for (int64_t i = topIndex; i < bottomIndex; ++i) {
+        bigger->put(i, old->get(i));
+    }
+    // L'ancien tableau reste vivant : un voleur peut être en train de le lire
+    arrays.emplace_back(bigger);
+    array.store(bigger, std::memory_order_release);
+    return bigger;
+}
+
+void WorkStealingDeque::push(Task* task) {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_acquire);
+    Array* a = array.load(std::memory_order_relaxed);
+
+    if (b - t > a->capacity - 1) {
+        a = grow(a, b, t);
+    }
+
+    a->put(b, task);
+    std::atomic_thread_fence(std::memory_order_release);
+    bottom.store(b + 1, std::memory_order_relaxed);
+}
+
+Task* WorkStealingDeque::pop() {
+    int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+    Array* a = array.load(std::memory_order_relaxed);
+    bottom.store(b, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t t = top.load(std::memory_order_relaxed);
+
+    if (t > b) {
+        // File vide
+        bottom.store(b + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Task* task = a->get(b);
+    if (t == b) {
+        // Dernier élément : course possible avec un voleur
+        if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            task = nullptr;
+        }
+        bottom.store(b + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+Task* WorkStealingDeque::steal() {
+    int64_t t = top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom.load(std::memory_order_acquire);
+
+    if (t >= b) {
+        return nullptr;
+    }
+
+    Array* a = array.load(std::memory_order_acquire);
+    Task* task = a->get(t);
+    if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+        return nullptr; // Un autre thread a gagné la course
+    }
+    return task;
+}
+
+bool WorkStealingDeque::empty() const {
+    int64_t b = bottom.load(std::memory_order_relaxed);
+    int64_t t = top.load(std::memory_order_relaxed);
+    return b <= t;
+}
+
+// --- TaskGroup ---------------------------------------------------------------
+
+TaskGroup::TaskGroup(TaskScheduler& s)
+    : scheduler(s), pending(0), ownsExternalSlot(false),
+      previousScheduler(TaskScheduler::currentScheduler), previousWorker(TaskScheduler::currentWorker) {
+    if (TaskScheduler::currentScheduler != &scheduler) {
+        // Thread externe : il prend la place du worker 0 le temps du groupe
+        scheduler.externalMutex.lock();
+        ownsExternalSlot = true;
+        TaskScheduler::currentScheduler = &scheduler;
+        TaskScheduler::currentWorker = 0;
+    }
+}
+
+TaskGroup::~TaskGroup() {
+    scheduler.waitFor(*this);
+    if (ownsExternalSlot) {
+        TaskScheduler::currentScheduler = previousScheduler;
+        TaskScheduler::currentWorker = previousWorker;
+        scheduler.externalMutex.unlock();
+    }
+}
+
+void TaskGroup::run(std::function<void()> function) {
+    pending.fetch_add(1, std::memory_order_relaxed);
+    Task* task = new Task();
+    task->function = std::move(function);
+    task->group = this;
+    scheduler.spawn(task);
+}
+
+void TaskGroup::wait() {
+    scheduler.waitFor(*this);
+
+    std::exception_ptr failure;
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        std::swap(failure, error);
+    }
+    if (failure) {
+        std::rethrow_exception(failure);
+    }
+}
+
+// --- TaskScheduler -----------------------------------------------------------
+
+TaskScheduler::TaskScheduler(unsigned threadCount, PinningPolicy policy)
+    : sleepers(0), workEpoch(0), stopping(false), pinning(policy) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back(new Worker(0x9E3779B9u * (i + 1)));
+    }
+
+    // Chaque worker dédié s'épingle lui-même au démarrage ; le thread appelant tout de suite
+    if (pinning != PinningPolicy::None) {
+        NumaTopology topology;
+        std::vector<int> cpus = topology.assignCpus(threadCount, pinning);
+        for (unsigned i = 0; i < threadCount; ++i) {
+            workers[i]->cpu = cpus[i];
+            workers[i]->node = topology.nodeOfCpu(cpus[i]);
+        }
+        callerCpus = NumaTopology::currentThreadCpus();
+        NumaTopology::pinCurrentThread(std::vector<int>(1, workers[0]->cpu));
+    }
+
+    // Le worker 0 est le thread appelant, seuls les suivants ont un thread dédié
+    for (unsigned i = 1; i < threadCount; ++i) {
+        threads.emplace_back(&TaskScheduler::workerLoop, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping.store(true);
+    }
+    sleepCondition.notify_all();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    if (!callerCpus.empty()) {
+        NumaTopology::pinCurrentThread(callerCpus);
+    }
+}
+
+void TaskScheduler::spawn(Task* task) {
+    workers[currentWorker]->deque.push(task);
+
+    workEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_one();
+    }
+}
+
+void TaskScheduler::execute(Task* task, unsigned self) {
+    Worker& worker = *workers[self];
+    auto start = std::chrono::steady_clock::now();
+
+    try {
+        task->function();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(task->group->errorMutex);
+        if (!task->group->error) {
+            task->group->error = std::current_exception();
+        }
+    }
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    worker.busyNanoseconds.fetch_add(static_cast<uint64_t>(elapsed.count()), std::memory_order_relaxed);
+    worker.tasksExecuted.fetch_add(1, std::memory_order_relaxed);
+
+    TaskGroup* group = task->group;
+    delete task;
+    group->pending.fetch_sub(1, std::memory_order_release);
+}
+
+bool TaskScheduler::executeOne(unsigned self) {
+    Worker& worker = *workers[self];
+
+    // Les tâches réservées passent avant la file : le reste du groupe les attend
+    Task* task = worker.affine.exchange(nullptr, std::memory_order_acquire);
+    if (task == nullptr) {
+        task = worker.deque.pop();
+    }
+    if (task == nullptr && workers.size() > 1) {
+        // Vol chez des victimes tirées au hasard (xorshift)
+        unsigned count = static_cast<unsigned>(workers.size());
+        for (unsigned attempt = 0; attempt < count && task == nullptr; ++attempt) {
+            worker.randomState ^= worker.randomState << 13;
+            worker.randomState ^= worker.randomState >> 17;
+            worker.randomState ^= worker.randomState << 5;
+            unsigned victim = worker.randomState % count;
+            if (victim == self) continue;
+
+            worker.stealAttempts.fetch_add(1, std::memory_order_relaxed);
+            task = workers[victim]->deque.steal();
+            if (task != nullptr) {
+                worker.steals.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    if (task == nullptr) {
+        return false;
+    }
+
+    execute(task, self);
+    return true;
+}
+
+void TaskScheduler::workerLoop(unsigned index) {
+    currentScheduler = this;
+    currentWorker = index;
+#ifdef __linux__
+    workers[index]->threadId.store(static_cast<int>(syscall(SYS_gettid)), std::memory_order_release);
+#else
+    workers[index]->threadId.store(-1, std::memory_order_release);
+#endif
+    if (workers[index]->cpu >= 0) {
+        NumaTopology::pinCurrentThread(std::vector<int>(1, workers[index]->cpu));
+    }
+
+    int idleRounds = 0;
+    while (!stopping.load(std::memory_order_relaxed)) {
+        uint64_t epoch = workEpoch.load(std::memory_order_seq_cst);
+
+        if (executeOne(index)) {
+            idleRounds = 0;
+            continue;
+        }
+
+        if (++idleRounds < 64) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        // Plus de travail visible : dormir jusqu'à la prochaine soumission
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepers.fetch_add(1, std::memory_order_seq_cst);
+        if (!stopping.load() && workEpoch.load(std::memory_order_seq_cst) == epoch) {
+            sleepCondition.wait_for(lock, std::chrono::milliseconds(10));
+        }
+        sleepers.fetch_sub(1, std::memory_order_seq_cst);
+        idleRounds = 0;
+    }
+}
+
+void TaskScheduler::waitFor(TaskGroup& group) {
+    unsigned self = currentWorker;
+    while (group.pending.load(std::memory_order_acquire) > 0) {
+        if (!executeOne(self)) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::splitRange(TaskGroup& group, size_t begin, size_t end, size_t grain,
+                               const std::function<void(size_t, size_t)>& body) {
+    // On garde la première moitié et on publie la seconde : les voleurs
+    // récupèrent ainsi les plus gros morceaux restants
+    while (end - begin > grain) {
+        size_t middle = begin + (end - begin) / 2;
+        size_t upper = end;
+        group.run([this, &group, middle, upper, grain, &body]() {
+            splitRange(group, middle, upper, grain, body);
+        });
+        end = middle;
+    }
+    body(begin, end);
+}
+
+void TaskScheduler::parallelFor(size_t begin, size_t end, size_t grain,
+                                const std::function<void(size_t, size_t)>& body) {
+    if (end <= begin) return;
+    if (grain == 0) grain = 1;
+
+    if (workers.size() == 1 || end - begin <= grain) {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group(*this);
+    splitRange(group, begin, end, grain, body);
+    group.wait();
+}
+
+void TaskScheduler::staticFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body) {
+    if (end <= begin) return;
+
+    size_t count = end - begin;
+    size_t chunks = workers.size();
+    if (chunks == 1) {
+        body(begin, end);
+        return;
+    }
+
+    // Un bloc contigu indivisible par worker : les blocs peuvent changer de
+    // thread mais jamais être redécoupés, comme un découpage statique classique
+    TaskGroup group(*this);
+    for (size_t c = 0; c < chunks; ++c) {
+        size_t chunkBegin = begin + count * c / chunks;
+        size_t chunkEnd = begin + count * (c + 1) / chunks;
+        if (chunkBegin == chunkEnd) continue;
+        group.run([&body, chunkBegin, chunkEnd]() { body(chunkBegin, chunkEnd); });
+    }
+    group.wait();
+}
+
+void TaskScheduler::affinityFor(size_t begin, size_t end, const std::function<void(size_t, size_t)>& body) {
+    if (end <= begin) return;
+
+    size_t count = end - begin;
+    size_t chunks = workers.size();
+    if (chunks == 1) {
+        body(begin, end);
+        return;
+    }
+
+    // Bloc c déposé dans la case réservée du worker c ; le bloc 0 revient au thread appelant
+    TaskGroup group(*this);
+    for (size_t c = 1; c < chunks; ++c) {
+        size_t chunkBegin = begin + count * c / chunks;
+        size_t chunkEnd = begin + count * (c + 1) / chunks;
+        if (chunkBegin == chunkEnd) continue;
+        Task* task = new Task();
+        task->function = [&body, chunkBegin, chunkEnd]() { body(chunkBegin, chunkEnd); };
+        task->group = &group;
+        group.pending.fetch_add(1, std::memory_order_relaxed);
+        Task* empty = nullptr;
+        if (!workers[c]->affine.compare_exchange_strong(empty, task, std::memory_order_release,
+                                                        std::memory_order_relaxed)) {
+            // Case encore occupée (appel imbriqué ou concurrent) : ne jamais écraser
+            // la tâche d'un autre groupe, le bloc passe par la file ordinaire
+            spawn(task);
+        }
+    }
+
+    // Tous les workers concernés doivent se réveiller, pas seulement un
+    workEpoch.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers.load(std::memory_order_seq_cst) > 0) {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        sleepCondition.notify_all();
+    }
+
+    size_t firstEnd = begin + count / chunks;
+    if (firstEnd > begin) {
+        body(begin, firstEnd);
+    }
+    group.wait();
+}
+
+std::vector<WorkerStats> TaskScheduler::getStats() const {
+    std::vector<WorkerStats> stats(workers.size());
+    for (size_t i = 0; i < workers.size(); ++i) {
+        stats[i].busyNanoseconds = workers[i]->busyNanoseconds.load(std::memory_order_relaxed);
+        stats[i].tasksExecuted = workers[i]->tasksExecuted.load(std::memory_order_relaxed);
+        stats[i].steals = workers[i]->steals.load(std::memory_order_relaxed);
+        stats[i].stealAttempts = workers[i]->stealAttempts.load(std::memory_order_relaxed);
+    }
+    return stats;
+}
+
+void TaskScheduler::resetStats() {
+    for (auto& worker : workers) {
+        worker->busyNanoseconds.store(0, std::memory_order_relaxed);
+        worker->tasksExecuted.store(0, std::memory_order_relaxed);
+        worker->steals.store(0, std::memory_order_relaxed);
+        worker->stealAttempts.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::vector<int> TaskScheduler::getWorkerThreadIds() const {
+    std::vector<int> ids;
+    for (size_t i = 1; i < workers.size(); ++i) {
+        // Attendre que le thread ait publié son identifiant
+        int id;
+        while ((id = workers[i]->threadId.load(std::memory_order_acquire)) == 0) {
+            std::this_thread::yield();
+        }
+        ids.push_back(id);
+    }
+    return ids;
+}
+
+std::vector<int> TaskScheduler::getSpareCpus() const {
+    // Le thread appelant est épinglé comme worker 0 : ses cœurs d'origine sont dans callerCpus
+    std::vector<int> allowed = callerCpus.empty() ? NumaTopology::currentThreadCpus() : callerCpus;
+    std::vector<int> spare;
+    for (int cpu : allowed) {
+        bool used = false;
+        for (const auto& worker : workers) {
+            if (worker->cpu == cpu) used = true;
+        }
+        if (!used) spare.push_back(cpu);
+    }
+    return spare.empty() ? allowed : spare;
+}
@@ -0,0 +1,231 @@
+#include "../../include/Telemetry.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+    // Délai maximal pour remarquer stop() et pour lire une requête
+    const int POLL_TIMEOUT_MS = 200;
+    const int REQUEST_TIMEOUT_MS = 1000;
+
+#ifdef MSG_NOSIGNAL
+    const int SEND_FLAGS = MSG_NOSIGNAL;   // Client parti : pas de SIGPIPE
+#else
+    const int SEND_FLAGS = 0;
+#endif
+
+    void sendAll(int client, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t written = send(client, data.data() + sent, data.size() - sent, SEND_FLAGS);
+            if (written <= 0) return;
+            sent += static_cast<size_t>(written);
+        }
+    }
+
+    // Mémoire résidente du processus (Linux), 0 si inconnue
+    uint64_t residentBytes() {
+        std::FILE* statm = std::fopen("/proc/self/statm", "r");
+        if (!statm) return 0;
+        unsigned long long size = 0, resident = 0;
+        int fields = std::fscanf(statm, "%llu %llu", &size, &resident);
+        std::fclose(statm);
+        return fields == 2 ? resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+    }
+
+    void metric(std::ostringstream& out, const char* name, const char* type, const char* help) {
+        out << "# HELP " << name << ' ' << help << '\n';
+        out << "# TYPE " << name << ' ' << type << '\n';
+    }
+}
+
+TelemetryServer::TelemetryServer(const TelemetryMetrics& metrics)
+    : metrics(metrics), listener(-1), port(0), running(false) {}
+
+TelemetryServer::~TelemetryServer() {
+    stop();
+}
+
+bool TelemetryServer::listenTcp(int portNumber) {
+    stop();
+    int descriptor = socket(AF_INET, SOCK_STREAM, 0);
+    if (descriptor < 0) {
+        lastError = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+    int reuse = 1;
+    setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    // Boucle locale seulement : les métriques ne sortent pas de la machine
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(portNumber));
+    if (bind(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        lastError = "bind 127.0.0.1:" + std::to_string(portNumber) + ": " + std::strerror(errno);
+        ::close(descriptor);
+        return false;
+    }
+
+    socklen_t length = sizeof(address);
+    getsockname(descriptor, reinterpret_cast<sockaddr*>(&address), &length);
+    port = ntohs(address.sin_port);
+    return start(descriptor);
+}
+
+bool TelemetryServer::listenUnix(const std::string& path) {
+    stop();
+    sockaddr_un address;
+    std::memset(&address, 0, sizeof(address));
+    if (path.size() >= sizeof(address.sun_path)) {
+        lastError = path + ": chemin trop long";
+        return false;
+    }
+    int descriptor = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (descriptor < 0) {
+        lastError = std::string("socket: ") + std::strerror(errno);
+        return false;
+    }
+
+    address.sun_family = AF_UNIX;
+    std::memcpy(address.sun_path, path.c_str(), path.size());
+    unlink(path.c_str()); // Socket laissée par une exécution précédente
+    if (bind(descriptor, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        lastError = path + ": " + std::strerror(errno);
+        ::close(descriptor);
+        return false;
+    }
+    socketPath = path;
+    return start(descriptor);
+}
+
+bool TelemetryServer::listen(const std::string& address) {
+    if (address.compare(0, 5, "unix:") == 0) {
+        return listenUnix(address.substr(5));
+    }
+    return listenTcp(std::atoi(address.c_str()));
+}
+
+bool TelemetryServer::start(int descriptor) {
+    if (::listen(descriptor, 8) != 0) {
+        lastError = std::string("listen: ") + std::strerror(errno);
+        ::close(descriptor);
+        return false;
+    }
+    listener = descriptor;
+    running = true;
+    thread = std::thread(&TelemetryServer::serve, this);
+    return true;
+}
+
+void TelemetryServer::stop() {
+    if (thread.joinable()) {
+        running = false;
+        thread.join();
+    }
+    if (listener >= 0) {
+        ::close(listener);
+        listener = -1;
+    }
+    if (!socketPath.empty()) {
+        unlink(socketPath.c_str());
+        socketPath.clear();
+    }
+}
+
+void TelemetryServer::serve() {
+    while (running.load()) {
+        pollfd entry;
+        entry.fd = listener;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        if (poll(&entry, 1, POLL_TIMEOUT_MS) <= 0) continue;
+
+        int client = accept(listener, nullptr, nullptr);
+        if (client < 0) continue;
+        answer(client);
+        ::close(client);
+    }
+}
+
+void TelemetryServer::answer(int client) {
+    // Seule la ligne de requête compte ; les en-têtes sont lus puis ignorés
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.find("\n\n") == std::string::npos
+           && request.size() < 8192) {
+        pollfd entry;
+        entry.fd = client;
+        entry.events = POLLIN;
+        entry.revents = 0;
+        if (poll(&entry, 1, REQUEST_TIMEOUT_MS) <= 0) return;
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::istringstream line(request);
+    std::string method, target;
+    line >> method >> target;
+    if (method != "GET" || (target != "/metrics" && target != "/")) {
+        sendAll(client, "HTTP/1.0 404 Not Found\r\nContent-Type: text/plain\r\nContent-Length: 10\r\n\r\nNot Found\n");
+        return;
+    }
+
+    std::string body = renderMetrics();
+    std::ostringstream response;
+    response << "HTTP/1.0 200 OK\r\n"
+             << "Content-Type: text/plain; version=0.0.4\r\n"
+             << "Content-Length: " << body.size() << "\r\n\r\n" << body;
+    sendAll(client, response.str());
+}
+
+std::string TelemetryServer::renderMetrics() {
+    uint64_t steps = metrics.steps.load(std::memory_order_relaxed);
+    uint64_t stepNs = metrics.stepNanoseconds.load(std::memory_order_relaxed);
+    uint64_t forceNs = metrics.forceNanoseconds.load(std::memory_order_relaxed);
+    uint64_t diagnosticsNs = metrics.diagnosticsNanoseconds.load(std::memory_order_relaxed);
+    uint64_t measuredNs = forceNs + diagnosticsNs;
+
+    std::ostringstream out;
+    out.precision(17);
+    metric(out, "nbody_steps_total", "counter", "Pas simulés");
+    out << "nbody_steps_total " << steps << '\n';
+    metric(out, "nbody_bodies", "gauge", "Nombre de corps");
+    out << "nbody_bodies " << metrics.bodies.load(std::memory_order_relaxed) << '\n';
+    metric(out, "nbody_interactions_total", "counter", "Paires de corps évaluées");
+    out << "nbody_interactions_total " << metrics.interactions.load(std::memory_order_relaxed) << '\n';
+
+    // Intégration = reste du pas (dérives, kicks, paires régularisées)
+    metric(out, "nbody_phase_seconds_total", "counter", "Temps cumulé par phase de step()");
+    out << "nbody_phase_seconds_total{phase=\"forces\"} " << forceNs * 1e-9 << '\n';
+    out << "nbody_phase_seconds_total{phase=\"diagnostics\"} " << diagnosticsNs * 1e-9 << '\n';
+    out << "nbody_phase_seconds_total{phase=\"integration\"} " << (stepNs > measuredNs ? stepNs - measuredNs : 0) * 1e-9 << '\n';
+
+    if (metrics.hasEnergy.load(std::memory_order_acquire)) {
+        double energy = metrics.energy.load(std::memory_order_relaxed);
+        double initial = metrics.initialEnergy.load(std::memory_order_relaxed);
+        metric(out, "nbody_energy", "gauge", "Énergie totale au dernier relevé");
+        out << "nbody_energy " << energy << '\n';
+        metric(out, "nbody_energy_drift", "gauge", "Dérive relative de l'énergie depuis le premier relevé");
+        out << "nbody_energy_drift " << std::abs(energy - initial) / std::max(std::abs(initial), 1e-300) << '\n';
+    }
+
+    uint64_t resident = residentBytes();
+    if (resident > 0) {
+        metric(out, "nbody_resident_memory_bytes", "gauge", "Mémoire résidente du processus");
+        out << "nbody_resident_memory_bytes " << resident << '\n';
+    }
+    return out.str();
+}
@@ -0,0 +1,426 @@
+#include "../../include/Trajectory.hpp"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+    const char TRAJECTORY_MAGIC[8] = {'N', 'C', 'O', 'R', 'P', 'S', '0', '1'};
+
+    const size_t NO_FRAME = static_cast<size_t>(-1);
+
+    size_t frameBytes(size_t bodyCount, int dimension) {
+        return sizeof(FrameHeader) + bodyCount * dimension * sizeof(double);
+    }
+}
+
+// --- TrajectoryWriter --------------------------------------------------------
+
+TrajectoryWriter::TrajectoryWriter()
+    : file(nullptr), tolerance(0.0), keyframeInterval(TrajectoryCodec::DEFAULT_KEYFRAME_INTERVAL),
+      submittedFrames(0), queueHead(0), queueCount(0), stopping(false), writing(false), failed(false),
+      executor(nullptr), writtenFrames(0), writtenBytes(0) {
+    std::memset(&header, 0, sizeof(header));
+}
+
+TrajectoryWriter::~TrajectoryWriter() {
+    close();
+}
+
+void TrajectoryWriter::setCompression(double toleranceValue, int interval) {
+    tolerance = toleranceValue;
+    keyframeInterval = interval;
+}
+
+void TrajectoryWriter::setExecutor(CoroutineExecutor* shared) {
+    executor = shared;
+}
+
+bool TrajectoryWriter::writeBlock(const void* data, size_t bytes) {
+    return bytes == 0 || std::fwrite(data, 1, bytes, file) == bytes;
+}
+
+bool TrajectoryWriter::writeHeader() {
+    return std::fseek(file, 0, SEEK_SET) == 0 && writeBlock(&header, sizeof(header));
+}
+
+template <int D>
+bool TrajectoryWriter::open(const std::string& path, const SimulationT<D>& simulation) {
+    close();
+    // close() attend la coroutine d'écriture : son exécuteur doit tourner sur un autre thread
+    if (executor && !executor->hasThread()) {
+        lastError = "exécuteur d'écriture sans thread propre (start())";
+        return false;
+    }
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const auto& bodies = simulation.getBodies();
+    std::memcpy(header.magic, TRAJECTORY_MAGIC, sizeof(header.magic));
+    header.dimension = D;
+    header.encoding = tolerance > 0.0 ? 1 : 0;
+    header.bodyCount = bodies.size();
+    header.frameCount = 0;
+    header.timeStep = simulation.getTimeStep();
+
+    // Masses puis rayons, une fois pour toutes
+    std::vector<double> statics(2 * bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        statics[i] = bodies[i]->getMass();
+        statics[bodies.size() + i] = bodies[i]->getRadius();
+    }
+    if (!writeHeader() || !writeBlock(statics.data(), statics.size() * sizeof(double))) {
+        lastError = std::string("écriture: ") + std::strerror(errno);
+        close();
+        return false;
+    }
+
+    if (header.encoding == 1) {
+        codec.reset(new TrajectoryCodec(bodies.size(), D, tolerance, keyframeInterval));
+    } else {
+        codec.reset();
+    }
+    submittedFrames = 0;
+    writtenFrames = 0;
+    writtenBytes = 0;
+    queueHead = 0;
+    queueCount = 0;
+    stopping = false;
+    failed = false;
+    workerError.clear();
+
+    CoroutineExecutor* target = executor;
+    if (!target) {
+        if (!ownExecutor) {
+            ownExecutor.reset(new CoroutineExecutor());
+            ownExecutor->start();
+        }
+        target = ownExecutor.get();
+    }
+    frameReady.reset(new AsyncSignal(*target));
+    writing = true;
+    target->spawn(writerLoop(*target));
+    return true;
+}
+
+template <int D>
+bool TrajectoryWriter::writeFrame(const SimulationT<D>& simulation) {
+    if (!file) {
+        lastError = "fichier non ouvert";
+        return false;
+    }
+    const auto& bodies = simulation.getBodies();
+    if (bodies.size() != header.bodyCount || header.dimension != static_cast<uint32_t>(D)) {
+        lastError = "nombre de corps ou dimension différent de l'ouverture";
+        return false;
+    }
+
+    // Attendre une place libre : le codeur a au plus QUEUE_DEPTH images de retard
+    std::unique_lock<std::mutex> lock(queueMutex);
+    queueChanged.wait(lock, [this] { return queueCount < QUEUE_DEPTH || failed; });
+    if (failed) {
+        lastError = workerError;
+        return false;
+    }
+    PendingFrame& frame = pending[(queueHead + queueCount) % QUEUE_DEPTH];
+    lock.unlock();
+
+    // La place réservée n'est lue par le thread d'écriture qu'une fois comptée dans la file
+    frame.header.step = simulation.getStepCount();
+    frame.header.time = frame.header.step * simulation.getTimeStep();
+    frame.positions.resize(bodies.size() * D);
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        typename SimulationT<D>::VectorType position = bodies[i]->getPosition();
+        for (int axis = 0; axis < D; ++axis) {
+            frame.positions[i * D + axis] = position[axis];
+        }
+    }
+
+    lock.lock();
+    ++queueCount;
+    ++submittedFrames;
+    lock.unlock();
+    frameReady->set();
+    return true;
+}
+
+bool TrajectoryWriter::writePending(const PendingFrame& frame) {
+    if (!codec) {
+        return writeBlock(&frame.header, sizeof(frame.header))
+            && writeBlock(frame.positions.data(), frame.positions.size() * sizeof(double));
+    }
+
+    PackedFrameHeader packed;
+    packed.keyframe = codec->encode(frame.positions.data(), payload) ? 1 : 0;
+    packed.step = frame.header.step;
+    packed.time = frame.header.time;
+    packed.payloadBytes = static_cast<uint32_t>(payload.size());
+    if (payload.size() != packed.payloadBytes) {
+        errno = EFBIG;
+        return false;
+    }
+    return writeBlock(&packed, sizeof(packed)) && writeBlock(payload.data(), payload.size());
+}
+
+AsyncTask<void> TrajectoryWriter::writerLoop(CoroutineExecutor& target) {
+    while (true) {
+        std::unique_lock<std::mutex> lock(queueMutex);
+        if (queueCount == 0) {
+            if (stopping) {
+                // Arrêt demandé et file vidée
+                writing = false;
+                queueChanged.notify_all();
+                co_return;
+            }
+            // Le verrou n'est jamais gardé pendant une suspension
+            lock.unlock();
+            co_await frameReady->wait();
+            continue;
+        }
+
+        const PendingFrame& frame = pending[queueHead];
+        lock.unlock();
+        // Après une erreur la file est seulement vidée, pour ne pas bloquer writeFrame()
+        bool written = !failed && writePending(frame);
+        std::string error = written || failed ? std::string() : std::string("écriture: ") + std::strerror(errno);
+        lock.lock();
+
+        if (written) {
+            ++writtenFrames;
+        } else if (!failed) {
+            failed = true;
+            workerError = error;
+        }
+        queueHead = (queueHead + 1) % QUEUE_DEPTH;
+        --queueCount;
+        queueChanged.notify_all();
+        lock.unlock();
+
+        // Une image par reprise : les autres tâches de l'exécuteur passent entre deux images
+        co_await target.schedule();
+    }
+}
+
+void TrajectoryWriter::close() {
+    if (!file) return;
+    std::unique_lock<std::mutex> lock(queueMutex);
+    if (writing) {
+        stopping = true;
+        lock.unlock();
+        frameReady->set();
+        lock.lock();
+        queueChanged.wait(lock, [this] { return !writing; });
+        if (failed) lastError = workerError;
+    }
+    lock.unlock();
+
+    // Le nombre d'images n'est connu qu'à la fin : l'en-tête est réécrit en place
+    header.frameCount = writtenFrames;
+    if (std::fseek(file, 0, SEEK_END) == 0) {
+        writtenBytes = static_cast<uint64_t>(std::ftell(file));
+    }
+    writeHeader();
+    std::fclose(file);
+    file = nullptr;
+    codec.reset();
+}
+
+template bool TrajectoryWriter::open<2>(const std::string& path, const Simulation& simulation);
+template bool TrajectoryWriter::open<3>(const std::string& path, const Simulation3D& simulation);
+template bool TrajectoryWriter::writeFrame<2>(const Simulation& simulation);
+template bool TrajectoryWriter::writeFrame<3>(const Simulation3D& simulation);
+
+// --- TrajectoryReader --------------------------------------------------------
+
+TrajectoryReader::TrajectoryReader()
+    : descriptor(-1), mapping(nullptr), mappingSize(0), frameSize(0), framesOffset(0), decodedIndex(NO_FRAME) {
+    std::memset(&header, 0, sizeof(header));
+}
+
+TrajectoryReader::~TrajectoryReader() {
+    close();
+}
+
+bool TrajectoryReader::open(const std::string& path) {
+    close();
+    descriptor = ::open(path.c_str(), O_RDONLY);
+    if (descriptor < 0) {
+        lastError = path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(descriptor, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(TrajectoryHeader)) {
+        lastError = path + ": fichier trop court";
+        close();
+        return false;
+    }
+
+    mappingSize = static_cast<size_t>(info.st_size);
+    void* address = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+    if (address == MAP_FAILED) {
+        lastError = std::string("mmap: ") + std::strerror(errno);
+        mappingSize = 0;
+        close();
+        return false;
+    }
+    mapping = static_cast<const unsigned char*>(address);
+
+    std::memcpy(&header, mapping, sizeof(header));
+    if (std::memcmp(header.magic, TRAJECTORY_MAGIC, sizeof(header.magic)) != 0 || header.encoding > 1
+        || (header.dimension != 2 && header.dimension != 3)) {
+        lastError = path + ": format de trajectoire inconnu";
+        close();
+        return false;
+    }
+
+    framesOffset = sizeof(TrajectoryHeader) + 2 * header.bodyCount * sizeof(double);
+    frameSize = frameBytes(header.bodyCount, header.dimension);
+    if (mappingSize < framesOffset) {
+        lastError = path + ": masses et rayons tronqués";
+        close();
+        return false;
+    }
+
+    // Dernière image complète : fichier en cours d'écriture ou calcul interrompu
+    if (isCompressed()) {
+        if (!indexPackedFrames()) {
+            lastError = path + ": la première image n'est pas une image clé";
+            close();
+            return false;
+        }
+    } else {
+        header.frameCount = (mappingSize - framesOffset) / frameSize;
+    }
+
+    // La lecture à l'envers défait la lecture anticipée du noyau : c'est
+    // prefetch(), appelé par le lecteur dans le sens de lecture, qui la remplace
+    madvise(address, mappingSize, MADV_RANDOM);
+    prefetch(0, 1);
+    return true;
+}
+
+void TrajectoryReader::close() {
+    if (mapping) {
+        munmap(const_cast<unsigned char*>(mapping), mappingSize);
+        mapping = nullptr;
+    }
+    if (descriptor >= 0) {
+        ::close(descriptor);
+        descriptor = -1;
+    }
+    mappingSize = 0;
+    std::memset(&header, 0, sizeof(header));
+    frameOffsets.clear();
+    keyframeOf.clear();
+    codec.reset();
+    decoded.clear();
+    decodedIndex = NO_FRAME;
+}
+
+bool TrajectoryReader::indexPackedFrames() {
+    size_t offset = framesOffset;
+    size_t keyframe = NO_FRAME;
+    while (mappingSize - offset >= sizeof(PackedFrameHeader)) {
+        PackedFrameHeader packed;
+        std::memcpy(&packed, mapping + offset, sizeof(packed));
+        if (mappingSize - offset - sizeof(packed) < packed.payloadBytes) break;
+
+        if (packed.keyframe) {
+            keyframe = frameOffsets.size();
+        } else if (keyframe == NO_FRAME) {
+            return false;
+        }
+        frameOffsets.push_back(offset);
+        keyframeOf.push_back(keyframe);
+        offset += sizeof(packed) + packed.payloadBytes;
+    }
+
+    header.frameCount = frameOffsets.size();
+    codec.reset(new TrajectoryCodec(header.bodyCount, header.dimension));
+    decoded.resize(header.bodyCount * header.dimension);
+    decodedIndex = NO_FRAME;
+    return true;
+}
+
+PackedFrameHeader TrajectoryReader::packedHeader(size_t index) const {
+    // Les en-têtes suivent des données de taille quelconque : pas d'alignement garanti
+    PackedFrameHeader packed;
+    std::memcpy(&packed, mapping + frameOffsets[index], sizeof(packed));
+    return packed;
+}
+
+bool TrajectoryReader::decodeUpTo(size_t index) const {
+    if (decodedIndex == index) return true;
+
+    // Image suivante : un seul décodage ; sinon repartir de l'image clé
+    size_t first = keyframeOf[index];
+    if (decodedIndex != NO_FRAME && decodedIndex < index && decodedIndex >= first) {
+        first = decodedIndex + 1;
+    }
+    for (size_t k = first; k <= index; ++k) {
+        PackedFrameHeader packed = packedHeader(k);
+        const unsigned char* payload = mapping + frameOffsets[k] + sizeof(packed);
+        if (!codec->decode(payload, packed.payloadBytes, packed.keyframe != 0, decoded.data())) {
+            decodedIndex = NO_FRAME;
+            return false;
+        }
+        decodedIndex = k;
+    }
+    return true;
+}
+
+FrameView TrajectoryReader::frame(size_t index) const {
+    FrameView view;
+    const double* statics = reinterpret_cast<const double*>(mapping + sizeof(TrajectoryHeader));
+    view.mass = statics;
+    view.radius = statics + header.bodyCount;
+    view.bodyCount = static_cast<size_t>(header.bodyCount);
+    view.dimension = static_cast<int>(header.dimension);
+
+    if (isCompressed()) {
+        PackedFrameHeader packed = packedHeader(index);
+        view.step = packed.step;
+        view.time = packed.time;
+        if (decodeUpTo(index)) {
+            view.positions = decoded.data();
+        } else {
+            view.bodyCount = 0; // Image illisible : rien à dessiner
+        }
+        return view;
+    }
+
+    const unsigned char* base = mapping + framesOffset + index * frameSize;
+    FrameHeader frameHeader;
+    std::memcpy(&frameHeader, base, sizeof(frameHeader));
+    view.positions = reinterpret_cast<const double*>(base + sizeof(FrameHeader));
+    view.step = frameHeader.step;
+    view.time = frameHeader.time;
+    return view;
+}
+
+void TrajectoryReader::prefetch(size_t first, size_t count) const {
+    if (!mapping || first >= getFrameCount()) return;
+    if (count > getFrameCount() - first) count = getFrameCount() - first;
+
+    size_t begin;
+    size_t end;
+    if (isCompressed()) {
+        // Le décodage repart de l'image clé qui précède
+        begin = frameOffsets[keyframeOf[first]];
+        end = first + count < frameOffsets.size() ? frameOffsets[first + count] : mappingSize;
+    } else {
+        begin = framesOffset + first * frameSize;
+        end = framesOffset + (first + count) * frameSize;
+    }
+
+    // madvise exige une adresse alignée sur une page
+    size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    begin = begin / page * page;
+    madvise(const_cast<unsigned char*>(mapping) + begin, end - begin, MADV_WILLNEED);
+}
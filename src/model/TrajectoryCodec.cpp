@@ -0,0 +1,277 @@
+#include "../../include/TrajectoryCodec.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+    // Probabilités sur 11 bits, adaptation en 1/32 (paramètres de LZMA)
+    const int PROBABILITY_BITS = 11;
+    const uint16_t PROBABILITY_HALF = 1 << (PROBABILITY_BITS - 1);
+    const int ADAPTATION_SHIFT = 5;
+    const uint32_t RANGE_TOP = 1u << 24;
+
+    // Au-delà, la coordonnée est hors de toute grille raisonnable (corps éjecté, NaN)
+    const double QUANTIZED_LIMIT = 1152921504606846976.0;   // 2^60
+
+    class RangeEncoder {
+    private:
+        std::vector<unsigned char>& output;
+        uint64_t low;
+        uint32_t range;
+        unsigned char cache;
+        uint64_t cacheSize;
+
+        void shiftLow() {
+            if (static_cast<uint32_t>(low) < 0xFF000000u || (low >> 32) != 0) {
+                unsigned char carry = static_cast<unsigned char>(low >> 32);
+                unsigned char pending = cache;
+                do {
+                    output.push_back(static_cast<unsigned char>(pending + carry));
+                    pending = 0xFF;
+                } while (--cacheSize != 0);
+                cache = static_cast<unsigned char>(low >> 24);
+            }
+            ++cacheSize;
+            low = (low & 0x00FFFFFFu) << 8;
+        }
+
+        void normalize() {
+            while (range < RANGE_TOP) {
+                range <<= 8;
+                shiftLow();
+            }
+        }
+
+    public:
+        explicit RangeEncoder(std::vector<unsigned char>& out)
+            : output(out), low(0), range(0xFFFFFFFFu), cache(0), cacheSize(1) {}
+
+        void encodeBit(uint16_t& probability, int bit) {
+            uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+            if (bit == 0) {
+                range = bound;
+                probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPTATION_SHIFT;
+            } else {
+                low += bound;
+                range -= bound;
+                probability -= probability >> ADAPTATION_SHIFT;
+            }
+            normalize();
+        }
+
+        // Bit équiprobable, sans modèle
+        void encodeDirect(int bit) {
+            range >>= 1;
+            if (bit) low += range;
+            normalize();
+        }
+
+        void flush() {
+            for (int i = 0; i < 5; ++i) shiftLow();
+        }
+    };
+
+    class RangeDecoder {
+    private:
+        const unsigned char* current;
+        const unsigned char* end;
+        uint32_t range;
+        uint32_t code;
+
+        unsigned char next() { return current < end ? *current++ : 0; }
+
+        void normalize() {
+            while (range < RANGE_TOP) {
+                range <<= 8;
+                code = (code << 8) | next();
+            }
+        }
+
+    public:
+        RangeDecoder(const unsigned char* data, size_t bytes)
+            : current(data), end(data + bytes), range(0xFFFFFFFFu), code(0) {
+            for (int i = 0; i < 5; ++i) code = (code << 8) | next();
+        }
+
+        int decodeBit(uint16_t& probability) {
+            uint32_t bound = (range >> PROBABILITY_BITS) * probability;
+            int bit;
+            if (code < bound) {
+                range = bound;
+                probability += ((1 << PROBABILITY_BITS) - probability) >> ADAPTATION_SHIFT;
+                bit = 0;
+            } else {
+                code -= bound;
+                range -= bound;
+                probability -= probability >> ADAPTATION_SHIFT;
+                bit = 1;
+            }
+            normalize();
+            return bit;
+        }
+
+        int decodeDirect() {
+            range >>= 1;
+            int bit = 0;
+            if (code >= range) {
+                code -= range;
+                bit = 1;
+            }
+            normalize();
+            return bit;
+        }
+    };
+
+    // Entiers signés -> non signés, petits en valeur absolue -> petits
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+
+    int64_t unzigzag(uint64_t value) {
+        return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+    }
+
+    int bitLength(uint64_t value) {
+        int length = 0;
+        while (value != 0) {
+            ++length;
+            value >>= 1;
+        }
+        return length;
+    }
+
+    // Longueur en bits (arbre adaptatif) puis bits sous le bit de tête (équiprobables)
+    void encodeResidual(RangeEncoder& encoder, uint16_t* lengthTree, int64_t residual) {
+        uint64_t value = zigzag(residual);
+        int length = bitLength(value);
+        unsigned node = 1;
+        for (int bit = 6; bit >= 0; --bit) {
+            int b = (length >> bit) & 1;
+            encoder.encodeBit(lengthTree[node], b);
+            node = (node << 1) | b;
+        }
+        for (int bit = length - 2; bit >= 0; --bit) {
+            encoder.encodeDirect(static_cast<int>((value >> bit) & 1));
+        }
+    }
+
+    int64_t decodeResidual(RangeDecoder& decoder, uint16_t* lengthTree) {
+        unsigned node = 1;
+        for (int bit = 0; bit < 7; ++bit) {
+            node = (node << 1) | decoder.decodeBit(lengthTree[node]);
+        }
+        int length = static_cast<int>(node - 128);
+        if (length == 0) return 0;
+        if (length > 64) length = 64;   // Données corrompues
+
+        uint64_t value = 1;
+        for (int bit = length - 2; bit >= 0; --bit) {
+            value = (value << 1) | static_cast<uint64_t>(decoder.decodeDirect());
+        }
+        return unzigzag(value);
+    }
+}
+
+TrajectoryCodec::TrajectoryCodec(size_t bodyCount, int dimension, double tolerance, int keyframeInterval)
+    : bodyCount(bodyCount), dimension(dimension), tolerance(tolerance),
+      keyframeInterval(std::max(1, keyframeInterval)), quantum(1.0),
+      current(bodyCount * dimension), previous(bodyCount * dimension), beforePrevious(bodyCount * dimension),
+      framesSinceKeyframe(-1),
+      lengthModels(LENGTH_TREE_SIZE * dimension) {
+    origin[0] = origin[1] = origin[2] = 0.0;
+    resetModels();
+}
+
+void TrajectoryCodec::resetModels() {
+    std::fill(lengthModels.begin(), lengthModels.end(), PROBABILITY_HALF);
+}
+
+int64_t TrajectoryCodec::predict(size_t coordinate) const {
+    if (framesSinceKeyframe == 0) {
+        return previous[coordinate];
+    }
+    // Extrapolation linéaire en arithmétique non signée : pas de débordement indéfini
+    return static_cast<int64_t>(2 * static_cast<uint64_t>(previous[coordinate])
+                                - static_cast<uint64_t>(beforePrevious[coordinate]));
+}
+
+void TrajectoryCodec::rotateHistory() {
+    beforePrevious.swap(previous);
+    previous.swap(current);
+}
+
+bool TrajectoryCodec::encode(const double* positions, std::vector<unsigned char>& payload) {
+    payload.clear();
+    size_t count = bodyCount * dimension;
+    bool keyframe = framesSinceKeyframe < 0 || framesSinceKeyframe + 1 >= keyframeInterval;
+
+    if (keyframe) {
+        // Nouvelle grille sur la boîte englobante courante
+        double low[3] = {HUGE_VAL, HUGE_VAL, HUGE_VAL};
+        double high[3] = {-HUGE_VAL, -HUGE_VAL, -HUGE_VAL};
+        for (size_t i = 0; i < count; ++i) {
+            int axis = static_cast<int>(i % dimension);
+            if (std::isfinite(positions[i])) {
+                low[axis] = std::min(low[axis], positions[i]);
+                high[axis] = std::max(high[axis], positions[i]);
+            }
+        }
+        double extent = 0.0;
+        for (int axis = 0; axis < dimension; ++axis) {
+            origin[axis] = std::isfinite(low[axis]) ? low[axis] : 0.0;
+            extent = std::max(extent, high[axis] - low[axis]);
+        }
+        quantum = tolerance * extent;
+        if (!(quantum > 0.0) || !std::isfinite(quantum)) quantum = tolerance > 0.0 ? tolerance : 1.0;
+
+        payload.resize(sizeof(double) * (dimension + 1));
+        std::memcpy(payload.data(), origin, sizeof(double) * dimension);
+        std::memcpy(payload.data() + sizeof(double) * dimension, &quantum, sizeof(double));
+        resetModels();
+    }
+
+    RangeEncoder encoder(payload);
+    for (size_t i = 0; i < count; ++i) {
+        int axis = static_cast<int>(i % dimension);
+        double scaled = (positions[i] - origin[axis]) / quantum;
+        if (!(std::fabs(scaled) < QUANTIZED_LIMIT)) scaled = scaled > 0.0 ? QUANTIZED_LIMIT : -QUANTIZED_LIMIT;
+        current[i] = std::llround(scaled);
+
+        int64_t prediction = keyframe ? 0 : predict(i);
+        int64_t residual = static_cast<int64_t>(static_cast<uint64_t>(current[i]) - static_cast<uint64_t>(prediction));
+        encodeResidual(encoder, &lengthModels[axis * LENGTH_TREE_SIZE], residual);
+    }
+    encoder.flush();
+
+    framesSinceKeyframe = keyframe ? 0 : framesSinceKeyframe + 1;
+    rotateHistory();
+    return keyframe;
+}
+
+bool TrajectoryCodec::decode(const unsigned char* payload, size_t bytes, bool keyframe, double* positions) {
+    size_t count = bodyCount * dimension;
+    if (keyframe) {
+        size_t gridBytes = sizeof(double) * (dimension + 1);
+        if (bytes < gridBytes) return false;
+        std::memcpy(origin, payload, sizeof(double) * dimension);
+        std::memcpy(&quantum, payload + sizeof(double) * dimension, sizeof(double));
+        payload += gridBytes;
+        bytes -= gridBytes;
+        resetModels();
+    } else if (framesSinceKeyframe < 0) {
+        return false;
+    }
+
+    RangeDecoder decoder(payload, bytes);
+    for (size_t i = 0; i < count; ++i) {
+        int axis = static_cast<int>(i % dimension);
+        int64_t prediction = keyframe ? 0 : predict(i);
+        int64_t residual = decodeResidual(decoder, &lengthModels[axis * LENGTH_TREE_SIZE]);
+        current[i] = static_cast<int64_t>(static_cast<uint64_t>(prediction) + static_cast<uint64_t>(residual));
+        positions[i] = origin[axis] + current[i] * quantum;
+    }
+
+    framesSinceKeyframe = keyframe ? 0 : framesSinceKeyframe + 1;
+    rotateHistory();
+    return true;
+}
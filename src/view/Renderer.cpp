@@ -1,10 +1,13 @@
 #include "../../include/Renderer.hpp"
+#include "../../include/Profiler.hpp"
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 Renderer::Renderer(int width, int height, const char* title)
     : window(nullptr), renderer(nullptr), windowWidth(width), windowHeight(height),
-      cameraOffset(0, 0), zoomLevel(1.0), showTrails(true), maxTrailLength(100) {
+      cameraOffset(0, 0), zoomLevel(1.0), cameraDistance(1000.0), showTrails(true), maxTrailLength(100),
+      highlightedBody(static_cast<size_t>(-1)), font(nullptr), ttfStarted(false) {
     windowTitle = title;
 }
 
@@ -37,10 +40,32 @@ bool Renderer::initialize() {
     // Enable blending for alpha transparency
     SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
     
+    // Texte facultatif : la simulation s'affiche même sans police
+    if (TTF_Init() == 0) {
+        ttfStarted = true;
+        font = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 14);
+        if (!font) {
+            font = TTF_OpenFont("/usr/share/fonts/truetype/liberation/LiberationSans-Regular.ttf", 14);
+        }
+        if (!font) {
+            std::cerr << "Police introuvable, pas de panneaux de texte: " << TTF_GetError() << std::endl;
+        }
+    } else {
+        std::cerr << "SDL_ttf could not initialize! SDL_ttf Error: " << TTF_GetError() << std::endl;
+    }
+    
     return true;
 }
 
 void Renderer::cleanup() {
+    if (font) {
+        TTF_CloseFont(font);
+        font = nullptr;
+    }
+    if (ttfStarted) {
+        TTF_Quit();
+        ttfStarted = false;
+    }
     if (renderer) {
         SDL_DestroyRenderer(renderer);
         renderer = nullptr;
@@ -57,23 +82,107 @@ void Renderer::clear(Color color) {
     SDL_RenderClear(renderer);
 }
 
+void Renderer::renderTextPanel(const std::vector<std::string>& lines, int x, int y) {
+    if (!font || lines.empty()) return;
+    
+    // Une surface par ligne : le fond est dimensionné avant de copier les textures
+    const int margin = 6;
+    std::vector<SDL_Surface*> surfaces;
+    int width = 0, height = 0;
+    for (const std::string& line : lines) {
+        SDL_Surface* surface = TTF_RenderUTF8_Blended(font, line.empty() ? " " : line.c_str(), {230, 230, 240, 255});
+        if (!surface) continue;
+        width = std::max(width, surface->w);
+        height += surface->h;
+        surfaces.push_back(surface);
+    }
+    
+    SDL_Rect background = {x, y, width + 2 * margin, height + 2 * margin};
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 170);
+    SDL_RenderFillRect(renderer, &background);
+    
+    int lineY = y + margin;
+    for (SDL_Surface* surface : surfaces) {
+        SDL_Texture* texture = SDL_CreateTextureFromSurface(renderer, surface);
+        if (texture) {
+            SDL_Rect destination = {x + margin, lineY, surface->w, surface->h};
+            SDL_RenderCopy(renderer, texture, nullptr, &destination);
+            SDL_DestroyTexture(texture);
+        }
+        lineY += surface->h;
+        SDL_FreeSurface(surface);
+    }
+}
+
 void Renderer::present() {
+    PROFILE_SCOPE("Renderer::present");
     SDL_RenderPresent(renderer);
 }
 
-void Renderer::renderSimulation(const Simulation& simulation) {
-    updateTrails(simulation);
+template <int D>
+FrameView Renderer::stageFrame(const SimulationT<D>& simulation) {
+    const auto& bodies = simulation.getBodies();
+    stagedPositions.resize(bodies.size() * D);
+    stagedMass.resize(bodies.size());
+    stagedRadius.resize(bodies.size());
+    for (size_t i = 0; i < bodies.size(); ++i) {
+        Vector<D> position = bodies[i]->getPosition();
+        for (int axis = 0; axis < D; ++axis) {
+            stagedPositions[i * D + axis] = position[axis];
+        }
+        stagedMass[i] = bodies[i]->getMass();
+        stagedRadius[i] = bodies[i]->getRadius();
+    }
+    
+    FrameView frame;
+    frame.positions = stagedPositions.data();
+    frame.mass = stagedMass.data();
+    frame.radius = stagedRadius.data();
+    frame.bodyCount = bodies.size();
+    frame.dimension = D;
+    frame.step = simulation.getStepCount();
+    frame.time = frame.step * simulation.getTimeStep();
+    return frame;
+}
+
+template FrameView Renderer::stageFrame<2>(const Simulation& simulation);
+template FrameView Renderer::stageFrame<3>(const Simulation3D& simulation);
+
+template <int D>
+void Renderer::renderSimulation(const SimulationT<D>& simulation) {
+    renderFrame(stageFrame(simulation));
+}
+
+template void Renderer::renderSimulation<2>(const Simulation& simulation);
+template void Renderer::renderSimulation<3>(const Simulation3D& simulation);
+
+void Renderer::renderFrame(const FrameView& frame) {
+    updateTrails(frame);
     
     if (showTrails) {
         renderTrails();
     }
     
-    const auto& bodies = simulation.getBodies();
-    for (size_t i = 0; i < bodies.size(); ++i) {
+    PROFILE_SCOPE("Renderer::renderBodies");
+    
+    // Algorithme du peintre en 3D : les corps proches recouvrent les lointains
+    drawOrder.resize(frame.bodyCount);
+    for (size_t i = 0; i < frame.bodyCount; ++i) {
+        drawOrder[i] = i;
+    }
+    if (frame.dimension == 3) {
+        const double* positions = frame.positions;
+        std::sort(drawOrder.begin(), drawOrder.end(), [positions](size_t a, size_t b) {
+            return positions[a * 3 + 2] < positions[b * 3 + 2];
+        });
+    }
+    
+    for (size_t k = 0; k < drawOrder.size(); ++k) {
+        size_t i = drawOrder[k];
         Color bodyColor;
         
         // Couleurs différentes selon la masse
-        double mass = bodies[i]->getMass();
+        double mass = frame.mass[i];
         if (mass > 100) {
             bodyColor = Color(255, 255, 0, 255);  // Jaune pour les étoiles
         } else if (mass > 50) {
@@ -84,14 +193,39 @@ void Renderer::renderSimulation(const Simulation& simulation) {
             bodyColor = Color(100, 150, 255, 255); // Bleu pour les petites planètes
         }
         
-        renderBody(*bodies[i], bodyColor);
+        // En 2D z = 0 : perspectiveScale(0) vaut exactement zoomLevel
+        Vector3D position = frame.position(i);
+        double scale = perspectiveScale(position.z);
+        if (scale <= 0.0) continue; // Derrière la caméra
+        
+        int radius = static_cast<int>(frame.radius[i] * scale);
+        Vector2D screenPos = worldToScreen(position);
+        renderDisc(screenPos, radius, bodyColor);
+        
+        if (i == highlightedBody) {
+            Color ring(255, 255, 255, 255);
+            drawCircle(static_cast<int>(screenPos.x), static_cast<int>(screenPos.y), std::max(radius, 1) + 4, ring);
+            drawCircle(static_cast<int>(screenPos.x), static_cast<int>(screenPos.y), std::max(radius, 1) + 5, ring);
+        }
     }
 }
 
 void Renderer::renderBody(const Body& body, Color color) {
     Vector2D screenPos = worldToScreen(body.getPosition());
     int radius = static_cast<int>(body.getRadius() * zoomLevel);
+    renderDisc(screenPos, radius, color);
+}
+
+void Renderer::renderBody(const Body3D& body, Color color) {
+    Vector3D position = body.getPosition();
+    double scale = perspectiveScale(position.z);
+    if (scale <= 0.0) return; // Derrière la caméra
     
+    int radius = static_cast<int>(body.getRadius() * scale);
+    renderDisc(worldToScreen(position), radius, color);
+}
+
+void Renderer::renderDisc(const Vector2D& screenPos, int radius, Color color) {
     // S'assurer que le rayon est au moins de 1 pixel
     if (radius < 1) radius = 1;
     
@@ -103,17 +237,24 @@ void Renderer::renderBody(const Body& body, Color color) {
 }
 
 void Renderer::renderTrails() {
+    PROFILE_SCOPE("Renderer::renderTrails");
     for (size_t i = 0; i < trails.size(); ++i) {
         const auto& trail = trails[i];
         if (trail.size() < 2) continue;
         
         for (size_t j = 1; j < trail.size(); ++j) {
+            if (perspectiveScale(trail[j-1].z) <= 0.0 || perspectiveScale(trail[j].z) <= 0.0) continue;
+            
             Vector2D start = worldToScreen(trail[j-1]);
             Vector2D end = worldToScreen(trail[j]);
             
             // Fade effect basé sur l'âge du point
             int alpha = static_cast<int>(255.0 * j / trail.size());
-            SDL_SetRenderDrawColor(renderer, 100, 100, 100, alpha);
+            if (i == highlightedBody) {
+                SDL_SetRenderDrawColor(renderer, 255, 220, 80, alpha);
+            } else {
+                SDL_SetRenderDrawColor(renderer, 100, 100, 100, alpha);
+            }
             
             SDL_RenderDrawLine(renderer, 
                              static_cast<int>(start.x), static_cast<int>(start.y),
@@ -173,23 +314,44 @@ Vector2D Renderer::worldToScreen(const Vector2D& worldPos) const {
     return Vector2D(scaled.x + windowWidth / 2, scaled.y + windowHeight / 2);
 }
 
+Vector2D Renderer::worldToScreen(const Vector3D& worldPos) const {
+    double scale = perspectiveScale(worldPos.z);
+    return Vector2D((worldPos.x - cameraOffset.x) * scale + windowWidth / 2,
+                    (worldPos.y - cameraOffset.y) * scale + windowHeight / 2);
+}
+
+double Renderer::perspectiveScale(double z) const {
+    // L'œil est à z = cameraDistance et regarde vers les z décroissants
+    double depth = cameraDistance - z;
+    if (depth <= 1e-6 * cameraDistance) return 0.0;
+    return zoomLevel * (cameraDistance / depth);
+}
+
 Vector2D Renderer::screenToWorld(const Vector2D& screenPos) const {
     Vector2D centered = Vector2D(screenPos.x - windowWidth / 2, screenPos.y - windowHeight / 2);
     Vector2D scaled = centered * (1.0 / zoomLevel);
     return scaled + cameraOffset;
 }
 
-void Renderer::updateTrails(const Simulation& simulation) {
-    const auto& bodies = simulation.getBodies();
+template <int D>
+void Renderer::updateTrails(const SimulationT<D>& simulation) {
+    updateTrails(stageFrame(simulation));
+}
+
+template void Renderer::updateTrails<2>(const Simulation& simulation);
+template void Renderer::updateTrails<3>(const Simulation3D& simulation);
+
+void Renderer::updateTrails(const FrameView& frame) {
+    PROFILE_SCOPE("Renderer::updateTrails");
     
     // Redimensionner le vecteur de trails si nécessaire
-    if (trails.size() != bodies.size()) {
-        trails.resize(bodies.size());
+    if (trails.size() != frame.bodyCount) {
+        trails.resize(frame.bodyCount);
     }
     
     // Ajouter les positions actuelles aux trails
-    for (size_t i = 0; i < bodies.size(); ++i) {
-        trails[i].push_back(bodies[i]->getPosition());
+    for (size_t i = 0; i < frame.bodyCount; ++i) {
+        trails[i].push_back(frame.position(i));
         
         // Limiter la longueur des trails
         if (trails[i].size() > static_cast<size_t>(maxTrailLength)) {
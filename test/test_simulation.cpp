@@ -1,7 +1,37 @@
 #include "../include/Simulation.hpp"
 #include "../include/Body.hpp"
+#include "../include/TaskScheduler.hpp"
+#include "../include/PerfCounters.hpp"
+#include "../include/NeighborList.hpp"
+#include "../include/Ensemble.hpp"
+#include "../include/Trajectory.hpp"
+#include "../include/Telemetry.hpp"
+#include "../include/SpatialIndex.hpp"
+#include "../include/Camera.hpp"
+#include "../include/OffscreenRenderer.hpp"
+#include "../include/Scene.hpp"
+#include "../include/Orbit.hpp"
+#include "../include/OutOfCore.hpp"
+#include "../include/Decomposition.hpp"
+#include "../include/Numa.hpp"
+#include "../include/Coroutine.hpp"
+#include <random>
 #include <iostream>
 #include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
 
 void testBodyCreation() {
     std::cout << "Test: Création d'un corps..." << std::endl;
@@ -94,6 +124,1680 @@ void testPresets() {
     std::cout << "✅ Tous les préréglages fonctionnent" << std::endl;
 }
 
+void testTaskScheduler() {
+    std::cout << "Test: Ordonnanceur à vol de travail..." << std::endl;
+    
+    TaskScheduler scheduler(4);
+    assert(scheduler.getThreadCount() == 4);
+    
+    // Chaque indice doit être traité exactement une fois
+    std::vector<int> visits(100000, 0);
+    scheduler.parallelFor(0, visits.size(), 100, [&visits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) visits[i]++;
+    });
+    for (int v : visits) assert(v == 1);
+    
+    // Tri parallèle
+    std::vector<int> values(50000);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>((i * 7919) % 50021);
+    scheduler.parallelSort(values.begin(), values.end(), [](int a, int b) { return a < b; }, 1000);
+    for (size_t i = 1; i < values.size(); ++i) assert(values[i - 1] <= values[i]);
+    
+    uint64_t executed = 0;
+    for (const auto& stats : scheduler.getStats()) executed += stats.tasksExecuted;
+    assert(executed > 0);
+    std::cout << "✅ parallelFor et parallelSort corrects (" << executed << " tâches)" << std::endl;
+    
+    // La version parallèle de step() doit suivre la version séquentielle
+    Simulation sequential(50.0, 0.01);
+    Simulation parallel(50.0, 0.01);
+    for (int i = 0; i < 100; ++i) {
+        Vector2D pos(std::cos(i * 0.7) * (50 + i), std::sin(i * 0.7) * (50 + i));
+        sequential.addBody(pos, Vector2D(0, 0), 1.0 + i % 5, 2.0);
+        parallel.addBody(pos, Vector2D(0, 0), 1.0 + i % 5, 2.0);
+    }
+    parallel.setTaskScheduler(&scheduler);
+    for (int s = 0; s < 10; ++s) {
+        sequential.step();
+        parallel.step();
+    }
+    for (size_t i = 0; i < sequential.getBodyCount(); ++i) {
+        Vector2D diff = sequential.getBodies()[i]->getPosition() - parallel.getBodies()[i]->getPosition();
+        assert(diff.magnitude() < 1e-9);
+    }
+    std::cout << "✅ Simulation parallèle identique à la séquentielle" << std::endl;
+}
+
+void testInstrumentation() {
+    std::cout << "Test: Compteurs d'interactions et compteurs matériels..." << std::endl;
+    
+    Simulation sim(50.0, 0.01);
+    sim.setupSolarSystem();
+    size_t n = sim.getBodyCount();
+    
+    // Les compteurs peuvent être indisponibles (VM, conteneur) : la simulation doit continuer
+    PerfCounters counters;
+    if (counters.attachCurrentThread()) {
+        sim.setPerfCounters(&counters);
+    } else {
+        std::cout << "   Compteurs matériels indisponibles: " << counters.getError() << std::endl;
+    }
+    
+    for (int i = 0; i < 10; ++i) {
+        sim.step();
+    }
+    
+    assert(sim.getInteractionCount() == 10 * n * (n - 1) / 2);
+    if (counters.isAvailable()) {
+        assert(sim.getPhaseCounters().steps == 10);
+        assert(sim.getPhaseCounters().interactions == sim.getInteractionCount());
+        PerfCounters::printReport(std::cout, sim.getPhaseCounters(), 0.0);
+    }
+    
+    std::cout << "✅ Instrumentation fonctionnelle" << std::endl;
+}
+
+void testForceLaws() {
+    std::cout << "Test: Lois de force..." << std::endl;
+    
+    // Accélération du corps 1 due au corps 0 (masse 10, G = 1) à la distance d
+    struct Probe {
+        static double acceleration(ForceLaw law, double softening, double d) {
+            Simulation sim(1.0, 0.01, law, softening);
+            sim.addBody(Vector2D(0, 0), Vector2D(0, 0), 10.0, 1.0);
+            sim.addBody(Vector2D(d, 0), Vector2D(0, 0), 1.0, 1.0);
+            sim.calculateForces();
+            return -sim.getBodies()[1]->getAcceleration().x;
+        }
+    };
+    
+    // Loin des corps, toutes les lois retrouvent Newton
+    double newton = 10.0 / (100.0 * 100.0);
+    assert(std::abs(Probe::acceleration(ForceLaw::Newtonian, 0.0, 100.0) - newton) < 1e-12);
+    assert(std::abs(Probe::acceleration(ForceLaw::Clamped, 0.0, 100.0) - newton) < 1e-12);
+    assert(std::abs(Probe::acceleration(ForceLaw::Spline, 1.0, 100.0) - newton) < 1e-12);
+    assert(std::abs(Probe::acceleration(ForceLaw::Plummer, 1.0, 100.0) - newton) / newton < 1e-3);
+    
+    // De près, l'adoucissement borne la force
+    double close = 0.5;
+    double newtonClose = Probe::acceleration(ForceLaw::Newtonian, 0.0, close);
+    assert(std::abs(newtonClose - 10.0 / (close * close)) < 1e-9);
+    assert(Probe::acceleration(ForceLaw::Clamped, 0.0, close) < newtonClose);
+    assert(Probe::acceleration(ForceLaw::Plummer, 1.0, close) < newtonClose);
+    assert(Probe::acceleration(ForceLaw::Spline, 1.0, close) < newtonClose);
+    
+    // Le noyau spline est continu à la frontière u = 1 (r = 2.8 ε)
+    double inside = Probe::acceleration(ForceLaw::Spline, 1.0, 2.8 - 1e-7);
+    double outside = Probe::acceleration(ForceLaw::Spline, 1.0, 2.8 + 1e-7);
+    assert(std::abs(inside - outside) / outside < 1e-5);
+    
+    // La loi historique reproduit Body::calculateGravitationalForce
+    Body a(Vector2D(0, 0), Vector2D(0, 0), 10.0, 1.0);
+    Body b(Vector2D(close, 0), Vector2D(0, 0), 1.0, 1.0);
+    double legacy = a.calculateGravitationalForce(b, 1.0).x / b.getMass();
+    assert(std::abs(Probe::acceleration(ForceLaw::Clamped, 0.0, close) - legacy) < 1e-12);
+    
+    std::cout << "✅ Lois clamped, newton, plummer et spline cohérentes" << std::endl;
+}
+
+void testNeighborList() {
+    std::cout << "Test: Liste de voisins de Verlet..." << std::endl;
+    
+    std::mt19937 gen(7);
+    std::uniform_real_distribution<> coordinate(-100.0, 100.0);
+    BodyArrays arrays;
+    arrays.resize(500);
+    for (size_t i = 0; i < arrays.size(); ++i) {
+        arrays.x[i] = coordinate(gen);
+        arrays.y[i] = coordinate(gen);
+    }
+    
+    const double cutoff = 6.0, skin = 2.0;
+    NeighborList list(cutoff, skin);
+    assert(list.update(arrays));
+    
+    // Mêmes paires que la recherche exhaustive à moins de cutoff + skin
+    size_t bruteForce = 0;
+    for (size_t i = 0; i < arrays.size(); ++i) {
+        for (size_t j = i + 1; j < arrays.size(); ++j) {
+            double dx = arrays.x[j] - arrays.x[i];
+            double dy = arrays.y[j] - arrays.y[i];
+            if (dx * dx + dy * dy < (cutoff + skin) * (cutoff + skin)) {
+                ++bruteForce;
+                bool found = false;
+                for (uint32_t k = list.getOffsets()[i]; k < list.getOffsets()[i + 1]; ++k) {
+                    found = found || list.getNeighbors()[k] == j;
+                }
+                assert(found);
+            }
+        }
+    }
+    assert(list.getPairCount() == bruteForce);
+    
+    // Déplacement inférieur à skin/2 : la liste est conservée
+    for (size_t i = 0; i < arrays.size(); ++i) arrays.x[i] += 0.9;
+    assert(!list.update(arrays));
+    arrays.x[0] += 0.2;
+    assert(list.update(arrays));
+    assert(list.getRebuildCount() == 2 && list.getUpdateCount() == 3);
+    
+    // Deux corps qui se chevauchent sont repoussés
+    Simulation sim(0.0, 0.01);
+    sim.addBody(Vector2D(0, 0), Vector2D(0, 0), 1.0, 5.0);
+    sim.addBody(Vector2D(8, 0), Vector2D(0, 0), 1.0, 5.0);
+    sim.setContactStiffness(10.0);
+    sim.calculateForces();
+    assert(std::abs(sim.getBodies()[0]->getAcceleration().x + 20.0) < 1e-12);
+    assert(std::abs(sim.getBodies()[1]->getAcceleration().x - 20.0) < 1e-12);
+    
+    // Peau par défaut non nulle : la liste de la simulation survit à plusieurs pas
+    Simulation drifting(0.0, 0.01);
+    for (int i = 0; i < 16; ++i) {
+        drifting.addBody(Vector2D(12.0 * i, 0), Vector2D(1.0, 0.5 * (i % 3)), 1.0, 5.0);
+    }
+    drifting.setContactStiffness(10.0);
+    for (int step = 0; step < 50; ++step) {
+        drifting.step();
+    }
+    assert(drifting.getNeighborList().getSkin() == 5.0);
+    assert(drifting.getNeighborList().getRebuildCount() < 10);
+    drifting.setNeighborSkin(0.0);
+    size_t rebuilds = drifting.getNeighborList().getRebuildCount();
+    for (int step = 0; step < 10; ++step) {
+        drifting.step();
+    }
+    assert(drifting.getNeighborList().getSkin() == 0.0);
+    assert(drifting.getNeighborList().getRebuildCount() == rebuilds + 10);
+    
+    std::cout << "✅ Liste de voisins exacte et reconstruite seulement au besoin" << std::endl;
+}
+
+void testThreeDimensions() {
+    std::cout << "Test: Simulation 3D..." << std::endl;
+    
+    // Dans le plan z = 0, la 3D reproduit exactement la 2D
+    Simulation flat(1.0, 0.01, ForceLaw::Plummer, 0.5);
+    Simulation3D space(1.0, 0.01, ForceLaw::Plummer, 0.5);
+    flat.setupBinarySystem();
+    space.setupBinarySystem();
+    for (int i = 0; i < 50; ++i) {
+        flat.step();
+        space.step();
+    }
+    for (size_t i = 0; i < flat.getBodyCount(); ++i) {
+        Vector2D a = flat.getBodies()[i]->getPosition();
+        Vector3D b = space.getBodies()[i]->getPosition();
+        assert(a.x == b.x && a.y == b.y && b.z == 0.0);
+    }
+    
+    // Attraction le long de z, égale et opposée
+    Simulation3D vertical(1.0, 0.01, ForceLaw::Newtonian);
+    vertical.addBody(Vector3D(0, 0, 0), Vector3D(), 10.0, 1.0);
+    vertical.addBody(Vector3D(0, 0, 10), Vector3D(), 10.0, 1.0);
+    vertical.calculateForces();
+    Vector3D a0 = vertical.getBodies()[0]->getAcceleration();
+    Vector3D a1 = vertical.getBodies()[1]->getAcceleration();
+    assert(std::abs(a0.z - 0.1) < 1e-12 && std::abs(a1.z + 0.1) < 1e-12);
+    assert(a0.x == 0.0 && a0.y == 0.0);
+    
+    // Noyau ligne par ligne (parallèle) identique au noyau symétrique
+    Simulation3D sequential(1.0, 0.01, ForceLaw::Spline, 2.0);
+    sequential.setupGalaxyCollision(60);
+    Simulation3D parallel(1.0, 0.01, ForceLaw::Spline, 2.0);
+    for (const auto& body : sequential.getBodies()) {
+        parallel.addBody(body->getPosition(), body->getVelocity(), body->getMass(), body->getRadius());
+    }
+    TaskScheduler scheduler(4);
+    parallel.setTaskScheduler(&scheduler);
+    sequential.calculateForces();
+    parallel.calculateForces();
+    for (size_t i = 0; i < sequential.getBodyCount(); ++i) {
+        Vector3D difference = sequential.getBodies()[i]->getAcceleration() - parallel.getBodies()[i]->getAcceleration();
+        assert(difference.magnitude() < 1e-9);
+    }
+    
+    std::cout << "✅ 3D cohérente avec la 2D, noyaux 3D symétriques et parallèles concordants" << std::endl;
+}
+
+void testEnsemble() {
+    std::cout << "Test: Ensemble de systèmes..." << std::endl;
+    
+    // Problème à trois corps de demonstrateChaos, G et dt différents par système
+    std::vector<std::unique_ptr<Simulation>> references;
+    Ensemble ensemble(3);
+    for (int s = 0; s < 300; ++s) {
+        std::unique_ptr<Simulation> sim(new Simulation(40.0 + s * 0.1, 0.005 + s * 1e-5));
+        sim->addBody(Vector2D(-50, 0), Vector2D(0, 10), 100.0, 10.0);
+        sim->addBody(Vector2D(50, 0), Vector2D(0, -10), 100.0, 10.0);
+        sim->addBody(Vector2D(0, 50), Vector2D(-10, 0), 100.0, 10.0);
+        assert(ensemble.addSystem(*sim));
+        references.push_back(std::move(sim));
+    }
+    
+    // Nombre de corps différent : refusé
+    Simulation binary(1.0, 0.01);
+    binary.setupBinarySystem();
+    assert(!ensemble.addSystem(binary));
+    
+    TaskScheduler scheduler(4);
+    ensemble.setTaskScheduler(&scheduler);
+    std::vector<int> reported(ensemble.getSystemCount(), 0);
+    ensemble.run(200, [&reported](size_t system) { reported[system]++; });
+    
+    for (size_t s = 0; s < references.size(); ++s) {
+        assert(reported[s] == 1);
+        for (int i = 0; i < 200; ++i) references[s]->step();
+        for (size_t k = 0; k < 3; ++k) {
+            Vector2D expected = references[s]->getBodies()[k]->getPosition();
+            Vector2D difference = ensemble.getPosition(s, k) - expected;
+            assert(difference.magnitude() < 1e-9 * (1.0 + expected.magnitude()));
+        }
+    }
+    assert(ensemble.getStepCount() == 200);
+    
+    std::cout << "✅ Ensemble identique aux simulations individuelles" << std::endl;
+}
+
+void testReproducibility() {
+    std::cout << "Test: Graines, leapfrog, énergie et empreinte..." << std::endl;
+    
+    // Même graine, même état ; une graine différente change l'empreinte
+    Simulation a(50.0, 0.01), b(50.0, 0.01), c(50.0, 0.01);
+    a.setRandomSeed(42);
+    b.setRandomSeed(42);
+    c.setRandomSeed(43);
+    a.setupRandomBodies(30, 800, 600);
+    b.setupRandomBodies(30, 800, 600);
+    c.setupRandomBodies(30, 800, 600);
+    for (int i = 0; i < 20; ++i) {
+        a.step();
+        b.step();
+        c.step();
+    }
+    assert(a.computeStateHash() == b.computeStateHash());
+    assert(a.computeStateHash() != c.computeStateHash());
+    
+    // Orbite circulaire : le leapfrog conserve mieux l'énergie qu'Euler
+    double drift[2];
+    for (int k = 0; k < 2; ++k) {
+        Simulation orbit(1.0, 0.05, ForceLaw::Newtonian);
+        orbit.setIntegrator(k == 0 ? Integrator::Euler : Integrator::Leapfrog);
+        orbit.addBody(Vector2D(0, 0), Vector2D(0, 0), 1000.0, 1.0);
+        orbit.addBody(Vector2D(100, 0), Vector2D(0, std::sqrt(10.0)), 1e-6, 1.0);
+        double initial = orbit.computeEnergy();
+        for (int i = 0; i < 2000; ++i) orbit.step();
+        drift[k] = std::abs(orbit.computeEnergy() - initial) / std::abs(initial);
+    }
+    assert(drift[1] < drift[0]);
+    assert(drift[1] < 1e-6);
+    
+    std::cout << "✅ Exécutions reproductibles, dérive d'énergie leapfrog " << drift[1] << std::endl;
+}
+
+void testReproducibleMode() {
+    std::cout << "Test: Mode reproductible..." << std::endl;
+    
+    // Empreintes identiques en séquentiel et sur 2, 3 ou 4 threads
+    std::vector<StateHash> reference;
+    for (unsigned threads = 1; threads <= 4; ++threads) {
+        Simulation sim(50.0, 0.01, ForceLaw::Plummer, 1.0);
+        sim.setRandomSeed(7);
+        sim.setupGalaxyCollision(100);
+        for (size_t i = 0; i < sim.getBodyCount(); i += 4) sim.setParticleClass(i, ParticleClass::Tracer);
+        sim.setReproducible(true);
+        sim.setStateHashInterval(10);
+        
+        TaskScheduler scheduler(threads);
+        if (threads > 1) sim.setTaskScheduler(&scheduler);
+        for (int i = 0; i < 50; ++i) sim.step();
+        
+        const std::vector<StateHash>& hashes = sim.getStateHashes();
+        assert(hashes.size() == 5 && hashes.back().step == 50);
+        if (threads == 1) {
+            reference = hashes;
+        }
+        for (size_t k = 0; k < hashes.size(); ++k) {
+            assert(hashes[k].hash == reference[k].hash);
+        }
+    }
+    
+    // Traceurs : mêmes bits que la ligne reproductible d'un corps de masse nulle placé après
+    // les sources, donc pas de réduction SIMD dont l'ordre suivrait la largeur des vecteurs
+    std::mt19937 generator(12);
+    std::uniform_real_distribution<double> coordinate(-100.0, 100.0);
+    BodyArrays sources, tracers, rows;
+    sources.resize(37, 3);
+    tracers.resize(5, 3);
+    rows.resize(38, 3);
+    for (size_t j = 0; j < 37; ++j) {
+        sources.x[j] = rows.x[j] = coordinate(generator);
+        sources.y[j] = rows.y[j] = coordinate(generator);
+        sources.z[j] = rows.z[j] = coordinate(generator);
+        sources.mass[j] = rows.mass[j] = 1.0 + j % 5;
+        sources.radius[j] = rows.radius[j] = 0.5;
+    }
+    ForceKernels kernels = selectForceKernels<3>(ForceLaw::Plummer);
+    std::vector<double> nearest(5);
+    for (size_t t = 0; t < 5; ++t) {
+        tracers.x[t] = rows.x[37] = coordinate(generator);
+        tracers.y[t] = rows.y[37] = coordinate(generator);
+        tracers.z[t] = rows.z[37] = coordinate(generator);
+        tracers.radius[t] = rows.radius[37] = 0.25;
+        rows.mass[37] = 0.0;
+        kernels.reproducibleRows(rows, 50.0, 1.0, 37, 38);
+        kernels.reproducibleTracers(sources, tracers, 50.0, 1.0, t, t + 1, nearest.data());
+        assert(tracers.ax[t] == rows.ax[37] && tracers.ay[t] == rows.ay[37] && tracers.az[t] == rows.az[37]);
+    }
+    
+    std::cout << "✅ Empreintes identiques de 1 à 4 threads, traceurs compris" << std::endl;
+}
+
+void testTrajectory() {
+    std::cout << "Test: Enregistrement et relecture de trajectoire..." << std::endl;
+    
+    const char* path = "test_trajectory.traj";
+    Simulation3D sim(50.0, 0.01);
+    sim.setRandomSeed(3);
+    sim.setupRandomBodies(12, 800, 600);
+    
+    // Une image tous les 5 pas, état de référence gardé pour comparaison
+    TrajectoryWriter writer;
+    assert(writer.open(path, sim));
+    std::vector<std::vector<Vector3D>> expected;
+    for (int i = 0; i <= 20; ++i) {
+        if (i % 5 == 0) {
+            assert(writer.writeFrame(sim));
+            expected.push_back(std::vector<Vector3D>());
+            for (const auto& body : sim.getBodies()) expected.back().push_back(body->getPosition());
+        }
+        sim.step();
+    }
+    writer.close();
+    
+    TrajectoryReader reader;
+    assert(reader.open(path));
+    assert(reader.getFrameCount() == 5 && reader.getBodyCount() == 12 && reader.getDimension() == 3);
+    
+    // Accès dans le désordre : chaque image est une simple adresse dans le fichier projeté
+    const size_t order[] = {4, 0, 2, 3, 1};
+    for (size_t index : order) {
+        FrameView frame = reader.frame(index);
+        assert(frame.step == 5 * index);
+        for (size_t i = 0; i < frame.bodyCount; ++i) {
+            Vector3D position = frame.position(i);
+            assert(position.x == expected[index][i].x && position.y == expected[index][i].y);
+            assert(position.z == expected[index][i].z);
+            assert(frame.mass[i] == sim.getBodies()[i]->getMass());
+        }
+    }
+    reader.close();
+    
+    // Fichier tronqué au milieu d'une image : seules les images complètes sont relues
+    std::FILE* file = std::fopen(path, "ab");
+    assert(file);
+    double partial[3] = {1.0, 2.0, 3.0};
+    std::fwrite(partial, sizeof(double), 3, file);
+    std::fclose(file);
+    assert(reader.open(path) && reader.getFrameCount() == 5);
+    reader.close();
+    
+    assert(!reader.open("inexistant.traj") && !reader.getError().empty());
+    std::remove(path);
+    
+    std::cout << "✅ 5 images relues à l'identique, fichier tronqué toléré" << std::endl;
+}
+
+void testTrajectoryCompression() {
+    std::cout << "Test: Trajectoire compressée..." << std::endl;
+    
+    const char* path = "test_trajectory_packed.traj";
+    const double tolerance = 1e-4;
+    Simulation sim(50.0, 0.01);
+    sim.setRandomSeed(11);
+    sim.setupGalaxyCollision(100);
+    
+    TrajectoryWriter writer;
+    writer.setCompression(tolerance, 16);
+    assert(writer.open(path, sim));
+    std::vector<std::vector<Vector2D>> expected;
+    for (int i = 0; i < 100; ++i) {
+        assert(writer.writeFrame(sim));
+        expected.push_back(std::vector<Vector2D>());
+        for (const auto& body : sim.getBodies()) expected.back().push_back(body->getPosition());
+        sim.step();
+    }
+    writer.close();
+    assert(writer.getError().empty());
+    
+    // Au moins 10 fois plus petit que les doubles bruts
+    double rawBytes = 100.0 * (sizeof(FrameHeader) + sim.getBodyCount() * 2 * sizeof(double));
+    assert(rawBytes / writer.getFileSize() >= 10.0);
+    
+    TrajectoryReader reader;
+    assert(reader.open(path));
+    assert(reader.isCompressed() && reader.getFrameCount() == 100);
+    
+    // En avant, en arrière, par sauts, à cheval sur les images clés
+    const size_t order[] = {0, 1, 2, 47, 48, 33, 32, 31, 99, 15, 16, 17, 5};
+    for (size_t index : order) {
+        FrameView frame = reader.frame(index);
+        assert(frame.step == index && frame.bodyCount == sim.getBodyCount());
+        
+        double low = 1e300, high = -1e300;
+        for (const Vector2D& position : expected[index]) {
+            low = std::min(low, std::min(position.x, position.y));
+            high = std::max(high, std::max(position.x, position.y));
+        }
+        for (size_t i = 0; i < frame.bodyCount; ++i) {
+            Vector3D position = frame.position(i);
+            assert(std::abs(position.x - expected[index][i].x) <= tolerance * (high - low));
+            assert(std::abs(position.y - expected[index][i].y) <= tolerance * (high - low));
+        }
+    }
+    reader.close();
+    std::remove(path);
+    
+    std::cout << "✅ Erreur sous la tolérance, accès direct, compression x"
+              << rawBytes / writer.getFileSize() << std::endl;
+}
+
+// Requête HTTP minimale, comme curl
+std::string httpGet(int port, const std::string& target) {
+    int client = socket(AF_INET, SOCK_STREAM, 0);
+    assert(client >= 0);
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    assert(connect(client, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0);
+    
+    std::string request = "GET " + target + " HTTP/1.0\r\nHost: localhost\r\n\r\n";
+    assert(send(client, request.data(), request.size(), 0) == static_cast<ssize_t>(request.size()));
+    std::string response;
+    char buffer[4096];
+    ssize_t received;
+    while ((received = recv(client, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<size_t>(received));
+    }
+    close(client);
+    return response;
+}
+
+void testTelemetry() {
+    std::cout << "Test: Télémétrie..." << std::endl;
+    
+    TelemetryMetrics metrics;
+    metrics.energyInterval = 5;
+    Simulation sim(50.0, 0.01);
+    sim.setRandomSeed(2);
+    sim.setupGalaxyCollision(30);
+    sim.setTelemetry(&metrics);
+    for (int i = 0; i < 10; ++i) sim.step();
+    
+    assert(metrics.steps.load() == 10);
+    assert(metrics.bodies.load() == sim.getBodyCount());
+    assert(metrics.stepNanoseconds.load() >= metrics.forceNanoseconds.load() + metrics.diagnosticsNanoseconds.load());
+    assert(metrics.diagnosticsNanoseconds.load() > 0);
+    assert(metrics.energy.load() == sim.computeEnergy());
+    
+    // Port choisi par le système : pas de conflit avec un autre service
+    TelemetryServer server(metrics);
+    assert(server.listenTcp(0) && server.getPort() > 0);
+    std::string page = httpGet(server.getPort(), "/metrics");
+    assert(page.compare(0, 15, "HTTP/1.0 200 OK") == 0);
+    assert(page.find("\nnbody_steps_total 10\n") != std::string::npos);
+    assert(page.find("nbody_bodies " + std::to_string(sim.getBodyCount())) != std::string::npos);
+    assert(page.find("nbody_phase_seconds_total{phase=\"forces\"}") != std::string::npos);
+    assert(page.find("nbody_phase_seconds_total{phase=\"diagnostics\"}") != std::string::npos);
+    assert(page.find("nbody_steps_per_second") == std::string::npos);
+    assert(page.find("nbody_energy_drift ") != std::string::npos);
+    assert(httpGet(server.getPort(), "/autre").find("404") != std::string::npos);
+    server.stop();
+    
+    std::cout << "✅ Page de métriques servie sur 127.0.0.1" << std::endl;
+}
+
+void testSelection() {
+    std::cout << "Test: Sélection d'un corps..." << std::endl;
+    
+    // Plus proche voisin comparé à un parcours linéaire, y compris hors de la grille
+    std::mt19937 gen(5);
+    std::uniform_real_distribution<> coordinate(-500.0, 500.0);
+    std::vector<Vector2D> points(2000);
+    for (auto& p : points) p = Vector2D(coordinate(gen), coordinate(gen) * 0.2);
+    points[7] = Vector2D(NAN, NAN); // Corps invisible
+    
+    SpatialIndex index;
+    index.build(points);
+    std::uniform_real_distribution<> query(-700.0, 700.0);
+    for (int q = 0; q < 500; ++q) {
+        Vector2D target(query(gen), query(gen));
+        double radius = (q % 2 == 0) ? 1e9 : 15.0;
+        size_t expected = SpatialIndex::NONE;
+        double bestDistance = radius;
+        for (size_t i = 0; i < points.size(); ++i) {
+            double distance = (points[i] - target).magnitude();
+            if (distance <= bestDistance) {
+                bestDistance = distance;
+                expected = i;
+            }
+        }
+        size_t found = index.nearest(target, radius);
+        assert(found == expected || (found != SpatialIndex::NONE && expected != SpatialIndex::NONE
+                                     && (points[found] - target).magnitude() == bestDistance));
+    }
+    
+    // Orbite circulaire autour d'une masse dominante : e = 0, a = r, T = 2 pi sqrt(r³ / mu)
+    Simulation sim(1.0, 0.01);
+    sim.addBody(Vector2D(0, 0), Vector2D(0, 0), 1000.0, 10.0);
+    double speed = std::sqrt(1.0 * 1001.0 / 100.0);
+    sim.addBody(Vector2D(100, 0), Vector2D(0, speed), 1.0, 2.0);
+    sim.addBody(Vector2D(-400, 0), Vector2D(0, 0), 1.0, 2.0);
+    OrbitalElements orbit = computeOrbitalElements(sim, 1);
+    assert(orbit.attractor == 0 && orbit.bound);
+    assert(std::abs(orbit.eccentricity) < 1e-12);
+    assert(std::abs(orbit.semiMajorAxis - 100.0) < 1e-9);
+    assert(std::abs(orbit.period - 2 * M_PI * std::sqrt(1e6 / 1001.0)) < 1e-9);
+    
+    std::cout << "✅ Plus proche voisin exact, éléments orbitaux d'une orbite circulaire" << std::endl;
+}
+
+void testCamera() {
+    std::cout << "Test: Caméra et centre de masse..." << std::endl;
+    
+    // Centre de masse tenu à jour sans parcours, comparé au calcul direct ; avec
+    // l'arbre et les contacts, Σ m a n'est pas nul et la quantité de mouvement varie
+    SolverConfig approximate;
+    approximate.kind = SolverKind::Tree;
+    approximate.openingAngle = 0.8;
+    for (int scheme = 0; scheme < 4; ++scheme) {
+        Simulation sim(1.0, 0.01);
+        sim.setRandomSeed(11);
+        sim.setupGalaxyCollision(30);
+        sim.setIntegrator(scheme % 2 == 0 ? Integrator::Euler : Integrator::Leapfrog);
+        if (scheme >= 2) {
+            sim.setSolver(approximate);
+            sim.setContactStiffness(50.0);
+        }
+        for (int i = 0; i < 200; ++i) sim.step();
+        
+        Vector2D incremental = sim.getCenterOfMass();
+        Vector2D carried = sim.getTotalMomentum();
+        sim.recomputeCenterOfMass();
+        Vector2D direct = sim.getCenterOfMass();
+        Vector2D actual = sim.getTotalMomentum();
+        assert((incremental - direct).magnitude() < 1e-6 * (1.0 + direct.magnitude()));
+        assert((carried - actual).magnitude() < 1e-6 * (1.0 + actual.magnitude()));
+    }
+    
+    // Zoom au curseur : le point sous le curseur reste fixe pendant toute l'animation
+    Camera camera(0.1);
+    camera.reset(Vector2D(50, -20), 2.0);
+    Vector2D cursor(120, -80);
+    Vector2D anchor = camera.screenToWorld(cursor);
+    camera.zoomAt(1.1 * 1.1 * 1.1, cursor);
+    for (int frame = 0; frame < 60; ++frame) {
+        camera.update(1.0 / 60.0);
+        assert((camera.screenToWorld(cursor) - anchor).magnitude() < 1e-9);
+    }
+    assert(std::abs(camera.getZoom() - 2.0 * 1.331) < 1e-3);
+    
+    // Déplacements cumulés, zoom conservé ; le suivi rejoint la cible
+    camera.update(0.0);
+    Vector2D before = camera.getTargetOffset();
+    camera.pan(10, 0);
+    camera.pan(10, 0);
+    assert(std::abs(camera.getTargetOffset().x - before.x - 20.0 / camera.getTargetZoom()) < 1e-12);
+    camera.update(0.0);
+    assert(std::abs(camera.getZoom() - camera.getTargetZoom()) < 1e-12);
+    
+    camera.setMode(CameraMode::CenterOfMass);
+    for (int frame = 0; frame < 120; ++frame) {
+        camera.track(Vector2D(300, 400));
+        camera.update(1.0 / 60.0);
+    }
+    assert((camera.getOffset() - Vector2D(300, 400)).magnitude() < 1e-2);
+    camera.pan(1, 0);
+    assert(camera.getMode() == CameraMode::Free);
+    
+    std::cout << "✅ Centre de masse incrémental exact, zoom ancré au curseur" << std::endl;
+}
+
+void testOffscreenRenderer() {
+    std::cout << "Test: Rendu sans fenêtre..." << std::endl;
+    
+    Simulation sim(50.0, 0.01);
+    sim.setRandomSeed(3);
+    sim.setupGalaxyCollision(200);
+    
+    // Plusieurs tuiles, bords partiels : même image quel que soit le nombre de threads
+    OffscreenRenderer serial(200, 150);
+    OffscreenRenderer parallel(200, 150);
+    TaskScheduler scheduler(4);
+    parallel.setTaskScheduler(&scheduler);
+    for (OffscreenRenderer* renderer : {&serial, &parallel}) {
+        renderer->setTrailPersistence(0.8);
+        renderer->fitCamera(renderer->stageFrame(sim));
+    }
+    for (int frame = 0; frame < 3; ++frame) {
+        serial.renderSimulation(sim);
+        parallel.renderSimulation(sim);
+        for (int i = 0; i < 20; ++i) sim.step();
+    }
+    assert(serial.getPixels() == parallel.getPixels());
+    
+    // Étoile centrale d'une galaxie éclairée, coin vide noir
+    Vector2D center = serial.getCameraCenter();
+    const Body& star = *sim.getBodies()[0];
+    int x = static_cast<int>((star.getPosition().x - center.x) * serial.getZoom() + 100);
+    int y = static_cast<int>((star.getPosition().y - center.y) * serial.getZoom() + 75);
+    assert(x >= 0 && x < 200 && y >= 0 && y < 150);
+    assert(serial.getPixels()[(y * 200 + x) * 3] > 200);
+    assert(serial.getPixels()[0] == 0);
+    
+    // Fichiers : en-têtes PNG et PPM, numérotation
+    const char* pngPath = "test_offscreen.png";
+    const char* ppmPath = "test_offscreen.ppm";
+    assert(serial.writeImage(pngPath) && serial.writeImage(ppmPath));
+    assert(!serial.writeImage("test_offscreen.bmp"));
+    unsigned char signature[8] = {0};
+    std::FILE* file = std::fopen(pngPath, "rb");
+    assert(file && std::fread(signature, 1, 8, file) == 8);
+    std::fclose(file);
+    assert(signature[0] == 0x89 && signature[1] == 'P' && signature[2] == 'N' && signature[3] == 'G');
+    char magic[3] = {0};
+    int w = 0, h = 0;
+    file = std::fopen(ppmPath, "rb");
+    assert(file && std::fscanf(file, "%2s %d %d", magic, &w, &h) == 3);
+    std::fclose(file);
+    assert(std::string(magic) == "P6" && w == 200 && h == 150);
+    std::remove(pngPath);
+    std::remove(ppmPath);
+    
+    assert(OffscreenRenderer::framePath("img_%05d.png", 42) == "img_00042.png");
+    assert(OffscreenRenderer::framePath("out/img.ppm", 7) == "out/img_000007.ppm");
+    
+    std::cout << "✅ Image identique sur 1 et 4 threads, PNG et PPM valides" << std::endl;
+}
+
+void testScene() {
+    std::cout << "Test: Fichier de scène..." << std::endl;
+    
+    // Aller-retour exact en CSV (%.17g) et en binaire, en-tête compris
+    Simulation3D original(2.5, 0.004, ForceLaw::Plummer, 0.75);
+    original.setIntegrator(Integrator::Leapfrog);
+    original.setRandomSeed(9);
+    original.setupRandomBodies(40000, 800, 600);
+    for (int binary = 0; binary < 2; ++binary) {
+        const char* path = binary ? "test_scene_binary.scene" : "test_scene.scene";
+        SceneWriter writer;
+        assert(writer.write(path, original, binary == 1));
+        
+        SceneLoader loader;
+        assert(loader.open(path));
+        const SceneSettings& settings = loader.getSettings();
+        assert(settings.dimension == 3 && settings.gravitationalConstant == 2.5 && settings.timeStep == 0.004);
+        assert(settings.forceLaw == ForceLaw::Plummer && settings.softening == 0.75);
+        assert(settings.integrator == Integrator::Leapfrog);
+        
+        // Table de plusieurs blocs analysés en parallèle
+        TaskScheduler scheduler(4);
+        std::unique_ptr<Simulation3D> loaded;
+        settings.configure(loaded);
+        assert(loader.load(*loaded, &scheduler));
+        assert(loaded->getBodyCount() == original.getBodyCount());
+        assert(loaded->computeStateHash() == original.computeStateHash());
+        assert(std::abs(loaded->getTotalMass() - original.getTotalMass()) < 1e-9 * original.getTotalMass());
+        
+        Simulation flat;
+        assert(!loader.load(flat)); // Dimension différente
+        std::remove(path);
+    }
+    
+    // Table en ligne écrite à la main : séparateurs variés, rayon facultatif, nombres décimaux exacts,
+    // masse nulle pour un traceur
+    const char* path = "test_scene_text.scene";
+    std::FILE* file = std::fopen(path, "w");
+    std::fputs("# Deux corps\nnbody-scene 1\nG 50\nbodies 4\ndata csv\n"
+               "x,y,vx,vy,mass,radius\n"
+               "0.1, -2.5e-3, 0, 0, 1000, 10\n"
+               "\n# planète\n"
+               "100 0 0 22.36 1\n"
+               "-7.25;3;1e2;0;0.5;2\n"
+               "+0.12345678901234567,1e-30,0,0,0\n", file);
+    std::fclose(file);
+    SceneLoader loader;
+    assert(loader.open(path));
+    Simulation sim;
+    assert(loader.load(sim));
+    assert(sim.getBodyCount() == 4);
+    assert(sim.getBodies()[0]->getPosition().x == 0.1 && sim.getBodies()[0]->getPosition().y == -2.5e-3);
+    assert(sim.getBodies()[1]->getVelocity().y == 22.36 && sim.getBodies()[1]->getRadius() == 5.0);
+    assert(sim.getBodies()[2]->getPosition().x == -7.25 && sim.getBodies()[2]->getVelocity().x == 100.0);
+    assert(sim.getBodies()[3]->isTracer() && sim.getTotalMass() == 1001.5);
+    assert(sim.getBodies()[3]->getPosition().x == 0.12345678901234567 && sim.getBodies()[3]->getPosition().y == 1e-30);
+    
+    // Erreur localisée à la ligne fautive
+    file = std::fopen(path, "w");
+    std::fputs("nbody-scene 1\ndata csv\n1,2,3,4,5\n1,2,trois,4,5\n", file);
+    std::fclose(file);
+    assert(loader.open(path));
+    assert(!loader.load(sim));
+    assert(loader.getError().find(":4:") != std::string::npos);
+    
+    file = std::fopen(path, "w");
+    std::fputs("nbody-scene 1\ngravity 50\ndata csv\n", file);
+    std::fclose(file);
+    assert(!loader.open(path));
+    
+    // Solveur : relu dans la forme de describe(), réécrit tel qu'actif
+    file = std::fopen(path, "w");
+    std::fputs("nbody-scene 1\nsolver tree theta=0.3 leaf=8 threads=1\ndata csv\n0,0,0,0,1\n", file);
+    std::fclose(file);
+    assert(loader.open(path));
+    std::unique_ptr<Simulation> solved;
+    loader.getSettings().configure(solved);
+    assert(solved->getSolver().kind == SolverKind::Tree && solved->getSolver().openingAngle == 0.3);
+    assert(solved->getSolver().leafSize == 8 && solved->getSolver().threads == 1 && !solved->isAutotuning());
+    assert(loader.load(*solved));
+    SceneWriter solverWriter;
+    assert(solverWriter.write(path, *solved));
+    assert(loader.open(path) && loader.getSettings().solver.describe() == solved->getSolver().describe());
+    solved->setAutotuning(true);
+    assert(solverWriter.write(path, SceneSnapshot::capture(*solved)));
+    assert(loader.open(path) && loader.getSettings().autotune);
+    SolverConfig parsed;
+    assert(parseSolverConfig("direct", parsed) && parsed.kind == SolverKind::Pairwise);
+    assert(parseSolverConfig("blocked tile=512", parsed) && parsed.tileSize == 512);
+    assert(!parseSolverConfig("tree theta=abc", parsed) && !parseSolverConfig("fmm", parsed));
+    assert(!parseSolverConfig("tree depth=3", parsed));
+    file = std::fopen(path, "w");
+    std::fputs("nbody-scene 1\nsolver fmm\ndata csv\n", file);
+    std::fclose(file);
+    assert(!loader.open(path));
+    std::remove(path);
+    
+    std::cout << "✅ Scènes CSV et binaires relues à l'identique, erreurs localisées" << std::endl;
+}
+
+void testTracers() {
+    std::cout << "Test: Traceurs et gel..." << std::endl;
+    
+    // Les traceurs ne perturbent pas les sources : trajectoires identiques bit à bit
+    Simulation massive(50.0, 0.01);
+    Simulation ring(50.0, 0.01);
+    massive.setIntegrator(Integrator::Leapfrog);
+    ring.setIntegrator(Integrator::Leapfrog);
+    massive.setupBinarySystem();
+    ring.setupBinarySystem();
+    for (int i = 0; i < 200; ++i) {
+        double angle = 2.0 * M_PI * i / 200;
+        ring.addBody(Vector2D(400 * std::cos(angle), 400 * std::sin(angle)),
+                     Vector2D(-std::sin(angle), std::cos(angle)) * 10.0, 1.0, 1.0, ParticleClass::Tracer);
+    }
+    assert(ring.getTotalMass() == massive.getTotalMass());
+    TaskScheduler scheduler(4);
+    ring.setTaskScheduler(&scheduler);
+    for (int step = 0; step < 100; ++step) {
+        massive.step();
+        ring.step();
+    }
+    for (size_t i = 0; i < massive.getBodyCount(); ++i) {
+        assert(ring.getBodies()[i]->getPosition().x == massive.getBodies()[i]->getPosition().x);
+        assert(ring.getBodies()[i]->getVelocity().y == massive.getBodies()[i]->getVelocity().y);
+    }
+    assert(ring.getSourceCount() == 4);
+    
+    // S(S-1)/2 + T*S interactions au lieu de N(N-1)/2
+    uint64_t before = ring.getInteractionCount();
+    ring.calculateForces();
+    assert(ring.getInteractionCount() - before == 6 + 200 * 4);
+    
+    // Accélération d'un traceur : celle d'un corps massif de masse nulle au même endroit
+    Simulation probe(50.0, 0.01);
+    for (size_t i = 0; i < 4; ++i) {
+        const Body& body = *ring.getBodies()[i];
+        probe.addBody(body.getPosition(), body.getVelocity(), body.getMass(), body.getRadius());
+    }
+    const Body& tracer = *ring.getBodies()[17];
+    probe.addBody(tracer.getPosition(), tracer.getVelocity(), 0.0, tracer.getRadius());
+    probe.calculateForces();
+    Vector2D expected = probe.getBodies()[4]->getAcceleration();
+    assert((tracer.getAcceleration() - expected).magnitude() < 1e-12 * expected.magnitude());
+    
+    // Gel : un traceur lointain dérive en ligne droite, puis est réévalué quand une source approche
+    Simulation debris(1.0, 0.1);
+    debris.addBody(Vector2D(0, 0), Vector2D(20, 0), 1000.0, 5.0);
+    debris.addBody(Vector2D(1000, 0), Vector2D(0, 1), 0.0, 1.0, ParticleClass::Tracer);
+    debris.setFreezeDistance(500.0);
+    bool wasFrozen = false;
+    for (int step = 0; step < 400; ++step) {
+        debris.step();
+        const Body& particle = *debris.getBodies()[1];
+        double distance = (particle.getPosition() - debris.getBodies()[0]->getPosition()).magnitude();
+        // Gel décidé au calcul des forces, avant la dérive : à un pas (2.1) près
+        assert(!particle.isFrozen() || distance > 500.0 - 2.1);
+        if (step == 100) {
+            wasFrozen = particle.isFrozen();
+            assert(particle.getPosition().x == 1000.0 && particle.getVelocity().x == 0.0);
+        }
+    }
+    assert(wasFrozen && debris.getFrozenCount() == 0);
+    assert(debris.getBodies()[1]->getVelocity().x < 0.0);
+    
+    std::cout << "✅ Traceurs sans effet sur les sources, gelés seulement loin de toute source" << std::endl;
+}
+
+void testBinaries() {
+    std::cout << "Test: Paires serrées régularisées..." << std::endl;
+    
+    // Binaire circulaire isolée : orbite exacte avec un pas de 1/9 de période
+    Simulation circular(1.0, 0.5, ForceLaw::Newtonian);
+    circular.setIntegrator(Integrator::Leapfrog);
+    circular.addBody(Vector2D(-0.5, 0), Vector2D(0, -std::sqrt(0.5)), 1.0, 0.01);
+    circular.addBody(Vector2D(0.5, 0), Vector2D(0, std::sqrt(0.5)), 1.0, 0.01);
+    circular.setBinaryRadius(3.0);
+    for (int step = 0; step < 200; ++step) {
+        circular.step();
+    }
+    assert(circular.getBinaryCount() == 1);
+    Vector2D separation = circular.getBodies()[1]->getPosition() - circular.getBodies()[0]->getPosition();
+    double phase = std::sqrt(2.0) * 100.0;
+    assert(std::abs(separation.x - std::cos(phase)) < 1e-8 && std::abs(separation.y - std::sin(phase)) < 1e-8);
+    assert((circular.getBodies()[0]->getPosition() + circular.getBodies()[1]->getPosition()).magnitude() < 1e-9);
+    
+    // Triple hiérarchique : la marée du troisième corps suit la rotation de la paire
+    double outer = std::sqrt(3.0 / 30.0);
+    Simulation regularized(1.0, 0.5, ForceLaw::Newtonian);
+    Simulation direct(1.0, 0.5, ForceLaw::Newtonian);
+    for (Simulation* sim : {&regularized, &direct}) {
+        sim->setIntegrator(Integrator::Leapfrog);
+        sim->addBody(Vector2D(-0.5, 0), Vector2D(0, -std::sqrt(0.5) - outer / 3), 1.0, 0.01);
+        sim->addBody(Vector2D(0.5, 0), Vector2D(0, std::sqrt(0.5) - outer / 3), 1.0, 0.01);
+        sim->addBody(Vector2D(30, 0), Vector2D(0, 2 * outer / 3), 1.0, 0.01);
+    }
+    regularized.setBinaryRadius(3.0);
+    double initialEnergy = direct.computeEnergy();
+    for (int step = 0; step < 200; ++step) {
+        regularized.step();
+        direct.step();
+    }
+    assert(regularized.getBinaryCount() == 1);
+    double regularizedError = std::abs(regularized.computeEnergy() / initialEnergy - 1.0);
+    double directError = std::abs(direct.computeEnergy() / initialEnergy - 1.0);
+    assert(regularizedError < 1e-6 && regularizedError < 1e-3 * directError);
+    assert(regularized.getTotalMomentum().magnitude() < 1e-12);
+    
+    // Perturbateur de passage : paire formée loin de lui, dissoute quand sa marée dépasse 1 %
+    Simulation encounter(1.0, 0.01, ForceLaw::Newtonian);
+    encounter.setIntegrator(Integrator::Leapfrog);
+    encounter.addBody(Vector2D(-0.5, 0), Vector2D(0, -std::sqrt(0.5)), 1.0, 0.01);
+    encounter.addBody(Vector2D(0.5, 0), Vector2D(0, std::sqrt(0.5)), 1.0, 0.01);
+    encounter.addBody(Vector2D(10, 100), Vector2D(0, -20), 100.0, 0.01);
+    encounter.setBinaryRadius(3.0);
+    encounter.step();
+    assert(encounter.getBinaryCount() == 1);
+    bool dissolved = false;
+    for (int step = 0; step < 500; ++step) {
+        encounter.step();
+        Vector2D center = (encounter.getBodies()[0]->getPosition() + encounter.getBodies()[1]->getPosition()) * 0.5;
+        double distance = (encounter.getBodies()[2]->getPosition() - center).magnitude();
+        if (distance < 15.0) {
+            dissolved = dissolved || encounter.getBinaryCount() == 0;
+            assert(encounter.getBinaryCount() == 0 || !dissolved);
+        }
+    }
+    assert(dissolved && std::isfinite(encounter.getBodies()[0]->getPosition().x));
+    
+    // Dans le champ d'un voisin massif, la paire n'est pas formée
+    Simulation crowded(1.0, 0.01, ForceLaw::Newtonian);
+    crowded.addBody(Vector2D(-0.5, 0), Vector2D(0, -std::sqrt(0.5)), 1.0, 0.01);
+    crowded.addBody(Vector2D(0.5, 0), Vector2D(0, std::sqrt(0.5)), 1.0, 0.01);
+    crowded.addBody(Vector2D(0, 6), Vector2D(0, 0), 100.0, 0.01);
+    crowded.setBinaryRadius(3.0);
+    crowded.step();
+    assert(crowded.getBinaryCount() == 0);
+    
+    // Plummer adouci : force non képlérienne, jamais régularisée
+    Simulation softened(1.0, 0.5, ForceLaw::Plummer, 0.1);
+    softened.addBody(Vector2D(-0.5, 0), Vector2D(0, -std::sqrt(0.5)), 1.0, 0.01);
+    softened.addBody(Vector2D(0.5, 0), Vector2D(0, std::sqrt(0.5)), 1.0, 0.01);
+    softened.setBinaryRadius(3.0);
+    softened.step();
+    assert(softened.getBinaryCount() == 0);
+    
+    std::cout << "✅ Binaires exactes sans perturbation, dissoutes sous forte marée" << std::endl;
+}
+
+void testPipeline() {
+    std::cout << "Test: Mode pipeliné..." << std::endl;
+    
+    TaskScheduler scheduler(4);
+    
+    // Intégration fusionnée aux blocs de forces : trajectoires identiques bit à bit
+    for (Integrator scheme : {Integrator::Euler, Integrator::Leapfrog}) {
+        Simulation reference(50.0, 0.01);
+        Simulation pipelined(50.0, 0.01);
+        for (Simulation* sim : {&reference, &pipelined}) {
+            sim->setRandomSeed(7);
+            sim->setupGalaxyCollision(150);
+            sim->setIntegrator(scheme);
+            sim->setTaskScheduler(&scheduler);
+            sim->setStateHashInterval(5);
+            // Une étoile sur deux en traceur, et quelques traceurs lointains gelés
+            for (size_t i = 1; i < sim->getBodyCount(); i += 2) {
+                sim->setParticleClass(i, ParticleClass::Tracer);
+            }
+            for (int k = 0; k < 5; ++k) {
+                sim->addBody(Vector2D(3000.0 + 10.0 * k, 0), Vector2D(0, 1), 0.0, 1.0, ParticleClass::Tracer);
+            }
+            sim->setFreezeDistance(500.0);
+        }
+        pipelined.setPipelined(true);
+        for (int step = 0; step < 40; ++step) {
+            reference.step();
+            pipelined.step();
+        }
+        assert(pipelined.computeStateHash() == reference.computeStateHash());
+        assert(pipelined.getFrozenCount() == reference.getFrozenCount() && reference.getFrozenCount() == 5);
+        assert(reference.getSourceCount() >= 64);
+        
+        // Dernière empreinte calculée pendant le pas suivant : visible après finishPipeline()
+        assert(pipelined.getStateHashes().size() + 1 == reference.getStateHashes().size());
+        pipelined.finishPipeline();
+        assert(pipelined.getStateHashes().size() == reference.getStateHashes().size());
+        for (size_t k = 0; k < reference.getStateHashes().size(); ++k) {
+            assert(pipelined.getStateHashes()[k].step == reference.getStateHashes()[k].step);
+            assert(pipelined.getStateHashes()[k].hash == reference.getStateHashes()[k].hash);
+        }
+    }
+    
+    // Énergie de télémétrie calculée sur la copie figée du dernier pas
+    Simulation observed(50.0, 0.01);
+    observed.setRandomSeed(3);
+    observed.setupGalaxyCollision(100);
+    observed.setTaskScheduler(&scheduler);
+    observed.setPipelined(true);
+    TelemetryMetrics metrics;
+    metrics.energyInterval = 1;
+    observed.setTelemetry(&metrics);
+    for (int step = 0; step < 10; ++step) {
+        observed.step();
+    }
+    observed.finishPipeline();
+    assert(metrics.energy.load() == observed.computeEnergy());
+    
+    // Travail recouvert par le pas suivant, attendu à sa fin
+    int done = 0;
+    observed.overlapNextStep([&done]() { done = 1; });
+    observed.step();
+    assert(done == 1);
+    
+    // Contact mou : deux phases conservées, même résultat
+    Simulation touching(50.0, 0.01);
+    Simulation touchingPipelined(50.0, 0.01);
+    for (Simulation* sim : {&touching, &touchingPipelined}) {
+        sim->setRandomSeed(11);
+        sim->setupRandomBodies(200, 400, 300);
+        sim->setTaskScheduler(&scheduler);
+        sim->setContactStiffness(5.0);
+    }
+    touchingPipelined.setPipelined(true);
+    for (int step = 0; step < 20; ++step) {
+        touching.step();
+        touchingPipelined.step();
+    }
+    assert(touching.computeStateHash() == touchingPipelined.computeStateHash());
+    
+    std::cout << "✅ Pipeline identique bit à bit, diagnostics sur l'état du pas précédent" << std::endl;
+}
+
+// Plus grand écart de position rapporté à la taille du système
+template <int D>
+double maxPositionError(const SimulationT<D>& expected, const SimulationT<D>& actual) {
+    double error = 0.0, extent = 0.0;
+    for (size_t i = 0; i < expected.getBodyCount(); ++i) {
+        Vector<D> p = expected.getBodies()[i]->getPosition();
+        Vector<D> d = actual.getBodies()[i]->getPosition() - p;
+        error = std::max(error, std::sqrt(d.dot(d)));
+        extent = std::max(extent, std::sqrt(p.dot(p)));
+    }
+    return error / extent;
+}
+
+void testOutOfCore() {
+    std::cout << "Test: Simulation hors mémoire par tuiles..." << std::endl;
+    
+    const char* path = "test_out_of_core.bodies";
+    const char* serialPath = "test_out_of_core_serial.bodies";
+    TaskScheduler scheduler(4);
+    
+    // Tuiles de 32 corps (une page chacune) : 10 tuiles, blocs de 3 dans ce budget
+    const size_t budget = 2 * 4096 + 4 * 32 * 6 * sizeof(double);
+    for (Integrator scheme : {Integrator::Euler, Integrator::Leapfrog}) {
+        Simulation reference(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        reference.setRandomSeed(5);
+        reference.setupRandomBodies(300, 800, 600);
+        reference.setIntegrator(scheme);
+        reference.setTaskScheduler(&scheduler);
+        
+        OutOfCoreSimulation streamed(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        streamed.setIntegrator(scheme);
+        streamed.setTaskScheduler(&scheduler);
+        assert(streamed.create(path, reference, budget, 32));
+        assert(streamed.getTileCount() == 10 && streamed.getBlockTiles() == 3);
+        assert(streamed.getResidentBytes() <= budget);
+        assert(streamed.computeStateHash() == reference.computeStateHash());
+        assert(std::abs(streamed.computeEnergy() - reference.computeEnergy()) < 1e-12 * std::abs(reference.computeEnergy()));
+        
+        // Sans threads : chaque paire une fois, réactions accumulées dans le fichier
+        OutOfCoreSimulation serial(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        serial.setIntegrator(scheme);
+        assert(serial.create(serialPath, reference, budget, 32));
+        
+        for (int step = 0; step < 30; ++step) {
+            reference.step();
+            streamed.step();
+            serial.step();
+        }
+        assert(streamed.getStepCount() == 30);
+        const OutOfCoreStats& stats = streamed.getStats();
+        assert(stats.steps == 30 && stats.bytesRead > 0 && stats.bytesWritten > 0 && stats.getThroughput() > 0.0);
+        
+        // Même trajectoire aux arrondis de sommation près
+        Simulation exported(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        assert(streamed.exportTo(exported));
+        assert(exported.getBodyCount() == reference.getBodyCount());
+        assert(maxPositionError(reference, exported) < 1e-9);
+        assert(exported.computeStateHash() == streamed.computeStateHash());
+        Simulation exportedSerial(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        assert(serial.exportTo(exportedSerial));
+        assert(maxPositionError(reference, exportedSerial) < 1e-9);
+        assert(std::abs(streamed.computeEnergy() - exported.computeEnergy()) < 1e-12 * std::abs(exported.computeEnergy()));
+        
+        // Reprise du fichier : même état, pas compris
+        uint64_t hash = streamed.computeStateHash();
+        streamed.close();
+        OutOfCoreSimulation resumed(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        resumed.setIntegrator(scheme);
+        assert(resumed.open(path, budget));
+        assert(resumed.getStepCount() == 30 && resumed.computeStateHash() == hash);
+        for (int step = 0; step < 10; ++step) {
+            reference.step();
+            resumed.step();
+        }
+        assert(resumed.exportTo(exported));
+        assert(maxPositionError(reference, exported) < 1e-9);
+    }
+    
+    // 3D, budget plus large que les corps : un seul bloc
+    Simulation3D reference3D(50.0, 0.01, ForceLaw::Spline, 3.0);
+    reference3D.setRandomSeed(2);
+    reference3D.setupRandomBodies(100, 800, 600);
+    OutOfCoreSimulation3D streamed3D(50.0, 0.01, ForceLaw::Spline, 3.0);
+    assert(streamed3D.create(path, reference3D, 1 << 20, 16));
+    assert(streamed3D.getBlockTiles() == streamed3D.getTileCount());
+    for (int step = 0; step < 20; ++step) {
+        reference3D.step();
+        streamed3D.step();
+    }
+    Simulation3D exported3D(50.0, 0.01, ForceLaw::Spline, 3.0);
+    assert(streamed3D.exportTo(exported3D));
+    assert(maxPositionError(reference3D, exported3D) < 1e-9);
+    
+    // Budget sous une tuile, dimension différente, traceurs : refus explicites
+    OutOfCoreSimulation3D tight(50.0, 0.01);
+    assert(!tight.create(path, reference3D, 4096, 16) && !tight.getError().empty());
+    OutOfCoreSimulation flat(50.0, 0.01);
+    assert(!flat.open(path, 1 << 20) && !flat.getError().empty());
+    reference3D.setParticleClass(0, ParticleClass::Tracer);
+    assert(!tight.create(path, reference3D, 1 << 20, 16));
+    std::remove(path);
+    std::remove(serialPath);
+    
+    std::cout << "✅ Tuiles en flux sous budget, trajectoire et empreinte du calcul en mémoire" << std::endl;
+}
+
+void testDecomposition() {
+    std::cout << "Test: Décomposition de domaine sur plusieurs processus..." << std::endl;
+    
+    for (Integrator scheme : {Integrator::Euler, Integrator::Leapfrog}) {
+        Simulation reference(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        reference.setRandomSeed(4);
+        reference.setupRandomBodies(300, 800, 600);
+        reference.setIntegrator(scheme);
+        
+        // Tolérance nulle : rééquilibrage à chaque évaluation, tous les 5 pas
+        DecomposedSimulation split(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        split.setIntegrator(scheme);
+        split.setRebalancing(5, 0.0);
+        assert(split.start(reference, 3));
+        assert(split.isRunning() && split.getProcessCount() == 3 && split.getBodyCount() == 300);
+        assert(split.computeStateHash() == reference.computeStateHash());
+        assert(split.computeEnergy() == reference.computeEnergy());
+        
+        for (int step = 0; step < 20; ++step) {
+            reference.step();
+            split.step();
+        }
+        assert(split.isRunning() && split.getStepCount() == 20);
+        assert(split.getRebalanceCount() > 0 && split.getImbalance() >= 1.0);
+        
+        // Tranches contiguës couvrant tous les corps, masses conservées
+        std::vector<DomainSummary> domains = split.getDomains();
+        assert(domains.size() == 3 && domains.front().begin == 0 && domains.back().end == 300);
+        double totalMass = 0.0;
+        for (size_t r = 0; r < domains.size(); ++r) {
+            if (r > 0) assert(domains[r].begin == domains[r - 1].end);
+            totalMass += domains[r].mass;
+        }
+        double expectedMass = 0.0;
+        for (const auto& body : reference.getBodies()) expectedMass += body->getMass();
+        assert(std::abs(totalMass - expectedMass) < 1e-9 * expectedMass);
+        
+        Simulation exported(50.0, 0.01, ForceLaw::Plummer, 2.0);
+        assert(split.exportTo(exported));
+        assert(maxPositionError(reference, exported) < 1e-9);
+        assert(exported.computeStateHash() == split.computeStateHash());
+        
+        // Rééquilibrage explicite entre deux pas : même trajectoire
+        split.rebalance();
+        for (int step = 0; step < 5; ++step) {
+            reference.step();
+            split.step();
+        }
+        assert(split.exportTo(exported));
+        assert(maxPositionError(reference, exported) < 1e-9);
+        split.stop();
+        assert(!split.isRunning());
+    }
+    
+    // 3D, deux processus
+    Simulation3D reference3D(50.0, 0.01, ForceLaw::Spline, 3.0);
+    reference3D.setRandomSeed(6);
+    reference3D.setupRandomBodies(120, 800, 600);
+    DecomposedSimulation3D split3D(50.0, 0.01, ForceLaw::Spline, 3.0);
+    assert(split3D.start(reference3D, 2));
+    for (int step = 0; step < 10; ++step) {
+        reference3D.step();
+        split3D.step();
+    }
+    Simulation3D exported3D(50.0, 0.01, ForceLaw::Spline, 3.0);
+    assert(split3D.exportTo(exported3D));
+    assert(maxPositionError(reference3D, exported3D) < 1e-9);
+    
+    reference3D.setParticleClass(0, ParticleClass::Tracer);
+    assert(!split3D.start(reference3D, 2) && !split3D.getError().empty());
+    
+    std::cout << "✅ Rangs en mémoire partagée, trajectoire du calcul en mémoire après rééquilibrage" << std::endl;
+}
+
+void testNumaPlacement() {
+    std::cout << "Test: Épinglage des workers et placement NUMA..." << std::endl;
+    
+    NumaTopology topology;
+    assert(topology.getNodeCount() >= 1 && !topology.getNode(0).cpus.empty());
+    std::vector<int> parsed = NumaTopology::parseCpuList("0-3,8-9");
+    assert(parsed.size() == 6 && parsed[3] == 3 && parsed[4] == 8);
+    
+    // Au-delà des cœurs autorisés, l'attribution recommence
+    size_t cpuCount = 0;
+    for (size_t k = 0; k < topology.getNodeCount(); ++k) cpuCount += topology.getNode(k).cpus.size();
+    std::vector<int> compact = topology.assignCpus(cpuCount + 1, PinningPolicy::Compact);
+    assert(compact[cpuCount] == compact[0] && topology.nodeOfCpu(compact[0]) == topology.getNode(0).id);
+    std::vector<int> scatter = topology.assignCpus(2, PinningPolicy::Scatter);
+    assert(topology.nodeOfCpu(scatter[0]) == topology.getNode(0).id);
+    assert(topology.assignCpus(3, PinningPolicy::None)[2] == -1);
+    
+    std::vector<int> callerCpus = NumaTopology::currentThreadCpus();
+    {
+        TaskScheduler scheduler(4, PinningPolicy::Scatter);
+        for (unsigned w = 0; w < scheduler.getThreadCount(); ++w) {
+            assert(scheduler.getWorkerCpu(w) >= 0 && scheduler.getWorkerNode(w) >= 0);
+        }
+        
+        // Bloc c toujours sur le worker c, le bloc 0 sur le thread appelant
+        std::vector<std::thread::id> first(4), second(4);
+        scheduler.affinityFor(0, 400, [&first](size_t begin, size_t) { first[begin / 100] = std::this_thread::get_id(); });
+        scheduler.affinityFor(0, 400, [&second](size_t begin, size_t) { second[begin / 100] = std::this_thread::get_id(); });
+        assert(first == second && first[0] == std::this_thread::get_id());
+        for (size_t c = 1; c < 4; ++c) assert(first[c] != first[0] && first[c] != first[c - 1]);
+        
+        // Appels imbriqués : les cases déjà prises ne sont pas écrasées, chaque indice passe une fois
+        std::vector<std::atomic<int>> visits(400 * 400);
+        scheduler.affinityFor(0, 400, [&scheduler, &visits](size_t outerBegin, size_t outerEnd) {
+            for (size_t i = outerBegin; i < outerEnd; ++i) {
+                scheduler.affinityFor(0, 400, [&visits, i](size_t begin, size_t end) {
+                    for (size_t j = begin; j < end; ++j) visits[i * 400 + j].fetch_add(1);
+                });
+            }
+        });
+        for (const auto& visit : visits) assert(visit.load() == 1);
+        
+        // Placement sans effet sur la trajectoire
+        Simulation reference(50.0, 0.01);
+        reference.setRandomSeed(8);
+        reference.setupRandomBodies(200, 800, 600);
+        reference.setTaskScheduler(&scheduler);
+        for (MemoryPlacement placement : {MemoryPlacement::FirstTouch, MemoryPlacement::Interleave}) {
+            Simulation placed(50.0, 0.01);
+            placed.setRandomSeed(8);
+            placed.setupRandomBodies(200, 800, 600);
+            placed.setTaskScheduler(&scheduler);
+            placed.setMemoryPlacement(placement);
+            for (int step = 0; step < 10; ++step) placed.step();
+            if (placement == MemoryPlacement::FirstTouch) {
+                for (int step = 0; step < 10; ++step) reference.step();
+            }
+            assert(placed.computeStateHash() == reference.computeStateHash());
+        }
+        
+        std::vector<NodeBandwidth> bandwidth = topology.measureBandwidth(scheduler, 1 << 20, MemoryPlacement::FirstTouch);
+        unsigned measured = 0;
+        for (const NodeBandwidth& node : bandwidth) {
+            assert(node.getBandwidth() > 0.0);
+            measured += node.workers;
+        }
+        assert(measured == 4);
+    }
+    // Le pool détruit rend au thread appelant ses cœurs d'origine
+    assert(NumaTopology::currentThreadCpus() == callerCpus);
+    
+    std::cout << "✅ Workers épinglés, tranches fixes par worker, trajectoire inchangée" << std::endl;
+}
+
+void testSolverRegistry() {
+    std::cout << "Test: Registre des solveurs et calibration automatique..." << std::endl;
+    
+    // Erreur relative RMS des accélérations de sim par rapport à celles de reference
+    auto forceError = [](const Simulation& sim, const Simulation& reference) {
+        double difference = 0.0, norm = 0.0;
+        for (size_t i = 0; i < sim.getBodyCount(); ++i) {
+            Vector2D exact = reference.getBodies()[i]->getAcceleration();
+            Vector2D delta = sim.getBodies()[i]->getAcceleration() - exact;
+            difference += delta.x * delta.x + delta.y * delta.y;
+            norm += exact.x * exact.x + exact.y * exact.y;
+        }
+        return std::sqrt(difference / norm);
+    };
+    
+    Simulation reference(50.0, 0.01);
+    reference.setRandomSeed(12);
+    reference.setupRandomBodies(300, 800, 600);
+    reference.calculateForces();
+    
+    // θ = 0 : aucune cellule acceptée, seul l'ordre de sommation change
+    SolverConfig config;
+    config.kind = SolverKind::Tree;
+    config.openingAngle = 0.0;
+    config.leafSize = 8;
+    Simulation tree(50.0, 0.01);
+    tree.setRandomSeed(12);
+    tree.setupRandomBodies(300, 800, 600);
+    tree.setSolver(config);
+    tree.calculateForces();
+    assert(forceError(tree, reference) < 1e-12);
+    
+    config.openingAngle = 0.5;
+    tree.setSolver(config);
+    uint64_t before = tree.getInteractionCount();
+    tree.calculateForces();
+    double approximate = forceError(tree, reference);
+    assert(approximate > 0.0 && approximate < 1e-2);
+    assert(tree.getInteractionCount() - before < 300u * 299u);
+    
+    config.kind = SolverKind::Blocked;
+    config.tileSize = 64;
+    Simulation blocked(50.0, 0.01);
+    blocked.setRandomSeed(12);
+    blocked.setupRandomBodies(300, 800, 600);
+    blocked.setSolver(config);
+    blocked.calculateForces();
+    assert(forceError(blocked, reference) < 1e-12);
+    
+    // Arbre 3D à θ = 0 contre la somme directe
+    Simulation3D direct3D(50.0, 0.01), tree3D(50.0, 0.01);
+    direct3D.setRandomSeed(5);
+    direct3D.setupGalaxyCollision(100);
+    tree3D.setRandomSeed(5);
+    tree3D.setupGalaxyCollision(100);
+    config.kind = SolverKind::Tree;
+    config.openingAngle = 0.0;
+    tree3D.setSolver(config);
+    direct3D.calculateForces();
+    tree3D.calculateForces();
+    for (size_t i = 0; i < direct3D.getBodyCount(); ++i) {
+        Vector3D delta = tree3D.getBodies()[i]->getAcceleration() - direct3D.getBodies()[i]->getAcceleration();
+        assert(delta.magnitude() <= 1e-9 * (1.0 + direct3D.getBodies()[i]->getAcceleration().magnitude()));
+    }
+    
+    // Calibration : le plus rapide des candidats assez précis, puis enregistré
+    std::string cachePath = "/tmp/n-corps-solvers-test-" + std::to_string(getpid()) + ".txt";
+    std::remove(cachePath.c_str());
+    Simulation tuned(50.0, 0.01);
+    tuned.setRandomSeed(12);
+    tuned.setupRandomBodies(600, 800, 600);
+    tuned.setSolverCachePath(cachePath);
+    tuned.setForceAccuracy(5e-3);
+    tuned.setAutotuning(true);
+    tuned.step();
+    assert(tuned.getCalibrationCount() == 1 && tuned.getSolverCacheHits() == 0);
+    const std::vector<SolverTiming>& timings = tuned.getCalibration();
+    assert(timings.size() == solverCandidates(1).size() && timings[0].error == 0.0);
+    double chosen = -1.0;
+    for (const SolverTiming& timing : timings) {
+        if (timing.config.describe() == tuned.getSolver().describe()) chosen = timing.seconds;
+    }
+    assert(chosen >= 0.0);
+    assert(timings[0].completed);
+    for (const SolverTiming& timing : timings) {
+        assert(timing.accepted == (timing.error <= 5e-3));
+        assert(!timing.accepted || timing.seconds >= chosen);
+        // Arrêté au-delà du meilleur temps d'alors : jamais retenu, jamais plus rapide que le choix
+        assert(timing.completed || (!timing.accepted && timing.seconds >= chosen));
+    }
+    for (int step = 0; step < 5; ++step) tuned.step();
+    assert(tuned.getCalibrationCount() == 1);
+    
+    // Même situation sur la même machine : relue dans le cache, sans calibration
+    Simulation cached(50.0, 0.01);
+    cached.setRandomSeed(12);
+    cached.setupRandomBodies(600, 800, 600);
+    cached.setSolverCachePath(cachePath);
+    cached.setForceAccuracy(5e-3);
+    cached.setAutotuning(true);
+    cached.step();
+    assert(cached.getCalibrationCount() == 0 && cached.getSolverCacheHits() == 1);
+    assert(cached.getSolver().describe() == tuned.getSolver().describe());
+    
+    // Nouvelle scène : N et groupement changent, la situation est réévaluée
+    tuned.setupGalaxyCollision(150);
+    tuned.step();
+    assert(tuned.getCalibrationCount() + tuned.getSolverCacheHits() == 2);
+    std::remove(cachePath.c_str());
+    
+    std::cout << "✅ Arbre exact à θ = 0, tuiles exactes, calibration mise en cache" << std::endl;
+}
+
+// Coroutines de testCoroutines : paramètres par valeur ou références vivant jusqu'à run()/drain()
+AsyncTask<int> coroutineSquare(int x) {
+    co_return x * x;
+}
+
+AsyncTask<void> coroutineFailure() {
+    throw std::runtime_error("échec attendu");
+    co_return;
+}
+
+AsyncTask<void> coroutineSum(int& result) {
+    result = co_await coroutineSquare(3) + co_await coroutineSquare(4);
+    try {
+        co_await coroutineFailure();
+    } catch (const std::runtime_error&) {
+        result += 100;
+    }
+}
+
+AsyncTask<void> coroutineSleeper(CoroutineExecutor& executor, int milliseconds, std::vector<int>& order) {
+    co_await executor.sleepFor(std::chrono::milliseconds(milliseconds));
+    order.push_back(milliseconds);
+}
+
+AsyncTask<void> coroutineHop(CoroutineExecutor& ui, CoroutineExecutor& io, std::thread::id& ioThread,
+                             std::thread::id& uiThread) {
+    co_await io.schedule();
+    ioThread = std::this_thread::get_id();
+    co_await ui.schedule();
+    uiThread = std::this_thread::get_id();
+}
+
+AsyncTask<void> coroutineWaiter(AsyncSignal& signal, std::atomic<int>& wakeups, int rounds) {
+    for (int i = 0; i < rounds; ++i) {
+        co_await signal.wait();
+        wakeups.fetch_add(1);
+    }
+}
+
+AsyncTask<void> coroutineCheckpoint(CoroutineExecutor& io, SceneWriter& writer, std::string path,
+                                    SceneSnapshot snapshot, bool& written) {
+    written = co_await writer.writeAsync(io, path, std::move(snapshot), true);
+}
+
+void testCoroutines() {
+    std::cout << "Test: Coroutines d'entrées-sorties et d'interface..." << std::endl;
+    
+    // Exécuteur mené par le thread appelant : valeurs et exceptions remontent par co_await
+    CoroutineExecutor ui;
+    int sum = 0;
+    ui.spawn(coroutineSum(sum));
+    ui.run();
+    assert(sum == 125 && ui.getCompletedCount() == 1);
+    
+    // Minuteries : réveil dans l'ordre des échéances, run() rend la main une fois tout terminé
+    std::vector<int> order;
+    auto start = std::chrono::steady_clock::now();
+    ui.spawn(coroutineSleeper(ui, 20, order));
+    ui.spawn(coroutineSleeper(ui, 5, order));
+    ui.run();
+    assert(order.size() == 2 && order[0] == 5 && order[1] == 20);
+    assert(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(20));
+    
+    // Passage d'un exécuteur à l'autre : l'aller sur le thread d'entrées-sorties, le retour sur celui-ci
+    CoroutineExecutor io;
+    io.start(std::vector<int>(), 5);
+    assert(io.hasThread() && !ui.hasThread());
+    std::thread::id ioThread, uiThread;
+    ui.spawn(coroutineHop(ui, io, ioThread, uiThread));
+    ui.run();
+    assert(ioThread != std::this_thread::get_id() && uiThread == std::this_thread::get_id());
+    
+    // Signal levé par un autre thread : avant l'attente il n'est pas perdu, pendant il la réveille
+    AsyncSignal signal(io);
+    std::atomic<int> wakeups(0);
+    io.spawn(coroutineWaiter(signal, wakeups, 2));
+    signal.set();
+    while (wakeups.load() < 1) std::this_thread::yield();
+    signal.set();
+    io.drain();
+    assert(wakeups.load() == 2);
+    
+    // L'exception d'une tâche détachée est relancée par drain(), une seule fois
+    io.spawn(coroutineFailure());
+    bool thrown = false;
+    try {
+        io.drain();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+    io.drain();
+    
+    // Point de reprise : l'état copié est écrit pendant que la simulation continue
+    const char* path = "test_checkpoint.scene";
+    Simulation sim(50.0, 0.01, ForceLaw::Plummer, 0.5);
+    sim.setRandomSeed(21);
+    sim.setupRandomBodies(500, 800, 600);
+    sim.step();
+    uint64_t capturedHash = sim.computeStateHash();
+    SceneWriter writer;
+    bool written = false;
+    io.spawn(coroutineCheckpoint(io, writer, path, SceneSnapshot::capture(sim), written));
+    for (int i = 0; i < 5; ++i) sim.step();
+    io.drain();
+    assert(written);
+    FILE* temporary = std::fopen((std::string(path) + ".tmp").c_str(), "rb");
+    assert(!temporary);
+    
+    SceneLoader loader;
+    assert(loader.open(path));
+    std::unique_ptr<Simulation> restored;
+    loader.getSettings().configure(restored);
+    assert(loader.load(*restored));
+    assert(restored->computeStateHash() == capturedHash && capturedHash != sim.computeStateHash());
+    assert(restored->getForceLaw() == ForceLaw::Plummer && restored->getSoftening() == 0.5);
+    std::remove(path);
+    
+    // Trajectoire écrite par une coroutine sur l'exécuteur partagé
+    const char* trajectoryPath = "test_coroutine.traj";
+    TrajectoryWriter recorder;
+    recorder.setExecutor(&ui);
+    assert(!recorder.open(trajectoryPath, sim)); // Sans thread propre, close() attendrait indéfiniment
+    recorder.setExecutor(&io);
+    assert(recorder.open(trajectoryPath, sim));
+    for (int i = 0; i < 8; ++i) {
+        assert(recorder.writeFrame(sim));
+        sim.step();
+    }
+    recorder.close();
+    io.drain();
+    TrajectoryReader reader;
+    assert(reader.open(trajectoryPath) && reader.getFrameCount() == 8);
+    reader.close();
+    std::remove(trajectoryPath);
+    io.stop();
+    
+    // Le thread d'entrées-sorties va sur les cœurs qu'aucun worker n'occupe, s'il en reste
+    TaskScheduler scheduler(2);
+    std::vector<int> spare = scheduler.getSpareCpus();
+    assert(!spare.empty());
+    
+    std::cout << "✅ Valeurs, exceptions et minuteries, point de reprise et trajectoire hors du calcul" << std::endl;
+}
+
+void testPersistentTree() {
+    std::cout << "Test: Arbre persistant, réajustement et plus proche voisin..." << std::endl;
+    
+    // Réajusté après un mouvement, l'arbre reste exact : θ = 0 contre une construction neuve
+    std::mt19937 generator(21);
+    std::uniform_real_distribution<double> coordinate(-500.0, 500.0), jitter(-40.0, 40.0);
+    BodyArrays moved;
+    moved.resize(500, 2);
+    for (size_t i = 0; i < 500; ++i) {
+        moved.x[i] = coordinate(generator);
+        moved.y[i] = coordinate(generator);
+        moved.mass[i] = 1.0 + (i % 7);
+        moved.radius[i] = 1.0;
+    }
+    BarnesHutTree refitted, rebuilt;
+    refitted.build(moved, 8);
+    assert(refitted.getBuildOverlap() > 0.0 && refitted.getBuildOverlap() <= 1.0 + 1e-12);
+    for (size_t i = 0; i < 500; ++i) {
+        moved.x[i] += jitter(generator);
+        moved.y[i] += jitter(generator);
+    }
+    assert(refitted.refit(moved));
+    assert(refitted.getOverlap() >= refitted.getBuildOverlap());
+    BodyArrays exact = moved;
+    refitted.accelerate(moved, 1.0, 0.5, 0.0, 0, 500);
+    rebuilt.build(exact, 8);
+    rebuilt.accelerate(exact, 1.0, 0.5, 0.0, 0, 500);
+    for (size_t i = 0; i < 500; ++i) {
+        double norm = std::hypot(exact.ax[i], exact.ay[i]);
+        assert(std::hypot(moved.ax[i] - exact.ax[i], moved.ay[i] - exact.ay[i]) <= 1e-12 * (1.0 + norm));
+    }
+    BodyArrays smaller;
+    smaller.resize(10, 2);
+    assert(!refitted.refit(smaller));
+    
+    // Seuil large : une construction puis des réajustements ; ratio ≤ 1 : construction à chaque pas
+    SolverConfig config;
+    config.kind = SolverKind::Tree;
+    Simulation persistent(50.0, 0.01);
+    persistent.setRandomSeed(4);
+    persistent.setupGalaxyCollision(300);
+    persistent.setSolver(config);
+    persistent.setTreeRebuildRatio(100.0);
+    for (int step = 0; step < 10; ++step) persistent.step();
+    assert(persistent.getTreeBuildCount() == 1 && persistent.getTreeRefitCount() == 9);
+    persistent.addBody(Vector2D(0, 0), Vector2D(0, 0), 1.0);
+    persistent.step();
+    assert(persistent.getTreeBuildCount() == 2);
+    persistent.setTreeRebuildRatio(0.0);
+    for (int step = 0; step < 3; ++step) persistent.step();
+    assert(persistent.getTreeBuildCount() == 5 && persistent.getTreeRefitCount() == 9);
+    
+    // Plus proche voisin contre la recherche exhaustive, traceurs exclus des candidats
+    persistent.setParticleClass(7, ParticleClass::Tracer);
+    persistent.setTreeRebuildRatio(100.0);
+    std::uniform_real_distribution<double> probe(-300.0, 300.0);
+    for (int query = 0; query < 50; ++query) {
+        Vector2D position(probe(generator), probe(generator));
+        size_t exclude = query % 2 == 0 ? static_cast<size_t>(query) : static_cast<size_t>(-1);
+        size_t expected = persistent.getBodyCount();
+        double best = 0.0;
+        for (size_t i = 0; i < persistent.getBodyCount(); ++i) {
+            const Body& body = *persistent.getBodies()[i];
+            if (i == exclude || body.isTracer()) continue;
+            double distance = (body.getPosition() - position).magnitude();
+            if (expected == persistent.getBodyCount() || distance < best) {
+                expected = i;
+                best = distance;
+            }
+        }
+        double distance = -1.0;
+        assert(persistent.findNearestBody(position, exclude, &distance) == expected);
+        assert(std::fabs(distance - best) <= 1e-9 * (1.0 + best));
+        if (query == 10) persistent.step();
+    }
+    assert(persistent.findNearestBody(Vector2D(0, 0), 7) != 7);
+    
+    // Sélection : traceurs candidats sur demande, par le même appel
+    Vector2D tracerPosition = persistent.getBodies()[7]->getPosition();
+    double tracerDistance = -1.0;
+    assert(persistent.findNearestBody(tracerPosition) != 7);
+    assert(persistent.findNearestBody(tracerPosition, static_cast<size_t>(-1), &tracerDistance, true) == 7);
+    assert(tracerDistance == 0.0);
+    assert(persistent.findNearestBody(tracerPosition, 7, nullptr, true) == persistent.findNearestBody(tracerPosition));
+    Simulation empty(50.0, 0.01);
+    assert(empty.findNearestBody(Vector2D(0, 0)) == 0);
+    
+    // Paire régularisée : requêtes sur les lignes du calcul des forces, sans reconstruction
+    Simulation paired(1.0, 0.01, ForceLaw::Newtonian);
+    paired.setIntegrator(Integrator::Leapfrog);
+    paired.addBody(Vector2D(-0.5, 0), Vector2D(0, -std::sqrt(0.5)), 1.0, 0.01);
+    paired.addBody(Vector2D(0.5, 0), Vector2D(0, std::sqrt(0.5)), 1.0, 0.01);
+    paired.addBody(Vector2D(30, 0), Vector2D(0, 0.2), 1.0, 0.01);
+    paired.setBinaryRadius(3.0);
+    paired.setSolver(config);
+    paired.setTreeRebuildRatio(100.0);
+    for (int step = 0; step < 3; ++step) paired.step();
+    assert(paired.getBinaryCount() == 1);
+    uint64_t builds = paired.getTreeBuildCount();
+    for (int step = 0; step < 5; ++step) {
+        for (size_t i = 0; i < paired.getBodyCount(); ++i) {
+            double distance = -1.0;
+            Vector2D position = paired.getBodies()[i]->getPosition();
+            assert(paired.findNearestBody(position, static_cast<size_t>(-1), &distance) == i && distance == 0.0);
+        }
+        assert(paired.findNearestBody(paired.getBodies()[0]->getPosition(), 0) == 1);
+        assert(paired.findNearestBody(paired.getBodies()[1]->getPosition(), 1) == 0);
+        paired.step();
+    }
+    assert(paired.getTreeBuildCount() == builds);
+    
+    // Traceurs servis par l'arbre du calcul des forces : à θ = 0, la somme directe
+    Simulation direct(50.0, 0.01), walked(50.0, 0.01);
+    for (Simulation* sim : {&direct, &walked}) {
+        sim->setRandomSeed(9);
+        sim->setupGalaxyCollision(150);
+        for (size_t i = 0; i < sim->getBodyCount(); i += 3) sim->setParticleClass(i, ParticleClass::Tracer);
+    }
+    config.openingAngle = 0.0;
+    walked.setSolver(config);
+    TaskScheduler scheduler(4);
+    walked.setTaskScheduler(&scheduler);
+    direct.calculateForces();
+    walked.calculateForces();
+    for (size_t i = 0; i < direct.getBodyCount(); i += 3) {
+        Vector2D expected = direct.getBodies()[i]->getAcceleration();
+        Vector2D delta = walked.getBodies()[i]->getAcceleration() - expected;
+        assert(delta.magnitude() <= 1e-9 * (1.0 + expected.magnitude()));
+    }
+    
+    std::cout << "✅ Réajustement exact, reconstructions au seuil, plus proche voisin et traceurs par l'arbre" << std::endl;
+}
+
 int main() {
     std::cout << "=== Tests de la Simulation N-Corps ===" << std::endl << std::endl;
     
@@ -110,6 +1814,78 @@ int main() {
         testPresets();
         std::cout << std::endl;
         
+        testTaskScheduler();
+        std::cout << std::endl;
+        
+        testInstrumentation();
+        std::cout << std::endl;
+        
+        testForceLaws();
+        std::cout << std::endl;
+        
+        testNeighborList();
+        std::cout << std::endl;
+        
+        testThreeDimensions();
+        std::cout << std::endl;
+        
+        testEnsemble();
+        std::cout << std::endl;
+        
+        testReproducibility();
+        std::cout << std::endl;
+        
+        testReproducibleMode();
+        std::cout << std::endl;
+        
+        testTrajectory();
+        std::cout << std::endl;
+        
+        testTrajectoryCompression();
+        std::cout << std::endl;
+        
+        testTelemetry();
+        std::cout << std::endl;
+        
+        testSelection();
+        std::cout << std::endl;
+        
+        testCamera();
+        std::cout << std::endl;
+        
+        testOffscreenRenderer();
+        std::cout << std::endl;
+        
+        testScene();
+        std::cout << std::endl;
+        
+        testTracers();
+        std::cout << std::endl;
+        
+        testBinaries();
+        std::cout << std::endl;
+        
+        testPipeline();
+        std::cout << std::endl;
+        
+        testOutOfCore();
+        std::cout << std::endl;
+        
+        testDecomposition();
+        std::cout << std::endl;
+        
+        testNumaPlacement();
+        std::cout << std::endl;
+        
+        testSolverRegistry();
+        std::cout << std::endl;
+        
+        testCoroutines();
+        std::cout << std::endl;
+        
+        testPersistentTree();
+        std::cout << std::endl;
+        
         std::cout << "🎉 Tous les tests sont passés avec succès !" << std::endl;
         std::cout << "La simulation est prête à être utilisée." << std::endl;
         
@@ -0,0 +1,408 @@
+#include "../include/Simulation.hpp"
+#include "../include/TaskScheduler.hpp"
+#include "../include/PerfCounters.hpp"
+#include "../include/Ensemble.hpp"
+#include "../include/Telemetry.hpp"
+#include "../include/OutOfCore.hpp"
+#include "../include/Decomposition.hpp"
+#include "../include/Numa.hpp"
+#include <cstdio>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+double secondsSince(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void printWorkerStats(const TaskScheduler& scheduler) {
+    std::vector<WorkerStats> stats = scheduler.getStats();
+
+    double maxBusy = 0, totalBusy = 0;
+    uint64_t steals = 0;
+    for (size_t i = 0; i < stats.size(); ++i) {
+        double busy = stats[i].busyNanoseconds * 1e-6;
+        maxBusy = std::max(maxBusy, busy);
+        totalBusy += busy;
+        steals += stats[i].steals;
+
+        std::cout << "    worker " << i << ": occupé " << std::fixed << std::setprecision(2) << busy << " ms, "
+                  << stats[i].tasksExecuted << " tâches, " << stats[i].steals << "/" << stats[i].stealAttempts
+                  << " vols" << std::endl;
+    }
+
+    double meanBusy = totalBusy / stats.size();
+    std::cout << "    déséquilibre (max/moyenne): " << std::setprecision(3)
+              << (meanBusy > 0 ? maxBusy / meanBusy : 1.0) << ", vols: " << steals << std::endl;
+}
+
+// Nombre de voisins à moins de h, sur un tableau trié par x : le coût par corps
+// suit la densité locale, très inégale dans une scène de galaxies
+size_t countNeighbors(const std::vector<Vector2D>& sorted, size_t i, double h) {
+    size_t count = 0;
+    for (size_t j = i + 1; j < sorted.size() && sorted[j].x - sorted[i].x < h; ++j) {
+        if (std::abs(sorted[j].y - sorted[i].y) < h) ++count;
+    }
+    for (size_t j = i; j-- > 0 && sorted[i].x - sorted[j].x < h;) {
+        if (std::abs(sorted[j].y - sorted[i].y) < h) ++count;
+    }
+    return count;
+}
+
+void benchmarkNeighborLoad(TaskScheduler& scheduler, int starsPerGalaxy) {
+    std::cout << "\n=== Charge irrégulière : voisins proches (collision de galaxies) ===" << std::endl;
+
+    Simulation sim(1.0, 0.01);
+    sim.setupGalaxyCollision(starsPerGalaxy);
+
+    std::vector<Vector2D> positions;
+    positions.reserve(sim.getBodyCount());
+    for (const auto& body : sim.getBodies()) {
+        positions.push_back(body->getPosition());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    scheduler.parallelSort(positions.begin(), positions.end(),
+                           [](const Vector2D& a, const Vector2D& b) { return a.x < b.x; });
+    std::cout << "  Tri parallèle de " << positions.size() << " corps: "
+              << std::fixed << std::setprecision(2) << secondsSince(start) * 1000 << " ms" << std::endl;
+
+    const double h = 10.0;
+    std::vector<size_t> neighbors(positions.size());
+    auto kernel = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            neighbors[i] = countNeighbors(positions, i, h);
+        }
+    };
+
+    scheduler.resetStats();
+    start = std::chrono::steady_clock::now();
+    scheduler.staticFor(0, positions.size(), kernel);
+    double staticTime = secondsSince(start);
+    std::cout << "  Découpage statique: " << std::setprecision(2) << staticTime * 1000 << " ms" << std::endl;
+    printWorkerStats(scheduler);
+
+    scheduler.resetStats();
+    start = std::chrono::steady_clock::now();
+    scheduler.parallelFor(0, positions.size(), 64, kernel);
+    double stealingTime = secondsSince(start);
+    std::cout << "  Vol de travail: " << std::setprecision(2) << stealingTime * 1000 << " ms" << std::endl;
+    printWorkerStats(scheduler);
+
+    std::cout << "  Gain: x" << std::setprecision(2) << staticTime / stealingTime << std::endl;
+}
+
+void benchmarkStep(TaskScheduler& scheduler, int starsPerGalaxy, int steps) {
+    std::cout << "\n=== Simulation::step() ===" << std::endl;
+
+    Simulation sim(1.0, 0.01);
+    sim.setupGalaxyCollision(starsPerGalaxy);
+    std::cout << "  " << sim.getBodyCount() << " corps, " << steps << " pas" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) sim.step();
+    double sequential = secondsSince(start);
+    std::cout << "  Séquentiel: " << std::fixed << std::setprecision(1) << steps / sequential << " pas/s" << std::endl;
+
+    PerfCounters counters;
+    if (counters.attachScheduler(scheduler)) {
+        sim.setPerfCounters(&counters);
+    } else {
+        std::cout << "  Compteurs matériels indisponibles: " << counters.getError() << std::endl;
+    }
+
+    sim.setTaskScheduler(&scheduler);
+    scheduler.resetStats();
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) sim.step();
+    double parallel = secondsSince(start);
+    std::cout << "  Parallèle (" << scheduler.getThreadCount() << " threads): "
+              << steps / parallel << " pas/s" << std::endl;
+    printWorkerStats(scheduler);
+
+    if (counters.isAvailable()) {
+        PerfCounters::printReport(std::cout, sim.getPhaseCounters(), steps / parallel);
+    }
+}
+
+// Chemin critique d'un pas avec diagnostics à chaque pas (empreinte, énergie en O(N²))
+void benchmarkPipeline(TaskScheduler& scheduler, int starsPerGalaxy, int steps) {
+    std::cout << "\n=== Pas pipeliné (diagnostics à chaque pas) ===" << std::endl;
+
+    double rates[2];
+    for (int mode = 0; mode < 2; ++mode) {
+        Simulation sim(1.0, 0.01);
+        sim.setRandomSeed(1);
+        sim.setupGalaxyCollision(starsPerGalaxy);
+        sim.setIntegrator(Integrator::Leapfrog);
+        sim.setTaskScheduler(&scheduler);
+        sim.setStateHashInterval(1);
+        sim.setPipelined(mode == 1);
+        TelemetryMetrics metrics;
+        metrics.energyInterval = 1;
+        sim.setTelemetry(&metrics);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) sim.step();
+        sim.finishPipeline();
+        double elapsed = secondsSince(start);
+        rates[mode] = steps / elapsed;
+        std::cout << "  " << (mode == 1 ? "Pipeliné: " : "Séquencé: ") << std::fixed << std::setprecision(2)
+                  << elapsed / steps * 1000 << " ms/pas (forces " << metrics.forceNanoseconds.load() * 1e-6 / steps
+                  << " ms/pas)" << std::endl;
+    }
+    std::cout << "  Gain: x" << std::setprecision(2) << rates[1] / rates[0] << std::endl;
+}
+
+void benchmarkOutOfCore(TaskScheduler& scheduler, int bodies, int steps) {
+    std::cout << "\n=== Hors mémoire : tuiles en flux contre corps en mémoire ===" << std::endl;
+
+    Simulation sim(1.0, 0.01, ForceLaw::Plummer, 1.0);
+    sim.setRandomSeed(1);
+    sim.setupRandomBodies(bodies, 800, 600);
+    sim.setTaskScheduler(&scheduler);
+
+    // Fichier écrit avant les pas de référence : même état initial
+    const char* path = "benchmark_out_of_core.bodies";
+    const size_t tileBodies = 1024;
+    const size_t budget = 4 * tileBodies * 6 * sizeof(double) + 2 * tileBodies * 8 * sizeof(double);
+    OutOfCoreSimulation streamed(1.0, 0.01, ForceLaw::Plummer, 1.0);
+    streamed.setTaskScheduler(&scheduler);
+    if (!streamed.create(path, sim, budget, tileBodies)) {
+        std::cout << "  Indisponible: " << streamed.getError() << std::endl;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) sim.step();
+    double inMemory = secondsSince(start) / steps;
+    for (int i = 0; i < steps; ++i) streamed.step();
+    const OutOfCoreStats& stats = streamed.getStats();
+    double outOfCore = stats.stepSeconds / steps;
+
+    std::cout << "  En mémoire: " << std::fixed << std::setprecision(2) << inMemory * 1000 << " ms/pas" << std::endl;
+    std::cout << "  Hors mémoire (" << streamed.getTileCount() << " tuiles, blocs de " << streamed.getBlockTiles()
+              << ", " << std::setprecision(0) << streamed.getResidentBytes() / 1024.0 << " Kio résidents): "
+              << std::setprecision(2) << outOfCore * 1000 << " ms/pas (x" << outOfCore / inMemory << ")" << std::endl;
+    std::cout << "  E/S: " << stats.getThroughput() / 1073741824.0 << " Go/s, " << std::setprecision(1)
+              << 100.0 * stats.ioSeconds / stats.stepSeconds << " % du pas" << std::endl;
+    streamed.close();
+    std::remove(path);
+}
+
+void benchmarkDecomposition(TaskScheduler& scheduler, int bodies, int steps) {
+    std::cout << "\n=== Décomposition : threads contre processus en mémoire partagée ===" << std::endl;
+
+    Simulation sim(1.0, 0.01, ForceLaw::Plummer, 1.0);
+    sim.setRandomSeed(1);
+    sim.setupRandomBodies(bodies, 800, 600);
+    sim.setTaskScheduler(&scheduler);
+
+    // Un processus par thread du pool : même nombre de cœurs des deux côtés
+    int processes = static_cast<int>(scheduler.getThreadCount());
+    DecomposedSimulation split(1.0, 0.01, ForceLaw::Plummer, 1.0);
+    split.setNumaPinning(false);
+    if (!split.start(sim, processes)) {
+        std::cout << "  Indisponible: " << split.getError() << std::endl;
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) sim.step();
+    double threads = secondsSince(start) / steps;
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < steps; ++i) split.step();
+    double decomposed = secondsSince(start) / steps;
+
+    std::cout << "  " << processes << " threads: " << std::fixed << std::setprecision(2) << threads * 1000 << " ms/pas" << std::endl;
+    std::cout << "  " << processes << " processus: " << decomposed * 1000 << " ms/pas (x" << decomposed / threads
+              << ", déséquilibre " << split.getImbalance() << ")" << std::endl;
+}
+
+void benchmarkNuma(unsigned threads, int bodies, int steps) {
+    std::cout << "\n=== NUMA : épinglage et placement des tableaux de forces ===" << std::endl;
+
+    NumaTopology topology;
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    unsigned socket = std::min<unsigned>(threads, static_cast<unsigned>(topology.getNode(0).cpus.size()));
+    std::cout << "  " << topology.getNodeCount() << " nœud(s), " << socket << " cœurs autorisés sur le premier" << std::endl;
+
+    struct Configuration {
+        const char* label;
+        unsigned threads;
+        PinningPolicy pinning;
+        MemoryPlacement placement;
+    };
+    // Un socket plein d'abord : la référence de passage à l'échelle au-delà
+    const Configuration configurations[] = {
+        {"un socket, compact", socket, PinningPolicy::Compact, MemoryPlacement::FirstTouch},
+        {"libre, défaut", threads, PinningPolicy::None, MemoryPlacement::Default},
+        {"scatter, défaut", threads, PinningPolicy::Scatter, MemoryPlacement::Default},
+        {"scatter, first-touch", threads, PinningPolicy::Scatter, MemoryPlacement::FirstTouch},
+        {"scatter, interleave", threads, PinningPolicy::Scatter, MemoryPlacement::Interleave},
+    };
+
+    double reference = 0.0;
+    for (const Configuration& configuration : configurations) {
+        TaskScheduler scheduler(configuration.threads, configuration.pinning);
+        Simulation sim(1.0, 0.01, ForceLaw::Plummer, 1.0);
+        sim.setRandomSeed(1);
+        sim.setupRandomBodies(bodies, 800, 600);
+        sim.setTaskScheduler(&scheduler);
+        sim.setMemoryPlacement(configuration.placement);
+        sim.step();
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) sim.step();
+        double perStep = secondsSince(start) / steps;
+        if (reference == 0.0) reference = perStep;
+
+        std::cout << "  " << configuration.threads << " threads, " << configuration.label << ": " << std::fixed
+                  << std::setprecision(2) << perStep * 1000 << " ms/pas (x" << reference / perStep << ")";
+        for (const NodeBandwidth& node : topology.measureBandwidth(scheduler, 16 << 20, configuration.placement)) {
+            std::cout << ", nœud " << node.node << " " << std::setprecision(1) << node.getBandwidth() / 1073741824.0 << " Go/s";
+        }
+        std::cout << std::endl;
+    }
+}
+
+void benchmarkSolvers(TaskScheduler& scheduler, int starsPerGalaxy, int steps) {
+    std::cout << "\n=== Solveurs de forces et calibration automatique ===" << std::endl;
+
+    auto makeSimulation = [&scheduler, starsPerGalaxy]() {
+        std::unique_ptr<Simulation> sim(new Simulation(50.0, 0.01));
+        sim->setRandomSeed(1);
+        sim->setupGalaxyCollision(starsPerGalaxy);
+        sim->setTaskScheduler(&scheduler);
+        return sim;
+    };
+
+    std::vector<SolverConfig> fixed(3);
+    fixed[1].kind = SolverKind::Blocked;
+    fixed[2].kind = SolverKind::Tree;
+    double reference = 0.0;
+    for (const SolverConfig& config : fixed) {
+        std::unique_ptr<Simulation> sim = makeSimulation();
+        sim->setSolver(config);
+        sim->step();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) sim->step();
+        double perStep = secondsSince(start) / steps;
+        if (reference == 0.0) reference = perStep;
+        std::cout << "  " << std::left << std::setw(36) << config.describe() << std::right << " " << std::fixed
+                  << std::setprecision(2) << perStep * 1000 << " ms/pas (x" << reference / perStep << ")" << std::endl;
+    }
+
+    // Premier pas : calibration puis enregistrement ; seconde simulation : lecture du cache
+    char cachePath[] = "/tmp/n-corps-solvers-XXXXXX";
+    int descriptor = mkstemp(cachePath);
+    if (descriptor < 0) return;
+    close(descriptor);
+    for (int run = 0; run < 2; ++run) {
+        std::unique_ptr<Simulation> sim = makeSimulation();
+        sim->setSolverCachePath(cachePath);
+        sim->setAutotuning(true);
+        auto start = std::chrono::steady_clock::now();
+        sim->step();
+        double firstStep = secondsSince(start);
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) sim->step();
+        double perStep = secondsSince(start) / steps;
+        std::cout << "  calibré (" << (run == 0 ? "mesure" : "cache") << "), " << sim->getSolver().describe() << ": "
+                  << std::setprecision(2) << perStep * 1000 << " ms/pas (x" << reference / perStep << "), premier pas "
+                  << firstStep * 1000 << " ms" << std::endl;
+    }
+    std::remove(cachePath);
+}
+
+void benchmarkPersistentTree(TaskScheduler& scheduler, int starsPerGalaxy, int steps) {
+    std::cout << "\n=== Arbre persistant : réajustement contre reconstruction à chaque pas ===" << std::endl;
+
+    SolverConfig config;
+    config.kind = SolverKind::Tree;
+    double ratios[2] = {0.0, Simulation(50.0, 0.01).getTreeRebuildRatio()};
+    double reference = 0.0;
+    for (double ratio : ratios) {
+        std::unique_ptr<Simulation> sim(new Simulation(50.0, 0.01));
+        sim->setRandomSeed(1);
+        sim->setupGalaxyCollision(starsPerGalaxy);
+        sim->setTaskScheduler(&scheduler);
+        sim->setSolver(config);
+        sim->setTreeRebuildRatio(ratio);
+        sim->step();
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < steps; ++i) sim->step();
+        double perStep = secondsSince(start) / steps;
+        if (reference == 0.0) reference = perStep;
+        std::cout << "  seuil " << std::fixed << std::setprecision(1) << ratio << ": " << std::setprecision(2)
+                  << perStep * 1000 << " ms/pas (x" << reference / perStep << "), " << sim->getTreeBuildCount()
+                  << " reconstructions, " << sim->getTreeRefitCount() << " réajustements" << std::endl;
+    }
+}
+
+void benchmarkEnsemble(TaskScheduler& scheduler, size_t systems, int steps) {
+    std::cout << "\n=== Ensemble de systèmes binaires (4 corps) ===" << std::endl;
+
+    std::vector<std::unique_ptr<Simulation>> simulations;
+    Ensemble ensemble(4);
+    for (size_t s = 0; s < systems; ++s) {
+        std::unique_ptr<Simulation> sim(new Simulation(50.0 + 0.01 * s, 0.01));
+        sim->setupBinarySystem();
+        ensemble.addSystem(*sim);
+        simulations.push_back(std::move(sim));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (auto& sim : simulations) {
+        for (int i = 0; i < steps; ++i) sim->step();
+    }
+    double loopTime = secondsSince(start);
+    double loopRate = systems * steps / loopTime;
+    std::cout << "  Boucle sur Simulation: " << std::fixed << std::setprecision(0) << loopRate
+              << " systèmes·pas/s" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    ensemble.run(steps);
+    double sequentialTime = secondsSince(start);
+    std::cout << "  Ensemble (1 thread): " << systems * steps / sequentialTime << " systèmes·pas/s (x"
+              << std::setprecision(1) << loopTime / sequentialTime << ")" << std::endl;
+
+    ensemble.setTaskScheduler(&scheduler);
+    start = std::chrono::steady_clock::now();
+    ensemble.run(steps);
+    double parallelTime = secondsSince(start);
+    std::cout << "  Ensemble (" << scheduler.getThreadCount() << " threads): " << std::setprecision(0)
+              << systems * steps / parallelTime << " systèmes·pas/s (x" << std::setprecision(1)
+              << loopTime / parallelTime << ")" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int starsPerGalaxy = argc > 1 ? std::atoi(argv[1]) : 20000;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::atoi(argv[2])) : 0;
+
+    TaskScheduler scheduler(threads);
+
+    std::cout << "🚀 BENCHMARK SIMULATION N-CORPS 🚀" << std::endl;
+    std::cout << "Threads: " << scheduler.getThreadCount() << std::endl;
+
+    benchmarkNeighborLoad(scheduler, starsPerGalaxy);
+    benchmarkStep(scheduler, 500, 20);
+    benchmarkPipeline(scheduler, 1000, 20);
+    benchmarkOutOfCore(scheduler, 8192, 5);
+    benchmarkDecomposition(scheduler, 8192, 5);
+    benchmarkNuma(threads, 8192, 3);
+    benchmarkSolvers(scheduler, 4000, 5);
+    benchmarkPersistentTree(scheduler, starsPerGalaxy, 20);
+    benchmarkEnsemble(scheduler, 4096, 1000);
+
+    return 0;
+}
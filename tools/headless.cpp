@@ -0,0 +1,809 @@
+#include "../include/Simulation.hpp"
+#include "../include/TaskScheduler.hpp"
+#include "../include/Profiler.hpp"
+#include "../include/PerfCounters.hpp"
+#include "../include/Trajectory.hpp"
+#include "../include/Telemetry.hpp"
+#include "../include/OffscreenRenderer.hpp"
+#include "../include/Scene.hpp"
+#include "../include/OutOfCore.hpp"
+#include "../include/Decomposition.hpp"
+#include "../include/Coroutine.hpp"
+#include <iostream>
+#include <algorithm>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include <atomic>
+#include <memory>
+#include <string>
+
+namespace {
+
+// Thread d'entrées-sorties moins prioritaire que le calcul quand il partage ses cœurs
+const int IO_NICENESS = 10;
+
+struct HeadlessOptions {
+    std::string preset;
+    std::string scenePath;
+    std::string saveScenePath;
+    bool saveSceneBinary;
+    int bodies;
+    int steps;
+    int dimension;
+    double gravitationalConstant;
+    double timeStep;
+    unsigned threads;
+    PinningPolicy pinning;
+    MemoryPlacement placement;
+    bool numaReport;
+    SolverConfig solver;
+    bool autotune;
+    double forceAccuracy;
+    double treeRebuildRatio;            // < 0 : seuil par défaut de la simulation
+    std::string tuneCachePath;
+    ForceLaw forceLaw;
+    double softening;
+    double contactStiffness;
+    double neighborSkin;
+    double tracerMass;
+    double freezeDistance;
+    double binaryRadius;
+    double binaryLimit;
+    Integrator integrator;
+    bool seeded;
+    uint32_t seed;
+    bool reproducible;
+    bool pipelined;
+    uint64_t hashInterval;
+    std::string tracePath;
+    bool hardwareCounters;
+    std::string recordPath;
+    int recordInterval;
+    double recordTolerance;
+    int keyframeInterval;
+    std::string telemetryAddress;
+    std::string checkpointPath;
+    int checkpointInterval;
+    std::string renderPattern;
+    std::string renderPipe;
+    int renderWidth;
+    int renderHeight;
+    int renderInterval;
+    double renderExposure;
+    double renderTrails;
+    std::string outOfCorePath;
+    double memoryBudget;
+    int processes;
+
+    HeadlessOptions() : preset("galaxy"), saveSceneBinary(false), bodies(0), steps(1000), dimension(2), gravitationalConstant(50.0),
+                        timeStep(0.01), threads(1), pinning(PinningPolicy::None),
+                        placement(MemoryPlacement::Default), numaReport(false), autotune(false), forceAccuracy(1e-3), treeRebuildRatio(-1.0), forceLaw(ForceLaw::Clamped), softening(0.0),
+                        contactStiffness(0.0), neighborSkin(-1.0), tracerMass(0.0), freezeDistance(0.0),
+                        binaryRadius(0.0), binaryLimit(1e-2), integrator(Integrator::Euler), seeded(false), seed(0),
+                        reproducible(false), pipelined(false), hashInterval(0),
+                        hardwareCounters(false), recordInterval(1), recordTolerance(1e-4),
+                        keyframeInterval(TrajectoryCodec::DEFAULT_KEYFRAME_INTERVAL), checkpointInterval(100),
+                        renderWidth(1920), renderHeight(1080), renderInterval(1),
+                        renderExposure(1.0), renderTrails(0.9), memoryBudget(256.0), processes(0) {}
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " [options]" << std::endl;
+    std::cout << "  --preset solar|binary|random|galaxy  Préréglage (défaut: galaxy)" << std::endl;
+    std::cout << "  --bodies N     Corps aléatoires, ou étoiles par galaxie" << std::endl;
+    std::cout << "  --scene f      Fichier de scène (paramètres et corps) à la place d'un préréglage" << std::endl;
+    std::cout << "  --save-scene f Écrit l'état final au format de scène" << std::endl;
+    std::cout << "  --save-format csv|binary  Table des corps de --save-scene (défaut: csv)" << std::endl;
+    std::cout << "  --steps N      Nombre de pas (défaut: 1000)" << std::endl;
+    std::cout << "  --dim 2|3      Dimension de la simulation (défaut: 2)" << std::endl;
+    std::cout << "  --G valeur     Constante gravitationnelle (défaut: 50)" << std::endl;
+    std::cout << "  --dt valeur    Pas de temps (défaut: 0.01)" << std::endl;
+    std::cout << "  --threads N    Threads de calcul, 0 = tous les cœurs (défaut: 1)" << std::endl;
+    std::cout << "  --pin none|compact|scatter  Un cœur par thread : sockets remplis un à un, ou à tour de rôle" << std::endl;
+    std::cout << "  --placement default|first-touch|interleave  Pages des tableaux de forces (défaut: default)" << std::endl;
+    std::cout << "  --numa-report  Débit mémoire par nœud NUMA avant le calcul" << std::endl;
+    std::cout << "  --solver pairwise|blocked|tree  Solveur de forces (défaut: pairwise, le calcul d'origine)" << std::endl;
+    std::cout << "  --tile T       Sources par tuile du solveur blocked (défaut: 1024)" << std::endl;
+    std::cout << "  --theta t      Angle d'ouverture du solveur tree (défaut: 0.5)" << std::endl;
+    std::cout << "  --leaf L       Corps par feuille du solveur tree (défaut: 16)" << std::endl;
+    std::cout << "  --tree-rebuild r  Dégradation tolérée de l'arbre réajusté avant reconstruction (0 = à chaque pas, défaut: 1.05)" << std::endl;
+    std::cout << "  --autotune     Solveur et paramètres calibrés sur les premiers pas, mis en cache par machine" << std::endl;
+    std::cout << "  --accuracy e   Erreur relative RMS tolérée sur les accélérations (défaut: 1e-3)" << std::endl;
+    std::cout << "  --tune-cache f Fichier de cache de --autotune (défaut: ~/.cache/n-corps-solvers.txt)" << std::endl;
+    std::cout << "  --law clamped|newton|plummer|spline  Loi de force (défaut: clamped)" << std::endl;
+    std::cout << "  --softening e  Longueur d'adoucissement (plummer, spline)" << std::endl;
+    std::cout << "  --integrator euler|leapfrog  Schéma d'intégration (défaut: euler)" << std::endl;
+    std::cout << "  --seed N       Graine des préréglages aléatoires" << std::endl;
+    std::cout << "  --reproducible Sommation des forces en ordre fixe (identique quel que soit --threads)" << std::endl;
+    std::cout << "  --hash-every K Empreinte 64 bits de l'état tous les K pas" << std::endl;
+    std::cout << "  --pipeline     Intégration fusionnée aux forces ; empreintes et images pendant le pas suivant" << std::endl;
+    std::cout << "  --contact k    Raideur du contact mou entre corps qui se chevauchent" << std::endl;
+    std::cout << "  --skin s       Peau de la liste de voisins (défaut: moitié de la coupure)" << std::endl;
+    std::cout << "  --tracer-below m  Les corps de masse < m deviennent des traceurs (sans effet sur les autres)" << std::endl;
+    std::cout << "  --freeze d     Gèle les traceurs à plus de d de toute source" << std::endl;
+    std::cout << "  --binaries R   Régularise (Kustaanheimo-Stiefel) les paires liées plus serrées que R" << std::endl;
+    std::cout << "  --binary-limit g  Marée relative au-delà de laquelle une paire est dissoute (défaut: 0.01)" << std::endl;
+    std::cout << "  --trace f.json Export Chrome trace-event (binaire compilé avec PROFILE=1)" << std::endl;
+    std::cout << "  --perf         Compteurs matériels par phase (Linux, perf_event_open)" << std::endl;
+    std::cout << "  --record f     Enregistre la trajectoire (relecture : N-Corps --replay f)" << std::endl;
+    std::cout << "  --record-every K  Une image tous les K pas (défaut: 1)" << std::endl;
+    std::cout << "  --record-tolerance t  Erreur relative à la taille du système, 0 = doubles exacts (défaut: 1e-4)" << std::endl;
+    std::cout << "  --record-keyframe K   Une image clé (accès direct) toutes les K images (défaut: 32)" << std::endl;
+    std::cout << "  --telemetry port|unix:chemin  Métriques Prometheus pendant le calcul (curl 127.0.0.1:port/metrics)" << std::endl;
+    std::cout << "  --checkpoint f Point de reprise (scène, format de --save-format) écrit pendant le calcul" << std::endl;
+    std::cout << "  --checkpoint-every K  Un point de reprise tous les K pas (défaut: 100)" << std::endl;
+    std::cout << "  --render motif Images numérotées sans fenêtre (images/galaxie_%05d.png, .ppm)" << std::endl;
+    std::cout << "  --render-pipe cmd  Flux RGB24 brut vers un encodeur, par exemple" << std::endl;
+    std::cout << "                 \"ffmpeg -f rawvideo -pix_fmt rgb24 -s 1920x1080 -r 30 -i - galaxie.mp4\"" << std::endl;
+    std::cout << "  --render-size LxH  Résolution des images (défaut: 1920x1080)" << std::endl;
+    std::cout << "  --render-every K   Une image tous les K pas (défaut: 1)" << std::endl;
+    std::cout << "  --render-exposure e  Exposition du tone mapping (défaut: 1)" << std::endl;
+    std::cout << "  --render-trails p    Rémanence des traînées, 0 = aucune (défaut: 0.9)" << std::endl;
+    std::cout << "  --out-of-core f      Corps dans le fichier f projeté en mémoire, tuiles lues en flux" << std::endl;
+    std::cout << "  --memory-budget Mo   Mémoire résidente de --out-of-core (défaut: 256)" << std::endl;
+    std::cout << "  --processes P        Domaine découpé entre P processus en mémoire partagée, un nœud NUMA chacun" << std::endl;
+}
+
+bool parseArguments(int argc, char** argv, HeadlessOptions& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            return false;
+        } else if (arg == "--preset" && hasValue) {
+            options.preset = argv[++i];
+        } else if (arg == "--bodies" && hasValue) {
+            options.bodies = std::atoi(argv[++i]);
+        } else if (arg == "--scene" && hasValue) {
+            options.scenePath = argv[++i];
+        } else if (arg == "--save-scene" && hasValue) {
+            options.saveScenePath = argv[++i];
+        } else if (arg == "--save-format" && hasValue) {
+            std::string format = argv[++i];
+            if (format != "csv" && format != "binary") {
+                std::cerr << "Format de table inconnu: " << format << std::endl;
+                return false;
+            }
+            options.saveSceneBinary = format == "binary";
+        } else if (arg == "--steps" && hasValue) {
+            options.steps = std::atoi(argv[++i]);
+        } else if (arg == "--dim" && hasValue) {
+            options.dimension = std::atoi(argv[++i]);
+            if (options.dimension != 2 && options.dimension != 3) {
+                std::cerr << "Dimension non prise en charge: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--G" && hasValue) {
+            options.gravitationalConstant = std::atof(argv[++i]);
+        } else if (arg == "--dt" && hasValue) {
+            options.timeStep = std::atof(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--pin" && hasValue) {
+            if (!parsePinningPolicy(argv[++i], options.pinning)) {
+                std::cerr << "Épinglage inconnu: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--placement" && hasValue) {
+            if (!parseMemoryPlacement(argv[++i], options.placement)) {
+                std::cerr << "Placement inconnu: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--numa-report") {
+            options.numaReport = true;
+        } else if (arg == "--solver" && hasValue) {
+            if (!parseSolverKind(argv[++i], options.solver.kind)) {
+                std::cerr << "Solveur inconnu: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--tile" && hasValue) {
+            options.solver.tileSize = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (arg == "--theta" && hasValue) {
+            options.solver.openingAngle = std::atof(argv[++i]);
+        } else if (arg == "--leaf" && hasValue) {
+            options.solver.leafSize = static_cast<size_t>(std::atol(argv[++i]));
+        } else if (arg == "--tree-rebuild" && hasValue) {
+            options.treeRebuildRatio = std::max(0.0, std::atof(argv[++i]));
+        } else if (arg == "--autotune") {
+            options.autotune = true;
+        } else if (arg == "--accuracy" && hasValue) {
+            options.forceAccuracy = std::atof(argv[++i]);
+        } else if (arg == "--tune-cache" && hasValue) {
+            options.tuneCachePath = argv[++i];
+        } else if (arg == "--law" && hasValue) {
+            if (!parseForceLaw(argv[++i], options.forceLaw)) {
+                std::cerr << "Loi de force inconnue: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--softening" && hasValue) {
+            options.softening = std::atof(argv[++i]);
+        } else if (arg == "--integrator" && hasValue) {
+            if (!parseIntegrator(argv[++i], options.integrator)) {
+                std::cerr << "Intégrateur inconnu: " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--seed" && hasValue) {
+            options.seeded = true;
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (arg == "--reproducible") {
+            options.reproducible = true;
+        } else if (arg == "--pipeline") {
+            options.pipelined = true;
+        } else if (arg == "--hash-every" && hasValue) {
+            options.hashInterval = std::strtoull(argv[++i], nullptr, 10);
+        } else if (arg == "--contact" && hasValue) {
+            options.contactStiffness = std::atof(argv[++i]);
+        } else if (arg == "--skin" && hasValue) {
+            options.neighborSkin = std::atof(argv[++i]);
+        } else if (arg == "--tracer-below" && hasValue) {
+            options.tracerMass = std::atof(argv[++i]);
+        } else if (arg == "--freeze" && hasValue) {
+            options.freezeDistance = std::atof(argv[++i]);
+        } else if (arg == "--binaries" && hasValue) {
+            options.binaryRadius = std::atof(argv[++i]);
+        } else if (arg == "--binary-limit" && hasValue) {
+            options.binaryLimit = std::atof(argv[++i]);
+        } else if (arg == "--trace" && hasValue) {
+            options.tracePath = argv[++i];
+        } else if (arg == "--perf") {
+            options.hardwareCounters = true;
+        } else if (arg == "--record" && hasValue) {
+            options.recordPath = argv[++i];
+        } else if (arg == "--record-every" && hasValue) {
+            options.recordInterval = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--record-tolerance" && hasValue) {
+            options.recordTolerance = std::atof(argv[++i]);
+        } else if (arg == "--record-keyframe" && hasValue) {
+            options.keyframeInterval = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--telemetry" && hasValue) {
+            options.telemetryAddress = argv[++i];
+        } else if (arg == "--checkpoint" && hasValue) {
+            options.checkpointPath = argv[++i];
+        } else if (arg == "--checkpoint-every" && hasValue) {
+            options.checkpointInterval = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--render" && hasValue) {
+            options.renderPattern = argv[++i];
+        } else if (arg == "--render-pipe" && hasValue) {
+            options.renderPipe = argv[++i];
+        } else if (arg == "--render-size" && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.renderWidth, &options.renderHeight) != 2
+                || options.renderWidth <= 0 || options.renderHeight <= 0) {
+                std::cerr << "Résolution invalide (attendu LxH): " << argv[i] << std::endl;
+                return false;
+            }
+        } else if (arg == "--render-every" && hasValue) {
+            options.renderInterval = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--render-exposure" && hasValue) {
+            options.renderExposure = std::atof(argv[++i]);
+        } else if (arg == "--render-trails" && hasValue) {
+            options.renderTrails = std::atof(argv[++i]);
+        } else if (arg == "--out-of-core" && hasValue) {
+            options.outOfCorePath = argv[++i];
+        } else if (arg == "--memory-budget" && hasValue) {
+            options.memoryBudget = std::atof(argv[++i]);
+        } else if (arg == "--processes" && hasValue) {
+            options.processes = std::max(1, std::atoi(argv[++i]));
+        } else {
+            std::cerr << "Option inconnue ou incomplète: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+template <int D>
+bool setupPreset(SimulationT<D>& sim, const HeadlessOptions& options) {
+    if (options.preset == "solar") {
+        sim.setupSolarSystem();
+    } else if (options.preset == "binary") {
+        sim.setupBinarySystem();
+    } else if (options.preset == "random") {
+        sim.setupRandomBodies(options.bodies > 0 ? options.bodies : 15, 800, 600);
+    } else if (options.preset == "galaxy") {
+        sim.setupGalaxyCollision(options.bodies > 0 ? options.bodies : 20);
+    } else {
+        std::cerr << "Préréglage inconnu: " << options.preset << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Image suivante : fichier numéroté et/ou flux vers l'encodeur
+template <int D>
+bool renderFrame(OffscreenRenderer& frames, const SimulationT<D>& sim, const HeadlessOptions& options,
+                 std::FILE* videoPipe, uint64_t index) {
+    return renderFrame(frames, frames.stageFrame(sim), options, videoPipe, index);
+}
+
+bool renderFrame(OffscreenRenderer& frames, const FrameView& frame, const HeadlessOptions& options,
+                 std::FILE* videoPipe, uint64_t index) {
+    frames.renderFrame(frame);
+    if (!options.renderPattern.empty() && !frames.writeImage(OffscreenRenderer::framePath(options.renderPattern, index))) {
+        return false;
+    }
+    return !videoPipe || frames.writeRaw(videoPipe);
+}
+
+// Points de reprise écrits sur le thread d'entrées-sorties ; un seul à la fois
+struct CheckpointLog {
+    SceneWriter writer;
+    std::atomic<int> inFlight;
+    uint64_t written;           // Thread d'entrées-sorties
+    std::string error;          // Thread d'entrées-sorties
+    uint64_t skipped;           // Boucle de calcul
+
+    CheckpointLog() : inFlight(0), written(0), skipped(0) {}
+};
+
+AsyncTask<void> writeCheckpoint(CoroutineExecutor& io, CheckpointLog& log, std::string path, SceneSnapshot snapshot,
+                                bool binary) {
+    bool ok = co_await log.writer.writeAsync(io, std::move(path), std::move(snapshot), binary);
+    if (ok) ++log.written;
+    else if (log.error.empty()) log.error = log.writer.getError();
+    log.inFlight.fetch_sub(1);
+}
+
+// Corps dans un fichier projeté : même boucle de pas, mémoire bornée par --memory-budget
+template <int D>
+int runOutOfCore(const HeadlessOptions& options, SimulationT<D>& sim, TaskScheduler* scheduler) {
+    if (options.contactStiffness > 0.0 || options.binaryRadius > 0.0 || options.freezeDistance > 0.0 || options.pipelined
+        || !options.recordPath.empty() || !options.checkpointPath.empty() || !options.renderPattern.empty()
+        || !options.renderPipe.empty() || !options.telemetryAddress.empty()) {
+        std::cerr << "--out-of-core : gravité seule, sans contact, paires, gel, pipeline, enregistrement, rendu ni télémétrie"
+                  << std::endl;
+        return 1;
+    }
+
+    OutOfCoreSimulationT<D> streamed(options.gravitationalConstant, options.timeStep, options.forceLaw, options.softening);
+    streamed.setIntegrator(options.integrator);
+    streamed.setTaskScheduler(scheduler);
+    if (!streamed.create(options.outOfCorePath, sim, static_cast<size_t>(options.memoryBudget * 1048576.0))) {
+        std::cerr << "Fichier hors mémoire impossible: " << streamed.getError() << std::endl;
+        return 1;
+    }
+    // Les corps ne vivent plus que dans le fichier
+    sim.replaceBodies(std::vector<std::unique_ptr<BodyT<D>>>());
+    std::cout << "  Hors mémoire: " << options.outOfCorePath << ", " << std::fixed << std::setprecision(1)
+              << streamed.getFileSize() / 1048576.0 << " Mo, " << streamed.getTileCount() << " tuiles de "
+              << streamed.getTileBodies() << " corps, blocs de " << streamed.getBlockTiles() << " tuiles, "
+              << streamed.getResidentBytes() / 1048576.0 << " Mo résidents (budget " << options.memoryBudget << " Mo)"
+              << std::defaultfloat << std::endl;
+
+    double initialEnergy = streamed.computeEnergy();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.steps; ++i) {
+        streamed.step();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "  " << options.steps << " pas en " << std::fixed << std::setprecision(3) << elapsed << " s ("
+              << std::setprecision(1) << options.steps / elapsed << " pas/s)" << std::endl;
+    double finalEnergy = streamed.computeEnergy();
+    std::cout << "  Dérive relative de l'énergie: " << std::scientific << std::setprecision(3)
+              << std::abs(finalEnergy - initialEnergy) / std::abs(initialEnergy) << std::fixed << std::endl;
+    std::cout << "  Empreinte de l'état: " << std::hex << std::setw(16) << std::setfill('0')
+              << streamed.computeStateHash() << std::dec << std::setfill(' ') << std::endl;
+
+    // Débit pendant les transferts seuls ; leur part dans le pas dit si le calcul les recouvre
+    const OutOfCoreStats& stats = streamed.getStats();
+    std::cout << "  E/S: " << std::setprecision(1) << stats.bytesRead / 1048576.0 << " Mo lus, "
+              << stats.bytesWritten / 1048576.0 << " Mo écrits, " << std::setprecision(2)
+              << stats.getThroughput() / 1073741824.0 << " Go/s, " << std::setprecision(1) << 100.0 * stats.ioSeconds / std::max(stats.stepSeconds, 1e-9)
+              << " % du temps de pas (" << std::setprecision(3) << 1e3 * stats.stepSeconds / std::max<uint64_t>(stats.steps, 1)
+              << " ms par pas)" << std::endl;
+
+    if (!options.saveScenePath.empty()) {
+        SceneWriter writer;
+        if (!streamed.exportTo(sim) || !writer.write(options.saveScenePath, sim, options.saveSceneBinary)) {
+            std::cerr << "Scène non écrite: " << writer.getError() << std::endl;
+            return 1;
+        }
+        std::cout << "  État final écrit dans " << options.saveScenePath << std::endl;
+    }
+    return 0;
+}
+
+// Domaine découpé le long d'une courbe de Morton entre --processes processus
+template <int D>
+int runDecomposed(const HeadlessOptions& options, SimulationT<D>& sim) {
+    if (options.contactStiffness > 0.0 || options.binaryRadius > 0.0 || options.freezeDistance > 0.0 || options.pipelined
+        || options.tracerMass > 0.0 || !options.recordPath.empty() || !options.checkpointPath.empty()
+        || !options.renderPattern.empty() || !options.renderPipe.empty() || !options.telemetryAddress.empty()) {
+        std::cerr << "--processes : gravité seule, sans contact, paires, traceurs, gel, pipeline, enregistrement, rendu ni télémétrie"
+                  << std::endl;
+        return 1;
+    }
+
+    DecomposedSimulationT<D> split(options.gravitationalConstant, options.timeStep, options.forceLaw, options.softening);
+    split.setIntegrator(options.integrator);
+    if (!split.start(sim, options.processes)) {
+        std::cerr << "Décomposition impossible: " << split.getError() << std::endl;
+        return 1;
+    }
+    std::cout << "  Décomposition: " << split.getProcessCount() << " processus, " << std::fixed << std::setprecision(1)
+              << split.getSharedBytes() / 1048576.0 << " Mo partagés" << std::defaultfloat << std::endl;
+
+    double initialEnergy = split.computeEnergy();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.steps && split.isRunning(); ++i) {
+        split.step();
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (!split.isRunning()) {
+        std::cerr << "Décomposition interrompue au pas " << split.getStepCount() << ": " << split.getError() << std::endl;
+        return 1;
+    }
+
+    std::cout << "  " << options.steps << " pas en " << std::fixed << std::setprecision(3) << elapsed << " s ("
+              << std::setprecision(1) << options.steps / elapsed << " pas/s)" << std::endl;
+    double finalEnergy = split.computeEnergy();
+    std::cout << "  Dérive relative de l'énergie: " << std::scientific << std::setprecision(3)
+              << std::abs(finalEnergy - initialEnergy) / std::abs(initialEnergy) << std::fixed << std::endl;
+    std::cout << "  Empreinte de l'état: " << std::hex << std::setw(16) << std::setfill('0')
+              << split.computeStateHash() << std::dec << std::setfill(' ') << std::endl;
+
+    // Temps de forces depuis la dernière évaluation de l'équilibre
+    std::vector<DomainSummary> domains = split.getDomains();
+    for (size_t r = 0; r < domains.size(); ++r) {
+        std::cout << "  Rang " << r << ": nœud " << domains[r].node << ", " << domains[r].end - domains[r].begin
+                  << " corps, forces " << std::setprecision(3) << 1e3 * domains[r].forceSeconds << " ms" << std::endl;
+    }
+    std::cout << "  Déséquilibre: " << std::setprecision(2) << split.getImbalance() << ", "
+              << split.getRebalanceCount() << " rééquilibrages" << std::endl;
+
+    if (!options.saveScenePath.empty()) {
+        SceneWriter writer;
+        if (!split.exportTo(sim) || !writer.write(options.saveScenePath, sim, options.saveSceneBinary)) {
+            std::cerr << "Scène non écrite: " << writer.getError() << std::endl;
+            return 1;
+        }
+        std::cout << "  État final écrit dans " << options.saveScenePath << std::endl;
+    }
+    return 0;
+}
+
+template <int D>
+int run(const HeadlessOptions& options, SceneLoader& scene) {
+    SimulationT<D> sim(options.gravitationalConstant, options.timeStep, options.forceLaw, options.softening);
+    sim.setIntegrator(options.integrator);
+    sim.setReproducible(options.reproducible);
+    sim.setPipelined(options.pipelined);
+    sim.setStateHashInterval(options.hashInterval);
+    if (options.seeded) {
+        sim.setRandomSeed(options.seed);
+    }
+
+    std::unique_ptr<TaskScheduler> scheduler;
+    if (options.threads != 1) {
+        scheduler.reset(new TaskScheduler(options.threads, options.pinning));
+        sim.setTaskScheduler(scheduler.get());
+    }
+    sim.setMemoryPlacement(options.placement);
+    sim.setSolver(options.solver);
+    if (options.treeRebuildRatio >= 0.0) sim.setTreeRebuildRatio(options.treeRebuildRatio);
+    sim.setForceAccuracy(options.forceAccuracy);
+    if (!options.tuneCachePath.empty()) {
+        sim.setSolverCachePath(options.tuneCachePath);
+    }
+    sim.setAutotuning(options.autotune);
+
+    // Scène : analyse parallèle sur les threads de calcul (pool temporaire avec --threads 1)
+    double loadSeconds = 0.0;
+    if (!options.scenePath.empty()) {
+        auto loadStart = std::chrono::steady_clock::now();
+        if (!scene.load(sim, scheduler.get())) {
+            std::cerr << "Scène illisible: " << scene.getError() << std::endl;
+            return 1;
+        }
+        loadSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - loadStart).count();
+    } else if (!setupPreset(sim, options)) {
+        return 1;
+    }
+
+    sim.setContactStiffness(options.contactStiffness);
+    sim.setNeighborSkin(options.neighborSkin);
+    if (options.tracerMass > 0.0) {
+        sim.convertLightBodiesToTracers(options.tracerMass);
+    }
+    sim.setFreezeDistance(options.freezeDistance);
+    sim.setBinaryRadius(options.binaryRadius);
+    sim.setBinaryPerturbationLimit(options.binaryLimit);
+
+    std::cout << "=== Simulation N-Corps (sans affichage) ===" << std::endl;
+    if (options.scenePath.empty()) {
+        std::cout << "  Préréglage: " << options.preset << ", " << sim.getBodyCount() << " corps en " << D << "D" << std::endl;
+    } else {
+        std::cout << "  Scène: " << options.scenePath << ", " << sim.getBodyCount() << " corps en " << D << "D, lus en "
+                  << std::fixed << std::setprecision(3) << loadSeconds << " s" << std::defaultfloat << std::endl;
+    }
+    std::cout << "  G = " << options.gravitationalConstant << ", dt = " << options.timeStep
+              << ", threads = " << (scheduler ? scheduler->getThreadCount() : 1) << std::endl;
+    std::cout << "  Loi de force: " << forceLawName(options.forceLaw) << ", adoucissement = " << options.softening
+              << ", intégrateur: " << integratorName(options.integrator)
+              << (options.reproducible ? ", reproductible" : "") << (options.pipelined ? ", pipeliné" : "") << std::endl;
+    NumaTopology topology;
+    if (options.pinning != PinningPolicy::None || options.placement != MemoryPlacement::Default || options.numaReport) {
+        std::cout << "  NUMA: " << topology.getNodeCount() << " nœud(s), épinglage " << pinningPolicyName(options.pinning)
+                  << ", placement " << memoryPlacementName(options.placement) << std::endl;
+    }
+    if (options.numaReport) {
+        // Les threads de calcul lisent chacun 64 Mo placés comme les tableaux de forces
+        std::unique_ptr<TaskScheduler> single;
+        TaskScheduler* pool = scheduler.get();
+        if (!pool) {
+            single.reset(new TaskScheduler(1, options.pinning));
+            pool = single.get();
+        }
+        for (const NodeBandwidth& node : topology.measureBandwidth(*pool, 64 << 20, options.placement)) {
+            std::cout << "  Nœud " << node.node << ": " << node.workers << " thread(s), " << std::fixed << std::setprecision(1)
+                      << node.getBandwidth() / 1073741824.0 << " Go/s en lecture" << std::defaultfloat << std::endl;
+        }
+    }
+    if (!options.outOfCorePath.empty()) {
+        return runOutOfCore(options, sim, scheduler.get());
+    }
+    if (options.processes > 0) {
+        return runDecomposed(options, sim);
+    }
+
+    PerfCounters counters;
+    if (options.hardwareCounters) {
+        bool attached = scheduler ? counters.attachScheduler(*scheduler) : counters.attachCurrentThread();
+        if (!attached) {
+            std::cout << "  Compteurs matériels indisponibles: " << counters.getError() << std::endl;
+        }
+        if (counters.isAvailable()) {
+            sim.setPerfCounters(&counters);
+        }
+    }
+
+    TelemetryMetrics metrics;
+    TelemetryServer telemetry(metrics);
+    if (!options.telemetryAddress.empty()) {
+        if (!telemetry.listen(options.telemetryAddress)) {
+            std::cerr << "Télémétrie impossible: " << telemetry.getError() << std::endl;
+            return 1;
+        }
+        sim.setTelemetry(&metrics);
+        if (telemetry.getPort() > 0) {
+            std::cout << "  Télémétrie: http://127.0.0.1:" << telemetry.getPort() << "/metrics" << std::endl;
+        } else {
+            std::cout << "  Télémétrie: " << options.telemetryAddress << std::endl;
+        }
+    }
+
+    // Trajectoire et points de reprise partagent un thread, hors des cœurs des workers s'il en reste
+    CheckpointLog checkpoints;
+    CoroutineExecutor io;
+    if (!options.recordPath.empty() || !options.checkpointPath.empty()) {
+        io.start(scheduler ? scheduler->getSpareCpus() : std::vector<int>(), IO_NICENESS);
+    }
+
+    TrajectoryWriter recorder;
+    recorder.setExecutor(&io);
+    recorder.setCompression(options.recordTolerance, options.keyframeInterval);
+    if (!options.recordPath.empty() && !(recorder.open(options.recordPath, sim) && recorder.writeFrame(sim))) {
+        std::cerr << "Enregistrement impossible: " << recorder.getError() << std::endl;
+        return 1;
+    }
+
+    // Rendu sans fenêtre : cadrage fixé sur la première image, tuiles réparties sur les threads de calcul
+    std::unique_ptr<OffscreenRenderer> frames;
+    std::FILE* videoPipe = nullptr;
+    uint64_t framesRendered = 0;
+    double renderSeconds = 0.0;
+    if (!options.renderPattern.empty() || !options.renderPipe.empty()) {
+        frames.reset(new OffscreenRenderer(options.renderWidth, options.renderHeight));
+        frames->setTaskScheduler(scheduler.get());
+        frames->setExposure(options.renderExposure);
+        frames->setTrailPersistence(options.renderTrails);
+        frames->fitCamera(frames->stageFrame(sim));
+        if (!options.renderPipe.empty()) {
+            videoPipe = popen(options.renderPipe.c_str(), "w");
+            if (!videoPipe) {
+                std::cerr << "Encodeur impossible à lancer: " << options.renderPipe << std::endl;
+                return 1;
+            }
+        }
+        if (!renderFrame(*frames, sim, options, videoPipe, framesRendered++)) {
+            std::cerr << "Rendu impossible: " << frames->getError() << std::endl;
+            if (videoPipe) pclose(videoPipe);
+            return 1;
+        }
+    }
+
+    // Image copiée après le pas, dessinée et écrite pendant le suivant en mode pipeliné ;
+    // son échec n'est donc connu qu'après ce pas
+    bool renderFailed = false;
+    double initialEnergy = sim.computeEnergy();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < options.steps; ++i) {
+        sim.step();
+        if (renderFailed) break;
+        if (recorder.isOpen() && (i + 1) % options.recordInterval == 0 && !recorder.writeFrame(sim)) {
+            std::cerr << "Enregistrement interrompu: " << recorder.getError() << std::endl;
+            return 1;
+        }
+        // Seule la copie de l'état interrompt le calcul ; un point de reprise encore en écriture fait sauter le suivant
+        if (!options.checkpointPath.empty() && (i + 1) % options.checkpointInterval == 0) {
+            if (checkpoints.inFlight.load() == 0) {
+                checkpoints.inFlight.fetch_add(1);
+                io.spawn(writeCheckpoint(io, checkpoints, options.checkpointPath, SceneSnapshot::capture(sim),
+                                         options.saveSceneBinary));
+            } else {
+                ++checkpoints.skipped;
+            }
+        }
+        if (frames && (i + 1) % options.renderInterval == 0) {
+            FrameView frame = frames->stageFrame(sim);
+            uint64_t index = framesRendered++;
+            OffscreenRenderer& renderer = *frames;
+            sim.overlapNextStep([&renderer, frame, &options, videoPipe, index, &renderFailed, &renderSeconds]() {
+                auto renderStart = std::chrono::steady_clock::now();
+                renderFailed = !renderFrame(renderer, frame, options, videoPipe, index);
+                renderSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - renderStart).count();
+            });
+        }
+    }
+    sim.finishPipeline();
+    if (renderFailed) {
+        std::cerr << "Rendu interrompu: " << frames->getError() << std::endl;
+        if (videoPipe) pclose(videoPipe);
+        return 1;
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (videoPipe && pclose(videoPipe) != 0) {
+        std::cerr << "L'encodeur s'est terminé en erreur: " << options.renderPipe << std::endl;
+    }
+
+    std::cout << "  " << options.steps << " pas en " << std::fixed << std::setprecision(3) << elapsed << " s ("
+              << std::setprecision(1) << options.steps / elapsed << " pas/s)" << std::endl;
+    double finalEnergy = sim.computeEnergy();
+    std::cout << "  Dérive relative de l'énergie: " << std::scientific << std::setprecision(3)
+              << std::abs(finalEnergy - initialEnergy) / std::abs(initialEnergy) << std::fixed << std::endl;
+    // Une ligne par empreinte : diff entre deux exécutions donne le premier pas divergent
+    for (const StateHash& record : sim.getStateHashes()) {
+        std::cout << "  pas " << record.step << ": " << std::hex << std::setw(16) << std::setfill('0')
+                  << record.hash << std::dec << std::setfill(' ') << std::endl;
+    }
+    std::cout << "  Empreinte de l'état: " << std::hex << std::setw(16) << std::setfill('0')
+              << sim.computeStateHash() << std::dec << std::setfill(' ') << std::endl;
+    if (recorder.isOpen()) {
+        recorder.close();
+        if (!recorder.getError().empty()) {
+            std::cerr << "Enregistrement interrompu: " << recorder.getError() << std::endl;
+            return 1;
+        }
+        // Taux rapporté aux images en doubles bruts
+        double rawBytes = static_cast<double>(recorder.getFrameCount()) * (sizeof(FrameHeader) + sim.getBodyCount() * D * sizeof(double));
+        std::cout << "  Trajectoire: " << recorder.getFrameCount() << " images dans " << options.recordPath << ", "
+                  << std::setprecision(2) << recorder.getFileSize() / 1048576.0 << " Mo (compression x"
+                  << std::setprecision(1) << rawBytes / recorder.getFileSize() << ")" << std::endl;
+    }
+    // Après recorder.close() : la coroutine d'écriture de trajectoire ne se termine qu'à la fermeture
+    if (!options.checkpointPath.empty()) {
+        io.drain();
+        if (!checkpoints.error.empty()) {
+            std::cerr << "Point de reprise non écrit: " << checkpoints.error << std::endl;
+            return 1;
+        }
+        std::cout << "  Points de reprise: " << checkpoints.written << " écrits dans " << options.checkpointPath;
+        if (checkpoints.skipped > 0) std::cout << " (" << checkpoints.skipped << " sautés, écriture précédente en cours)";
+        std::cout << std::endl;
+    }
+
+    if (!options.saveScenePath.empty()) {
+        SceneWriter writer;
+        if (!writer.write(options.saveScenePath, sim, options.saveSceneBinary)) {
+            std::cerr << "Scène non écrite: " << writer.getError() << std::endl;
+            return 1;
+        }
+        std::cout << "  État final écrit dans " << options.saveScenePath << std::endl;
+    }
+
+    if (frames) {
+        // Temps de rendu compris dans la durée totale ci-dessus
+        std::cout << "  Rendu: " << framesRendered << " images " << options.renderWidth << "x" << options.renderHeight
+                  << ", " << std::setprecision(3) << renderSeconds << " s pendant le calcul ("
+                  << std::setprecision(1) << (framesRendered > 1 ? (framesRendered - 1) / std::max(renderSeconds, 1e-9) : 0.0)
+                  << " images/s)" << std::endl;
+    }
+
+    size_t sources = sim.getSourceCount();
+    if (sources < sim.getBodyCount()) {
+        std::cout << "  Sources: " << sources << ", traceurs: " << sim.getBodyCount() - sources
+                  << " dont " << sim.getFrozenCount() << " gelés, "
+                  << std::setprecision(0) << static_cast<double>(sim.getInteractionCount()) / std::max(options.steps, 1)
+                  << " interactions par pas" << std::endl;
+    }
+
+    if (options.autotune) {
+        // Dernière calibration : un candidat par ligne, le retenu marqué d'une étoile
+        std::cout << "  Solveur: " << sim.getSolver().describe() << " (" << sim.getCalibrationCount() << " calibration(s), "
+                  << sim.getSolverCacheHits() << " lecture(s) du cache " << sim.getSolverCachePath() << ")" << std::endl;
+        for (const SolverTiming& timing : sim.getCalibration()) {
+            bool chosen = timing.config.describe() == sim.getSolver().describe();
+            std::cout << "    " << (chosen ? "* " : "  ") << std::left << std::setw(36) << timing.config.describe() << std::right
+                      << std::setprecision(2) << timing.seconds * 1000.0 << " ms, erreur " << std::scientific
+                      << std::setprecision(1) << timing.error << std::fixed
+                      << (!timing.completed ? " (abandonné)" : timing.accepted ? "" : " (rejeté)") << std::endl;
+        }
+    } else if (options.solver.kind != SolverKind::Pairwise) {
+        std::cout << "  Solveur: " << sim.getSolver().describe() << std::endl;
+    }
+    if (sim.getTreeBuildCount() > 0) {
+        std::cout << "  Arbre: " << sim.getTreeBuildCount() << " reconstructions, " << sim.getTreeRefitCount()
+                  << " réajustements (seuil " << std::setprecision(2) << sim.getTreeRebuildRatio() << ")" << std::endl;
+    }
+
+    if (options.binaryRadius > 0.0) {
+        std::cout << "  Paires régularisées: " << sim.getBinaryCount() << " en fin de calcul" << std::endl;
+    }
+
+    if (options.contactStiffness > 0.0) {
+        const NeighborList& list = sim.getNeighborList();
+        std::cout << "  Liste de voisins: " << list.getRebuildCount() << " reconstructions ("
+                  << std::setprecision(3) << list.getRebuildFrequency() << " par pas), "
+                  << std::setprecision(1) << list.getAverageListLength() << " voisins par corps" << std::endl;
+    }
+
+    if (counters.isAvailable()) {
+        PerfCounters::printReport(std::cout, sim.getPhaseCounters(), options.steps / elapsed);
+    }
+
+    if (Profiler::isCompiledIn()) {
+        Profiler::printSummary(std::cout);
+        if (!options.tracePath.empty()) {
+            if (Profiler::writeChromeTrace(options.tracePath)) {
+                std::cout << "Trace écrite dans " << options.tracePath << std::endl;
+            } else {
+                std::cerr << "Impossible d'écrire la trace " << options.tracePath << std::endl;
+            }
+        }
+    } else if (!options.tracePath.empty()) {
+        std::cerr << "Profilage non compilé : relancer avec make headless PROFILE=1" << std::endl;
+    }
+
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    HeadlessOptions options;
+    if (!parseArguments(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    // Les paramètres de la scène remplacent --dim, --G, --dt, --law, --softening, --integrator et --contact ;
+    // --freeze, --binaries, --solver et --autotune gardent la priorité sur les valeurs de la scène
+    SceneLoader scene;
+    if (!options.scenePath.empty()) {
+        if (!scene.open(options.scenePath)) {
+            std::cerr << "Scène illisible: " << scene.getError() << std::endl;
+            return 1;
+        }
+        const SceneSettings& settings = scene.getSettings();
+        options.dimension = settings.dimension;
+        options.gravitationalConstant = settings.gravitationalConstant;
+        options.timeStep = settings.timeStep;
+        options.forceLaw = settings.forceLaw;
+        options.softening = settings.softening;
+        options.integrator = settings.integrator;
+        options.contactStiffness = settings.contactStiffness;
+        if (options.freezeDistance == 0.0) options.freezeDistance = settings.freezeDistance;
+        if (options.binaryRadius == 0.0) options.binaryRadius = settings.binaryRadius;
+        if (options.solver.kind == SolverKind::Pairwise && !options.autotune) {
+            options.solver = settings.solver;
+            options.autotune = settings.autotune;
+        }
+    }
+
+    return options.dimension == 3 ? run<3>(options, scene) : run<2>(options, scene);
+}
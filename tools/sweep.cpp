@@ -0,0 +1,275 @@
+#include "../include/Simulation.hpp"
+#include "../include/TaskScheduler.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace {
+
+// Colonnes du résumé, clé comprise
+const long SUMMARY_COLUMNS = 12;
+
+// Une exécution de la grille
+struct SweepJob {
+    std::string preset;
+    int bodies;
+    double gravitationalConstant;
+    double timeStep;
+    uint32_t seed;
+    Integrator integrator;
+
+    // Identifiant stable, seule clé utilisée pour la reprise ; 17 chiffres :
+    // deux valeurs voisines de G ou dt ne donnent jamais la même clé
+    std::string key(int steps) const {
+        std::ostringstream out;
+        out << std::setprecision(17) << preset << '/' << bodies << '/' << gravitationalConstant << '/' << timeStep << '/'
+            << seed << '/' << integratorName(integrator) << '/' << steps;
+        return out.str();
+    }
+};
+
+struct SweepOptions {
+    std::string jobsPath;
+    std::string outputPath;
+    int steps;
+    unsigned threads;
+
+    SweepOptions() : outputPath("sweep.csv"), steps(1000), threads(0) {}
+};
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " --jobs grille.txt [options]" << std::endl;
+    std::cout << "  --jobs f       Fichier de scénarios (voir ci-dessous)" << std::endl;
+    std::cout << "  --output f.csv Résumé, une ligne par exécution (défaut: sweep.csv)" << std::endl;
+    std::cout << "  --steps N      Pas par exécution (défaut: 1000)" << std::endl;
+    std::cout << "  --threads N    Exécutions simultanées, 0 = tous les cœurs (défaut: 0)" << std::endl;
+    std::cout << std::endl;
+    std::cout << "Chaque ligne : préréglage N G dt graine intégrateur" << std::endl;
+    std::cout << "Un champ peut lister des valeurs (10,50,100) et la graine un intervalle (1-8) :" << std::endl;
+    std::cout << "la ligne est développée en produit cartésien. '#' commence un commentaire." << std::endl;
+    std::cout << "  galaxy 50,100 10,50 0.01 1-4 euler,leapfrog" << std::endl;
+}
+
+std::vector<std::string> splitList(const std::string& field) {
+    std::vector<std::string> values;
+    std::stringstream stream(field);
+    std::string value;
+    while (std::getline(stream, value, ',')) {
+        if (!value.empty()) values.push_back(value);
+    }
+    return values;
+}
+
+std::vector<uint32_t> parseSeeds(const std::string& field) {
+    std::vector<uint32_t> seeds;
+    for (const std::string& value : splitList(field)) {
+        size_t dash = value.find('-');
+        if (dash == std::string::npos) {
+            seeds.push_back(static_cast<uint32_t>(std::strtoul(value.c_str(), nullptr, 10)));
+            continue;
+        }
+        uint32_t first = static_cast<uint32_t>(std::strtoul(value.substr(0, dash).c_str(), nullptr, 10));
+        uint32_t last = static_cast<uint32_t>(std::strtoul(value.substr(dash + 1).c_str(), nullptr, 10));
+        // Arrêt sur last avant l'incrément : pas de tour complet quand last vaut UINT32_MAX
+        for (uint32_t seed = first; first <= last; ++seed) {
+            seeds.push_back(seed);
+            if (seed == last) break;
+        }
+    }
+    return seeds;
+}
+
+bool parseJobs(const std::string& path, std::vector<SweepJob>& jobs) {
+    std::ifstream input(path.c_str());
+    if (!input) {
+        std::cerr << "Impossible de lire " << path << std::endl;
+        return false;
+    }
+
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(input, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        std::string presets, counts, constants, steps, seeds, integrators;
+        if (!(fields >> presets)) continue;
+        if (!(fields >> counts >> constants >> steps >> seeds >> integrators)) {
+            std::cerr << path << ":" << lineNumber << ": 6 champs attendus" << std::endl;
+            return false;
+        }
+
+        for (const std::string& preset : splitList(presets))
+        for (const std::string& count : splitList(counts))
+        for (const std::string& constant : splitList(constants))
+        for (const std::string& dt : splitList(steps))
+        for (uint32_t seed : parseSeeds(seeds))
+        for (const std::string& name : splitList(integrators)) {
+            SweepJob job;
+            job.preset = preset;
+            job.bodies = std::atoi(count.c_str());
+            job.gravitationalConstant = std::atof(constant.c_str());
+            job.timeStep = std::atof(dt.c_str());
+            job.seed = seed;
+            if (!parseIntegrator(name, job.integrator)) {
+                std::cerr << path << ":" << lineNumber << ": intégrateur inconnu " << name << std::endl;
+                return false;
+            }
+            jobs.push_back(job);
+        }
+    }
+    return true;
+}
+
+// Clés des exécutions déjà présentes dans le résumé : elles sont sautées à la reprise.
+// Seules comptent les lignes complètes : terminées par un saut de ligne, toutes
+// colonnes présentes (une ligne coupée par un arrêt brutal est refaite)
+std::set<std::string> readCompleted(const std::string& path) {
+    std::set<std::string> completed;
+    std::ifstream input(path.c_str());
+    std::string line;
+    while (std::getline(input, line)) {
+        if (input.eof()) break; // Dernière ligne sans saut de ligne
+        size_t comma = line.find(',');
+        if (comma == std::string::npos || line.compare(0, comma, "key") == 0) continue;
+        if (std::count(line.begin(), line.end(), ',') + 1 != SUMMARY_COLUMNS) continue;
+        completed.insert(line.substr(0, comma));
+    }
+    return completed;
+}
+
+// Vrai si le fichier existe, n'est pas vide et ne finit pas par un saut de ligne
+bool endsMidLine(const std::string& path) {
+    std::ifstream input(path.c_str(), std::ios::binary | std::ios::ate);
+    if (!input || input.tellg() <= 0) return false;
+    input.seekg(-1, std::ios::end);
+    return input.get() != '\n';
+}
+
+bool setupPreset(Simulation& sim, const SweepJob& job) {
+    if (job.preset == "solar") {
+        sim.setupSolarSystem();
+    } else if (job.preset == "binary") {
+        sim.setupBinarySystem();
+    } else if (job.preset == "random") {
+        sim.setupRandomBodies(job.bodies > 0 ? job.bodies : 15, 800, 600);
+    } else if (job.preset == "galaxy") {
+        sim.setupGalaxyCollision(job.bodies > 0 ? job.bodies : 20);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    SweepOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--jobs" && hasValue) {
+            options.jobsPath = argv[++i];
+        } else if (arg == "--output" && hasValue) {
+            options.outputPath = argv[++i];
+        } else if (arg == "--steps" && hasValue) {
+            options.steps = std::atoi(argv[++i]);
+        } else if (arg == "--threads" && hasValue) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.jobsPath.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::vector<SweepJob> grid;
+    if (!parseJobs(options.jobsPath, grid)) {
+        return 1;
+    }
+
+    std::set<std::string> completed = readCompleted(options.outputPath);
+    std::vector<SweepJob> pending;
+    for (const SweepJob& job : grid) {
+        if (!completed.count(job.key(options.steps))) pending.push_back(job);
+    }
+
+    bool hasHeader = std::ifstream(options.outputPath.c_str()).peek() != std::ifstream::traits_type::eof();
+    bool truncated = endsMidLine(options.outputPath);
+    std::ofstream output(options.outputPath.c_str(), std::ios::app);
+    if (!output) {
+        std::cerr << "Impossible d'écrire " << options.outputPath << std::endl;
+        return 1;
+    }
+    if (truncated) {
+        // La ligne coupée reste seule sur sa ligne, ignorée à la prochaine reprise
+        output << std::endl;
+    }
+    if (!hasHeader) {
+        output << "key,preset,bodies,G,dt,seed,integrator,steps,wall_s,steps_per_s,energy_drift,state_hash" << std::endl;
+    }
+
+    TaskScheduler scheduler(options.threads);
+    std::cout << "=== Balayage de paramètres ===" << std::endl;
+    std::cout << "  " << grid.size() << " exécutions, " << grid.size() - pending.size() << " déjà faites, "
+              << scheduler.getThreadCount() << " threads" << std::endl;
+
+    // Une exécution par tâche ; chaque simulation reste séquentielle, le vol
+    // de travail équilibre les exécutions de durées très différentes
+    std::mutex outputMutex;
+    size_t finished = 0;
+    auto sweepStart = std::chrono::steady_clock::now();
+    scheduler.parallelFor(0, pending.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t index = begin; index < end; ++index) {
+            const SweepJob& job = pending[index];
+            Simulation sim(job.gravitationalConstant, job.timeStep);
+            sim.setRandomSeed(job.seed);
+            sim.setIntegrator(job.integrator);
+            if (!setupPreset(sim, job)) {
+                std::lock_guard<std::mutex> lock(outputMutex);
+                std::cerr << "Préréglage inconnu: " << job.preset << std::endl;
+                continue;
+            }
+
+            double initialEnergy = sim.computeEnergy();
+            auto start = std::chrono::steady_clock::now();
+            for (int step = 0; step < options.steps; ++step) {
+                sim.step();
+            }
+            double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            double finalEnergy = sim.computeEnergy();
+            double drift = std::abs(finalEnergy - initialEnergy) / std::max(std::abs(initialEnergy), 1e-300);
+
+            std::ostringstream row;
+            row << job.key(options.steps) << ',' << job.preset << ',' << sim.getBodyCount() << ','
+                << std::setprecision(17) << job.gravitationalConstant << ',' << job.timeStep << ',' << job.seed << ','
+                << integratorName(job.integrator) << ',' << options.steps << ',' << std::setprecision(6)
+                << wall << ',' << options.steps / wall << ',' << drift << ','
+                << std::hex << std::setw(16) << std::setfill('0') << sim.computeStateHash();
+
+            // Ligne écrite et vidée dès la fin de l'exécution : un arrêt ne perd que les exécutions en cours
+            std::lock_guard<std::mutex> lock(outputMutex);
+            output << row.str() << std::endl;
+            ++finished;
+            std::cout << "  [" << finished << "/" << pending.size() << "] " << job.key(options.steps) << std::endl;
+        }
+    });
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - sweepStart).count();
+    std::cout << "  Terminé en " << std::fixed << std::setprecision(2) << elapsed << " s, résumé dans "
+              << options.outputPath << std::endl;
+    return 0;
+}